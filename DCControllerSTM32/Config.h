@@ -30,6 +30,10 @@
 #define BAUD_RATE	19200
 #define DEBOUNCE_DELAY		20		// ms, for buttons
 
+/*
+*	The libraries don't see this file.  To draw to the display without the
+*	vtable build with -DDISPLAY_STATIC_DRIVER=TFT_ILI9488 (see DisplayT.h.)
+*/
 #define DISPLAY_CONTROLLER	TFT_ILI9488
 namespace Config
 {
@@ -101,27 +105,15 @@ namespace Config
 	const uint8_t kAT24CDeviceCapacity = 8;	// Value at end of AT24Cxxx xxx/8
 	
 	/*
-	*	The SDCPreferences occupy the first 24 bytes of the AT24C64 EEPROM
-	*	[24 to 8192]		unused
+	*	AT24C64 EEPROM map:
+	*	[0 to 32)			DCPreferences record (version, crc, SDCSettings)
+	*	[32 to 4568)		PressureHistory ten minute and four hour tiers
+	*	[4568 to 4576)		unused
+	*	[4576 to 8192)		LogStore event log, 113 32 byte pages
 	*/
-	struct SDCPreferences
-	{
-		uint8_t		unused[2];
-		uint8_t		clockFormat : 1,// The time format (0=24, 1=12)
-					tempUnit : 1,	// Temperature display unit (0=C, 1=F)
-					presUnit : 1,	// Pressure display unit (0=hPa, 1=Inches)
-					unused5 : 5;
-		uint8_t		binThreshold; // Dust bin motor trigger threshold.
-								  // The value at which the motor will be
-								  // stopped and the bin considered full.
-		bool		binMotorEnabled;
-		bool		displayPressure; // Display pressure in filter status view.
-		bool		showInfoViewOnStartup;
-		uint8_t		unused2;
-		uint16_t	tsMinMax[4]; // Touch screen alignment values
-		uint32_t	cleanPressure;
-		uint32_t	dirtyPressure;
-	}; // __attribute__ ((packed)); (was getting compiler warnings)
+	const uint16_t	kHistoryEEPROMAddr	= 32;	// Page aligned
+	const uint16_t	kEventLogEEPROMAddr	= 4576;	// Page aligned
+	const uint16_t	kEventLogSize		= 8192 - kEventLogEEPROMAddr;
 }
 
 #endif // Config_h
@@ -23,12 +23,17 @@
 #include <Wire.h>
 
 #include "DustCollectorSTM32.h"
+#include "MemoryStats.h"
 
 DustCollectorSTM32	dustCollector;
 
 /*********************************** setup ************************************/
 void setup(void)
 {
+#if MEMORY_STATS_ENABLED
+	// Before anything else uses the stack, for the "mem" high-water mark.
+	MemoryStats::PaintStack();
+#endif
 	Serial.begin(BAUD_RATE);
 	Serial.println(F("Starting..."));
 
@@ -0,0 +1,257 @@
+/*
+*	DCPreferences.cpp, Copyright Jonathan Mackey 2026
+*	RAM shadow of the preferences stored in the AT24C EEPROM.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "DCPreferences.h"
+#include "CRC8.h"
+#include "Config.h"
+#include <string.h>
+
+const uint8_t DCPreferences::kVersion = 1;
+const uint32_t DCPreferences::kCommitDelay = 2000;	// ms
+
+/*
+*	Version 0 of the preferences, as it was declared in Config.h.  Only used
+*	to migrate to the current version.
+*/
+struct SPreferencesV0
+{
+	uint8_t		unused[2];	// version and crc in later versions
+	uint8_t		clockFormat : 1,// The time format (0=24, 1=12)
+				tempUnit : 1,	// Temperature display unit (0=C, 1=F)
+				presUnit : 1,	// Pressure display unit (0=hPa, 1=Inches)
+				unused5 : 5;
+	uint8_t		binThreshold;
+	bool		binMotorEnabled;
+	bool		displayPressure;
+	bool		showInfoViewOnStartup;
+	uint8_t		unused2;
+	uint16_t	tsMinMax[4];
+	uint32_t	cleanPressure;
+	uint32_t	dirtyPressure;
+};
+
+static_assert(sizeof(SDCSettings) == 0
+#define DC_SETTINGS_SIZE(key, type, min, max, def)	+ sizeof(type)
+	DC_SETTINGS_SCHEMA(DC_SETTINGS_SIZE)
+#undef DC_SETTINGS_SIZE
+	, "DC_SETTINGS_SCHEMA members aren't ordered largest first (padding)");
+static_assert(sizeof(SPreferencesV0) == 24, "SPreferencesV0 layout changed");
+
+/******************************* DCPreferences ********************************/
+DCPreferences::DCPreferences(
+	AT24C*	inEEPROM)
+	: mEEPROM(inEEPROM), mCommitPeriod(kCommitDelay), mPending(false)
+{
+	static_assert(sizeof(SRecord) <= Config::kHistoryEEPROMAddr,
+		"DCPreferences overlaps the PressureHistory in the EEPROM");
+	memset(&mRecord, 0, sizeof(SRecord));
+	mRecord.version = kVersion;
+	DCSettings::SetDefaults(mRecord.settings);
+	mRecord.crc = CalcCRC(mRecord);
+	mCommitted = mRecord;
+}
+
+/********************************** CalcCRC ***********************************/
+/*
+*	The crc covers everything following the crc field.
+*/
+uint8_t DCPreferences::CalcCRC(
+	const SRecord&	inRecord)
+{
+	const uint8_t*	start = &inRecord.crc + 1;
+	return(CRC8::Calc(start, sizeof(SRecord) - (start - &inRecord.version)));
+}
+
+/********************************* MigrateV0 **********************************/
+/*
+*	Converts version 0 preferences.  Returns false if inRecord is erased
+*	EEPROM or isn't version 0.  Version 0's header bytes were unused, they're
+*	either erased (0xFF) or zeroed (loaded from SD.)  Any other header, such
+*	as that of the current version with a bad crc, isn't migrated.  Version
+*	0 can't be distinguished from a partially erased EEPROM so it relies on
+*	the range checks applied after migrating (DCSettings::Validate).
+*/
+bool DCPreferences::MigrateV0(
+	const uint8_t*	inRecord,
+	SDCSettings&	outSettings)
+{
+	SPreferencesV0	prefs;
+	memcpy(&prefs, inRecord, sizeof(SPreferencesV0));
+	uint8_t	i = 0;
+	for (; i < sizeof(SPreferencesV0) && inRecord[i] == 0xFF; i++){}
+	bool	success = i < sizeof(SPreferencesV0) &&
+				(prefs.unused[0] == 0 || prefs.unused[0] == 0xFF) &&
+				(prefs.unused[1] == 0 || prefs.unused[1] == 0xFF);
+	if (success)
+	{
+		outSettings.hourFormat = prefs.clockFormat ? 12 : 24;
+		outSettings.temperatureUnitCelsius = prefs.tempUnit == 0;
+		outSettings.pressureUnit_hPa = prefs.presUnit == 0;
+		outSettings.binThreshold = prefs.binThreshold;
+		outSettings.binMotorEnabled = prefs.binMotorEnabled;
+		outSettings.displayPressure = prefs.displayPressure;
+		outSettings.currentView = prefs.showInfoViewOnStartup ? kInfoViewTag : kFilterStatusGaugeTag;
+		outSettings.tsXMin = prefs.tsMinMax[0];
+		outSettings.tsXMax = prefs.tsMinMax[1];
+		outSettings.tsYMin = prefs.tsMinMax[2];
+		outSettings.tsYMax = prefs.tsMinMax[3];
+		outSettings.cleanPressure = prefs.cleanPressure;
+		outSettings.dirtyPressure = prefs.dirtyPressure;
+	}
+	return(success);
+}
+
+/************************************ Load ************************************/
+DCPreferences::ELoadResult DCPreferences::Load(void)
+{
+	ELoadResult	result = eReadError;
+	union
+	{
+		SRecord			record;
+		SPreferencesV0	v0;
+	} stored;
+	if (mEEPROM->Read(0, sizeof(stored), (uint8_t*)&stored))
+	{
+		if (stored.record.version == kVersion &&
+			stored.record.crc == CalcCRC(stored.record))
+		{
+			result = eLoaded;
+			mRecord = stored.record;
+			mCommitted = mRecord;
+		} else
+		{
+			/*
+			*	A current version record with a bad crc (e.g. a commit
+			*	torn by a reset between its chunks) isn't migrated, it gets
+			*	the defaults.
+			*/
+			SDCSettings	settings;
+			DCSettings::SetDefaults(settings);
+			if (MigrateV0((const uint8_t*)&stored.v0, settings))
+			{
+				DCSettings::Validate(settings);
+				mRecord.settings = settings;
+				result = eMigrated;
+			} else
+			{
+				result = eDefaults;
+			}
+		}
+	}
+	if (result != eLoaded)
+	{
+		/*
+		*	The committed copy is made to differ so that the entire record
+		*	gets written by the next commit.
+		*/
+		if (result != eMigrated)
+		{
+			DCSettings::SetDefaults(mRecord.settings);
+		}
+		mRecord.version = kVersion;
+		memset(&mCommitted, 0xFF, sizeof(SRecord));
+		/*
+		*	Migrated or default preferences are committed with the current
+		*	version and crc on the next idle commit.  After a read error
+		*	what's stored is unknown, possibly valid, so the defaults are
+		*	only used in RAM.  They're committed only if they're edited.
+		*/
+		if (result != eReadError)
+		{
+			mPending = true;
+			mCommitPeriod.Start();
+		}
+	}
+	return(result);
+}
+
+/************************************ Edit ************************************/
+SDCSettings& DCPreferences::Edit(void)
+{
+	mPending = true;
+	mCommitPeriod.Start();
+	return(mRecord.settings);
+}
+
+/********************************** IsDirty ***********************************/
+bool DCPreferences::IsDirty(void) const
+{
+	return(mPending &&
+		memcmp(&mRecord, &mCommitted, sizeof(SRecord)) != 0);
+}
+
+/*********************************** Update ***********************************/
+void DCPreferences::Update(void)
+{
+	if (mPending &&
+		mCommitPeriod.Passed() &&
+		!Commit())
+	{
+		mCommitPeriod.Start();	// Try again later
+	}
+}
+
+/*********************************** Commit ***********************************/
+/*
+*	Writes the span of bytes that differ from what was last committed.  The
+*	crc byte changes with almost any change, so the span typically starts at
+*	the crc.
+*/
+bool DCPreferences::Commit(void)
+{
+	bool	success = true;
+	if (mPending)
+	{
+		mRecord.crc = CalcCRC(mRecord);
+		const uint8_t*	recordPtr = &mRecord.version;
+		const uint8_t*	committedPtr = &mCommitted.version;
+		uint8_t	first = 0;
+		uint8_t	last = sizeof(SRecord);
+		for (; first < last && recordPtr[first] == committedPtr[first]; first++){}
+		for (; last > first && recordPtr[last-1] == committedPtr[last-1]; last--){}
+		if (first < last)
+		{
+			success = mEEPROM->QueueWrite(first, last - first, &recordPtr[first], this);
+		}
+		if (success)
+		{
+			mCommitted = mRecord;
+			mPending = false;
+		}
+	}
+	return(success);
+}
+
+/******************************** WriteComplete *******************************/
+/*
+*	If the write failed, everything is written again on the next commit.
+*/
+void DCPreferences::WriteComplete(
+	bool	inSuccess)
+{
+	if (!inSuccess)
+	{
+		memset(&mCommitted, 0xFF, sizeof(SRecord));
+		mPending = true;
+		mCommitPeriod.Start();
+	}
+}
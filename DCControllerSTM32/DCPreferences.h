@@ -0,0 +1,102 @@
+/*
+*	DCPreferences.h, Copyright Jonathan Mackey 2026
+*	RAM shadow of the preferences stored in the AT24C EEPROM.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef DCPreferences_h
+#define DCPreferences_h
+
+#include "DCSettings.h"
+#include "MSPeriod.h"
+#include "AT24C.h"
+
+/*
+*	All reads are served from RAM.  Changes are made to the RAM copy via
+*	Edit() and committed by Update() once no further changes have been made
+*	for kCommitDelay ms.  The commit compares the RAM copy against the last
+*	committed copy and writes only the span of changed bytes.  The
+*	preferences fit within the first EEPROM page, so a commit is one page
+*	write no matter how many fields changed.  A span of more than 30 bytes
+*	(AT24C::WriteChunk's limit) takes two write cycles, so a reset can tear
+*	it.  The crc no longer matches, and Load uses the defaults.  The write is
+*	queued (AT24C::QueueWrite) so a commit doesn't stall the main loop.
+*
+*	The preferences are stored as an SRecord: a version, a crc, and the
+*	SDCSettings generated from DC_SETTINGS_SCHEMA.  The version and crc
+*	identify valid preferences.  Erased EEPROM is detected by the crc rather
+*	than by range checking each field.  Older versions are migrated on Load:
+*		0	SDCPreferences with bitfields, no version or crc (2023)
+*		1	SDCSettings
+*/
+class DCPreferences : public AT24CWriteDelegate
+{
+public:
+							DCPreferences(
+								AT24C*					inEEPROM);
+	enum ELoadResult
+	{
+		eLoaded,
+		eMigrated,	// Loaded from an older version and range checked
+		eDefaults,	// Erased or damaged, defaults used
+		eReadError	// The EEPROM couldn't be read, defaults used, nothing committed
+	};
+	ELoadResult				Load(void);
+	const SDCSettings&		Get(void) const
+								{return(mRecord.settings);}
+							/*
+							*	Returns the RAM copy to be modified.  The change
+							*	is committed by Update or Commit.
+							*/
+	SDCSettings&			Edit(void);
+							// Call from the main loop, commits when idle.
+	void					Update(void);
+							/*
+							*	Queues the pending changes now.  Call
+							*	AT24C::Flush after this if the write needs to
+							*	complete before continuing (e.g. a reset.)
+							*/
+	bool					Commit(void);
+	virtual void			WriteComplete(
+								bool					inSuccess);
+	bool					IsDirty(void) const;
+	static const uint8_t	kVersion;
+	static const uint32_t	kCommitDelay;
+protected:
+	struct SRecord
+	{
+		uint8_t		version;
+		uint8_t		crc;		// CRC8 of the bytes that follow
+		uint8_t		reserved[2];
+		SDCSettings	settings;
+	};
+	AT24C*			mEEPROM;
+	SRecord			mRecord;
+	SRecord			mCommitted;	// As stored in the EEPROM
+	MSPeriod		mCommitPeriod;
+	bool			mPending;
+
+	static uint8_t			CalcCRC(
+								const SRecord&			inRecord);
+	static bool				MigrateV0(
+								const uint8_t*			inRecord,
+								SDCSettings&			outSettings);
+};
+
+#endif // DCPreferences_h
@@ -1,14 +1,11 @@
 /*
 *	DCSettings.cpp, Copyright Jonathan Mackey 2023
 *
-*	This is a minimal parser for key=value files of the same form as
-*	boards.txt and platform.txt accept this class interprets the values as
-*	either strings or numbers with support for notted values and hex values.
-*	Only the select set of keys defined below are read.  Any other keys are
-*	skipped.
-*
-*	To keep the code size small, very little error checking performed.
-*	It's assumed that the config file was created by DCSettings::WriteFile
+*	Reads and writes the settings file, a key=value file of the same form
+*	as boards.txt and platform.txt.  The keys, types, ranges and defaults
+*	are defined once by DC_SETTINGS_SCHEMA (DCSettings.h.)  Parsing is done
+*	by KeyValueParser.  Unknown keys, duplicate keys and invalid values are
+*	reported rather than assuming the file was created by WriteFile.
 *
 *	GNU license:
 *	This program is free software: you can redistribute it and/or modify
@@ -29,195 +26,300 @@
 *
 */
 #include "DCSettings.h"
+#include "DataStream.h"
+#include "KeyValueParser.h"
+#include <string.h>
 #ifndef __MACH__
 #include <Arduino.h>
 #include "SdFat.h"
-#include "sdios.h"
-#else
-#include <string>
-#define _BV(bit) (1 << (bit))
 #endif
 #include "UnixTime.h"
+#include "BinThreshold.h"
 
-/*
-*	List of keys
-*/
-const char kBinMotorEnabledKeyStr[] = "binMotorEnabled";
-const char kBinThresholdKeyStr[] = "binThreshold";
-const char kCleanPressureKeyStr[] = "cleanPressure";
-const char kCurrentViewKeyStr[] = "currentView";
-const char kDirtyPressureKeyStr[] = "dirtyPressure";
-const char kDisplayPressureKeyStr[] = "displayPressure";
-const char kHourFormat24KeyStr[] = "hourFormat";
-const char kPressureUnitKeyStr[] = "pressureUnit_hPa";
-const char kTemperatureUnitKeyStr[] = "temperatureUnitCelsius";
-const char kTsXMaxKeyStr[] = "tsXMax";
-const char kTsXMinKeyStr[] = "tsXMin";
-const char kTsYMaxKeyStr[] = "tsYMax";
-const char kTsYMinKeyStr[] = "tsYMin";
-
-const char* const kSettingsKeys[] =
-{	// Sorted alphabetically
-	kBinMotorEnabledKeyStr,
-	kBinThresholdKeyStr,
-	kCleanPressureKeyStr,
-	kCurrentViewKeyStr,
-	kDirtyPressureKeyStr,
-	kDisplayPressureKeyStr,
-	kHourFormat24KeyStr,
-	kPressureUnitKeyStr,
-	kTemperatureUnitKeyStr,
-	kTsXMaxKeyStr,
-	kTsXMinKeyStr,
-	kTsYMaxKeyStr,
-	kTsYMinKeyStr
+const char* const DCSettings::kKeys[] =
+{
+#define DC_SETTINGS_KEY_STR(key, type, min, max, def)	#key,
+	DC_SETTINGS_SCHEMA(DC_SETTINGS_KEY_STR)
+#undef DC_SETTINGS_KEY_STR
 };
 
-enum EKeyIndexes
+/*
+*	A minimal DataStream over an open SdFile (FILE on the host) so that the
+*	parser can read the file in blocks.
+*/
+class SettingsFileStream : public DataStream
 {
-	eInvalidKeyIndex,
-	// Must align with kSettingsKeys
-	eBinMotorEnabled,
-	eBinThreshold,
-	eCleanPressure,
-	eCurrentView,
-	eDirtyPressure,
-	eDisplayPressure,
-	eHourFormat24,
-	ePressureUnit,
-	eTemperatureUnit,
-	eTsXMax,
-	eTsXMin,
-	eTsYMax,
-	eTsYMin,
-	eKeyCount
+public:
+							SettingsFileStream(
+								SdFile*					inFile)
+								: mFile(inFile){}
+	virtual uint32_t		Read(
+								uint32_t				inLength,
+								void*					outBuffer)
+							{
+							#ifdef __MACH__
+								return((uint32_t)fread(outBuffer, 1, inLength, mFile));
+							#else
+								int	bytesRead = mFile->read(outBuffer, inLength);
+								return(bytesRead > 0 ? bytesRead : 0);
+							#endif
+							}
+	virtual uint32_t		Write(
+								uint32_t				inLength,
+								const void*				inBuffer)
+							{
+							#ifdef __MACH__
+								return((uint32_t)fwrite(inBuffer, 1, inLength, mFile));
+							#else
+								return(mFile->write(inBuffer, inLength));
+							#endif
+							}
+	virtual bool			Seek(
+								int32_t					/*inOffset*/,
+								EOrigin					/*inOrigin*/)
+								{return(false);}
+	virtual uint32_t		GetPos(void) const
+								{return(0);}
+	virtual bool			AtEOF(void) const
+								{return(false);}
+	virtual uint32_t		Clip(
+								uint32_t				inLength) const
+								{return(inLength);}
+protected:
+	SdFile*	mFile;
 };
 
-static const uint32_t kNumericKeysMask =
-						_BV(eBinThreshold) |
-						_BV(eCleanPressure) |
-						_BV(eCurrentView) |
-						_BV(eDirtyPressure) |
-						_BV(eHourFormat24) |
-						_BV(eTsXMax) |
-						_BV(eTsXMin) |
-						_BV(eTsYMax) |
-						_BV(eTsYMin);
-
 /********************************* DCSettings **********************************/
 DCSettings::DCSettings(void)
-: mFile(nullptr)
+	: mErrorLine(0), mUnknownKeys(0), mDuplicateKeys(0), mMissingKeys(0)
+{
+	SetDefaults(mSettings);
+}
+
+/******************************** SetDefaults *********************************/
+void DCSettings::SetDefaults(
+	SDCSettings&	outSettings)
+{
+	// Clears any padding, which would otherwise be part of the EEPROM crc.
+	memset(&outSettings, 0, sizeof(SDCSettings));
+#define DC_SETTINGS_DEFAULT(key, type, min, max, def)	outSettings.key = def;
+	DC_SETTINGS_SCHEMA(DC_SETTINGS_DEFAULT)
+#undef DC_SETTINGS_DEFAULT
+}
+
+/********************************** Validate **********************************/
+/*
+*	Each value is checked against its range, then the values that depend on
+*	each other are checked.
+*/
+uint8_t DCSettings::Validate(
+	SDCSettings&	ioSettings)
+{
+	uint8_t	valuesReset = 0;
+#define DC_SETTINGS_VALIDATE(key, type, min, max, def)	\
+	if (!InRange(ioSettings.key, min, max))			\
+	{												\
+		ioSettings.key = def;						\
+		valuesReset++;								\
+	}
+	DC_SETTINGS_SCHEMA(DC_SETTINGS_VALIDATE)
+#undef DC_SETTINGS_VALIDATE
+	if (!PressuresAreValid(ioSettings.cleanPressure, ioSettings.dirtyPressure))
+	{
+		SDCSettings	defaults;
+		SetDefaults(defaults);
+		ioSettings.cleanPressure = defaults.cleanPressure;
+		ioSettings.dirtyPressure = defaults.dirtyPressure;
+		valuesReset++;
+	}
+	return(valuesReset);
+}
+
+/******************************** FindKeyIndex ********************************/
+/*
+*	Returns the EKeyIndexes index of inKey, or eInvalidKeyIndex if inKey isn't
+*	in the schema.  The switch cases are the compile time hashes of the keys,
+*	so a schema change that causes a hash collision won't compile.
+*/
+uint8_t DCSettings::FindKeyIndex(
+	const char*	inKey,
+	uint32_t	inKeyHash)
+{
+	uint8_t	keyIndex = eInvalidKeyIndex;
+	switch (inKeyHash)
+	{
+	#define DC_SETTINGS_HASH_CASE(key, type, min, max, def)	\
+		case KeyValueParser::Hash(#key):		\
+			keyIndex = e_##key;				\
+			break;
+		DC_SETTINGS_SCHEMA(DC_SETTINGS_HASH_CASE)
+	#undef DC_SETTINGS_HASH_CASE
+	}
+	if (keyIndex != eInvalidKeyIndex &&
+		strcmp(inKey, kKeys[keyIndex]) != 0)
+	{
+		keyIndex = eInvalidKeyIndex;
+	}
+	return(keyIndex);
+}
+
+/******************************** FindKeyIndex ********************************/
+uint8_t DCSettings::FindKeyIndex(
+	const char*	inKey)
+{
+	uint32_t	hash = KeyValueParser::Hash(inKey);
+	return(FindKeyIndex(inKey, hash));
+}
+
+/****************************** SetIndexedValue *******************************/
+/*
+*	Returns false if inValue isn't a valid value for the key or is out of
+*	range.  The setting is only changed if inValue is valid.
+*/
+bool DCSettings::SetIndexedValue(
+	SDCSettings&	ioSettings,
+	uint8_t			inKeyIndex,
+	const char*		inValue)
 {
+	bool	valid = false;
+	switch (inKeyIndex)
+	{
+	#define DC_SETTINGS_PARSE_CASE(key, type, min, max, def)		\
+		case e_##key:											\
+		{														\
+			type	value;										\
+			valid = ParseValue(inValue, value) &&				\
+				InRange(value, min, max);						\
+			if (valid)											\
+			{													\
+				ioSettings.key = value;							\
+			}													\
+			break;												\
+		}
+		DC_SETTINGS_SCHEMA(DC_SETTINGS_PARSE_CASE)
+	#undef DC_SETTINGS_PARSE_CASE
+	}
+	return(valid);
+}
+
+/********************************** SetValue **********************************/
+uint8_t DCSettings::SetValue(
+	SDCSettings&	ioSettings,
+	const char*		inKey,
+	const char*		inValue)
+{
+	uint8_t	keyIndex = FindKeyIndex(inKey);
+	return(keyIndex == eInvalidKeyIndex ? eUnknownKey :
+		(SetIndexedValue(ioSettings, keyIndex, inValue) ? eReadOK : eInvalidValue));
+}
+
+/********************************** GetValue **********************************/
+bool DCSettings::GetValue(
+	const SDCSettings&	inSettings,
+	const char*			inKey,
+	char*				outValue)
+{
+	char*	endOfStr = outValue;
+	switch (FindKeyIndex(inKey))
+	{
+	#define DC_SETTINGS_FORMAT_CASE(key, type, min, max, def)	\
+		case e_##key:											\
+			endOfStr = FormatValue(inSettings.key, outValue);	\
+			break;
+		DC_SETTINGS_SCHEMA(DC_SETTINGS_FORMAT_CASE)
+	#undef DC_SETTINGS_FORMAT_CASE
+	}
+	*endOfStr = 0;
+	return(endOfStr != outValue);
 }
 
 /********************************** ReadFile **********************************/
 /*
-*	It's assumed SdFat.begin was successfully called prior to calling this
-*	routine.
-*	This routine returns true if the file contains all of the following
-*	key values: desc, signature, upload.speed, f_cpu, flash.page_size
+*	It's assumed the card's volume was mounted (SDLogger::Volume) prior to
+*	calling this routine.
 */
-bool DCSettings::ReadFile(
+uint8_t DCSettings::ReadFile(
 	const char*	inPath)
 {
-	mSettings = {0};
-	uint8_t	requiredKeyValues = 0;
+	uint8_t	result = eOpenFailed;
 #ifndef __MACH__
 	SdFile file;
-	bool	fileOpened = file.open(inPath, O_RDONLY);
-	mFile = &file;
+	if (file.open(inPath, O_RDONLY))
+	{
+		SettingsFileStream	stream(&file);
+		result = Read(&stream);
+		file.close();
+	}
 #else
-	mFile = fopen(inPath, "r+");
-	bool	fileOpened = mFile != nullptr;
+	SdFile*	file = fopen(inPath, "r");
+	if (file)
+	{
+		SettingsFileStream	stream(file);
+		result = Read(&stream);
+		fclose(file);
+	}
 #endif
-	if (fileOpened)
+	return(result);
+}
+
+/************************************ Read ************************************/
+uint8_t DCSettings::Read(
+	DataStream*	inStream)
+{
+	// The keys read are tracked as bits of keysRead.
+	static_assert(eKeyCount <= 32, "DC_SETTINGS_SCHEMA has too many keys");
+	SetDefaults(mSettings);
+	mErrorLine = 0;
+	mUnknownKeys = 0;
+	mDuplicateKeys = 0;
+	uint8_t			result = eReadOK;
+	uint32_t		keysRead = 0;
+	KeyValueParser	parser(inStream);
+	uint8_t			parseResult;
+	while ((parseResult = parser.Next()) != KeyValueParser::eEnd)
 	{
-		char	thisChar = NextChar();
-		while (thisChar)
+		uint8_t	lineResult = eReadOK;
+		if (parseResult == KeyValueParser::eSyntaxError)
+		{
+			lineResult = eSyntaxError;
+		} else
 		{
-			thisChar = SkipWhitespaceAndHashComments(thisChar);
-			if (thisChar)
+			uint8_t	keyIndex = FindKeyIndex(parser.Key(), parser.KeyHash());
+			if (keyIndex == eInvalidKeyIndex)
+			{
+				if (mUnknownKeys < 0xFFFF) mUnknownKeys++;
+				lineResult = eUnknownKey;
+			} else if (keysRead & ((uint32_t)1 << keyIndex))
+			{
+				if (mDuplicateKeys < 0xFFFF) mDuplicateKeys++;
+				lineResult = eDuplicateKey;
+			} else
 			{
-				char keyStr[32];
-				keyStr[0] = thisChar;
-				thisChar = ReadStr('=', 31, &keyStr[1]);
-				while (thisChar)
+				keysRead |= ((uint32_t)1 << keyIndex);
+				if (!SetIndexedValue(mSettings, keyIndex, parser.Value()))
 				{
-					uint8_t keyIndex = FindKeyIndex(keyStr);
-					if (keyIndex)
-					{
-						requiredKeyValues++;
-						if (kNumericKeysMask & (_BV(keyIndex)))
-						{
-							uint32_t	value;
-							thisChar = ReadUInt32Number(value);
-							switch (keyIndex)
-							{
-								case eBinThreshold:
-									mSettings.binThreshold = value;
-									break;
-								case eCleanPressure:
-									mSettings.cleanPressure = value;
-									break;
-								case eCurrentView:
-									mSettings.currentView = value;
-									break;
-								case eDirtyPressure:
-									mSettings.dirtyPressure = value;
-									break;
-								case eHourFormat24:
-									mSettings.hourFormat = value;
-									break;
-								case eTsXMax:
-									mSettings.tsMinMax[1] = value;
-									break;
-								case eTsXMin:
-									mSettings.tsMinMax[0] = value;
-									break;
-								case eTsYMax:
-									mSettings.tsMinMax[3] = value;
-									break;
-								case eTsYMin:
-									mSettings.tsMinMax[2] = value;
-									break;
-							}
-						} else
-						{
-							char valueStr[10];
-							thisChar = ReadStr('\n', sizeof(valueStr), valueStr);
-							bool	isTrue = valueStr[0] == 't';
-							switch (keyIndex)
-							{
-								case eBinMotorEnabled:
-									mSettings.binMotorEnabled = isTrue;
-									break;
-								case eDisplayPressure:
-									mSettings.displayPressure = isTrue;
-									break;
-								case ePressureUnit:
-									mSettings.pressureUnit_hPa = isTrue;
-									break;
-								case eTemperatureUnit:
-									mSettings.temperatureUnitCelsius = isTrue;
-									break;
-							}
-						}
-					} else
-					{
-						thisChar = SkipToNextLine();
-					}
-					break;
+					lineResult = eInvalidValue;
 				}
 			}
 		}
-	#ifndef __MACH__
-		mFile->close();
-	#else
-		fclose(mFile);
-	#endif
-		mFile = nullptr;
+		if (lineResult != eReadOK &&
+			result == eReadOK)
+		{
+			result = lineResult;
+			mErrorLine = parser.Line();
+		}
+	}
+	mMissingKeys = 0;
+	for (uint8_t keyIndex = 0; keyIndex < eKeyCount; keyIndex++)
+	{
+		mMissingKeys += (keysRead & ((uint32_t)1 << keyIndex)) == 0;
+	}
+	if (result == eReadOK &&
+		Validate(mSettings))
+	{
+		result = eInvalidValue;
 	}
-	return(requiredKeyValues == eTsYMin);
+	return(result);
 }
 
 /********************************** WriteFile *********************************/
@@ -225,333 +327,155 @@ bool DCSettings::WriteFile(
 	const char*			inPath,
 	const SDCSettings&	inSettings)
 {
+	bool	success = false;
 #ifndef __MACH__
 	SdFile file;
 	SdFile::dateTimeCallback(UnixTime::SDFatDateTimeCB);
-	bool	fileOpened = file.open(inPath, O_WRONLY | O_TRUNC | O_CREAT);
-	mFile = &file;
-#else
-	mFile = fopen(inPath, "w");
-	bool	fileOpened = mFile != nullptr;
-#endif
-	if (fileOpened)
-	{
-		
-		for (uint8_t keyIndex = 1; keyIndex < eKeyCount; keyIndex++)
-		{
-			
-			WriteStr(kSettingsKeys[keyIndex-1]);
-			WriteChar('=');
-			if (kNumericKeysMask & (_BV(keyIndex)))
-			{
-				int32_t	value = 0;
-				switch (keyIndex)
-				{
-					case eBinThreshold:
-						value = inSettings.binThreshold;
-						break;
-					case eCleanPressure:
-						value = inSettings.cleanPressure;
-						break;
-					case eCurrentView:
-						value = inSettings.currentView;
-						break;
-					case eDirtyPressure:
-						value = inSettings.dirtyPressure;
-						break;
-					case eHourFormat24:
-						value = inSettings.hourFormat;
-						break;
-					case eTsXMax:
-						value = inSettings.tsMinMax[1];
-						break;
-					case eTsXMin:
-						value = inSettings.tsMinMax[0];
-						break;
-					case eTsYMax:
-						value = inSettings.tsMinMax[3];
-						break;
-					case eTsYMin:
-						value = inSettings.tsMinMax[2];
-						break;
-				}
-				char valueStr[15];
-				Int32ToString(value, valueStr);
-				WriteStr(valueStr);
-			} else
-			{
-				bool	isTrue = false;;
-				switch (keyIndex)
-				{
-					case eBinMotorEnabled:
-						isTrue = inSettings.binMotorEnabled;
-						break;
-					case eDisplayPressure:
-						isTrue = inSettings.displayPressure;
-						break;
-					case ePressureUnit:
-						isTrue = inSettings.pressureUnit_hPa;
-						break;
-					case eTemperatureUnit:
-						isTrue = inSettings.temperatureUnitCelsius;
-						break;
-				}
-				WriteStr(isTrue ? "true":"false");
-			}
-			WriteChar('\n');
-		}
-	#ifndef __MACH__
-		mFile->close();
-	#else
-		fclose(mFile);
-	#endif
-	}
-	return(fileOpened);
-}
-
-/********************************** NextChar **********************************/
-char DCSettings::NextChar(void)
-{
-	char	thisChar;
-#ifdef __MACH__
-	thisChar = getc(mFile);
-	if (thisChar == -1)
+	if (file.open(inPath, O_WRONLY | O_TRUNC | O_CREAT))
 	{
-		thisChar = 0;
+		SettingsFileStream	stream(&file);
+		success = Write(&stream, inSettings);
+		success = file.close() && success;
 	}
 #else
-	if (mFile->read(&thisChar,1) != 1)
+	SdFile*	file = fopen(inPath, "w");
+	if (file)
 	{
-		thisChar = 0;
+		SettingsFileStream	stream(file);
+		success = Write(&stream, inSettings);
+		success = fclose(file) == 0 && success;
 	}
 #endif
-	return(thisChar);
+	return(success);
 }
 
-/******************************** FindKeyIndex ********************************/
+/************************************ Write ***********************************/
 /*
-*	Returns the index of inKey within the array kSettingsKeys + 1.
-*	Returns 0 if inKey is not found.
+*	Each line is formatted in a buffer and written with one Write call.
 */
-uint8_t DCSettings::FindKeyIndex(
-	const char*	inKey)
+bool DCSettings::Write(
+	DataStream*			inStream,
+	const SDCSettings&	inSettings)
 {
-	uint8_t leftIndex = 0;
-	uint8_t rightIndex = (sizeof(kSettingsKeys)/sizeof(char*)) -1;
-	while (leftIndex <= rightIndex)
+	bool	success = true;
+	char	line[KeyValueParser::eMaxKeyLen + KeyValueParser::eMaxValueLen + 3];
+	for (uint8_t keyIndex = 0; keyIndex < eKeyCount && success; keyIndex++)
 	{
-		uint8_t current = (leftIndex + rightIndex) / 2;
-		const char* currentPtr = kSettingsKeys[current];
-		int cmpResult = strcmp(inKey, currentPtr);
-		if (cmpResult == 0)
+		char*	linePtr = line;
+		strcpy(linePtr, kKeys[keyIndex]);
+		linePtr += strlen(linePtr);
+		*(linePtr++) = '=';
+		switch (keyIndex)
 		{
-			return(current+1);	// Add 1, 0 is reserved for "not found"
-		} else if (cmpResult <= 0)
-		{
-			rightIndex = current - 1;
-		} else
-		{
-			leftIndex = current + 1;
+		#define DC_SETTINGS_FORMAT_CASE(key, type, min, max, def)	\
+			case e_##key:											\
+				linePtr = FormatValue(inSettings.key, linePtr);		\
+				break;
+			DC_SETTINGS_SCHEMA(DC_SETTINGS_FORMAT_CASE)
+		#undef DC_SETTINGS_FORMAT_CASE
 		}
+		*(linePtr++) = '\n';
+		uint32_t	length = (uint32_t)(linePtr - line);
+		success = inStream->Write(length, line) == length;
 	}
-	return(0);
+	return(success);
 }
 
-/******************************* SkipWhitespace *******************************/
-char DCSettings::SkipWhitespace(
-	char	inCurrChar)
+/********************************* ParseValue *********************************/
+bool DCSettings::ParseValue(
+	const char*	inString,
+	bool&		outValue)
 {
-	char	thisChar = inCurrChar;
-	for (; thisChar != 0; thisChar = NextChar())
-	{
-		if (isspace(thisChar))
-		{
-			continue;
-		}
-		break;
-	}
-	return(thisChar);
+	return(KeyValueParser::ParseBool(inString, outValue));
 }
 
-/*********************** SkipWhitespaceAndHashComments ************************/
-char DCSettings::SkipWhitespaceAndHashComments(
-	char	inCurrChar)
+/********************************* ParseValue *********************************/
+bool DCSettings::ParseValue(
+	const char*	inString,
+	uint8_t&	outValue)
 {
-	char	thisChar = inCurrChar;
-	while (thisChar)
+	uint32_t	value;
+	bool	success = KeyValueParser::ParseUInt32(inString, value) && value <= 0xFF;
+	if (success)
 	{
-		if (isspace(thisChar))
-		{
-			thisChar = NextChar();
-			continue;
-		} else if (thisChar == '#')
-		{
-			thisChar = SkipToNextLine();
-			continue;
-		}
-		break;
+		outValue = (uint8_t)value;
 	}
-	return(thisChar);
+	return(success);
 }
 
-/******************************* SkipToNextLine *******************************/
-/*
-*	Returns the character following the newline (if any).
-*	Does not support Windows CRLF line endings.
-*/
-char DCSettings::SkipToNextLine(void)
+/********************************* ParseValue *********************************/
+bool DCSettings::ParseValue(
+	const char*	inString,
+	uint16_t&	outValue)
 {
-	char thisChar = NextChar();
-	for (; thisChar; thisChar = NextChar())
+	uint32_t	value;
+	bool	success = KeyValueParser::ParseUInt32(inString, value) && value <= 0xFFFF;
+	if (success)
 	{
-		if (thisChar != '\n')
-		{
-			continue;
-		}
-		thisChar = NextChar();
-		break;
+		outValue = (uint16_t)value;
 	}
-	return(thisChar);
+	return(success);
 }
 
-/******************************** Int32ToString *******************************/
-void DCSettings::Int32ToString(
-	int32_t	inValue,
-	char*	outString)
+/********************************* ParseValue *********************************/
+bool DCSettings::ParseValue(
+	const char*	inString,
+	int16_t&	outValue)
 {
-	if (inValue < 0)
+	bool	negative = *inString == '-';
+	uint32_t	value;
+	bool	success = KeyValueParser::ParseUInt32(negative ? &inString[1] : inString, value) &&
+						value <= 0x7FFF;
+	if (success)
 	{
-		*(outString++) = '-';
-		inValue = -inValue;
+		outValue = negative ? -(int16_t)value : (int16_t)value;
 	}
-	for (int32_t num = inValue; num/=10; outString++);
-	outString[1] = 0;
-	do
-	{
-		*(outString--) = (inValue % 10) + '0';
-		inValue /= 10;
-	} while (inValue);
+	return(success);
 }
 
-/****************************** ReadUInt32Number ******************************/
-char DCSettings::ReadUInt32Number(
+/********************************* ParseValue *********************************/
+bool DCSettings::ParseValue(
+	const char*	inString,
 	uint32_t&	outValue)
 {
-	bool		bitwiseNot = false;
-	bool 		isHex = false;
-	uint32_t	value = 0;
-	char		thisChar = SkipWhitespaceAndHashComments(NextChar());
-	if (thisChar)
-	{
-		bitwiseNot = thisChar == '~';
-		/*
-		*	If notted THEN
-		*	get the next char after the not.
-		*/
-		if (bitwiseNot)
-		{
-			thisChar = SkipWhitespaceAndHashComments(NextChar());
-		}
-		if (thisChar == '0')
-		{
-			thisChar = NextChar();	// Get the character following the leading zero.
-			isHex = thisChar == 'x';
-			/*
-			*	If this is a hex prefix THEN
-			*	get the character following it.
-			*/
-			if (isHex)
-			{
-				thisChar = NextChar();
-			}
-		}
-		// Now just consume characters till a non valid numeric char is hit.
-		if (isHex)
-		{
-			for (; isxdigit(thisChar); thisChar = NextChar())
-			{
-				thisChar -= '0';
-				if (thisChar > 9)
-				{
-					thisChar -= 7;
-					if (thisChar > 15)
-					{
-						thisChar -= 32;
-					}
-				}
-				value = (value << 4) + thisChar;
-			}
-		} else
-		{
-			for (; isdigit(thisChar); thisChar = NextChar())
-			{
-				value = (value * 10) + (thisChar - '0');
-			}
-		}
-		thisChar = SkipWhitespaceAndHashComments(thisChar);
-	}
-	if (bitwiseNot)
-	{
-		value = ~value;
-	}
-	outValue = value;
-	return(thisChar);
+	return(KeyValueParser::ParseUInt32(inString, outValue));
 }
 
-/********************************** ReadStr ***********************************/
-/*
-*	Reads the string till the delimiter is hit.
-*	Once the string is full (inMaxStrLen), characters are ignored till the
-*	delimiter is hit.
-*	Hash (#) comments are not allowed because the strings aren't quoted.
-*/
-char DCSettings::ReadStr(
-	char	inDelimiter,
-	uint8_t	inMaxStrLen,
-	char*	outStr)
+/******************************** FormatValue *********************************/
+char* DCSettings::FormatValue(
+	bool	inValue,
+	char*	outString)
 {
-	char		thisChar;
-	char*		endOfStrPtr = &outStr[inMaxStrLen -1];
-
-	while((thisChar = NextChar()) != 0)
-	{
-		if (thisChar != inDelimiter)
-		{
-			/*
-			*	If outStr isn't full THEN
-			*	append thisChar to it.
-			*/
-			if (outStr < endOfStrPtr)
-			{
-				*(outStr++) = thisChar;
-			} // else discard the character, the outStr is full
-			continue;
-		}
-		break;
-	}
-	*outStr = 0;	// Terminate the string
-	return(thisChar);
+	strcpy(outString, inValue ? "true" : "false");
+	return(&outString[inValue ? 4 : 5]);
 }
 
-/********************************** WriteStr **********************************/
-void DCSettings::WriteStr(
-	const char*	inStr)
+/******************************** FormatValue *********************************/
+/*
+*	Returns the end of the string (not terminated.)
+*/
+char* DCSettings::FormatValue(
+	uint32_t	inValue,
+	char*		outString)
 {
-#ifdef __MACH__
-	fwrite(inStr, strlen(inStr), 1, mFile);
-#else
-	mFile->write(inStr ,strlen(inStr));
-#endif
+	for (uint32_t num = inValue; num /= 10; outString++){}
+	char*	endOfStr = &outString[1];
+	do
+	{
+		*(outString--) = (inValue % 10) + '0';
+		inValue /= 10;
+	} while (inValue);
+	return(endOfStr);
 }
 
-/********************************** WriteChar *********************************/
-void DCSettings::WriteChar(
-	char	inChar)
+/******************************** FormatValue *********************************/
+char* DCSettings::FormatValue(
+	int16_t	inValue,
+	char*	outString)
 {
-#ifdef __MACH__
-	putc(inChar, mFile);
-#else
-	mFile->write(&inChar ,1);
-#endif
+	if (inValue < 0)
+	{
+		*(outString++) = '-';
+	}
+	return(FormatValue((uint32_t)(inValue < 0 ? -inValue : inValue), outString));
 }
-
@@ -32,57 +32,200 @@
 #else
 class SdFile;
 #endif
+class DataStream;
+
+/*
+*	The views currentView can be.  These are also the views' tags (DCXViews.h)
+*/
+static const uint16_t	kInfoViewTag = 300;
+static const uint16_t	kFilterStatusGaugeTag = 500;
+
+/*
+*	The settings schema, X(key, type, min, max, default).  The key is both
+*	the settings file key and the SDCSettings member name.  Types are bool,
+*	uint8_t, uint16_t, int16_t and uint32_t.  The following are all generated from
+*	this one list:
+*	- SDCSettings, which is also the EEPROM layout (see DCPreferences)
+*	- the settings file keys, ReadFile and WriteFile
+*	- SetDefaults, Validate (range checks) and SetValue/GetValue by key,
+*	  as used by serial commands
+*	Members are listed largest type first so SDCSettings has no padding.
+*	Adding a setting changes the EEPROM layout, so DCPreferences::kVersion
+*	needs to be bumped and a migration added to DCPreferences::Load.
+*	min, max and default are only expanded in DCSettings.cpp (32 keys max.)
+*/
+#define DC_SETTINGS_SCHEMA(X) \
+	X(cleanPressure,			uint32_t,	100,	600,	100) \
+	X(dirtyPressure,			uint32_t,	100,	1000,	800) /* ~3.2" of water or 8 hPa */ \
+	X(currentView,				uint16_t,	0,		0xFFFF,	kInfoViewTag) \
+	X(tsXMax,					uint16_t,	0,		4095,	0) \
+	X(tsXMin,					uint16_t,	0,		4095,	0) \
+	X(tsYMax,					uint16_t,	0,		4095,	0) \
+	X(tsYMin,					uint16_t,	0,		4095,	0) \
+	X(tsXSkew,					int16_t,	-0x7FFF,	0x7FFF,	0) /* See TouchCalibration */ \
+	X(tsYSkew,					int16_t,	-0x7FFF,	0x7FFF,	0) \
+	X(binThreshold,				uint8_t,	BinThreshold::kLowerLimit, \
+										BinThreshold::kUpperLimit, \
+										BinThreshold::kDefault) \
+	X(hourFormat,				uint8_t,	12,		24,		12) \
+	X(binMotorEnabled,			bool,		0,		1,		true) \
+	X(displayPressure,			bool,		0,		1,		true) \
+	X(pressureUnit_hPa,			bool,		0,		1,		false) \
+	X(temperatureUnitCelsius,	bool,		0,		1,		false)
 
 struct SDCSettings
 {
-	uint8_t		hourFormat;
-	bool		temperatureUnitCelsius;
-	bool		pressureUnit_hPa;
-	uint8_t		binThreshold;
-	bool		binMotorEnabled;
-	bool		displayPressure;
-	uint16_t	currentView;
-	uint16_t	tsMinMax[4];
-	uint32_t	cleanPressure;
-	uint32_t	dirtyPressure;
+#define DC_SETTINGS_MEMBER(key, type, min, max, def)	type key;
+	DC_SETTINGS_SCHEMA(DC_SETTINGS_MEMBER)
+#undef DC_SETTINGS_MEMBER
 };
 
 class DCSettings
 {
 public:
 							DCSettings(void);
-	bool					ReadFile(
+	enum EReadResult
+	{
+		eReadOK,
+		eOpenFailed,
+		eSyntaxError,	// Line without '=', or a key or value too long
+		eUnknownKey,
+		eDuplicateKey,
+		eInvalidValue	// Not a number/bool, or out of range
+	};
+							/*
+							*	Returns the first error found, the whole file
+							*	is parsed regardless.  ErrorLine() is the
+							*	line of the first error.  Keys missing from
+							*	the file (e.g. a file written before the key
+							*	was added) are given their default value.
+							*	ErrorLine() is 0 if the values are each in
+							*	range but not valid together.
+							*/
+	uint8_t					ReadFile(
 								const char*				inPath);
+	uint8_t					Read(
+								DataStream*				inStream);
 	bool					WriteFile(
 								const char*				inPath,
 								const SDCSettings&		inSettings);
+	bool					Write(
+								DataStream*				inStream,
+								const SDCSettings&		inSettings);
 	const SDCSettings&		Settings(void) const
 								{return(mSettings);}
+	uint16_t				ErrorLine(void) const
+								{return(mErrorLine);}
+	uint16_t				UnknownKeys(void) const
+								{return(mUnknownKeys);}
+	uint16_t				DuplicateKeys(void) const
+								{return(mDuplicateKeys);}
+	uint8_t					MissingKeys(void) const
+								{return(mMissingKeys);}
+
+	static void				SetDefaults(
+								SDCSettings&			outSettings);
+							/*
+							*	The rule shared by Validate and the filter
+							*	settings dialog: the dirty pressure has to be
+							*	above the clean pressure.
+							*/
+	static inline bool		PressuresAreValid(
+								uint32_t				inCleanPressure,
+								uint32_t				inDirtyPressure)
+								{return(inCleanPressure < inDirtyPressure);}
+							/*
+							*	Resets any value that's out of range to its
+							*	default.  Returns the number of values reset.
+							*/
+	static uint8_t			Validate(
+								SDCSettings&			ioSettings);
+							/*
+							*	Sets the value of a single key from a string
+							*	as it would appear in the settings file.
+							*	Returns eReadOK, eUnknownKey or eInvalidValue.
+							*	Only the range of the one value is checked.
+							*/
+	static uint8_t			SetValue(
+								SDCSettings&			ioSettings,
+								const char*				inKey,
+								const char*				inValue);
+							/*
+							*	outValue needs room for
+							*	KeyValueParser::eMaxValueLen + 1 chars.
+							*	Returns false if inKey is unknown.
+							*/
+	static bool				GetValue(
+								const SDCSettings&		inSettings,
+								const char*				inKey,
+								char*					outValue);
+	static uint8_t			NumKeys(void)
+								{return(eKeyCount);}
+	static const char*		Key(
+								uint8_t					inIndex)
+								{return(inIndex < eKeyCount ? kKeys[inIndex] : nullptr);}
 protected:
-	SdFile*		mFile;
+	enum EKeyIndexes
+	{
+#define DC_SETTINGS_INDEX(key, type, min, max, def)	e_##key,
+		DC_SETTINGS_SCHEMA(DC_SETTINGS_INDEX)
+#undef DC_SETTINGS_INDEX
+		eKeyCount,
+		eInvalidKeyIndex = eKeyCount
+	};
 	SDCSettings	mSettings;
-	
-	char					NextChar(void);
-	uint8_t					FindKeyIndex(
+	uint16_t	mErrorLine;
+	uint16_t	mUnknownKeys;
+	uint16_t	mDuplicateKeys;
+	uint8_t		mMissingKeys;
+	static const char* const	kKeys[eKeyCount];
+
+	static uint8_t			FindKeyIndex(
+								const char*				inKey,
+								uint32_t				inKeyHash);
+	static uint8_t			FindKeyIndex(
 								const char*				inKey);
-	char					SkipWhitespace(
-								char					inCurrChar);
-	char					SkipWhitespaceAndHashComments(
-								char					inCurrChar);
-	char					SkipToNextLine(void);
-	void					Int32ToString(
-								int32_t					inValue,
-								char*					outString);
-	char					ReadUInt32Number(
+	static bool				SetIndexedValue(
+								SDCSettings&			ioSettings,
+								uint8_t					inKeyIndex,
+								const char*				inValue);
+	static inline bool		InRange(
+								int64_t					inValue,
+								int64_t					inMin,
+								int64_t					inMax)
+								{return(inValue >= inMin && inValue <= inMax);}
+	static bool				ParseValue(
+								const char*				inString,
+								bool&					outValue);
+	static bool				ParseValue(
+								const char*				inString,
+								uint8_t&				outValue);
+	static bool				ParseValue(
+								const char*				inString,
+								uint16_t&				outValue);
+	static bool				ParseValue(
+								const char*				inString,
+								int16_t&				outValue);
+	static bool				ParseValue(
+								const char*				inString,
 								uint32_t&				outValue);
-	char					ReadStr(
-								char					inDelimiter,
-								uint8_t					inMaxStrLen,
-								char*					outStr);
-	void					WriteStr(
-								const char*				inStr);
-	void					WriteChar(
-								char					inChar);
+	static char*			FormatValue(
+								bool					inValue,
+								char*					outString);
+	static char*			FormatValue(
+								uint32_t				inValue,
+								char*					outString);
+	static char*			FormatValue(
+								int16_t					inValue,
+								char*					outString);
+	static char*			FormatValue(
+								uint16_t				inValue,
+								char*					outString)
+								{return(FormatValue((uint32_t)inValue, outString));}
+	static char*			FormatValue(
+								uint8_t					inValue,
+								char*					outString)
+								{return(FormatValue((uint32_t)inValue, outString));}
 };
 
 #endif /* DCSettings_h */
@@ -23,6 +23,7 @@
 #ifndef DCXViews_h
 #define DCXViews_h
 
+#include "DCSettings.h"	// kInfoViewTag, kFilterStatusGaugeTag
 #include "FilterStatusGauge.h"
 #include "ST77XXToXPT2046Alignment.h"
 #include "ValueFormatter.h"
@@ -32,6 +33,7 @@
 #include "XColoredView.h"
 #include "XDateValueField.h"
 #include "XDialogBox.h"
+#include "XLabelTable.h"
 #include "XMenuButton.h"
 #include "XMenuItem.h"
 #include "XNumberValueField.h"
@@ -87,11 +89,13 @@ static const char kLoadSettingsStr[] = "Load settings from SD card:";
 static const char kLoadStr[] = "Load";
 static const char kSaveToSDFailedStr[] = "Save to SD failed.";
 static const char kLoadFromSDFailedStr[] = "Load from SD failed.";
+static const char kSettingsKeyErrorStr[] =	"DCSettings.txt has an\n"
+											"unknown or duplicate key.";
 static const char kNoSDCardFoundStr[] = "No SD card found.";
 static const char kSavedDCSettingsStr[] = "Saved to file DCSettings.txt";
 static const char kLoadDCSettingsStr[] =	"Press OK to load file\n"
-											"DCSettings.txt.  The board\n"
-											"will restart if successful.";
+											"DCSettings.txt.";
+static const char kLoadedDCSettingsStr[] = "Loaded file DCSettings.txt";
 
 // About Box
 static const char kSoftwareNameStr[] = "Dust Collector Monitor";
@@ -145,7 +149,7 @@ static const uint16_t	kBinWrnThresLabelTag = 202;
 static const uint16_t	kBinWrnThresValueFieldTag = 203;
 static const uint16_t	kBinWrnThresStepperTag = 204;
 
-static const uint16_t	kInfoViewTag = 300;
+// kInfoViewTag (300) is declared in DCSettings.h
 static const uint16_t	kInfoDateValueFieldTag = 301;
 static const uint16_t	kStartsPerHourLabelTag = 302;
 static const uint16_t	kStartsPerHourValueFieldTag = 303;
@@ -171,7 +175,7 @@ static const uint16_t	kSetClockDialogTag = 400;
 static const uint16_t	kDateValueFieldTag = 401;
 static const uint16_t	kDateValueStepperTag = 402;
 
-static const uint16_t	kFilterStatusGaugeTag = 500;
+// kFilterStatusGaugeTag (500) is declared in DCSettings.h
 static const uint16_t	kFilterPresValueFieldTag = 501;
 
 static const uint16_t	kAlertDialogTag = 600;
@@ -250,10 +254,16 @@ XAnimatedFontIcon dcStatusIcon(480-32-2, 320-32-2, 32, 32,
 				kDCStatusIconTag, &mainMenuBtn, 'A', 'B', &DC_Icons::font);
 
 // Filter settings dialog
-XLabel		presUnitLabel(0, kLabelYAdj, 150, 26,
-				kPresUnitLabelTag, nullptr, kPresUnitStr,
-				&UI20ptFont, nullptr,
-				XFont::eBlack, kDialogBGColor, XFont::eAlignRight);
+static const XLabelSpec	kFilterSettingsLabels[] =
+{
+	{0, kLabelYAdj, 150, 26, kPresUnitLabelTag, kPresUnitStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignRight},
+	{0, kLabelYAdj + kRowHeight, 150, 26, kCleanPresLabelTag, kCleanPresStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignRight},
+	{0, kLabelYAdj + (kRowHeight*2), 150, 26, kDirtyPresLabelTag, kDirtyPresStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignRight}
+};
+XLabelTable	filterSettingsLabels(kFilterSettingsLabels);
 				
 static const uint16_t	kHPaMenuItem = 1;
 static const uint16_t	kInchesMenuItem = 2;
@@ -263,17 +273,13 @@ XMenu		presUnitMenu(kPresUnitMenuTag,
 				&UI20ptFont, &hPaMenuItem, nullptr, kDialogBGColor);
 
 XPopUpButton presUnitPopUp(150+kSpaceBetween, 0, 90, 0,
-				kPresUnitPopUpTag, &presUnitMenu, &presUnitLabel,
+				kPresUnitPopUpTag, &presUnitMenu, &filterSettingsLabels,
 				&UI20ptFont,
 				XPopUpButton::eLargePopUpSize,
 				XFont::eWhite, kDialogBGColor);
 				
-XLabel		cleanPresLabel(0, kLabelYAdj + kRowHeight, 150, 26,
-				kCleanPresLabelTag, &presUnitPopUp, kCleanPresStr,
-				&UI20ptFont, nullptr,
-				XFont::eBlack, kDialogBGColor, XFont::eAlignRight);
 XNumberValueField	cleanPresValueField(0,0,60+kSpaceBetween,
-				kCleanPresValueFieldTag, &cleanPresLabel,
+				kCleanPresValueFieldTag, &presUnitPopUp,
 				&UI20ptFont, 0, 110000, 0, 10, true, true,
 				&ValueFormatter::PressureToStringNoUnit,
 				XFont::eBlack, kDialogBGColor);
@@ -284,12 +290,8 @@ XPushButton setCleanPresBtn(253, kRowHeight, 80, 0,
 				&UI20ptFont,
 				XFont::eWhite, kDialogBGColor);
 
-XLabel		dirtyPresLabel(0, kLabelYAdj + (kRowHeight*2), 150, 26,
-				kDirtyPresLabelTag, &setCleanPresBtn, kDirtyPresStr,
-				&UI20ptFont, nullptr, XFont::eBlack,
-				kDialogBGColor, XFont::eAlignRight);
 XNumberValueField	dirtyPresValueField(0,0,60+kSpaceBetween,
-				kDirtyPresValueFieldTag, &dirtyPresLabel,
+				kDirtyPresValueFieldTag, &setCleanPresBtn,
 				&UI20ptFont, 0, 110000, 0, 10, true, true,
 				&ValueFormatter::PressureToStringNoUnit,
 				XFont::eBlack, kDialogBGColor);
@@ -319,12 +321,14 @@ XCheckboxButton disableMotorCheckbox(0, 0, 150, 0,
 				XCheckboxButton::eLargeCheckSize,
 				XFont::eBlack, kDialogBGColor);
 
-XLabel		binWrnThresLabel(0, kLabelYAdj + kRowHeight, 195, 26,
-				kBinWrnThresLabelTag, &disableMotorCheckbox, kBinWarnThresStr,
-				&UI20ptFont, nullptr,
-				XFont::eBlack, kDialogBGColor, XFont::eAlignRight);
+static const XLabelSpec	kBinSettingsLabels[] =
+{
+	{0, kLabelYAdj + kRowHeight, 195, 26, kBinWrnThresLabelTag, kBinWarnThresStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignRight}
+};
+XLabelTable	binSettingsLabels(kBinSettingsLabels, &disableMotorCheckbox);
 XNumberValueField	binWrnThresValueField(0,0,40+kSpaceBetween,
-				kBinWrnThresValueFieldTag, &binWrnThresLabel,
+				kBinWrnThresValueFieldTag, &binSettingsLabels,
 				&UI20ptFont, 0, 125, 5, 1, true, false,
 				nullptr,
 				XFont::eBlack, kDialogBGColor);
@@ -350,50 +354,46 @@ XDialogBox	setClockDialog(&dateValueStepper,
 				nullptr, kDialogBGColor);
 				
 // Utilities dialog
+static const XLabelSpec	kUtilitiesLabels[] =
+{
+	{0, kLabelYAdj, 232, 26, kDustBinMotorLabelTag, kDustBinMotorStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignRight},
+	{0, kLabelYAdj + kRowHeight, 232, 26, kSaveSettingsLabelTag, kSaveSettingsStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignRight},
+	{0, kLabelYAdj + (kRowHeight*2), 232, 26, kLoadSettingsLabelTag, kLoadSettingsStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignRight}
+};
+XLabelTable	utilitiesLabels(kUtilitiesLabels);
 XPushButton motorStartStopBtn(232+kSpaceBetween, 0, 80, 0,
-				kMotorStartStopBtnTag, nullptr, kStartStr,
+				kMotorStartStopBtnTag, &utilitiesLabels, kStartStr,
 				&UI20ptFont,
 				XFont::eWhite, kDialogBGColor);
-XLabel		dustBinMotorLabel(0, kLabelYAdj, 232, 26,
-				kDustBinMotorLabelTag, &motorStartStopBtn, kDustBinMotorStr,
-				&UI20ptFont, nullptr,
-				XFont::eBlack, kDialogBGColor, XFont::eAlignRight);
 XPushButton saveSettingsBtn(232+kSpaceBetween, kRowHeight, 80, 0,
-				kSaveSettingsBtnTag, &dustBinMotorLabel, kSaveStr,
+				kSaveSettingsBtnTag, &motorStartStopBtn, kSaveStr,
 				&UI20ptFont,
 				XFont::eWhite, kDialogBGColor);
-XLabel		saveSettingsLabel(0, kLabelYAdj + kRowHeight, 232, 26,
-				kSaveSettingsLabelTag, &saveSettingsBtn, kSaveSettingsStr,
-				&UI20ptFont, nullptr,
-				XFont::eBlack, kDialogBGColor, XFont::eAlignRight);
 XPushButton loadSettingsBtn(232+kSpaceBetween, kRowHeight*2, 80, 0,
-				kLoadSettingsBtnTag, &saveSettingsLabel, kLoadStr,
+				kLoadSettingsBtnTag, &saveSettingsBtn, kLoadStr,
 				&UI20ptFont,
 				XFont::eWhite, kDialogBGColor);
-XLabel		loadSettingsLabel(0, kLabelYAdj + (kRowHeight*2), 232, 26,
-				kLoadSettingsLabelTag, &loadSettingsBtn, kLoadSettingsStr,
-				&UI20ptFont, nullptr,
-				XFont::eBlack, kDialogBGColor, XFont::eAlignRight);
-XDialogBox	utilitiesDialog(&loadSettingsLabel,
+XDialogBox	utilitiesDialog(&loadSettingsBtn,
 				kUtilitiesDialogTag, &setClockDialog,
 				kCloseStr, nullptr, kUtilitiesStr,
 				&UI20ptFont,
 				nullptr, kDialogBGColor);
 
 // About box
-XLabel		softwareNameLabel(0, 0, 280, 26,
-				kSoftwareNameLabelTag, nullptr, kSoftwareNameStr,
-				&UI20ptFont, nullptr,
-				XFont::eBlack, kDialogBGColor, XFont::eAlignCenter);
-XLabel		versionLabel(0, kRowHeight, 280, 26,
-				kVersionLabelTag, &softwareNameLabel, kVersionStr,
-				&UI20ptFont, nullptr,
-				XFont::eBlack, kDialogBGColor, XFont::eAlignCenter);
-XLabel		copyrightLabel(0, kRowHeight*2, 280, 26,
-				kCopyrightLabelTag, &versionLabel, kCopyrightStr,
-				&UI20ptFont, nullptr,
-				XFont::eBlack, kDialogBGColor, XFont::eAlignCenter);
-XDialogBox	aboutBox(&copyrightLabel,
+static const XLabelSpec	kAboutLabels[] =
+{
+	{0, 0, 280, 26, kSoftwareNameLabelTag, kSoftwareNameStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignCenter},
+	{0, kRowHeight, 280, 26, kVersionLabelTag, kVersionStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignCenter},
+	{0, kRowHeight*2, 280, 26, kCopyrightLabelTag, kCopyrightStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignCenter}
+};
+XLabelTable	aboutLabels(kAboutLabels);
+XDialogBox	aboutBox(&aboutLabels,
 				kAboutBoxTag, &utilitiesDialog,
 				kCloseStr, nullptr, nullptr,
 				&UI20ptFont,
@@ -414,71 +414,62 @@ XDateValueField	infoDateValueField(136,3,0,
 				kInfoDateValueFieldTag, nullptr,
 				&UI20ptFont);
 				
-XLabel			startsPerHourLabel(0, kRowHeight, 170, 26,
-				kStartsPerHourLabelTag, &infoDateValueField, kStartsPerHourStr,
-				&UI20ptFont, nullptr,
-				XFont::eWhite, XFont::eBlack, XFont::eAlignRight);
+static const XLabelSpec	kInfoLabels[] =
+{
+	{0, kRowHeight, 170, 26, kStartsPerHourLabelTag, kStartsPerHourStr,
+		&UI20ptFont, XFont::eWhite, XFont::eBlack, XFont::eAlignRight},
+	{0, (kRowHeight*2), 170, 26, kTemperatureLabelTag, kTemperatureStr,
+		&UI20ptFont, XFont::eWhite, XFont::eBlack, XFont::eAlignRight},
+	{0, (kRowHeight*3), 170, 26, kDuctPresLabelTag, kDuctPresStr,
+		&UI20ptFont, XFont::eWhite, XFont::eBlack, XFont::eAlignRight},
+	{0, (kRowHeight*4), 170, 26, kAmbientPresLabelTag, kAmbientPresStr,
+		&UI20ptFont, XFont::eWhite, XFont::eBlack, XFont::eAlignRight},
+	{0, (kRowHeight*5), 170, 26, kBasePresLabelTag, kBasePresStr,
+		&UI20ptFont, XFont::eWhite, XFont::eBlack, XFont::eAlignRight},
+	{0, (kRowHeight*6), 170, 26, kStaticPresLabelTag, kStaticPresStr,
+		&UI20ptFont, XFont::eWhite, XFont::eBlack, XFont::eAlignRight},
+	{0, (kRowHeight*7), 170, 26, kBinMotorValueLabelTag, kBinMotorValueStr,
+		&UI20ptFont, XFont::eWhite, XFont::eBlack, XFont::eAlignRight}
+};
+XLabelTable		infoLabels(kInfoLabels, &infoDateValueField);
+				
 XNumberValueField startsPerHourValueField(170+kSpaceBetween, kRowHeight, 130,
-				kStartsPerHourValueFieldTag, &startsPerHourLabel,
+				kStartsPerHourValueFieldTag, &infoLabels,
 				&UI20ptFont, 1, 100, 0, 1, false, false,
 				nullptr,	// nullptr = use default Int32ToString
 				XFont::eWhite, XFont::eBlack, XFont::eAlignLeft);
 				
-XLabel		temperatureLabel(0, (kRowHeight*2), 170, 26,
-				kTemperatureLabelTag, &startsPerHourValueField, kTemperatureStr,
-				&UI20ptFont, nullptr,
-				XFont::eWhite, XFont::eBlack, XFont::eAlignRight);
 XNumberValueField temperatureValueField(170+kSpaceBetween, kRowHeight*2, 130,
-				kTemperatureValueFieldTag, &temperatureLabel,
+				kTemperatureValueFieldTag, &startsPerHourValueField,
 				&UI20ptFont, 0, 8500, -4000, 1, true, false,
 				&ValueFormatter::TemperatureToString,
 				XFont::eWhite, XFont::eBlack, XFont::eAlignLeft);
 				
-XLabel		ductPresLabel(0, (kRowHeight*3), 170, 26,
-				kDuctPresLabelTag, &temperatureValueField, kDuctPresStr,
-				&UI20ptFont, nullptr,
-				XFont::eWhite, XFont::eBlack, XFont::eAlignRight);
 XNumberValueField ductPresValueField(170+kSpaceBetween, kRowHeight*3, 130,
-				kDuctPresValueFieldTag, &ductPresLabel,
+				kDuctPresValueFieldTag, &temperatureValueField,
 				&UI20ptFont, 0, 110000, 0, 1, true, false,
 				&ValueFormatter::PressureToString,
 				XFont::eCyan, XFont::eBlack, XFont::eAlignLeft);
 
-XLabel		ambientPresLabel(0, (kRowHeight*4), 170, 26,
-				kAmbientPresLabelTag, &ductPresValueField, kAmbientPresStr,
-				&UI20ptFont, nullptr,
-				XFont::eWhite, XFont::eBlack, XFont::eAlignRight);
 XNumberValueField ambientPresValueField(170+kSpaceBetween, kRowHeight*4, 130,
-				kAmbientPresValueFieldTag, &ambientPresLabel,
+				kAmbientPresValueFieldTag, &ductPresValueField,
 				&UI20ptFont, 0, 110000, 0, 1, true, false,
 				&ValueFormatter::PressureToString,
 				XFont::eCyan, XFont::eBlack, XFont::eAlignLeft);
 
-XLabel		basePresLabel(0, (kRowHeight*5), 170, 26,
-				kBasePresLabelTag, &ambientPresValueField, kBasePresStr,
-				&UI20ptFont, nullptr,
-				XFont::eWhite, XFont::eBlack, XFont::eAlignRight);
 XNumberValueField basePresValueField(170+kSpaceBetween, kRowHeight*5, 130,
-				kBasePresValueFieldTag, &basePresLabel,
+				kBasePresValueFieldTag, &ambientPresValueField,
 				&UI20ptFont, 0, 100, -100, 1, true, false,
 				&ValueFormatter::PressureToString,
 				XFont::eWhite, XFont::eBlack, XFont::eAlignLeft);
 
-XLabel		staticPresLabel(0, (kRowHeight*6), 170, 26,
-				kStaticPresLabelTag, &basePresValueField, kStaticPresStr,
-				&UI20ptFont, nullptr,
-				XFont::eWhite, XFont::eBlack, XFont::eAlignRight);
 XNumberValueField staticPresValueField(170+kSpaceBetween, kRowHeight*6, 130,
-				kStaticPresValueFieldTag, &staticPresLabel,
+				kStaticPresValueFieldTag, &basePresValueField,
 				&UI20ptFont, 0, 110000, 0, 1, true, false,
 				&ValueFormatter::PressureToString,
 				XFont::eYellow, XFont::eBlack, XFont::eAlignLeft);
-XLabel		binMotorValueLabel(0, (kRowHeight*7), 170, 26,
-				kBinMotorValueLabelTag, &staticPresValueField, kBinMotorValueStr,
-				&UI20ptFont, nullptr,
-				XFont::eWhite, XFont::eBlack, XFont::eAlignRight);
 XNumberValueField binMotorValueField(170+kSpaceBetween, kRowHeight*7, 130,
-				kBinMotorValueFieldTag, &binMotorValueLabel,
+				kBinMotorValueFieldTag, &staticPresValueField,
 				&UI20ptFont, 1, 100, 0, 1, true, false,
 				nullptr,	// nullptr = use default Int32ToString
 				XFont::eWhite, XFont::eBlack, XFont::eAlignLeft);
@@ -43,12 +43,94 @@ XFont	xFont;
 #include "DC_Icons.h"
 #include "DCSettings.h"
 #include "DCXViews.h"
+#include "SerialUtils.h"
+#include "CRC16.h"
+#include "KeyValueParser.h"
+#include "MemoryStats.h"
+#include "Profiler.h"
 
 void ButtonISR(void);
 
-bool DustCollectorSTM32::sButtonPressed;
 static const char kDCSettingsPath[] = "DCSettings.txt";
 
+enum EShellCommand
+{
+	eGetCmd,
+	eSetCmd,
+	eStatusCmd,
+	eHistoryCmd,
+	eRedrawCmd,
+	eFaultCmd,
+	eBenchCmd,
+	eTimeCmd,
+	eTelemetryCmd,
+	eCaptureCmd,
+	eTouchCmd,
+	eTasksCmd,
+	eMemCmd,
+	eProfileCmd
+};
+
+static const SShellCommand kShellCommands[] =
+{
+	{"get",			"[key]  DCSettings value, all if no key", eGetCmd},
+	{"set",			"key value  DCSettings value, applied now", eSetCmd},
+	{"status",		"", eStatusCmd},
+	{"history",		"[tier]  0 raw, 1 minute, 2 ten minute, 3 four hour", eHistoryCmd},
+	{"redraw",		"  prints the deepest nesting drawn and overflows", eRedrawCmd},
+	{"fault",		"bin|filter|cancel  simulate or cancel a fault", eFaultCmd},
+	{"bench",		"", eBenchCmd},
+	{"time",		"[hex UnixTime]  get or set, also >hex", eTimeCmd},
+	{"telemetry",	"divisor  0 off, n every nth sensor update", eTelemetryCmd},
+	{"capture",		"x y width height  screen region as telemetry packets", eCaptureCmd},
+	{"touch",		"down x y|drag x y|up|x y  inject a pen event, x y alone taps", eTouchCmd},
+	{"tasks",		"[reset]  slices, misses, max late ms, overruns, max us", eTasksCmd},
+#if MEMORY_STATS_ENABLED
+	{"mem",			"[reset]  RAM by section, scratch arena, stack probes, bytes", eMemCmd},
+#endif
+#if PROFILER_ENABLED
+	{"profile",		"[reset|budget us]  loop and scope times, us", eProfileCmd}
+#endif
+};
+
+/*
+*	Tasks, highest priority first.  The sensing tasks preempt everything
+*	else.  The display tasks are last, a full redraw is a single slice so
+*	it waits for a gap between the sensing tasks.
+*/
+enum ETask
+{
+	ePressureTask,
+	eMotorTask,
+	eTouchTask,
+	eButtonsTask,
+	eSerialTask,
+	eStorageTask,
+	eGaugeTask,
+	eIconTask,
+	eRedrawTask,
+	eSleepTask
+};
+
+static const STask kTasks[] =
+{
+	// name		priority, latency ms, budget us
+	{"pressure",	0, 100, 20000},	// Two BMP280 forced reads
+	{"motor",		0, 20, 1000},
+	{"touch",		1, 20, 50000},	// Can open a dialog
+	{"buttons",		1, 20, 50000},
+	{"serial",		2, 20, 5000},	// Shell and telemetry
+	{"storage",		3, 50, 10000},	// Preferences, EEPROM and SD
+	{"gauge",		4, 30, 3000},	// Filter gauge or info view values
+	{"icon",		4, 100, 3000},
+	{"redraw",		5, 200, 250000},
+	{"sleep",		5, 1000, 150000}
+};
+
+// See the AT24C64 EEPROM map in Config.h
+static_assert(Config::kHistoryEEPROMAddr + PressureHistory::EEPROMSize() <= Config::kEventLogEEPROMAddr,
+	"The pressure history tiers overlap the event log");
+
 /***************************** DustCollectorSTM32 *****************************/
 DustCollectorSTM32::DustCollectorSTM32(void)
   : DustCollectorBase(Config::kBMP1CSPin, Config::kBMP0CSPin,
@@ -56,10 +138,19 @@ DustCollectorSTM32::DustCollectorSTM32(void)
 	mDisplay(Config::kDispDCPin, Config::kDispResetPin,
 						Config::kDispCSPin, Config::kBacklightPin),
 	mPreferences(Config::kAT24CDeviceAddr, Config::kAT24CDeviceCapacity),
+	mPrefs(&mPreferences),
+	mHistory(&mPreferences, Config::kHistoryEEPROMAddr),
+	mEventLogStream(&mPreferences, (const void*)Config::kEventLogEEPROMAddr, Config::kEventLogSize),
+	mEventLog(&mEventLogStream),
+	mSDLogger(Config::kSDSelectPin, Config::kSDDetectPin),
+	mShell(kShellCommands, sizeof(kShellCommands)/sizeof(SShellCommand), this, &mTelemetry),
+	mCaptureOverruns(0),
+	mScheduler(kTasks, sizeof(kTasks)/sizeof(STask), this),
     mTouchScreen(Config::kTouchCSPin, Config::kTouchIRQPin,
 			Config::kDisplayHeight, Config::kDisplayWidth,
 			0, 0, 0, 0, Config::kInvertTouchX),
-	mDebouncePeriod(DEBOUNCE_DELAY),
+	mLoopStart(0), mLoopSum(0), mLoopMax(0), mLoopCount(0),
+	mDebouncePeriod(DEBOUNCE_DELAY), mButtonPins(0),
 	mStartsPerHourHead(0), mStartsPerHourTail(0)
 {
 }
@@ -89,55 +180,19 @@ void DustCollectorSTM32::begin(void)
 	pinMode(Config::kSDSelectPin, OUTPUT);
 	digitalWrite(Config::kSDSelectPin, HIGH);	// Deselect the SD card.
 	
+	mEventLog.Mount();
+
 	/*
 	*	Load the preferences...
 	*/
-	Config::SDCPreferences	prefs;
-	bool	prefsRead = mPreferences.Read(0, sizeof(Config::SDCPreferences), &prefs.unused[0]);
-	if (prefsRead)
-	{
-		UnixTime::SetFormat24Hour(prefs.clockFormat == 0);
-		ValueFormatter::sTemperatureUnit = (ValueFormatter::ETemperatureUnit)prefs.tempUnit;
-		ValueFormatter::sPressureUnit = (ValueFormatter::EPressureUnit)prefs.presUnit;
-		filterPresValueField.SetVisible(prefs.displayPressure);
-		mMotorEnabled = prefs.binMotorEnabled;
-		binMotorValueField.OverrideValueString(mMotorEnabled ? kStoppedStr : kDisabledStr, false);
-
-		/*
-		*	Initialize the touchscreen alignment values
-		*/
-		mTouchScreen.SetMinMax(prefs.tsMinMax);
-
-		mCleanPressure = prefs.cleanPressure;
-		if (mCleanPressure < 100 ||
-			mCleanPressure > 600)
-		{
-			mCleanPressure = 100;
-		}
-		
-		mDirtyPressure = prefs.dirtyPressure;
-		if (mDirtyPressure < mCleanPressure ||
-			mDirtyPressure > 1000)
-		{
-			mDirtyPressure = 800;	// Default to ~3.2" of water or 8 hPa
-		}
-		
-		/*
-		*	Sanity check the threshold value.
-		*	This value will be out of range when the EEPROM is erased and/or never
-		*	been accessed.
-		*/
-		mTriggerThreshold = prefs.binThreshold;
-		if (mTriggerThreshold > kThresholdUpperLimit ||
-			mTriggerThreshold < kThresholdLowerLimit)
-		{
-			mTriggerThreshold = kDefaultTriggerThreshold;
-		}
-	}
+	mPrefs.Load();
+	ApplySettings(false);
 	
-	filterStatusGauge.SetMinMax(mCleanPressure, mDirtyPressure);
 	mTouchScreen.begin(Config::kDisplayRotation);
 	mDisplay.begin(Config::kDisplayRotation);	// Init TFT
+#ifdef DISPLAY_STATIC_DRIVER
+	StaticDisplay::Select(&mDisplay);	// Draw to mDisplay without the vtable
+#endif
 	
 	filterSettingsDialog.SetValidatorDelegate(this);
 	filterPresValueField.SetHeight(20);	// Has no stepper to assign the height.
@@ -149,13 +204,76 @@ void DustCollectorSTM32::begin(void)
 	warningDialog.SetMinDialogSize();
 	xFont.SetDisplay(&mDisplay, &UI20ptFont);	// To initialize mDisplay of xFont
 	
-	if (prefs.showInfoViewOnStartup)
+	if (mPrefs.Get().currentView == kInfoViewTag)
 	{
 		ShowInfoView(false);
 	} else
 	{
 		ShowFilterStatusGauge(false);
 	}
+#if PROFILER_ENABLED
+	/*
+	*	A loop longer than the pressure update period delays a sample by at
+	*	least a whole period.
+	*/
+	Profiler::begin();
+	Profiler::SetBudget(mPressureUpdatePeriodMS * 1000);
+#endif
+	mScheduler.begin();
+}
+
+/******************************** ApplySettings *******************************/
+/*
+*	Applies the preferences to the runtime state.  The values are known to be
+*	valid, either by the crc or because they were range checked (migrated
+*	preferences or a settings file.)  When live (not called from begin),
+*	the displayed values and the current view are updated as well.
+*/
+void DustCollectorSTM32::ApplySettings(
+	bool	inLive)
+{
+	const SDCSettings&	settings = mPrefs.Get();
+	UnixTime::SetFormat24Hour(settings.hourFormat == 24);
+	ValueFormatter::sTemperatureUnit = settings.temperatureUnitCelsius ?
+		ValueFormatter::eCelsius : ValueFormatter::eFahrenheit;
+	ValueFormatter::sPressureUnit = settings.pressureUnit_hPa ?
+		ValueFormatter::eHectopascal : ValueFormatter::eInchesOfWater;
+	mMotorEnabled = settings.binMotorEnabled;
+	binMotorValueField.OverrideValueString(mMotorEnabled ? kStoppedStr : kDisabledStr, false);
+
+	/*
+	*	Initialize the touchscreen alignment values
+	*/
+	uint16_t	minMax[4] = {settings.tsXMin, settings.tsXMax,
+							settings.tsYMin, settings.tsYMax};
+	mTouchScreen.SetMinMax(minMax, settings.tsXSkew, settings.tsYSkew);
+
+	mCleanPressure = settings.cleanPressure;
+	mDirtyPressure = settings.dirtyPressure;
+	mTriggerThreshold = settings.binThreshold;
+	filterStatusGauge.SetMinMax(mCleanPressure, mDirtyPressure);
+	filterPresValueField.SetVisible(settings.displayPressure);
+	if (inLive)
+	{
+		if (!mMotorEnabled)
+		{
+			binMotorValueField.SetValue(0, false);
+			StopDustBinMotor();
+		} else if (mDCIsRunning)
+		{
+			StartDustBinMotor();
+		}
+		UpdateInfoPressureValues();
+		temperatureValueField.ValueChanged(false);
+		if (DeltaAveragesLoaded())
+		{
+			filterPresValueField.ValueChanged(false);
+		}
+		bool	showInfoView = settings.currentView == kInfoViewTag;
+		infoView.SetVisible(showInfoView);
+		filterStatusGauge.SetVisible(!showInfoView);
+		rootView.Draw(0, 0, 480, 320);
+	}
 }
 
 /************************ InitializeMotorThresholdVars ************************/
@@ -173,7 +291,7 @@ int32_t DustCollectorSTM32::CurrentDirtyPressure(void)
 /**************************** SaveTriggerThreshold ****************************/
 void DustCollectorSTM32::SaveTriggerThreshold(void)
 {
-	mPreferences.Write(offsetof(Config::SDCPreferences, binThreshold), 1, &mTriggerThreshold);
+	mPrefs.Edit().binThreshold = mTriggerThreshold;
 }
 
 /*************************** NoModalDialogDisplayed ***************************/
@@ -184,108 +302,702 @@ bool DustCollectorSTM32::NoModalDialogDisplayed(void) const
 
 /*********************************** Update ***********************************/
 /*
-*	Called from loop()
+*	Called from loop().  Each pass runs one task slice (see RunTask) or idles
+*	until the next interrupt.
 */
 bool DustCollectorSTM32::Update(void)
 {
-	if (mTouchScreen.PenStateChanged())
+	PROFILE_LOOP();
+	{
+		uint32_t	now = ClockSource::Micros();
+		uint32_t	loopPeriod = now - mLoopStart;
+		mLoopStart = now;
+		mLoopSum += loopPeriod;
+		if (loopPeriod > mLoopMax)
+		{
+			mLoopMax = loopPeriod;
+		}
+		mLoopCount++;
+	}
+	DispatchISREvents();
+	mScheduler.Update();	// One task slice, or idle
+	return(false);
+}
+
+/****************************** DispatchISREvents *****************************/
+/*
+*	Drains the events queued by the interrupt handlers, waking the tasks that
+*	handle them.  Nothing polls the touch screen, the buttons or the time.
+*/
+void DustCollectorSTM32::DispatchISREvents(void)
+{
+	SISREvent	event;
+	while (ISREvents::Pop(event))
 	{
-		if (mTouchScreen.PenIsDown())
+		switch (event.type)
 		{
+			case ISREvents::ePenDown:
+			case ISREvents::ePenUp:
+				mTouchScreen.PenEdge(event);
+				// The XPT2046 debounce is 1ms, +1 for the partial tick.
+				mScheduler.Wake(eTouchTask, 2);
+				break;
+			case ISREvents::eButtonEdge:
+				/*
+				*	Each edge restarts the debounce period.  The buttons
+				*	are acted on once they've been stable for the period.
+				*/
+				mButtonPins = event.data;
+				mDebouncePeriod.Start();
+				mScheduler.Wake(eButtonsTask, DEBOUNCE_DELAY);
+				break;
+			case ISREvents::eSecondTick:
+				if (!mDisplaySleeping)
+				{
+					mScheduler.Wake(eGaugeTask);	// The info view's time
+				}
+				mScheduler.Wake(eSleepTask);
+				break;
+		}
+	}
+}
+
+/*********************************** RunTask **********************************/
+/*
+*	Returns the ms until inTask is due again (see SchedulerDelegate.)
+*/
+uint32_t DustCollectorSTM32::RunTask(
+	uint8_t	inTask)
+{
+	uint32_t	delay = Scheduler::eSuspend;
+	switch (inTask)
+	{
+		case ePressureTask:
+			CheckFilter();
+			if (mDisplaySleeping &&
+				mDCIsRunning)
+			{
+				mScheduler.Wake(eSleepTask);
+			}
+			delay = mPressureUpdatePeriod.Remaining();
+			break;
+		case eMotorTask:
+			if (mMotorEnabled)
+			{
+				CheckDustBinMotor();
+			}
+			// StartDustBinMotor delays sensing by 2s, polling catches it.
+			delay = mMotorRunning ? mMotorSensePeriod.Remaining() : 100;
+			break;
+		case eTouchTask:
+			if (mTouchScreen.PenStateChanged() &&
+				!mTouchScreen.PenIsDown())
+			{
+				PenUp();
+			}
+			/*
+			*	Woken by the pen edges (see DispatchISREvents.)  While the
+			*	pen is down the touch screen is sampled every eSamplePeriod.
+			*	The first sample that passes the Z gate is the PenDown, the
+			*	rest are drags.  A touch too light to pass is ignored.
+			*/
+			if (mTouchScreen.EdgePending())
+			{
+				delay = 1;
+			} else if (mTouchScreen.PenIsDown())
+			{
+				uint16_t	x, y;
+				bool	tracking = mTouchScreen.IsTracking();
+				if (mTouchScreen.Sample(x, y))
+				{
+					if (tracking)
+					{
+						PenDragged(x, y);
+					} else
+					{
+						PenDown(x, y);
+					}
+				}
+				delay = XPT2046::eSamplePeriod;
+			}
+			break;
+		case eButtonsTask:
+			CheckButtons();	// Buttons are currently only used to setup the screen.
+			if (mButtonPins)
+			{
+				delay = mDebouncePeriod.Remaining();
+			}
+			break;
+		case eSerialTask:
+			mShell.Update();		// Serial commands
+			mTelemetry.Update();	// Sends what the UART has room for
+			delay = 5;
+			break;
+		case eStorageTask:
+			mPrefs.Update();		// Commits preference changes once idle
+			mPreferences.Update();	// Advances queued EEPROM writes
+			mSDLogger.Update();		// Writes at most one sector
+			delay = 5;
+			break;
+		/*
+		*	The display tasks suspend while the display is sleeping.  They're
+		*	woken by the redraw that follows WakeUp.
+		*/
+		case eGaugeTask:
 			if (!mDisplaySleeping)
 			{
-			//	Serial.println('D');
-				UnixTime::ResetSleepTime();
-				uint16_t	z;
-				mTouchScreen.Read(mX, mY, z);
-				mHitView = rootView.HitTest(mX, mY);
-				if (mHitView)
+				/*
+				*	If there are no modal dialogs visible THEN
+				*	update either the filter status gauge or the info view.
+				*/
+				delay = 100;
+				if (NoModalDialogDisplayed() &&
+					!mainMenu.IsVisible())
 				{
-					mHitView->MouseDown(mX,mY);
+					int32_t	adjustedDeltaAverage = DeltaAveragesLoaded() ? AdjustedDeltaAverage() : 0;
+					filterStatusGauge.SetValue(abs(adjustedDeltaAverage));
+					if (filterStatusGauge.IsVisible())
+					{
+						filterStatusGauge.Update();
+						if (DeltaAveragesLoaded())
+						{
+							filterPresValueField.SetValue(adjustedDeltaAverage);
+						}
+						delay = filterStatusGauge.TimeToNextStep();
+					} else
+					{
+						UpdateInfoView();
+					}
 				}
-			} else
+				UpdateInfoViewBinMotor();
+			}
+			break;
+		case eIconTask:
+			if (!mDisplaySleeping)
 			{
-				WakeUp();
+				dcStatusIcon.Update();
+				delay = dcStatusIcon.TimeToNextFrame();
+				if (!delay)
+				{
+					delay = Scheduler::eSuspend;	// Woken when started
+				}
 			}
-			
-		} else	// Else, pen is up
-		{
-		//	Serial.println('U');
-			if (mHitView)
+			break;
+		case eRedrawTask:
+			if (!mDisplaySleeping)
 			{
-				mHitView->MouseUp(mX, mY);
-				mHitView = nullptr;
+				rootView.Draw(0, 0, 999, 999);
+				mScheduler.Wake(eGaugeTask);
+				mScheduler.Wake(eIconTask);
 			}
-		}
+			break;
+		case eSleepTask:
+			if (!mDisplaySleeping)
+			{
+				if (UnixTime::TimeToSleep())
+				{
+					if (NoModalDialogDisplayed() &&
+						!mDCIsRunning)
+					{
+						GoToSleep();
+					} else
+					{
+						UnixTime::ResetSleepTime();
+					}
+				}
+			} else if (mDCIsRunning)
+			{
+				WakeUp();
+			}
+			// Woken by each RTC second (see DispatchISREvents.)
+			break;
 	}
+	return(delay);
+}
 
-	DustCollectorBase::Update();
-	CheckButtons();	// Buttons are currently only used to setup the screen.
-	
-	/*
-	*	If the display isn't sleeping...
-	*/
+/*********************************** PenDown **********************************/
+/*
+*	Pen events from the touch screen and from the serial shell (touch.)
+*/
+void DustCollectorSTM32::PenDown(
+	uint16_t	inX,
+	uint16_t	inY)
+{
+	PROFILE_SCOPE(PenDown);
 	if (!mDisplaySleeping)
 	{
-		bool	noModalDialogDisplayed = NoModalDialogDisplayed();
-		/*
-		*	If there are no modal dialogs visible THEN
-		*	update either the filter status gauge or the info view.
-		*/
-		if (noModalDialogDisplayed &&
-			!mainMenu.IsVisible())
+		UnixTime::ResetSleepTime();
+		mX = inX;
+		mY = inY;
+		mHitView = rootView.HitTest(mX, mY);
+		if (mHitView)
 		{
-			int32_t	adjustedDeltaAverage = DeltaAveragesLoaded() ? AdjustedDeltaAverage() : 0;
-			filterStatusGauge.SetValue(abs(adjustedDeltaAverage));
-			if (filterStatusGauge.IsVisible())
+			mHitView->MouseDown(mX,mY);
+		}
+	} else
+	{
+		WakeUp();
+	}
+}
+
+/********************************* PenDragged *********************************/
+void DustCollectorSTM32::PenDragged(
+	uint16_t	inX,
+	uint16_t	inY)
+{
+	if (mHitView)
+	{
+		mX = inX;
+		mY = inY;
+		mHitView->MouseDragged(mX, mY);
+	}
+}
+
+/************************************ PenUp ***********************************/
+void DustCollectorSTM32::PenUp(void)
+{
+	PROFILE_SCOPE(PenUp);
+	if (mHitView)
+	{
+		mHitView->MouseUp(mX, mY);
+		mHitView = nullptr;
+	}
+}
+
+/******************************** ShellCommand ********************************/
+bool DustCollectorSTM32::ShellCommand(
+	uint8_t			inID,
+	uint16_t		inLine,
+	SerialShell*	inShell)
+{
+	bool	more = false;
+	switch (inID)
+	{
+		case eGetCmd:
+		{
+			char	value[KeyValueParser::eMaxValueLen+1];
+			const char*	key = inShell->ArgCount() > 1 ? inShell->Arg(1) : DCSettings::Key(inLine);
+			if (DCSettings::GetValue(mPrefs.Get(), key, value))
+			{
+				inShell->Print(key).Print(" = ").Print(value).EndLine();
+			} else
+			{
+				inShell->Print("? unknown key ").Print(key).EndLine();
+			}
+			more = inShell->ArgCount() == 1 && inLine + 1 < DCSettings::NumKeys();
+			break;
+		}
+		case eSetCmd:
+		{
+			SDCSettings	settings = mPrefs.Get();
+			uint8_t	result = inShell->ArgCount() == 3 ?
+				DCSettings::SetValue(settings, inShell->Arg(1), inShell->Arg(2)) :
+				DCSettings::eSyntaxError;
+			if (result == DCSettings::eReadOK &&
+				DCSettings::Validate(settings) != 0)
 			{
-				filterStatusGauge.Update();
-				if (DeltaAveragesLoaded())
+				result = DCSettings::eInvalidValue;	// e.g. clean >= dirty
+			}
+			switch (result)
+			{
+				case DCSettings::eReadOK:
+					mPrefs.Edit() = settings;
+					ApplySettings(true);
+					inShell->PrintLine("ok");
+					break;
+				case DCSettings::eUnknownKey:
+					inShell->PrintLine("? unknown key");
+					break;
+				case DCSettings::eInvalidValue:
+					inShell->PrintLine("? invalid value");
+					break;
+				default:
+					inShell->PrintLine("? usage: set key value");
+					break;
+			}
+			break;
+		}
+		case eStatusCmd:
+			switch (inLine)
+			{
+				case 0:
+					inShell->Print("status ").PrintUInt(mStatus).
+						Print(" running ").PrintUInt(mDCIsRunning).
+						Print(" motor ").PrintUInt(mMotorRunning).
+						Print(" deltasLoaded ").PrintUInt(mDeltaAveragesLoaded).EndLine();
+					break;
+				case 1:
+					inShell->Print("duct ").PrintUInt(mDuctPressure).
+						Print(" ambient ").PrintUInt(mAmbientPressure).
+						Print(" temperature ").Print(mAmbientTemperature).EndLine();
+					break;
+				case 2:
+					inShell->Print("deltaAverage ").Print(DeltaAverage()).
+						Print(" baseline ").Print(DeltaAveragesLoaded() ? Baseline() : 0).
+						Print(" clean ").Print(mCleanPressure).
+						Print(" dirty ").Print(mDirtyPressure).EndLine();
+					break;
+				case 3:
+					inShell->Print("binMotor ").PrintUInt(mBinMotorAverage).
+						Print(" threshold ").PrintUInt(mTriggerThreshold).
+						Print(" enabled ").PrintUInt(mMotorEnabled).EndLine();
+					break;
+				case 4:
+					inShell->Print("sdLogging ").PrintUInt(mSDLogger.IsLogging()).
+						Print(" droppedSamples ").PrintUInt(mSDLogger.DroppedSamples()).
+						Print(" droppedFrames ").PrintUInt(mTelemetry.DroppedFrames()).EndLine();
+					break;
+			}
+			more = inLine < 4;
+			break;
+		case eHistoryCmd:
+		{
+			uint32_t	tier = PressureHistory::eRawTier;
+			if (inShell->ArgCount() > 1 &&
+				(!inShell->ArgUInt32(1, tier) || tier >= PressureHistory::eNumTiers))
+			{
+				inShell->PrintLine("? invalid tier");
+				break;
+			}
+			/*
+			*	Oldest first.  Missing entries (the unit was off) output nothing.
+			*	The static pressures are "-" when there are none (the delta
+			*	averages were loading.)
+			*/
+			uint16_t	numEntries = PressureHistory::NumEntries((PressureHistory::ETier)tier);
+			PressureHistory::SValues	values;
+			if (mHistory.GetEntry((PressureHistory::ETier)tier, numEntries - 1 - inLine, values))
+			{
+				inShell->PrintUInt(values.time);
+				if (values.staticMean == PressureHistory::eNoStaticPressure)
+				{
+					inShell->Print(" - - -");
+				} else
 				{
-					filterPresValueField.SetValue(adjustedDeltaAverage);
+					inShell->Print(" ").Print(values.staticMin).
+						Print(" ").Print(values.staticMean).
+						Print(" ").Print(values.staticMax);
 				}
+				inShell->Print(" ").PrintUInt(values.ambientMean).
+					Print(" ").Print(values.tempMean).EndLine();
+			}
+			more = inLine + 1 < numEntries;
+			break;
+		}
+		case eRedrawCmd:
+			rootView.Draw(0, 0, 480, 320);
+			inShell->Print("ok depth ").PrintUInt(XView::MaxDrawDepth()).
+				Print("/").PrintUInt(XView::eMaxDepth).
+				Print(" overflows ").PrintUInt(XView::DepthOverflows()).EndLine();
+			break;
+		case eFaultCmd:
+			if (strcmp(inShell->Arg(1), "bin") == 0)
+			{
+				DustBinFull();
+			} else if (strcmp(inShell->Arg(1), "filter") == 0)
+			{
+				FilterFull();
+			} else if (strcmp(inShell->Arg(1), "cancel") == 0)
+			{
+				CancelFault();
 			} else
 			{
-				UpdateInfoView();
+				inShell->PrintLine("? usage: fault bin|filter|cancel");
+				break;
+			}
+			inShell->PrintLine("ok");
+			break;
+		case eBenchCmd:
+		{
+			/*
+			*	Each line times one operation.  These block, which is the
+			*	point of running them from the shell rather than the UI.
+			*/
+			uint32_t	start = ClockSource::Micros();
+			switch (inLine)
+			{
+				case 0:
+					rootView.Draw(0, 0, 480, 320);
+					inShell->Print("redraw ");
+					break;
+				case 1:
+				{
+					uint8_t	buffer[256];
+					memset(buffer, 0x55, sizeof(buffer));
+					uint16_t	crc = CRC16::kInitialValue;
+					for (uint8_t i = 0; i < 4; i++)
+					{
+						crc = CRC16::Calc(buffer, sizeof(buffer), crc);
+					}
+					inShell->Print("crc16 1KB ").PrintHex(crc).Print(" ");
+					break;
+				}
+				case 2:
+				{
+					Telemetry::SSample	sample = {0};
+					uint8_t	payload[Telemetry::eSampleSize];
+					uint8_t	frame[Telemetry::eMaxFrame];
+					for (uint8_t i = 0; i < 100; i++)
+					{
+						sample.millis = i;
+						Telemetry::EncodeFrame(Telemetry::eSamplePacket, i, payload,
+							Telemetry::PackSample(sample, payload), frame);
+					}
+					inShell->Print("telemetry frame x100 ");
+					break;
+				}
 			}
+			inShell->PrintUInt(ClockSource::Micros() - start).Print(" us").EndLine();
+			more = inLine < 2;
+			break;
 		}
-		dcStatusIcon.Update();
-		UpdateInfoViewBinMotor();
-		
-		if (UnixTime::TimeToSleep())
+		case eTimeCmd:
+			if (inShell->ArgCount() > 1)
+			{
+				uint32_t	unixTime;
+				if (SerialUtils::HexStrToUInt32(inShell->Arg(1), unixTime) &&
+					unixTime)
+				{
+					UnixTime::SetTime(unixTime);
+					STM32UnixRTC::SyncRTCToTime();
+					UnixTime::ResetSleepTime();
+					inShell->PrintLine("ok");
+				} else
+				{
+					inShell->PrintLine("? invalid hex time");
+				}
+			} else
+			{
+				inShell->PrintHex(UnixTime::Time()).EndLine();
+			}
+			break;
+		case eTelemetryCmd:
 		{
-			if (noModalDialogDisplayed &&
-				!mDCIsRunning)
+			uint32_t	divisor;
+			if (inShell->ArgUInt32(1, divisor) &&
+				divisor <= 255)
 			{
-				GoToSleep();
+				mTelemetry.SetDivisor((uint8_t)divisor, (uint16_t)mPressureUpdatePeriodMS);
 			} else
 			{
-				UnixTime::ResetSleepTime();
+				inShell->PrintLine("? usage: telemetry divisor");
 			}
+			break;
 		}
-	} else if (mDCIsRunning)
-	{
-		WakeUp();
-	}
-
-#if 1
-	/*
-	*	Serial commands
-	*/
-	if (Serial.available())
-	{
-		switch (Serial.read())
+		case eCaptureCmd:
 		{
-			case '>':	// Set the time.  A hexadecimal ASCII UNIX time follows
-						// Use >65920071 for all-fields-change test (15s delay)
-				UnixTime::SetUnixTimeFromSerial();
-				STM32UnixRTC::SyncRTCToTime();
+			/*
+			*	Queues packets as room becomes available, one band of rows
+			*	rendered per call.  "ok" follows the last packet.  It's
+			*	printed by the call after the last row, when the shell has
+			*	made sure there's room for it.  It reports the longest band
+			*	and the serial task overruns during the capture.
+			*/
+			if (inLine == 0)
+			{
+				uint32_t	rect[4];
+				bool	valid = true;
+				for (uint8_t i = 0; i < 4 && valid; i++)
+				{
+					valid = inShell->ArgUInt32(i + 1, rect[i]) && rect[i] <= 0xFFFF;
+				}
+				if (!valid ||
+					!mCapture.Begin(&rootView, &xFont, rect[0], rect[1], rect[2], rect[3]))
+				{
+					inShell->PrintLine("? usage: capture x y width height");
+					break;
+				}
+				mCaptureOverruns = mScheduler.Overruns(eSerialTask);
+			}
+			if (mCapture.Capturing())
+			{
+				mCapture.Update(&mTelemetry);
+				more = true;
+			} else
+			{
+				inShell->Print("ok ").PrintUInt(mCapture.Runs()).Print(" runs ").
+					PrintUInt(mCapture.RenderTime()).Print(" us max ").
+					PrintUInt(mCapture.MaxRenderTime()).Print(" over ").
+					PrintUInt((uint16_t)(mScheduler.Overruns(eSerialTask) - mCaptureOverruns)).
+					EndLine();
+			}
+			break;
+		}
+		case eTouchCmd:
+		{
+			/*
+			*	The time reported is how long the view hierarchy took to
+			*	handle the event, including any drawing it did.
+			*/
+			uint32_t	start = ClockSource::Micros();
+			uint32_t	x, y;
+			bool		drag = strcmp(inShell->Arg(1), "drag") == 0;
+			uint8_t		xArg = drag || strcmp(inShell->Arg(1), "down") == 0 ? 2 : 1;
+			if (strcmp(inShell->Arg(1), "up") == 0)
+			{
+				PenUp();
+			} else if (inShell->ArgUInt32(xArg, x) &&
+				inShell->ArgUInt32(xArg + 1, y) &&
+				x < Config::kDisplayHeight &&
+				y < Config::kDisplayWidth)
+			{
+				if (drag)
+				{
+					PenDragged(x, y);
+				} else
+				{
+					PenDown(x, y);
+					if (xArg == 1)
+					{
+						PenUp();	// Tap
+					}
+				}
+			} else
+			{
+				inShell->PrintLine("? usage: touch down x y|drag x y|up|x y");
 				break;
+			}
+			inShell->Print("ok ").PrintUInt(ClockSource::Micros() - start).Print(" us").EndLine();
+			break;
+		}
+		case eTasksCmd:
+			/*
+			*	Line 0 is the number of idle passes and the ISR event queue's
+			*	high water mark and overflows, then one line per task.
+			*/
+			if (inLine == 0)
+			{
+				if (strcmp(inShell->Arg(1), "reset") == 0)
+				{
+					mScheduler.ResetStats();
+					inShell->PrintLine("ok");
+					break;
+				}
+				inShell->Print("idle ").PrintUInt(mScheduler.IdleCount()).
+					Print(" events max ").PrintUInt(ISREvents::HighWater()).
+					Print(" lost ").PrintUInt(ISREvents::Overflows()).EndLine();
+				more = mScheduler.NumTasks() != 0;
+			} else
+			{
+				uint8_t	task = inLine - 1;
+				inShell->Print(mScheduler.Task(task).name).
+					Print(" n ").PrintUInt(mScheduler.Slices(task)).
+					Print(" miss ").PrintUInt(mScheduler.Misses(task)).
+					Print(" late ").PrintUInt(mScheduler.MaxLate(task)).
+					Print(" over ").PrintUInt(mScheduler.Overruns(task)).
+					Print(" max ").PrintUInt(mScheduler.MaxTime(task)).EndLine();
+				more = inLine < mScheduler.NumTasks();
+			}
+			break;
+#if MEMORY_STATS_ENABLED
+		case eMemCmd:
+			/*
+			*	Line 0 is RAM by section.  "stack" is the high-water mark
+			*	since the stack was painted, "free" is the RAM between the
+			*	heap and the stack that has never been used.  Line 1 is the
+			*	display's scratch arena, the peak allocated and the number of
+			*	allocations that didn't fit.  Then one line per stack probe,
+			*	the deepest the stack has been there.
+			*/
+			if (inLine == 0)
+			{
+				if (strcmp(inShell->Arg(1), "reset") == 0)
+				{
+					MemoryStats::PaintStack();
+					DisplayController::Scratch().ResetStats();
+					inShell->PrintLine("ok");
+					break;
+				}
+				inShell->Print("ram ").PrintUInt(MemoryStats::RAMSize()).
+					Print(" data ").PrintUInt(MemoryStats::DataSize()).
+					Print(" bss ").PrintUInt(MemoryStats::BssSize()).
+					Print(" heap ").PrintUInt(MemoryStats::HeapSize()).
+					Print(" stack ").PrintUInt(MemoryStats::StackUsed()).
+					Print(" free ").PrintUInt(MemoryStats::StackFree()).EndLine();
+				more = true;
+			} else if (inLine == 1)
+			{
+				ScratchArena&	scratch = DisplayController::Scratch();
+				inShell->Print("scratch ").PrintUInt(scratch.Used()).
+					Print("/").PrintUInt(scratch.Peak()).
+					Print("/").PrintUInt(scratch.Capacity()).
+					Print(" failures ").PrintUInt(scratch.Failures()).EndLine();
+				more = StackProbe::First() != nullptr;
+			} else
+			{
+				StackProbe*	probe = StackProbe::First();
+				for (uint16_t i = 2; i < inLine && probe; i++)
+				{
+					probe = probe->Next();
+				}
+				if (probe)
+				{
+					inShell->Print(probe->Name()).
+						Print(" depth ").PrintUInt(probe->MaxDepth()).EndLine();
+					more = probe->Next() != nullptr;
+				}
+			}
+			break;
+#endif
+#if PROFILER_ENABLED
+		case eProfileCmd:
+		{
+			/*
+			*	Line 0 is the loop, then one line per scope.  "worst" is the
+			*	scope's time within the longest loop.
+			*/
+			uint32_t	cyclesPerUS = Profiler::CyclesPerUS();
+			if (inLine == 0)
+			{
+				uint32_t	budget;
+				if (strcmp(inShell->Arg(1), "reset") == 0)
+				{
+					Profiler::Reset();
+					inShell->PrintLine("ok");
+					break;
+				} else if (strcmp(inShell->Arg(1), "budget") == 0)
+				{
+					if (inShell->ArgUInt32(2, budget))
+					{
+						Profiler::SetBudget(budget);
+						inShell->PrintLine("ok");
+					} else
+					{
+						inShell->PrintLine("? usage: profile budget us");
+					}
+					break;
+				}
+				const ProfileHistogram&	loop = Profiler::Loop();
+				inShell->Print("Loop n ").PrintUInt(loop.Count()).
+					Print(" p50 ").PrintUInt(loop.Percentile(50)/cyclesPerUS).
+					Print(" p99 ").PrintUInt(loop.Percentile(99)/cyclesPerUS).
+					Print(" max ").PrintUInt(loop.Max()/cyclesPerUS).
+					Print(" over ").PrintUInt(Profiler::OverBudget()).
+					Print(" of ").PrintUInt(Profiler::Budget()).EndLine();
+				more = Profiler::First() != nullptr;
+			} else
+			{
+				ProfileHistogram*	histogram = Profiler::First();
+				for (uint16_t i = 1; i < inLine && histogram; i++)
+				{
+					histogram = histogram->Next();
+				}
+				if (histogram)
+				{
+					inShell->Print(histogram->Name()).
+						Print(" n ").PrintUInt(histogram->Count()).
+						Print(" p50 ").PrintUInt(histogram->Percentile(50)/cyclesPerUS).
+						Print(" p99 ").PrintUInt(histogram->Percentile(99)/cyclesPerUS).
+						Print(" max ").PrintUInt(histogram->Max()/cyclesPerUS).
+						Print(" worst ").PrintUInt(histogram->WorstLoop()/cyclesPerUS).EndLine();
+					more = histogram->Next() != nullptr;
+				}
+			}
+			break;
 		}
+#endif
 	}
-#endif	
-
-	return(false);
+	return(more);
 }
 
 /*********************************** WakeUp ***********************************/
@@ -298,7 +1010,7 @@ void DustCollectorSTM32::WakeUp(void)
 	{
 		mDisplaySleeping = false;
 		mDisplay.WakeUp();
-		rootView.Draw(0, 0, 999, 999);
+		mScheduler.Wake(eRedrawTask);
 	}
 	UnixTime::ResetSleepTime();
 }
@@ -309,6 +1021,7 @@ void DustCollectorSTM32::WakeUp(void)
 */
 void DustCollectorSTM32::GoToSleep(void)
 {
+	mPrefs.Commit();
 	if (!mDisplaySleeping)
 	{
 		mDisplay.Fill();
@@ -324,107 +1037,101 @@ void DustCollectorSTM32::GoToSleep(void)
 */
 void DustCollectorSTM32::CheckButtons(void)
 {
-	if (sButtonPressed)
+	/*
+	*	mButtonPins is the pin state queued by the last button edge.  It's
+	*	acted on once there have been no edges for the debounce period, and
+	*	only if the same buttons are still pressed.
+	*/
+	if (mButtonPins &&
+		mDebouncePeriod.Passed())
 	{
 		uint32_t	pinsState = (~GPIOA->IDR) & Config::kPINAtnMask;
-		if (pinsState)
+		bool	debounced = pinsState == mButtonPins;
+		mButtonPins = 0;
+		if (debounced)
 		{
 			/*
-			*	If debounced
+			*	Wakeup the display when any key is pressed.
 			*/
-			if (mStartPinState == pinsState)
+			WakeUp();
+			UnixTime::ResetSleepTime();
+			switch (pinsState)
 			{
-				/*
-				*	Wakeup the display when any key is pressed.
-				*/
-				WakeUp();
-				/*
-				*	If a debounce period has passed
-				*/
-				if (mDebouncePeriod.Passed())
-				{
-					UnixTime::ResetSleepTime();
-					sButtonPressed = false;
-					mStartPinState = 0xFF;
-					switch (pinsState)
+				case Config::kUpBtn:	// Up button pressed
+					//Serial.println('U');
+					if (touchScreenAlignment.IsVisible())
 					{
-						case Config::kUpBtn:	// Up button pressed
-							//Serial.println('U');
-							if (touchScreenAlignment.IsVisible())
-							{
-								// Stop and cancel/quit (restore old alignment)
-								Serial.println("Cancel Align");
-								infoView.SetVisible(true);
-								filterStatusGauge.SetVisible(false);
-								touchScreenAlignment.Stop(true);
-							}
-							break;
-						case Config::kEnterBtn:	// Enter button pressed
-							//Serial.println('E');
-							if (touchScreenAlignment.IsVisible())
-							{
-								if (touchScreenAlignment.OKToSave())
-								{
-									// Stop and save
-									infoView.SetVisible(true);
-									filterStatusGauge.SetVisible(false);
-									touchScreenAlignment.Stop(false);
-									uint16_t	minMax[4];
-									mTouchScreen.GetMinMax(minMax);
-									mPreferences.Write(offsetof(Config::SDCPreferences, tsMinMax), sizeof(minMax), (const uint8_t*)minMax);
-								}
-							} else if (NoModalDialogDisplayed() &&
-								!mDCIsRunning)
-							{
-								infoView.SetVisible(false);
-								filterStatusGauge.SetVisible(false);
-								touchScreenAlignment.Start(&mTouchScreen);
-							}
-							break;
-					#if 0
-						case Config::kLeftBtn:	// Left button pressed
-							break;
-						case Config::kDownBtn:	// Down button pressed
-							if (touchScreenAlignment.IsVisible())
-							{
-								touchScreenAlignment.ToggleInvertX();
-							}
-							break;
-						case Config::kRightBtn:	// Right button pressed
-							if (touchScreenAlignment.IsVisible())
-							{
-								touchScreenAlignment.ToggleInvertY();
-							}
-							break;
-					#else
-						case Config::kLeftBtn:	// Left button pressed
-							break;
-						case Config::kDownBtn:	// Down button pressed
+						// Stop and cancel/quit (restore old alignment)
+						Serial.println("Cancel Align");
+						infoView.SetVisible(true);
+						filterStatusGauge.SetVisible(false);
+						touchScreenAlignment.Stop(true);
+					}
+					break;
+				case Config::kEnterBtn:	// Enter button pressed
+					//Serial.println('E');
+					if (touchScreenAlignment.IsVisible())
+					{
+						if (touchScreenAlignment.OKToSave())
 						{
-					#if 0
-							Serial.print("ModalView = ");
-							if (rootView.ModalView())
-							{
-								Serial.println(rootView.ModalView()->Tag());
-							} else
-							{
-								Serial.println("nullptr");
-							}
-					#endif
-							break;
+							// Stop and save
+							infoView.SetVisible(true);
+							filterStatusGauge.SetVisible(false);
+							touchScreenAlignment.Stop(false);
+							uint16_t	minMax[4];
+							mTouchScreen.GetMinMax(minMax);
+							SDCSettings&	settings = mPrefs.Edit();
+							settings.tsXMin = minMax[0];
+							settings.tsXMax = minMax[1];
+							settings.tsYMin = minMax[2];
+							settings.tsYMax = minMax[3];
+							mTouchScreen.GetSkew(settings.tsXSkew, settings.tsYSkew);
 						}
-						case Config::kRightBtn:	// Right button pressed
-							break;
-					#endif
-						default:
-							mDebouncePeriod.Start();
-							break;
+					} else if (NoModalDialogDisplayed() &&
+						!mDCIsRunning)
+					{
+						infoView.SetVisible(false);
+						filterStatusGauge.SetVisible(false);
+						touchScreenAlignment.Start(&mTouchScreen);
 					}
+					break;
+			#if 0
+				case Config::kLeftBtn:	// Left button pressed
+					break;
+				case Config::kDownBtn:	// Down button pressed
+					if (touchScreenAlignment.IsVisible())
+					{
+						touchScreenAlignment.ToggleInvertX();
+					}
+					break;
+				case Config::kRightBtn:	// Right button pressed
+					if (touchScreenAlignment.IsVisible())
+					{
+						touchScreenAlignment.ToggleInvertY();
+					}
+					break;
+			#else
+				case Config::kLeftBtn:	// Left button pressed
+					break;
+				case Config::kDownBtn:	// Down button pressed
+				{
+			#if 0
+					Serial.print("ModalView = ");
+					if (rootView.ModalView())
+					{
+						Serial.println(rootView.ModalView()->Tag());
+					} else
+					{
+						Serial.println("nullptr");
+					}
+			#endif
+					break;
 				}
-			} else
-			{
-				mStartPinState = pinsState;
-				mDebouncePeriod.Start();
+				case Config::kRightBtn:	// Right button pressed
+					break;
+			#endif
+				default:	// More than one button
+					break;
 			}
 		}
 	}
@@ -432,10 +1139,11 @@ void DustCollectorSTM32::CheckButtons(void)
 
 /******************************* UpdateInfoView *******************************/
 /*
-*	Called from Update() when no modal dialogs are displayed.
+*	Called from the gauge task when no modal dialogs are displayed.
 */
 void DustCollectorSTM32::UpdateInfoView(void)
 {
+	PROFILE_SCOPE(UpdateInfoView);
 	if (infoView.IsVisible())
 	{
 		if (UnixTime::TimeChanged())
@@ -520,7 +1228,9 @@ void DustCollectorSTM32::DustCollectorJustStarted(void)
 {
 	DustCollectorBase::DustCollectorJustStarted();
 	dcStatusIcon.SetAnimationPeriod(750);
+	mScheduler.Wake(eIconTask, 750);
 	AddStartToRingBuffer(UnixTime::Time());
+	LogEvent(eDCStartedEvent, 0);
 }
 
 /************************** DustCollectorJustStopped **************************/
@@ -528,6 +1238,7 @@ void DustCollectorSTM32::DustCollectorJustStopped(void)
 {
 	DustCollectorBase::DustCollectorJustStopped();
 	dcStatusIcon.SetAnimationPeriod(0);
+	LogEvent(eDCStoppedEvent, mDeltaAveragesLoaded ? AdjustedDeltaAverage() : 0);
 	if (!mDeltaAveragesLoaded)
 	{
 		staticPresValueField.OverrideValueString(kStoppingStr, infoView.IsVisible() && filterSettingsDialog.IsVisible() == false);
@@ -542,6 +1253,68 @@ void DustCollectorSTM32::LoadingDeltas(void)
 	filterPresValueField.OverrideValueString(kWaitStr, filterStatusGauge.IsVisible());
 }
 
+/****************************** PressuresUpdated ******************************/
+void DustCollectorSTM32::PressuresUpdated(void)
+{
+	SDLogger::SSample	sample;
+	sample.time = UnixTime::Time();
+	sample.millis = ClockSource::Millis();
+	sample.binMotor = mBinMotorAverage;
+	sample.status = (mStatus & SampleLog::eStatusMask) |
+		(mMotorRunning ? SampleLog::eMotorRunningBit : 0) |
+		(mDCIsRunning ? SampleLog::eDCRunningBit : 0) |
+		(mDeltaAveragesLoaded ? SampleLog::eDeltasLoadedBit : 0);
+	/*
+	*	There's no static pressure till the delta averages are loaded (about
+	*	15 seconds after starting or after the collector stops.)  The
+	*	ambient pressure and temperature are recorded regardless.  The SD
+	*	log's static pressure is 0 with eDeltasLoadedBit clear, the
+	*	history's is PressureHistory::eNoStaticPressure.
+	*/
+	int32_t	staticPressure = DeltaAveragesLoaded() ? AdjustedDeltaAverage() : 0;
+	mHistory.AddSample(sample.time,
+		DeltaAveragesLoaded() ? staticPressure : (int32_t)PressureHistory::eNoStaticPressure,
+		mAmbientPressure, mAmbientTemperature);
+	sample.staticPressure = (int16_t)staticPressure;
+	sample.ambientPressure = mAmbientPressure;
+	sample.temperature = (int16_t)mAmbientTemperature;
+	mSDLogger.AddSample(sample);
+
+	if (mTelemetry.Divisor())
+	{
+		Telemetry::SSample	telemetry;
+		telemetry.time = sample.time;
+		telemetry.millis = sample.millis;
+		telemetry.ductPressure = mDuctPressure;
+		telemetry.ambientPressure = mAmbientPressure;
+		telemetry.temperature = mAmbientTemperature;
+		telemetry.deltaAverage = DeltaAverage();
+		telemetry.baseline = DeltaAveragesLoaded() ? Baseline() : 0;
+		telemetry.binMotor = mBinMotorAverage;
+		telemetry.status = sample.status;
+		uint32_t	loopAvg = mLoopCount ? mLoopSum / mLoopCount : 0;
+		telemetry.loopAvg = loopAvg < 0xFFFF ? loopAvg : 0xFFFF;
+		telemetry.loopMax = mLoopMax < 0xFFFF ? mLoopMax : 0xFFFF;
+		mTelemetry.AddSample(telemetry);
+	}
+	mLoopSum = 0;
+	mLoopMax = 0;
+	mLoopCount = 0;
+}
+
+/********************************** LogEvent **********************************/
+void DustCollectorSTM32::LogEvent(
+	uint8_t	inEventType,
+	int32_t	inValue)
+{
+	struct
+	{
+		time32_t	time;
+		int32_t		value;
+	} event = {UnixTime::Time(), inValue};
+	mEventLog.Append(inEventType, &event, sizeof(event));
+}
+
 /******************************** CancelFault *********************************/
 void DustCollectorSTM32::CancelFault(void)
 {
@@ -553,6 +1326,7 @@ void DustCollectorSTM32::CancelFault(void)
 void DustCollectorSTM32::FilterFull(void)
 {
 	DustCollectorBase::FilterFull();
+	LogEvent(eFilterFullEvent, AdjustedDeltaAverage());
 	/*
 	*	If no modal dialogs are showing THEN
 	*	display the "filter loaded" message.
@@ -569,6 +1343,7 @@ void DustCollectorSTM32::DustBinFull(void)
 	//Serial.print("mBinMotorAverage = ");
 	//Serial.println(mBinMotorAverage);
 	DustCollectorBase::DustBinFull();
+	LogEvent(eDustBinFullEvent, mBinMotorAverage);
 	if (NoModalDialogDisplayed() ||
 		utilitiesDialog.IsVisible())
 	{
@@ -586,7 +1361,7 @@ void DustCollectorSTM32::StopDustBinMotor(void)
 /********************************** ButtonISR *********************************/
 void ButtonISR(void)
 {
-	DustCollectorSTM32::sButtonPressed = true;
+	ISREvents::Push(ISREvents::eButtonEdge, (~GPIOA->IDR) & Config::kPINAtnMask);
 }
 
 /******************************* ValuesAreValid *******************************/
@@ -606,7 +1381,8 @@ bool DustCollectorSTM32::ValuesAreValid(
 		switch (inDialog->Tag())
 		{
 			case kFilterSettingsDialogTag:
-				valuesAreValid = cleanPresValueField.Value() < dirtyPresValueField.Value();
+				valuesAreValid = DCSettings::PressuresAreValid(cleanPresValueField.Value(),
+													dirtyPresValueField.Value());
 				if (!valuesAreValid)
 				{
 					warningDialog.DoMessage(kCleanPresInvalidMessageStr);
@@ -696,12 +1472,9 @@ void DustCollectorSTM32::HandleViewChange(
 			}
 			case kFilterSettingsDialogTag+XDialogBox::eCancelTagOffset:
 			{
-				Config::SDCPreferences	prefs;
 				// Revert back to original pressure unit when Cancel is selected.
-				if (mPreferences.Read(0, 3, &prefs.unused[0]))
-				{
-					ValueFormatter::sPressureUnit = (ValueFormatter::EPressureUnit)prefs.presUnit;
-				}
+				ValueFormatter::sPressureUnit = mPrefs.Get().pressureUnit_hPa ?
+					ValueFormatter::eHectopascal : ValueFormatter::eInchesOfWater;
 				break;
 			}
 			case kFilterSettingsDialogTag+XDialogBox::eOKTagOffset:
@@ -846,8 +1619,7 @@ void DustCollectorSTM32::ShowFilterStatusGauge(
 /********************** UpdateShowInfoViewrOnStartupPref **********************/
 void DustCollectorSTM32::UpdateShowInfoViewrOnStartupPref(void)
 {
-	uint8_t	infoViewIsVisible = infoView.IsVisible();
-	mPreferences.Write(offsetof(Config::SDCPreferences, showInfoViewOnStartup), 1, &infoViewIsVisible);
+	mPrefs.Edit().currentView = infoView.IsVisible() ? kInfoViewTag : kFilterStatusGaugeTag;
 }
 
 /************************** ShowFilterSettingsDialog **************************/
@@ -872,11 +1644,9 @@ void DustCollectorSTM32::SaveFilterSettingsDialogChanges(void)
 	*	(and passed) for this dialog.
 	*/
 	uint8_t showPressure = dispPresCheckbox.GetState();
-	uint8_t	prefShowPressure;
-	if (mPreferences.Read(offsetof(Config::SDCPreferences, displayPressure), 1, &prefShowPressure) &&
-		prefShowPressure != showPressure)
+	if (mPrefs.Get().displayPressure != showPressure)
 	{
-		mPreferences.Write(offsetof(Config::SDCPreferences, displayPressure), 1, &showPressure);
+		mPrefs.Edit().displayPressure = showPressure;
 		if (filterStatusGauge.IsVisible())
 		{
 			if (showPressure)
@@ -892,26 +1662,21 @@ void DustCollectorSTM32::SaveFilterSettingsDialogChanges(void)
 		}
 	}
 
+	bool	pressureUnit_hPa = ValueFormatter::sPressureUnit == ValueFormatter::eHectopascal;
+	if (mPrefs.Get().pressureUnit_hPa != pressureUnit_hPa)
 	{
-		Config::SDCPreferences	prefs;
-		if (mPreferences.Read(0, 3, &prefs.unused[0]))
+		mPrefs.Edit().pressureUnit_hPa = pressureUnit_hPa;
+		UpdateInfoPressureValues();
+		if (DeltaAveragesLoaded())
 		{
-			if (prefs.presUnit != ValueFormatter::sPressureUnit)
-			{
-				prefs.presUnit = ValueFormatter::sPressureUnit;
-				mPreferences.Write(0, 3, &prefs.unused[0]);
-				UpdateInfoPressureValues();
-				if (DeltaAveragesLoaded())
-				{
-					filterPresValueField.ValueChanged(filterStatusGauge.IsVisible());
-				}
-			}
+			filterPresValueField.ValueChanged(filterStatusGauge.IsVisible());
 		}
 	}
 	mDirtyPressure = dirtyPresValueField.Value();
 	mCleanPressure = cleanPresValueField.Value();
-	mPreferences.Write(offsetof(Config::SDCPreferences, dirtyPressure), 4, (uint8_t*)&mDirtyPressure);
-	mPreferences.Write(offsetof(Config::SDCPreferences, cleanPressure), 4, (uint8_t*)&mCleanPressure);
+	SDCSettings&	settings = mPrefs.Edit();
+	settings.dirtyPressure = mDirtyPressure;
+	settings.cleanPressure = mCleanPressure;
 	filterStatusGauge.SetMinMax(mCleanPressure, mDirtyPressure);
 }
 
@@ -938,7 +1703,7 @@ void DustCollectorSTM32::SaveBinSettingsDialogChanges(void)
 	if (newMotorEnabled != mMotorEnabled)
 	{
 		mMotorEnabled = newMotorEnabled;
-		mPreferences.Write(offsetof(Config::SDCPreferences, binMotorEnabled), 1, (uint8_t*)&mMotorEnabled);
+		mPrefs.Edit().binMotorEnabled = mMotorEnabled;
 		if (!mMotorEnabled)
 		{
 			binMotorValueField.SetValue(0, false);
@@ -969,27 +1734,9 @@ void DustCollectorSTM32::SaveDCSettingsToSD(void)
 	if (digitalRead(Config::kSDDetectPin) == LOW)
 	{
 		DCSettings	dcSettings;
-		SDCSettings	settings;
-		settings.hourFormat = UnixTime::Format24Hour() ? 24:12,
-		settings.temperatureUnitCelsius = ValueFormatter::sTemperatureUnit == ValueFormatter::eCelsius,
-		settings.pressureUnit_hPa = ValueFormatter::sPressureUnit == ValueFormatter::eHectopascal,
-		settings.binThreshold = mTriggerThreshold,
-		settings.binMotorEnabled = mMotorEnabled,
-		settings.displayPressure = filterPresValueField.IsVisible(),
-		settings.currentView = infoView.IsVisible() ? kInfoViewTag : kFilterStatusGaugeTag,
-		mTouchScreen.GetMinMax(settings.tsMinMax);
-		settings.cleanPressure = mCleanPressure;
-		settings.dirtyPressure = mDirtyPressure;
-
-		SdFat sd;
-		bool	success = sd.begin(Config::kSDSelectPin, SD_SCK_MHZ(4));
-		if (success)
-		{
-			success = dcSettings.WriteFile(kDCSettingsPath, settings);
-		} else
-		{
-			sd.initErrorHalt();
-		}
+		// Logging resumes on the next Update
+		bool	success = mSDLogger.Volume() &&
+					dcSettings.WriteFile(kDCSettingsPath, mPrefs.Get());
 		warningDialog.DoMessage(success ? kSavedDCSettingsStr : kSaveToSDFailedStr);
 	} else
 	{
@@ -1002,35 +1749,25 @@ void DustCollectorSTM32::LoadDCSettingsFromSD(void)
 {
 	if (digitalRead(Config::kSDDetectPin) == LOW)
 	{
-		SdFat sd;
 		DCSettings	dcSettings;
-		bool	success = sd.begin(Config::kSDSelectPin, SD_SCK_MHZ(4));
-		if (success)
+		uint8_t	result = DCSettings::eOpenFailed;
+		// Logging resumes on the next Update
+		if (mSDLogger.Volume())
 		{
-			success = dcSettings.ReadFile(kDCSettingsPath);
-		} else
-		{
-			sd.initErrorHalt();
+			result = dcSettings.ReadFile(kDCSettingsPath);
 		}
-		if (success)
+		if (result == DCSettings::eReadOK)
 		{
-			const SDCSettings&	settings = dcSettings.Settings();
-			Config::SDCPreferences	prefs = {0};
-			prefs.clockFormat = settings.hourFormat == 12;
-			prefs.tempUnit = settings.temperatureUnitCelsius == false;
-			prefs.presUnit = settings.pressureUnit_hPa == false;
-			prefs.binThreshold = settings.binThreshold;
-			prefs.binMotorEnabled = settings.binMotorEnabled;
-			prefs.displayPressure = settings.displayPressure;
-			prefs.showInfoViewOnStartup = settings.currentView == kInfoViewTag;
-			memcpy(prefs.tsMinMax, settings.tsMinMax, sizeof(prefs.tsMinMax));
-			prefs.cleanPressure = mCleanPressure;
-			prefs.dirtyPressure = mDirtyPressure;
-			mPreferences.Write(0, sizeof(Config::SDCPreferences), &prefs.unused[0]);
 			/*
-			*	Restart the board.
+			*	Applied live.  The preferences are committed when idle.
 			*/
-			HAL_NVIC_SystemReset();
+			mPrefs.Edit() = dcSettings.Settings();
+			ApplySettings(true);
+			warningDialog.DoMessage(kLoadedDCSettingsStr);
+		} else if (result == DCSettings::eUnknownKey ||
+			result == DCSettings::eDuplicateKey)
+		{
+			warningDialog.DoMessage(kSettingsKeyErrorStr);
 		} else
 		{
 			warningDialog.DoMessage(kLoadFromSDFailedStr);
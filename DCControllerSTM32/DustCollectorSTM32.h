@@ -28,14 +28,27 @@
 #include "Config.h"
 #include "AT24C.h"
 #include "TFT_ILI9488.h"
+#include "DisplayT.h"
 #include "XPT2046.h"
 #include "XDialogBox.h"
 #include "MSPeriod.h"
 #include "STM32UnixRTC.h"
+#include "PressureHistory.h"
+#include "DCPreferences.h"
+#include "AT24CDataStream.h"
+#include "LogStore.h"
+#include "SDLogger.h"
+#include "TelemetryTx.h"
+#include "SerialShell.h"
+#include "ScreenCapture.h"
+#include "Scheduler.h"
+#include "ISREvents.h"
 
 class DustCollectorSTM32 : public DustCollectorBase,
 							public XViewChangedDelegate,
-								public XValidatorDelegate
+								public XValidatorDelegate,
+									public SerialShellDelegate,
+										public SchedulerDelegate
 {
 public:
 							DustCollectorSTM32(void);
@@ -54,15 +67,35 @@ public:
 								uint16_t				inAction);
 	virtual bool			ValuesAreValid(
 								XDialogBox*				inDialog);
+	virtual bool			ShellCommand(
+								uint8_t					inID,
+								uint16_t				inLine,
+								SerialShell*			inShell);
+	virtual uint32_t		RunTask(
+								uint8_t					inTask);
 								
 protected:
 	XView*			mHitView;
 	TFT_ILI9488		mDisplay;
 	XPT2046			mTouchScreen;
-	AT24C			mPreferences;
+	AT24C			mPreferences;	// The EEPROM
+	DCPreferences	mPrefs;
+	PressureHistory	mHistory;
+	AT24CDataStream	mEventLogStream;
+	LogStore		mEventLog;
+	SDLogger		mSDLogger;
+	TelemetryTx		mTelemetry;
+	SerialShell		mShell;
+	ScreenCapture	mCapture;		// For the shell's capture command
+	uint16_t		mCaptureOverruns;	// Serial task's when it started
+	Scheduler		mScheduler;
+	uint32_t		mLoopStart;		// ClockSource::Micros() at the start of Update
+	uint32_t		mLoopSum;		// Loop period totals since the last
+	uint32_t		mLoopMax;		// telemetry sample, in us
+	uint16_t		mLoopCount;
 	bool			mDisplaySleeping;
 	MSPeriod		mDebouncePeriod;	// For buttons
-	uint32_t		mStartPinState;		// For buttons
+	uint16_t		mButtonPins;		// Queued by the last button edge
 	int32_t			mDirtyPressure;
 	int32_t			mCleanPressure;
 	uint16_t		mX, mY;
@@ -74,11 +107,6 @@ protected:
 	uint16_t		mStartsPerHourTail;
 	time32_t		mStartsPerHourRingBuffer[eMaxStartsPerHour];
 
-public:
-	static bool		sButtonPressed;
-	
-protected:
-	
 	bool					NoModalDialogDisplayed(void) const;
 	void					ShowInfoView(
 								bool					inUpdatePref = true);
@@ -89,20 +117,42 @@ protected:
 	virtual void			DustCollectorJustStopped(void);
 	virtual void			StopDustBinMotor(void);
 	virtual void			LoadingDeltas(void);
+	virtual void			PressuresUpdated(void);
+	enum EEventType
+	{
+		eDCStartedEvent,
+		eDCStoppedEvent,
+		eDustBinFullEvent,
+		eFilterFullEvent
+	};
+							// Appends {time32_t time, int32_t value} to mEventLog
+	void					LogEvent(
+								uint8_t					inEventType,
+								int32_t					inValue);
 	void					ShowFilterSettingsDialog(void);
 	void					SaveFilterSettingsDialogChanges(void);
 	void					ShowBinSettingsDialog(void);
 	void					SaveBinSettingsDialogChanges(void);
 	void					ShowUtilitiesDialog(void);
 	void					ShowSetClockDialog(void);
+	void					ApplySettings(
+								bool					inLive);
 	void					SaveDCSettingsToSD(void);
 	void					LoadDCSettingsFromSD(void);
 	void					UpdateInfoPressureValues(void);
 	void					UpdateInfoView(void);
 	void					UpdateInfoViewBinMotor(void);
+	void					PenDown(
+								uint16_t				inX,
+								uint16_t				inY);
+	void					PenDragged(
+								uint16_t				inX,
+								uint16_t				inY);
+	void					PenUp(void);
 	void					WakeUp(void);
 	void					GoToSleep(void);
 	void					CheckButtons(void);
+	void					DispatchISREvents(void);
 	void					AddStartToRingBuffer(
 								time32_t				inStartTime);
 	void					UpdateStartsPerHour(
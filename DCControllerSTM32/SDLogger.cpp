@@ -0,0 +1,305 @@
+/*
+*	SDLogger.cpp, Copyright Jonathan Mackey 2026
+*	Continuous sample logging to a pre-allocated contiguous file on the SD
+*	card.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "SDLogger.h"
+#include "Profiler.h"
+#include <string.h>
+
+static const char kLogDir[] = "DCLogs";
+
+/********************************** SDLogger **********************************/
+SDLogger::SDLogger(
+	pin_t	inSelectPin,
+	pin_t	inDetectPin)
+	: mSelectPin(inSelectPin), mDetectPin(inDetectPin), mState(eNoCard),
+	  mMounted(false), mActive(0), mDay(0), mNextSector(0), mNextBlock(0), mFirstSector(0),
+	  mDroppedSamples(0), mSettlePeriod(500)
+{
+	mFull[0] = mFull[1] = false;
+}
+
+/******************************** CardPresent *********************************/
+bool SDLogger::CardPresent(void) const
+{
+	return(digitalRead(mDetectPin) == LOW);
+}
+
+/********************************* AddSample **********************************/
+void SDLogger::AddSample(
+	const SSample&	inSample)
+{
+	if (mState == eLogging)
+	{
+		if (!mEncoder.IsOpen())
+		{
+			if (mFull[mActive])
+			{
+				/*
+				*	If the other buffer is still waiting to be written then
+				*	the sample is dropped.
+				*/
+				if (mFull[mActive ^ 1])
+				{
+					mDroppedSamples++;
+					return;
+				}
+				mActive ^= 1;
+			}
+			mEncoder.Begin(mBuffer[mActive], eSectorSize, mDay, mNextBlock++, inSample);
+		} else
+		{
+			mEncoder.Add(inSample);	// Can't fail, full blocks are finished below
+		}
+		if (mEncoder.IsFull())
+		{
+			mEncoder.Finish();
+			mFull[mActive] = true;
+		}
+	}
+}
+
+/******************************* IsValidSector ********************************/
+bool SDLogger::IsValidSector(
+	const uint8_t*	inSector,
+	uint16_t		inIndex) const
+{
+	SampleLog::SBlockHeader	header;
+	return(SampleLog::ReadHeader(inSector, eSectorSize, header) &&
+		header.fileID == mDay &&
+		header.index == inIndex);
+}
+
+/********************************** FindEnd ***********************************/
+/*
+*	Binary search for the first sector that isn't part of today's log.
+*	mBuffer[1] is used as the read buffer, so this is only called when both
+*	buffers are empty.
+*/
+uint16_t SDLogger::FindEnd(void)
+{
+	uint8_t*	sector = mBuffer[1];
+	uint16_t	lo = 0;				// First sector that may be invalid
+	uint16_t	hi = eFileSectors;	// Known to be past the end
+	while (lo < hi)
+	{
+		uint16_t	mid = (lo + hi) / 2;
+		if (mSD.card()->readSector(mFirstSector + mid, sector) &&
+			IsValidSector(sector, mid))
+		{
+			lo = mid + 1;
+		} else
+		{
+			hi = mid;
+		}
+	}
+	return(lo);
+}
+
+/******************************** OpenDayFile *********************************/
+bool SDLogger::OpenDayFile(
+	uint16_t	inDay)
+{
+	// DCLogs/YYYYMMDD.DCL
+	char	path[24];
+	uint16_t	year;
+	uint8_t		month, day;
+	UnixTime::DateComponents((time32_t)inDay * 86400, year, month, day);
+	strcpy(path, kLogDir);
+	char*	pathPtr = &path[sizeof(kLogDir)-1];
+	*(pathPtr++) = '/';
+	UnixTime::Uint16ToDecStr(year, pathPtr);
+	pathPtr += 4;
+	UnixTime::DecStrValue(month, pathPtr);
+	UnixTime::DecStrValue(day, &pathPtr[2]);
+	strcpy(&pathPtr[4], ".DCL");
+
+	mDay = inDay;
+	SdFile::dateTimeCallback(UnixTime::SDFatDateTimeCB);
+	bool	success = (mSD.exists(kLogDir) || mSD.mkdir(kLogDir)) &&
+					mFile.open(path, O_RDWR | O_CREAT);
+	if (success)
+	{
+		if (mFile.fileSize() == 0)
+		{
+			success = mFile.preAllocate((uint64_t)eFileSectors * eSectorSize);
+		}
+		uint32_t	lastSector;
+		success = success &&
+			mFile.contiguousRange(&mFirstSector, &lastSector) &&
+			(lastSector - mFirstSector + 1) >= eFileSectors;
+		if (success)
+		{
+			mNextSector = FindEnd();
+			mNextBlock = mNextSector;
+			success = mNextSector < eFileSectors &&
+				mSD.card()->writeStart(mFirstSector + mNextSector);
+		}
+		if (!success)
+		{
+			mFile.close();
+		}
+	}
+	return(success);
+}
+
+/******************************** WriteSector *********************************/
+bool SDLogger::WriteSector(
+	const uint8_t*	inSector)
+{
+	bool	success = mNextSector < eFileSectors &&
+		mSD.card()->writeData(inSector);
+	if (success)
+	{
+		mNextSector++;
+	}
+	return(success);
+}
+
+/********************************* CloseFile **********************************/
+void SDLogger::CloseFile(
+	bool	inFlush)
+{
+	if (mState == eLogging)
+	{
+		if (inFlush)
+		{
+			uint8_t	older = mActive ^ 1;
+			if (mFull[older])
+			{
+				WriteSector(mBuffer[older]);
+			}
+			if (mEncoder.IsOpen())
+			{
+				mEncoder.Finish();
+				mFull[mActive] = true;
+			}
+			if (mFull[mActive])
+			{
+				WriteSector(mBuffer[mActive]);
+			}
+		}
+		/*
+		*	The multi-block write started by OpenDayFile is ended even when
+		*	not flushing (a write error), otherwise the card is left
+		*	expecting data.
+		*/
+		mSD.card()->writeStop();
+		mFile.close();
+	}
+	if (mEncoder.IsOpen())
+	{
+		mEncoder.Finish();	// Discarded
+	}
+	mFull[0] = mFull[1] = false;
+	mActive = 0;
+}
+
+/*********************************** Close ************************************/
+void SDLogger::Close(void)
+{
+	CloseFile(true);
+	mState = eNoCard;
+}
+
+/*********************************** Volume ***********************************/
+SdFat* SDLogger::Volume(void)
+{
+	Close();
+	if (!mMounted && CardPresent())
+	{
+		mMounted = mSD.begin(mSelectPin, SD_SCK_MHZ(4));
+	}
+	return(mMounted ? &mSD : nullptr);
+}
+
+/*********************************** Update ***********************************/
+void SDLogger::Update(void)
+{
+	PROFILE_SCOPE(SDLogger);
+	switch (mState)
+	{
+		case eNoCard:
+			if (!CardPresent())
+			{
+				mMounted = false;
+			} else
+			{
+				mSettlePeriod.Start();
+				mState = eCardDetected;
+			}
+			break;
+		case eCardDetected:
+			if (!CardPresent())
+			{
+				mMounted = false;
+				mState = eNoCard;
+			} else if (mSettlePeriod.Passed())
+			{
+				if (!mMounted)
+				{
+					mMounted = mSD.begin(mSelectPin, SD_SCK_MHZ(4));
+				}
+				mState = mMounted &&
+					OpenDayFile(UnixTime::Time() / 86400) ? eLogging : eError;
+			}
+			break;
+		case eLogging:
+			if (!CardPresent())
+			{
+				// The card is gone, there's nothing to flush to.
+				CloseFile(false);
+				mMounted = false;
+				mState = eNoCard;
+			} else if (UnixTime::Time() / 86400 != mDay)
+			{
+				CloseFile(true);
+				mState = eCardDetected;	// Opens the new day's file
+			} else if (!mSD.card()->isBusy())
+			{
+				/*
+				*	Write at most one sector per call.  The older full buffer
+				*	is written first.
+				*/
+				uint8_t	index = mFull[mActive ^ 1] ? (mActive ^ 1) : mActive;
+				if (mFull[index])
+				{
+					if (WriteSector(mBuffer[index]))
+					{
+						mFull[index] = false;
+					} else
+					{
+						CloseFile(false);
+						mState = eError;
+					}
+				}
+			}
+			break;
+		case eError:
+			if (!CardPresent())
+			{
+				mMounted = false;
+				mState = eNoCard;
+			}
+			break;
+	}
+}
@@ -0,0 +1,134 @@
+/*
+*	SDLogger.h, Copyright Jonathan Mackey 2026
+*	Continuous sample logging to a pre-allocated contiguous file on the SD
+*	card.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef SDLogger_h
+#define SDLogger_h
+
+#include <inttypes.h>
+#include "PlatformDefs.h"
+#include "MSPeriod.h"
+#include "UnixTime.h"
+#include "SdFat.h"
+#include "SampleLog.h"
+
+/*
+*	One file per day: /DCLogs/YYYYMMDD.DCL, pre-allocated as a contiguous
+*	range of sectors.  Sectors are written directly to the card with a
+*	multi-block write, one sector per Update() call and only when the card
+*	isn't busy, so sampling never waits on the card.
+*
+*	Samples are encoded into one of two 512 byte sector buffers using the
+*	SampleLog block format (see SampleLog.h), so each sector is a block that
+*	starts with a keyframe and can be decoded on its own.  When a buffer is
+*	full the other buffer takes the samples while the full one is written.
+*	If both are full (card too slow or stalled) the sample is dropped and
+*	counted.
+*
+*	The block header's fileID is the day (time/86400) of the file, which
+*	detects stale sectors, and its index is the sector within the file.
+*	The unused tail of the file isn't erased.  A reader stops at the first
+*	sector with the wrong magic, fileID or index.
+*
+*	The card is mounted once per insert.  Other uses of the card get the
+*	logger's volume (Volume) rather than mounting the card again.
+*
+*	A card inserted or removed is detected with the card detect pin.  After
+*	an insert, or reset, logging resumes after the last valid sector of the
+*	day's file.  Samples in the partially filled buffer are lost when the
+*	card is removed or power fails (one sector of samples.)
+*/
+class SDLogger
+{
+public:
+							SDLogger(
+								pin_t					inSelectPin,
+								pin_t					inDetectPin);
+	typedef SampleLog::SSample	SSample;
+	enum
+	{
+		eSectorSize			= 512,
+		eFileSectors		= 4096	// 2 MB, a typical day uses a few hundred
+	};
+
+	void					AddSample(
+								const SSample&			inSample);
+							// Call from the main loop.
+	void					Update(void);
+							/*
+							*	Writes any buffered samples and closes the
+							*	file.  Call before anything else uses the card.
+							*	Logging resumes on the next Update().
+							*/
+	void					Close(void);
+							/*
+							*	Closes the file as Close does and returns the
+							*	logger's mounted volume for other uses of the
+							*	card (e.g. the settings file), mounting it if
+							*	needed.  nullptr if there's no card or it can't
+							*	be mounted.  Logging resumes on the next
+							*	Update() without mounting the card again.
+							*/
+	SdFat*					Volume(void);
+	bool					IsLogging(void) const
+								{return(mState == eLogging);}
+	uint32_t				DroppedSamples(void) const
+								{return(mDroppedSamples);}
+protected:
+	enum EState
+	{
+		eNoCard,
+		eCardDetected,	// Waiting for the card to settle
+		eLogging,
+		eError			// Waits for the card to be removed
+	};
+	SdFat			mSD;
+	SdFile			mFile;
+	pin_t			mSelectPin;
+	pin_t			mDetectPin;
+	uint8_t			mState;
+	bool			mMounted;		// mSD.begin succeeded, the card wasn't removed
+	uint8_t			mActive;		// Index of the buffer taking samples
+	bool			mFull[2];		// Buffer waiting to be written
+	uint16_t		mDay;			// Of the open file
+	uint16_t		mNextSector;	// Index within the file of the next write
+	uint16_t		mNextBlock;		// Index within the file of the next block
+	uint32_t		mFirstSector;	// Card sector of the file's first sector
+	uint32_t		mDroppedSamples;
+	MSPeriod		mSettlePeriod;
+	SampleLog::BlockEncoder	mEncoder;	// Encodes into mBuffer[mActive]
+	uint8_t			mBuffer[2][eSectorSize];
+
+	bool					CardPresent(void) const;
+	bool					OpenDayFile(
+								uint16_t				inDay);
+	uint16_t				FindEnd(void);
+	bool					IsValidSector(
+								const uint8_t*			inSector,
+								uint16_t				inIndex) const;
+	bool					WriteSector(
+								const uint8_t*			inSector);
+	void					CloseFile(
+								bool					inFlush);
+};
+
+#endif // SDLogger_h
@@ -0,0 +1,304 @@
+/*
+*	ScreenCapture.cpp, Copyright Jonathan Mackey 2026
+*	Captures a region of the screen by redrawing it into a line buffer.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "ScreenCapture.h"
+#include "XRootView.h"
+#include "XFont.h"
+#include "DataStream.h"
+#include "ClockSource.h"
+
+static_assert(SCREEN_CAPTURE_BAND_PIXELS >= ScreenCapture::eMaxWidth,
+	"SCREEN_CAPTURE_BAND_PIXELS < eMaxWidth");
+
+/******************************* ScreenCapture ********************************/
+ScreenCapture::ScreenCapture(void)
+	: DisplayController(0, 0), mRootView(nullptr), mXFont(nullptr),
+	  mX(0), mY(0), mWidth(0), mHeight(0), mBandRow(0), mBandRows(0),
+	  mLineRow(0), mEncoded(0),
+	  mStartRow(0), mEndRow(0), mStartColumn(0), mEndColumn(0),
+	  mWriteRow(0), mWriteColumn(0), mRuns(0), mRenderTime(0),
+	  mMaxRenderTime(0)
+{
+}
+
+/*********************************** Begin ************************************/
+bool ScreenCapture::Begin(
+	XRootView*	inRootView,
+	XFont*		inXFont,
+	uint16_t	inX,
+	uint16_t	inY,
+	uint16_t	inWidth,
+	uint16_t	inHeight)
+{
+	DisplayController*	display = inRootView->GetDisplay();
+	bool	success = inWidth && inHeight && inWidth <= eMaxWidth &&
+		(uint32_t)inX + inWidth <= display->GetColumns() &&
+		(uint32_t)inY + inHeight <= display->GetRows();
+	if (success)
+	{
+		mRows = display->GetRows();
+		mColumns = display->GetColumns();
+		mRootView = inRootView;
+		mXFont = inXFont;
+		mX = inX;
+		mY = inY;
+		mWidth = inWidth;
+		mHeight = inHeight;
+		mLineRow = inY;
+		mRuns = 0;
+		mRenderTime = 0;
+		mMaxRenderTime = 0;
+		RenderBand();
+	}
+	return(success);
+}
+
+/*********************************** Update ***********************************/
+/*
+*	Queues the rows of the band, then renders the next band, at most one per
+*	call.
+*/
+bool ScreenCapture::Update(
+	TelemetryTx*	inOutput)
+{
+	bool	rendered = false;
+	while (mRootView &&
+		!rendered &&
+		inOutput->Room() >= Telemetry::eMaxFrame)
+	{
+		if (mEncoded < mWidth)
+		{
+			QueueRuns(inOutput);
+		} else if (mLineRow + 1 == mY + mHeight)
+		{
+			mRootView = nullptr;	// Done
+		} else
+		{
+			mLineRow++;
+			mEncoded = 0;
+			if (mLineRow == mBandRow + mBandRows)
+			{
+				RenderBand();
+				rendered = true;
+			}
+		}
+	}
+	return(mRootView != nullptr);
+}
+
+/********************************* RenderBand *********************************/
+/*
+*	Redraws the views that intersect the band of the region starting at
+*	mLineRow with this as the display of the root view and the font.
+*/
+void ScreenCapture::RenderBand(void)
+{
+	uint32_t	start = ClockSource::Micros();
+	mBandRow = mLineRow;
+	mBandRows = eBandPixels / mWidth;
+	if (mBandRows > mY + mHeight - mBandRow)
+	{
+		mBandRows = mY + mHeight - mBandRow;
+	}
+	memset(mBand, 0, mWidth * mBandRows * sizeof(uint16_t));
+	mEncoded = 0;
+	mRow = mColumn = 0;
+	mStartRow = mWriteRow = 0;
+	mEndRow = mRows - 1;
+	mStartColumn = mWriteColumn = 0;
+	mEndColumn = mColumns - 1;
+
+	DisplayController*	display = mRootView->GetDisplay();
+	XFont::Font*	font = mXFont->GetFont();
+	mRootView->SetDisplay(this);
+	mXFont->SetDisplay(this, font);
+	mRootView->Draw(mX, mBandRow, mWidth, mBandRows);
+	mRootView->SetDisplay(display);
+	mXFont->SetDisplay(display, font);
+	uint32_t	elapsed = ClockSource::Micros() - start;
+	mRenderTime += elapsed;
+	if (elapsed > mMaxRenderTime)
+	{
+		mMaxRenderTime = elapsed;
+	}
+}
+
+/********************************* QueueRuns **********************************/
+/*
+*	Queues one packet of up to eMaxScreenRuns runs of mLineRow starting at
+*	mEncoded.
+*/
+void ScreenCapture::QueueRuns(
+	TelemetryTx*	inOutput)
+{
+	Telemetry::SScreen	screen;
+	screen.row = mLineRow;
+	screen.column = mX + mEncoded;
+	screen.numRuns = 0;
+	const uint16_t*	line = &mBand[(mLineRow - mBandRow) * mWidth];
+	while (mEncoded < mWidth &&
+		screen.numRuns < Telemetry::eMaxScreenRuns)
+	{
+		uint16_t	color = line[mEncoded];
+		uint16_t	runEnd = mEncoded + 1;
+		for (; runEnd < mWidth && line[runEnd] == color &&
+			(runEnd - mEncoded) < 255; runEnd++){}
+		screen.runs[screen.numRuns].count = (uint8_t)(runEnd - mEncoded);
+		screen.runs[screen.numRuns].color = color;
+		screen.numRuns++;
+		mEncoded = runEnd;
+	}
+	mRuns += screen.numRuns;
+	uint8_t	payload[Telemetry::eMaxPayload];
+	inOutput->Queue(Telemetry::eScreenPacket, payload, Telemetry::PackScreen(screen, payload));
+}
+
+/*********************************** MoveTo ***********************************/
+void ScreenCapture::MoveTo(
+	uint16_t	inRow,
+	uint16_t	inColumn)
+{
+	MoveToRow(inRow);
+	mColumn = inColumn;
+}
+
+/********************************* MoveToRow **********************************/
+// Same as the TFT: the row range is set from inRow to the last row.
+void ScreenCapture::MoveToRow(
+	uint16_t inRow)
+{
+	mStartRow = inRow;
+	mEndRow = mRows - 1;
+	mRow = inRow;
+}
+
+/******************************* SetColumnRange *******************************/
+// Same as the TFT: starts writing at the start of the row and column range.
+void ScreenCapture::SetColumnRange(
+	uint16_t	inStartColumn,
+	uint16_t	inEndColumn)
+{
+	mStartColumn = inStartColumn;
+	mEndColumn = inEndColumn >= inStartColumn ? inEndColumn : inStartColumn;
+	mWriteRow = mStartRow;
+	mWriteColumn = inStartColumn;
+}
+
+/******************************* SetRowRange **********************************/
+void ScreenCapture::SetRowRange(
+	uint16_t	inStartRow,
+	uint16_t	inEndRow)
+{
+	mStartRow = inStartRow;
+	mEndRow = inEndRow >= inStartRow ? inEndRow : inStartRow;
+}
+
+/********************************** NextSpan **********************************/
+uint16_t* ScreenCapture::NextSpan(
+	uint32_t	inPixels,
+	uint16_t&	outLength,
+	uint16_t&	outSkip,
+	uint16_t&	outCount)
+{
+	uint16_t*	span = nullptr;
+	uint16_t	rowRemaining = mEndColumn - mWriteColumn + 1;
+	outLength = inPixels < rowRemaining ? (uint16_t)inPixels : rowRemaining;
+	if (mWriteRow >= mBandRow &&
+		mWriteRow < mBandRow + mBandRows)
+	{
+		uint32_t	start = mWriteColumn > mX ? mWriteColumn : mX;
+		uint32_t	end = (uint32_t)mWriteColumn + outLength;
+		if (end > (uint32_t)mX + mWidth)
+		{
+			end = mX + mWidth;
+		}
+		if (start < end)
+		{
+			span = &mBand[(mWriteRow - mBandRow) * mWidth + start - mX];
+			outSkip = start - mWriteColumn;
+			outCount = end - start;
+		}
+	}
+	/*
+	*	Advance, wrapping at the end of the column and row ranges.
+	*/
+	if (outLength < rowRemaining)
+	{
+		mWriteColumn += outLength;
+	} else
+	{
+		mWriteColumn = mStartColumn;
+		mWriteRow = mWriteRow < mEndRow ? (mWriteRow + 1) : mStartRow;
+	}
+	return(span);
+}
+
+/********************************* FillPixels *********************************/
+void ScreenCapture::FillPixels(
+	uint32_t	inPixelsToFill,
+	uint16_t	inFillColor)
+{
+	uint16_t	length, skip, count;
+	while (inPixelsToFill)
+	{
+		uint16_t*	span = NextSpan(inPixelsToFill, length, skip, count);
+		for (; span && count; count--)
+		{
+			*(span++) = inFillColor;
+		}
+		inPixelsToFill -= length;
+	}
+}
+
+/******************************** StreamCopy **********************************/
+void ScreenCapture::StreamCopy(
+	DataStream*	inDataStream,	// A 16 bit data stream
+	uint16_t	inPixelsToCopy)
+{
+	uint16_t	buffer[32];
+	while (inPixelsToCopy)
+	{
+		uint16_t pixelsToCopy = inPixelsToCopy > 32 ? 32 : inPixelsToCopy;
+		inPixelsToCopy -= pixelsToCopy;
+		inDataStream->Read(pixelsToCopy, buffer);
+		CopyPixels(buffer, pixelsToCopy);
+	}
+}
+
+/******************************** CopyPixels **********************************/
+void ScreenCapture::CopyPixels(
+	const void*	inPixels,
+	uint16_t	inPixelsToCopy)
+{
+	const uint16_t*	pixels = (const uint16_t*)inPixels;
+	uint16_t	length, skip, count;
+	while (inPixelsToCopy)
+	{
+		uint16_t*	span = NextSpan(inPixelsToCopy, length, skip, count);
+		if (span)
+		{
+			memcpy(span, &pixels[skip], count * sizeof(uint16_t));
+		}
+		pixels += length;
+		inPixelsToCopy -= length;
+	}
+}
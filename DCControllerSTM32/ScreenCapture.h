@@ -0,0 +1,163 @@
+/*
+*	ScreenCapture.h, Copyright Jonathan Mackey 2026
+*	Captures a region of the screen by redrawing it into a line buffer.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef ScreenCapture_h
+#define ScreenCapture_h
+
+#include "DisplayController.h"
+#include "TelemetryTx.h"
+
+/*
+*	The band buffer, in pixels.  A band is as many rows of the region as fit.
+*/
+#ifndef SCREEN_CAPTURE_BAND_PIXELS
+#define SCREEN_CAPTURE_BAND_PIXELS	960	// 2 rows at 480
+#endif
+
+class XRootView;
+class XFont;
+
+/*
+*	TFT_ILI9488 is write only, so the region is redrawn one band of rows at
+*	a time with ScreenCapture standing in for the display.  ScreenCapture emulates
+*	the TFT's address window: pixels are written from the start of the
+*	column range, wrapping to the next row at the end of the range.  Only
+*	the pixels that land on the band being captured, within the region, are
+*	kept.  Everything else is skipped, so a band costs a traversal of the
+*	views that intersect it but no SPI traffic.  A view that intersects the
+*	band draws all of its pixels, so the wider the band the fewer times
+*	each view is drawn.
+*
+*	Each row is run length encoded into Telemetry::eScreenPacket packets
+*	queued on the TelemetryTx ring.  Update() renders at most one band per
+*	call and queues only what fits, so a capture never blocks the main
+*	loop for longer than a band takes to render (see MaxRenderTime.)  The screen can change while the capture is in progress, in which
+*	case rows captured before and after the change will differ.
+*
+*	What's captured is what a redraw produces.  Areas not covered by any
+*	view are black, as they are after the display is filled at startup.
+*/
+class ScreenCapture : public DisplayController
+{
+public:
+							ScreenCapture(void);
+							/*
+							*	Starts capturing the region.  Returns false if
+							*	the region is empty, off the display or wider
+							*	than eMaxWidth.
+							*/
+	bool					Begin(
+								XRootView*				inRootView,
+								XFont*					inXFont,
+								uint16_t				inX,
+								uint16_t				inY,
+								uint16_t				inWidth,
+								uint16_t				inHeight);
+							/*
+							*	Queues as many packets as inOutput has room for.
+							*	Returns true while rows remain.
+							*/
+	bool					Update(
+								TelemetryTx*			inOutput);
+	bool					Capturing(void) const
+								{return(mRootView != nullptr);}
+							// Totals for the last capture
+	uint32_t				Runs(void) const
+								{return(mRuns);}
+	uint32_t				RenderTime(void) const	// us
+								{return(mRenderTime);}
+	uint32_t				MaxRenderTime(void) const	// us, of one band
+								{return(mMaxRenderTime);}
+
+	virtual void			MoveTo(
+								uint16_t				inRow,
+								uint16_t				inColumn);
+	virtual void			MoveToRow(
+								uint16_t				inRow);
+	virtual void			MoveToColumn(
+								uint16_t				inColumn)
+								{mColumn = inColumn;}
+	virtual void			Sleep(void){}
+	virtual void			WakeUp(void){}
+	virtual void			FillPixels(
+								uint32_t				inPixelsToFill,
+								uint16_t				inFillColor);
+	virtual void			SetColumnRange(
+								uint16_t				inStartColumn,
+								uint16_t				inEndColumn);
+	virtual void			SetRowRange(
+								uint16_t				inStartRow,
+								uint16_t				inEndRow);
+	virtual void			StreamCopy(
+								DataStream*				inDataStream,
+								uint16_t				inPixelsToCopy);
+	virtual void			CopyPixels(
+								const void*				inPixels,
+								uint16_t				inPixelsToCopy);
+							// Horizontal only, like the TFT.
+	virtual void			SetAddressingMode(
+								EAddressingMode			inAddressingMode){}
+	enum
+	{
+		eMaxWidth	= 480,
+		eBandPixels	= SCREEN_CAPTURE_BAND_PIXELS
+	};
+protected:
+	XRootView*	mRootView;
+	XFont*		mXFont;
+	uint16_t	mX;				// The region
+	uint16_t	mY;
+	uint16_t	mWidth;
+	uint16_t	mHeight;
+	uint16_t	mBandRow;		// First row in mBand
+	uint16_t	mBandRows;
+	uint16_t	mLineRow;		// Row being queued
+	uint16_t	mEncoded;		// Pixels of mLineRow already queued
+	uint16_t	mStartRow;		// The address window
+	uint16_t	mEndRow;
+	uint16_t	mStartColumn;
+	uint16_t	mEndColumn;
+	uint16_t	mWriteRow;		// Where the next pixel goes
+	uint16_t	mWriteColumn;
+	uint32_t	mRuns;
+	uint32_t	mRenderTime;
+	uint32_t	mMaxRenderTime;
+	uint16_t	mBand[eBandPixels];
+
+	void					RenderBand(void);
+	void					QueueRuns(
+								TelemetryTx*			inOutput);
+							/*
+							*	Consumes the next inPixels or up to the end of
+							*	the window row, whichever is shorter (returned
+							*	in outLength.)  Returns where the outCount
+							*	pixels that are captured go after skipping
+							*	outSkip, nullptr if there are none.
+							*/
+	uint16_t*				NextSpan(
+								uint32_t				inPixels,
+								uint16_t&				outLength,
+								uint16_t&				outSkip,
+								uint16_t&				outCount);
+};
+
+#endif // ScreenCapture_h
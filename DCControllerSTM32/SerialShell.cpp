@@ -0,0 +1,261 @@
+/*
+*	SerialShell.cpp, Copyright Jonathan Mackey 2026
+*	Non-blocking, line oriented serial command interpreter.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "SerialShell.h"
+#include "KeyValueParser.h"
+#include "Profiler.h"
+#include <string.h>
+#ifndef __MACH__
+#include <Arduino.h>
+#endif
+
+/******************************** SerialShell *********************************/
+SerialShell::SerialShell(
+	const SShellCommand*	inCommands,
+	uint8_t					inNumCommands,
+	SerialShellDelegate*	inDelegate,
+	TelemetryTx*			inOutput)
+	: mCommands(inCommands), mNumCommands(inNumCommands),
+	  mDelegate(inDelegate), mOutput(inOutput), mCommand(eNoCommand),
+	  mCommandLine(0), mLineLength(0), mOverflow(false), mOutPending(false),
+	  mArgCount(0), mOutLength(0)
+{
+}
+
+/*********************************** Update ***********************************/
+void SerialShell::Update(void)
+{
+	PROFILE_SCOPE(Shell);
+	/*
+	*	Read what's available up to the end of a line.
+	*/
+	while (mCommand == eNoCommand &&
+		Serial.available() > 0)
+	{
+		char	thisChar = Serial.read();
+		if (thisChar == '\r' || thisChar == '\n')
+		{
+			if (mLineLength || mOverflow)
+			{
+				Execute();
+			}
+		} else if (thisChar == '\b' || thisChar == 0x7F)
+		{
+			if (mLineLength)
+			{
+				mLineLength--;
+			}
+		} else if (mLineLength < eMaxLine)
+		{
+			mLine[mLineLength++] = thisChar;
+		} else
+		{
+			mOverflow = true;
+		}
+	}
+
+	/*
+	*	Produce at most one line of output per call, when there's room for it
+	*	and any line that didn't fit has been queued.
+	*/
+	if (FlushLine() &&
+		mCommand != eNoCommand &&
+		mOutput->Room() >= eMaxOutLine + 2)
+	{
+		bool	more = false;
+		switch (mCommand)
+		{
+			case eHelpCommand:
+				more = Help(mCommandLine);
+				break;
+			case eUnknownCommand:
+				Print("? unknown command ").Print(Arg(0)).EndLine();
+				break;
+			case eLineTooLong:
+				PrintLine("? line too long");
+				break;
+			default:
+				more = mDelegate->ShellCommand(mCommands[mCommand].id, mCommandLine, this);
+				break;
+		}
+		mCommandLine++;
+		if (!more)
+		{
+			mCommand = eNoCommand;
+			mLineLength = 0;
+			mOverflow = false;
+		}
+	}
+}
+
+/*********************************** Execute **********************************/
+/*
+*	Splits the line into arguments in place and looks up the command.
+*/
+void SerialShell::Execute(void)
+{
+	mLine[mLineLength] = 0;
+	mArgCount = 0;
+	mCommandLine = 0;
+	char*	linePtr = mLine;
+	if (*linePtr == '>')
+	{
+		static char	sTimeName[] = "time";
+		mArgs[mArgCount++] = sTimeName;
+		linePtr++;
+	}
+	while (*linePtr && mArgCount < eMaxArgs)
+	{
+		for (; *linePtr == ' ' || *linePtr == '\t'; linePtr++){}
+		if (*linePtr)
+		{
+			mArgs[mArgCount++] = linePtr;
+			for (; *linePtr && *linePtr != ' ' && *linePtr != '\t'; linePtr++){}
+			if (*linePtr)
+			{
+				*(linePtr++) = 0;
+			}
+		}
+	}
+	if (mOverflow)
+	{
+		mCommand = eLineTooLong;
+	} else if (mArgCount == 0)
+	{
+		mLineLength = 0;	// Only whitespace
+	} else if (strcmp(mArgs[0], "help") == 0)
+	{
+		mCommand = eHelpCommand;
+	} else
+	{
+		mCommand = eUnknownCommand;
+		for (uint8_t i = 0; i < mNumCommands; i++)
+		{
+			if (strcmp(mArgs[0], mCommands[i].name) == 0)
+			{
+				mCommand = i;
+				break;
+			}
+		}
+	}
+}
+
+/************************************ Help ************************************/
+bool SerialShell::Help(
+	uint16_t	inLine)
+{
+	if (inLine < mNumCommands)
+	{
+		Print(mCommands[inLine].name).Print(" ").Print(mCommands[inLine].usage).EndLine();
+	}
+	return(inLine + 1 < mNumCommands);
+}
+
+/********************************** ArgUInt32 *********************************/
+bool SerialShell::ArgUInt32(
+	uint8_t		inIndex,
+	uint32_t&	outValue) const
+{
+	return(inIndex < mArgCount &&
+		KeyValueParser::ParseUInt32(mArgs[inIndex], outValue));
+}
+
+/************************************ Print ***********************************/
+SerialShell& SerialShell::Print(
+	const char*	inString)
+{
+	for (; !mOutPending && *inString && mOutLength < eMaxOutLine; inString++)
+	{
+		mOut[mOutLength++] = *inString;
+	}
+	return(*this);
+}
+
+/************************************ Print ***********************************/
+SerialShell& SerialShell::Print(
+	int32_t	inValue)
+{
+	if (inValue < 0)
+	{
+		Print("-");
+		return(PrintUInt(0 - (uint32_t)inValue));
+	}
+	return(PrintUInt((uint32_t)inValue));
+}
+
+/********************************** PrintUInt *********************************/
+SerialShell& SerialShell::PrintUInt(
+	uint32_t	inValue)
+{
+	char	digits[11];
+	char*	digitPtr = &digits[10];
+	*digitPtr = 0;
+	do
+	{
+		*(--digitPtr) = '0' + (inValue % 10);
+		inValue /= 10;
+	} while (inValue);
+	return(Print(digitPtr));
+}
+
+/********************************** PrintHex **********************************/
+SerialShell& SerialShell::PrintHex(
+	uint32_t	inValue)
+{
+	char	digits[9];
+	for (int8_t i = 7; i >= 0; i--)
+	{
+		uint8_t	nibble = inValue & 0xF;
+		digits[i] = nibble < 10 ? ('0' + nibble) : ('A' - 10 + nibble);
+		inValue >>= 4;
+	}
+	digits[8] = 0;
+	return(Print(digits));
+}
+
+/*********************************** EndLine **********************************/
+/*
+*	Only one line can be pending.  A line ended while another is pending
+*	(more than one line in a delegate call) is discarded.
+*/
+void SerialShell::EndLine(void)
+{
+	if (!mOutPending)
+	{
+		mOut[mOutLength++] = '\r';
+		mOut[mOutLength++] = '\n';
+		mOutPending = true;
+		FlushLine();
+	}
+}
+
+/********************************** FlushLine *********************************/
+bool SerialShell::FlushLine(void)
+{
+	if (mOutPending &&
+		mOutput->Write(mOut, mOutLength))
+	{
+		mOutPending = false;
+		mOutLength = 0;
+	}
+	return(!mOutPending);
+}
@@ -0,0 +1,154 @@
+/*
+*	SerialShell.h, Copyright Jonathan Mackey 2026
+*	Non-blocking, line oriented serial command interpreter.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef SerialShell_h
+#define SerialShell_h
+
+#include <inttypes.h>
+#include "TelemetryTx.h"
+
+class SerialShell;
+
+/*
+*	A command table entry.  The table is static (in flash), the id is passed
+*	to the delegate.
+*/
+struct SShellCommand
+{
+	const char*	name;
+	const char*	usage;	// Arguments and description, shown by help
+	uint8_t		id;
+};
+
+class SerialShellDelegate
+{
+public:
+							/*
+							*	Performs command inID.  Called with inLine 0,
+							*	then again with inLine 1, 2... for as long as
+							*	true is returned.  Each call may output at most
+							*	one line (SerialShell::EndLine), the shell makes
+							*	sure there's room for it before each call.  A
+							*	command that also queues other packets should
+							*	print its line on a later call.
+							*/
+	virtual bool			ShellCommand(
+								uint8_t					inID,
+								uint16_t				inLine,
+								SerialShell*			inShell) = 0;
+};
+
+/*
+*	Update() consumes only the bytes already received, so it never waits on
+*	the serial port.  A line is executed when its '\r' or '\n' arrives.  The
+*	line is split on spaces into at most eMaxArgs arguments, argument 0 being
+*	the command name.  Input isn't read while a command is producing output,
+*	it waits in the UART receive buffer.
+*
+*	Responses are queued in the TelemetryTx ring, one line at a time as room
+*	becomes available, so a long response (history) doesn't block the main
+*	loop either.  A line that doesn't fit (the delegate queued other packets
+*	in the same call) is kept and queued before anything else.  Errors start
+*	with "? ".
+*
+*	"help" is built in.  For compatibility with existing scripts, a line
+*	starting with '>' is the command "time" with the rest of the line as its
+*	argument (>65920071.)
+*/
+class SerialShell
+{
+public:
+							SerialShell(
+								const SShellCommand*	inCommands,
+								uint8_t					inNumCommands,
+								SerialShellDelegate*	inDelegate,
+								TelemetryTx*			inOutput);
+							// Call from the main loop.
+	void					Update(void);
+	uint8_t					ArgCount(void) const
+								{return(mArgCount);}
+	const char*				Arg(
+								uint8_t					inIndex) const
+								{return(inIndex < mArgCount ? mArgs[inIndex] : "");}
+							// Decimal or 0x hex, false if missing or invalid.
+	bool					ArgUInt32(
+								uint8_t					inIndex,
+								uint32_t&				outValue) const;
+							/*
+							*	Output, appended to the current line.  The line
+							*	is truncated at eMaxOutLine chars.
+							*/
+	SerialShell&			Print(
+								const char*				inString);
+	SerialShell&			Print(
+								int32_t					inValue);
+	SerialShell&			PrintUInt(
+								uint32_t				inValue);
+	SerialShell&			PrintHex(
+								uint32_t				inValue);
+							/*
+							*	Queues the current line followed by \r\n.  If
+							*	it doesn't fit, it's kept and queued by Update
+							*	before any further output.
+							*/
+	void					EndLine(void);
+							// Prints inString as a line, e.g. "ok"
+	void					PrintLine(
+								const char*				inString)
+								{Print(inString).EndLine();}
+	enum
+	{
+		eMaxLine		= 64,	// Input
+		eMaxArgs		= 5,
+		eMaxOutLine		= 80
+	};
+protected:
+	enum
+	{
+		eNoCommand		= 0xFF,
+		eHelpCommand	= 0xFE,
+		eUnknownCommand	= 0xFD,	// Errors are reported as commands so they
+		eLineTooLong	= 0xFC	// wait for room like any other output
+	};
+	const SShellCommand*	mCommands;
+	uint8_t					mNumCommands;
+	SerialShellDelegate*	mDelegate;
+	TelemetryTx*			mOutput;
+	uint8_t		mCommand;		// Index of the executing command, or eNoCommand...
+	uint16_t	mCommandLine;	// Next inLine to pass to the delegate
+	uint8_t		mLineLength;
+	bool		mOverflow;		// The input line was too long
+	bool		mOutPending;	// mOut holds an ended line that didn't fit
+	uint8_t		mArgCount;
+	uint8_t		mOutLength;
+	char*		mArgs[eMaxArgs];
+	char		mLine[eMaxLine+1];
+	char		mOut[eMaxOutLine+3];	// + \r\n\0
+
+	void					Execute(void);
+							// Returns true if no ended line is waiting.
+	bool					FlushLine(void);
+	bool					Help(
+								uint16_t				inLine);
+};
+
+#endif // SerialShell_h
@@ -0,0 +1,122 @@
+/*
+*	TelemetryTx.cpp, Copyright Jonathan Mackey 2026
+*	Non-blocking binary telemetry over Serial.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "TelemetryTx.h"
+#ifndef __MACH__
+#include <Arduino.h>
+#endif
+
+/******************************** TelemetryTx *********************************/
+TelemetryTx::TelemetryTx(void)
+	: mHead(0), mTail(0), mDivisor(0), mSampleCount(0), mSeq(0),
+	  mDroppedFrames(0)
+{
+}
+
+/********************************* SetDivisor *********************************/
+void TelemetryTx::SetDivisor(
+	uint8_t		inDivisor,
+	uint16_t	inUpdatePeriod)
+{
+	mDivisor = inDivisor;
+	mSampleCount = 0;
+	Telemetry::SInfo	info = {Telemetry::kVersion, inDivisor, inUpdatePeriod};
+	uint8_t	payload[Telemetry::eInfoSize];
+	Queue(Telemetry::eInfoPacket, payload, Telemetry::PackInfo(info, payload));
+}
+
+/********************************* AddSample **********************************/
+void TelemetryTx::AddSample(
+	const Telemetry::SSample&	inSample)
+{
+	if (mDivisor)
+	{
+		mSampleCount++;
+		if (mSampleCount >= mDivisor)
+		{
+			mSampleCount = 0;
+			uint8_t	payload[Telemetry::eSampleSize];
+			Queue(Telemetry::eSamplePacket, payload, Telemetry::PackSample(inSample, payload));
+		}
+	}
+}
+
+/*********************************** Queue ************************************/
+void TelemetryTx::Queue(
+	uint8_t			inType,
+	const uint8_t*	inPayload,
+	uint8_t			inLength)
+{
+	uint8_t	frame[Telemetry::eMaxFrame];
+	uint8_t	frameLength = Telemetry::EncodeFrame(inType, mSeq++, inPayload, inLength, frame);
+	if (!Write(frame, frameLength))
+	{
+		mDroppedFrames++;
+	}
+}
+
+/*********************************** Write ************************************/
+/*
+*	One byte of the ring is left unused so a full ring isn't mistaken for
+*	empty.
+*/
+bool TelemetryTx::Write(
+	const void*	inData,
+	uint16_t	inLength)
+{
+	bool	success = inLength <= Room();
+	if (success)
+	{
+		const uint8_t*	data = (const uint8_t*)inData;
+		for (uint16_t i = 0; i < inLength; i++)
+		{
+			mRing[mTail] = data[i];
+			mTail = (mTail + 1) & (eRingSize - 1);
+		}
+	}
+	return(success);
+}
+
+/*********************************** Update ***********************************/
+void TelemetryTx::Update(void)
+{
+	if (mHead != mTail)
+	{
+		int	room = Serial.availableForWrite();
+		while (room > 0 && mHead != mTail)
+		{
+			/*
+			*	Write the contiguous span up to the end of the ring or the
+			*	tail, whichever comes first.
+			*/
+			uint16_t	end = mTail > mHead ? mTail : eRingSize;
+			uint16_t	length = end - mHead;
+			if (length > (uint16_t)room)
+			{
+				length = room;
+			}
+			Serial.write(&mRing[mHead], length);
+			mHead = (mHead + length) & (eRingSize - 1);
+			room -= length;
+		}
+	}
+}
@@ -0,0 +1,92 @@
+/*
+*	TelemetryTx.h, Copyright Jonathan Mackey 2026
+*	Non-blocking binary telemetry over Serial.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef TelemetryTx_h
+#define TelemetryTx_h
+
+#include <inttypes.h>
+#include "Telemetry.h"
+
+/*
+*	Frames (see Telemetry.h) are queued in a ring buffer.  Update() moves
+*	only as many bytes to Serial as its transmit buffer has room for, so
+*	neither queueing nor sending ever waits on the UART.  When the ring
+*	doesn't have room for a whole frame the frame is dropped and counted
+*	(the receiver sees the gap in seq.)
+*
+*	The rate is a divisor of the sensor update rate: 1 sends every sample,
+*	n every nth, 0 is off (the default.)
+*
+*	The serial shell queues its responses with Write() so text and frames
+*	are never interleaved on the wire.
+*/
+class TelemetryTx
+{
+public:
+							TelemetryTx(void);
+							// Also sends an info packet with the new rate.
+	void					SetDivisor(
+								uint8_t					inDivisor,
+								uint16_t				inUpdatePeriod);
+	uint8_t					Divisor(void) const
+								{return(mDivisor);}
+							// Call after every sensor update.
+	void					AddSample(
+								const Telemetry::SSample&	inSample);
+							/*
+							*	Queues inLength bytes, all or nothing.  Returns
+							*	false if there isn't room.
+							*/
+	bool					Write(
+								const void*				inData,
+								uint16_t				inLength);
+							// Bytes that can be queued.
+	uint16_t				Room(void) const
+								{return((mHead - mTail - 1) & (eRingSize - 1));}
+							// Call from the main loop.
+	void					Update(void);
+	uint32_t				DroppedFrames(void) const
+								{return(mDroppedFrames);}
+							/*
+							*	Queues a packet of any type.  Check that Room()
+							*	is at least Telemetry::eMaxFrame first to avoid
+							*	dropping it.
+							*/
+	void					Queue(
+								uint8_t					inType,
+								const uint8_t*			inPayload,
+								uint8_t					inLength);
+protected:
+	enum
+	{
+		eRingSize	= 256	// Power of 2, about six sample frames
+	};
+	uint8_t		mRing[eRingSize];
+	uint16_t	mHead;			// Next byte to send
+	uint16_t	mTail;			// Next byte to queue
+	uint8_t		mDivisor;
+	uint8_t		mSampleCount;	// Samples since the last one sent
+	uint8_t		mSeq;
+	uint32_t	mDroppedFrames;
+};
+
+#endif // TelemetryTx_h
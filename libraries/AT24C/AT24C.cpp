@@ -23,13 +23,17 @@
 
 #include "Arduino.h"
 #include "AT24C.h"
+#include "USPeriod.h"
+#include "Profiler.h"
 #include <Wire.h>
+#include <string.h>
 
 /*********************************** AT24C ************************************/
 AT24C::AT24C(
 	uint8_t	inDeviceAddress,
 	uint8_t	inCapacity)
-	: mDeviceAddress(inDeviceAddress)
+	: mDeviceAddress(inDeviceAddress), mQueueHead(0), mQueueCount(0),
+	  mPolling(false), mPieceFailed(false), mPollTimeout(10000)	// 10ms
 #ifdef DEBUG_AT24C
 		, mMaxWaitTime(0)
 #endif
@@ -62,6 +66,15 @@ uint16_t AT24C::Read(
 	uint16_t	inLength,
 	uint8_t*	outBuffer)
 {
+	/*
+	*	The chip won't respond while a queued write's write cycle is in
+	*	progress.
+	*/
+	if (mPolling)
+	{
+		WaitTillReady();
+		mPolling = false;
+	}
 	/*
 	*	Setup the AT24C to inDataAddress
 	*/
@@ -88,6 +101,7 @@ uint16_t AT24C::Read(
 			return(0);
 		}
 	}
+	OverlayQueued(inDataAddress, inLength, outBuffer - inLength);
 	return(inLength);
 }
 
@@ -98,23 +112,23 @@ uint16_t AT24C::Read(
 */
 bool AT24C::WaitTillReady(void)
 {
-	uint32_t timeout = micros() + 10000;	// timeout after 10ms
+	USPeriod	timeout(10000);	// timeout after 10ms
+	timeout.Start();
 	do
 	{
-		Wire.beginTransmission(mDeviceAddress);
-		if (Wire.endTransmission(true))
+		if (!Ready())
 		{
 			continue;
 		}
 #ifdef DEBUG_AT24C
-		uint32_t	waitTime = micros() - timeout + 10000;
+		uint32_t	waitTime = timeout.ElapsedTime();
 		if (waitTime > mMaxWaitTime)
 		{
 			mMaxWaitTime = waitTime;
 		}
 #endif
 		return(true);
-	} while (timeout > micros());
+	} while (!timeout.Passed());
 #ifdef DEBUG_AT24C
 	mMaxWaitTime = 10000;
 #endif
@@ -126,6 +140,33 @@ uint16_t AT24C::Write(
 	uint16_t		inDataAddress,
 	uint16_t		inLength,
 	const uint8_t*	inBuffer)
+{
+	Flush();
+	uint16_t	bytesLeft2Write = inLength;
+	while (WaitTillReady() &&
+		bytesLeft2Write)
+	{
+		uint16_t	bytesWritten = WriteChunk(inDataAddress, bytesLeft2Write, inBuffer);
+		if (bytesWritten == 0)
+		{
+			break;
+		}
+		inBuffer += bytesWritten;
+		inDataAddress += bytesWritten;
+		bytesLeft2Write -= bytesWritten;
+	}
+	return(bytesLeft2Write == 0 ? inLength : 0);
+}
+
+/********************************* WriteChunk *********************************/
+/*
+*	Writes as much of inBuffer as a single transaction allows.
+*	Returns the number of bytes written, 0 on failure.
+*/
+uint16_t AT24C::WriteChunk(
+	uint16_t		inDataAddress,
+	uint16_t		inLength,
+	const uint8_t*	inBuffer)
 {
 	/*
 	*	Constraints:
@@ -139,15 +180,25 @@ uint16_t AT24C::Write(
 	// mPageSize -1 results in one of 0x1F, 0x3F, 0x7F, 0xFF.  This value is
 	// used as a mask to determine the bytes left in the current page.
 	uint16_t	bytesLeftInPage = mPageSize - (inDataAddress & (mPageSize -1));
-	uint16_t	bytesLeft2Write = inLength;
-	uint16_t	bytes2Write;
-	while (WaitTillReady() &&
-		bytesLeft2Write)
+	uint16_t	bytes2Write = bytesLeftInPage > 30 ? 30 : bytesLeftInPage;
+	if (bytes2Write > inLength)
+	{
+		bytes2Write = inLength;
+	}
+	Wire.beginTransmission(mDeviceAddress);
+	Wire.write(inDataAddress >> 8);
+	Wire.write(inDataAddress & 0xFF);
+	Wire.write(inBuffer, bytes2Write);
+	/*
+	This was an attempt to continue to write to the eeprom till the page is
+	full and only then end the transmission with a stop.  This doesn't work.
+	
+	while (bytesLeft2Write &&
+		bytesLeftInPage)
 	{
-		bytes2Write = bytesLeftInPage > 30 ? 30 : bytesLeftInPage;
+		Wire.endTransmission(false);
 		Wire.beginTransmission(mDeviceAddress);
-		Wire.write(inDataAddress >> 8);
-		Wire.write(inDataAddress & 0xFF);
+		bytes2Write = bytesLeftInPage > 32 ? 32 : bytesLeftInPage;
 		if (bytes2Write > bytesLeft2Write)
 		{
 			bytes2Write = bytesLeft2Write;
@@ -157,31 +208,151 @@ uint16_t AT24C::Write(
 		inDataAddress += bytes2Write;
 		bytesLeft2Write -= bytes2Write;
 		bytesLeftInPage -= bytes2Write;
-		if (bytesLeftInPage == 0)
+	}*/
+	return(Wire.endTransmission(true) == 0 ? bytes2Write : 0);
+}
+
+/********************************* QueueWrite *********************************/
+bool AT24C::QueueWrite(
+	uint16_t			inDataAddress,
+	uint16_t			inLength,
+	const uint8_t*		inBuffer,
+	AT24CWriteDelegate*	inDelegate)
+{
+	while (inLength)
+	{
+		while (mQueueCount == eQueueSize)
 		{
-			bytesLeftInPage = mPageSize;
+			Update();
 		}
+		SQueuedWrite&	queuedWrite = mQueue[(mQueueHead + mQueueCount) % eQueueSize];
+		uint8_t	length = inLength > eMaxQueuedLength ? (uint8_t)eMaxQueuedLength : (uint8_t)inLength;
+		queuedWrite.address = inDataAddress;
+		queuedWrite.length = length;
+		queuedWrite.written = 0;
+		memcpy(queuedWrite.data, inBuffer, length);
+		inDataAddress += length;
+		inBuffer += length;
+		inLength -= length;
+		// Only the last piece of a split write calls the delegate.
+		queuedWrite.flags = inLength ? eContinues : 0;
+		queuedWrite.delegate = inLength ? nullptr : inDelegate;
+		mQueueCount++;
+	}
+	Update();	// Start writing now rather than on the next loop.
+	return(true);
+}
+
+/*********************************** Update ***********************************/
+void AT24C::Update(void)
+{
+	PROFILE_SCOPE(EEPROMWrite);
+	if (mQueueCount)
+	{
+		SQueuedWrite&	queuedWrite = mQueue[mQueueHead];
 		/*
-		This was an attempt to continue to write to the eeprom till the page is
-		full and only then end the transmission with a stop.  This doesn't work.
-		
-		while (bytesLeft2Write &&
-			bytesLeftInPage)
+		*	The chunk following a successful ACK poll is written on the next
+		*	call so that each call does at most one I2C transaction.
+		*/
+		if (mPolling)
+		{
+			if (Ready())
+			{
+				mPolling = false;
+#ifdef DEBUG_AT24C
+				uint32_t	waitTime = mPollTimeout.ElapsedTime();
+				if (waitTime > mMaxWaitTime)
+				{
+					mMaxWaitTime = waitTime;
+				}
+#endif
+				if (queuedWrite.written >= queuedWrite.length)
+				{
+					CompleteHead(true);
+				}
+			} else if (mPollTimeout.Passed())
+			{
+				mPolling = false;
+				CompleteHead(false);
+			}
+		} else if (queuedWrite.written < queuedWrite.length)
 		{
-			Wire.endTransmission(false);
-			Wire.beginTransmission(mDeviceAddress);
-			bytes2Write = bytesLeftInPage > 32 ? 32 : bytesLeftInPage;
-			if (bytes2Write > bytesLeft2Write)
+			uint16_t	bytesWritten = WriteChunk(queuedWrite.address + queuedWrite.written,
+									queuedWrite.length - queuedWrite.written,
+									&queuedWrite.data[queuedWrite.written]);
+			if (bytesWritten)
+			{
+				queuedWrite.written += bytesWritten;
+				mPolling = true;
+				mPollTimeout.Start();
+			} else
 			{
-				bytes2Write = bytesLeft2Write;
+				CompleteHead(false);
 			}
-			Wire.write(inBuffer, bytes2Write);
-			inBuffer += bytes2Write;
-			inDataAddress += bytes2Write;
-			bytesLeft2Write -= bytes2Write;
-			bytesLeftInPage -= bytes2Write;
-		}*/
-		Wire.endTransmission(true);
+		} else
+		{
+			CompleteHead(true);
+		}
+	}
+}
+
+/******************************** CompleteHead ********************************/
+void AT24C::CompleteHead(
+	bool	inSuccess)
+{
+	SQueuedWrite&	queuedWrite = mQueue[mQueueHead];
+	AT24CWriteDelegate*	delegate = queuedWrite.delegate;
+	bool	success = inSuccess && !mPieceFailed;
+	mPieceFailed = (queuedWrite.flags & eContinues) ? !success : false;
+	mQueueHead = (mQueueHead + 1) % eQueueSize;
+	mQueueCount--;
+	if (delegate)
+	{
+		delegate->WriteComplete(success);
+	}
+}
+
+/*********************************** Flush ************************************/
+void AT24C::Flush(void)
+{
+	while (mQueueCount)
+	{
+		Update();
+	}
+}
+
+/*********************************** Ready ************************************/
+/*
+*	ACK poll.  The chip doesn't ACK its address while its write cycle is in
+*	progress.
+*/
+bool AT24C::Ready(void)
+{
+	Wire.beginTransmission(mDeviceAddress);
+	return(Wire.endTransmission(true) == 0);
+}
+
+/******************************* OverlayQueued ********************************/
+/*
+*	Copies any queued data within the range inDataAddress to
+*	inDataAddress + inLength over ioBuffer, oldest first so the newest wins.
+*/
+void AT24C::OverlayQueued(
+	uint16_t	inDataAddress,
+	uint16_t	inLength,
+	uint8_t*	ioBuffer) const
+{
+	uint32_t	end = (uint32_t)inDataAddress + inLength;
+	for (uint8_t i = 0; i < mQueueCount; i++)
+	{
+		const SQueuedWrite&	queuedWrite = mQueue[(mQueueHead + i) % eQueueSize];
+		uint32_t	qStart = queuedWrite.address;
+		uint32_t	qEnd = qStart + queuedWrite.length;
+		uint32_t	start = qStart > inDataAddress ? qStart : inDataAddress;
+		uint32_t	stop = qEnd < end ? qEnd : end;
+		if (start < stop)
+		{
+			memcpy(&ioBuffer[start - inDataAddress], &queuedWrite.data[start - qStart], stop - start);
+		}
 	}
-	return(bytesLeft2Write == 0 ? inLength : 0);
 }
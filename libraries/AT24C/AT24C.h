@@ -24,9 +24,34 @@
 #ifndef AT24C_H
 #define AT24C_H
 
+#include <inttypes.h>
+#include "USPeriod.h"
+
 // AT24C01A -> C16A aren't supported
 // Only tested with C32, C128, and C256 (32, 64 and 64 byte pages resp.)
 #define DEBUG_AT24C 1
+
+class AT24CWriteDelegate
+{
+public:
+	virtual void			WriteComplete(
+								bool					inSuccess) = 0;
+};
+
+/*
+*	Writes can either be synchronous (Write) or queued (QueueWrite.)
+*
+*	Queued writes are advanced by Update(), which is called from the main
+*	loop.  Each call does at most one I2C transaction: either writing the next
+*	chunk of the current write or a single ACK poll to see if the chip has
+*	finished its internal write cycle.  This avoids the ~5ms busy wait per
+*	page of the synchronous Write.  When all of a queued write has been
+*	written, the delegate (if any) is called.
+*
+*	Read is coherent with queued writes: data still in the queue is copied
+*	over the data read from the chip.  Write flushes the queue first so that
+*	the order of writes is maintained.
+*/
 class AT24C
 {
 public:
@@ -46,6 +71,20 @@ public:
 	*	chip waiting for it to return 0 after it enables itself after writing.
 	*/
 	bool					WaitTillReady(void);
+							/*
+							*	The data is copied so inBuffer doesn't need to
+							*	persist.  Only blocks when the queue is full.
+							*/
+	bool					QueueWrite(
+								uint16_t				inDataAddress,
+								uint16_t				inLength,
+								const uint8_t*			inBuffer,
+								AT24CWriteDelegate*		inDelegate = nullptr);
+	void					Update(void);
+	bool					IsBusy(void) const
+								{return(mQueueCount != 0);}
+							// Blocks till all queued writes have completed.
+	void					Flush(void);
 #ifdef DEBUG_AT24C
 	uint32_t				MaxWaitTime(void)
 								{return(mMaxWaitTime);}
@@ -55,6 +94,39 @@ private:
 	uint8_t		mDeviceAddress;	// 0x50 + N low address bits.
 								// 3 bits for C32 -> C64, 2 bits for C128 -> C512
 	uint16_t	mPageSize;		// Initialized to one of: 32, 64, 128
+	enum
+	{
+		eQueueSize			= 4,
+		eMaxQueuedLength	= 32,	// Longer writes use multiple entries
+		eContinues			= 1		// SQueuedWrite.flags
+	};
+	struct SQueuedWrite
+	{
+		uint16_t			address;
+		uint8_t				length;
+		uint8_t				written;
+		uint8_t				flags;
+		AT24CWriteDelegate*	delegate;
+		uint8_t				data[eMaxQueuedLength];
+	};
+	SQueuedWrite	mQueue[eQueueSize];
+	uint8_t			mQueueHead;
+	uint8_t			mQueueCount;
+	bool			mPolling;		// Waiting for the chip's write cycle
+	bool			mPieceFailed;	// A piece of a split write failed
+	USPeriod		mPollTimeout;
+
+	bool					Ready(void);
+	uint16_t				WriteChunk(
+								uint16_t				inDataAddress,
+								uint16_t				inLength,
+								const uint8_t*			inBuffer);
+	void					CompleteHead(
+								bool					inSuccess);
+	void					OverlayQueued(
+								uint16_t				inDataAddress,
+								uint16_t				inLength,
+								uint8_t*				ioBuffer) const;
 };
 
 #endif
\ No newline at end of file
@@ -22,6 +22,7 @@
 */
 #include "AT24CDataStream.h"
 #include "AT24C.h"
+#include <string.h>
 
 /****************************** AT24CDataStream *******************************/
 AT24CDataStream::AT24CDataStream(
@@ -29,15 +30,130 @@ AT24CDataStream::AT24CDataStream(
 	const void*	inStartAddress,
 	uint32_t	inLength)
 	: DataStreamImpl(inStartAddress, inLength), mAT24C(inAT24C)
+#if AT24C_CACHE_BLOCKS
+	  , mUseCounter(0), mNextSequential(eNoBlock), mHits(0), mMisses(0),
+	  mReadAheads(0)
+#endif
 {
+#if AT24C_CACHE_BLOCKS
+	for (uint8_t i = 0; i < eNumBlocks; i++)
+	{
+		mBlock[i].address = eNoBlock;
+		mBlock[i].lastUsed = 0;
+	}
+#endif
 }
 
+#if AT24C_CACHE_BLOCKS
+/********************************* FindBlock **********************************/
+AT24CDataStream::SBlock* AT24CDataStream::FindBlock(
+	uint16_t	inBlockAddress)
+{
+	for (uint8_t i = 0; i < eNumBlocks; i++)
+	{
+		if (mBlock[i].address == inBlockAddress)
+		{
+			return(&mBlock[i]);
+		}
+	}
+	return(nullptr);
+}
+
+/********************************* LoadBlock **********************************/
+/*
+*	Replaces the least recently used block.  The use counter is 8 bits, the
+*	age is the wrap safe difference from the current count.
+*/
+AT24CDataStream::SBlock* AT24CDataStream::LoadBlock(
+	uint16_t	inBlockAddress)
+{
+	SBlock*	block = &mBlock[0];
+	uint8_t	oldestAge = 0;
+	for (uint8_t i = 0; i < eNumBlocks; i++)
+	{
+		if (mBlock[i].address == eNoBlock)
+		{
+			block = &mBlock[i];
+			break;
+		}
+		uint8_t	age = mUseCounter - mBlock[i].lastUsed;
+		if (age >= oldestAge)
+		{
+			oldestAge = age;
+			block = &mBlock[i];
+		}
+	}
+	if (mAT24C->Read(inBlockAddress, eBlockSize, block->data) == eBlockSize)
+	{
+		block->address = inBlockAddress;
+		block->lastUsed = mUseCounter++;
+	} else
+	{
+		block->address = eNoBlock;
+		block = nullptr;
+	}
+	return(block);
+}
+#endif
+
 /************************************ Read ************************************/
 uint32_t AT24CDataStream::Read(
 	uint32_t	inLength,
 	void*		outBuffer)
 {
-	uint32_t	bytesRead = mAT24C->Read((uint32_t)mCurrent, Clip(inLength), (uint8_t*)outBuffer);
+	uint32_t	bytesRead;
+#if AT24C_CACHE_BLOCKS
+	uint32_t	length = Clip(inLength);
+	if (length < eBlockSize)
+	{
+		uint8_t*	buffer = (uint8_t*)outBuffer;
+		bool		sequential = EEPROMAddress() == mNextSequential;
+		bytesRead = 0;
+		while (bytesRead < length)
+		{
+			uint16_t	address = EEPROMAddress();
+			uint16_t	blockAddress = address & ~(eBlockSize-1);
+			uint16_t	offset = address - blockAddress;
+			SBlock*		block = FindBlock(blockAddress);
+			if (block)
+			{
+				mHits++;
+				block->lastUsed = mUseCounter++;
+			} else
+			{
+				mMisses++;
+				if ((block = LoadBlock(blockAddress)) == nullptr)
+				{
+					break;
+				}
+			}
+			uint32_t	bytesToCopy = eBlockSize - offset;
+			if (bytesToCopy > length - bytesRead)
+			{
+				bytesToCopy = length - bytesRead;
+			}
+			memcpy(&buffer[bytesRead], &block->data[offset], bytesToCopy);
+			bytesRead += bytesToCopy;
+			mCurrent += bytesToCopy;
+			/*
+			*	Read ahead when sequential and past the middle of the block.
+			*	This is done here rather than on the next miss so that the
+			*	block being read isn't the one replaced.
+			*/
+			if (sequential &&
+				offset + bytesToCopy > eBlockSize/2 &&
+				(uint32_t)blockAddress + eBlockSize < (uint32_t)(uintptr_t)mEndAddr &&
+				FindBlock(blockAddress + eBlockSize) == nullptr)
+			{
+				mReadAheads++;
+				LoadBlock(blockAddress + eBlockSize);
+			}
+		}
+		mNextSequential = EEPROMAddress();
+		return(bytesRead);
+	}
+#endif
+	bytesRead = mAT24C->Read(EEPROMAddress(), Clip(inLength), (uint8_t*)outBuffer);
 	mCurrent+=bytesRead;
 	return(bytesRead);
 }
@@ -49,8 +165,31 @@ uint32_t AT24CDataStream::Write(
 {
 	// Space needs to be preallocated via the constructor, the end doesn't
 	// automatically extend.
-	uint32_t	bytesWritten = mAT24C->Write((uint32_t)mCurrent, Clip(inLength), (const uint8_t*)inBuffer);
+	// The write is queued.  Reads via mAT24C see the queued data.
+	uint32_t	bytesWritten = Clip(inLength);
+	uint16_t	address = EEPROMAddress();
+	mAT24C->QueueWrite(address, bytesWritten, (const uint8_t*)inBuffer);
+#if AT24C_CACHE_BLOCKS
+	/*
+	*	Update any cached copy (write through)
+	*/
+	uint32_t	end = (uint32_t)address + bytesWritten;
+	for (uint8_t i = 0; i < eNumBlocks; i++)
+	{
+		SBlock&	block = mBlock[i];
+		if (block.address != eNoBlock)
+		{
+			uint32_t	blockEnd = (uint32_t)block.address + eBlockSize;
+			uint32_t	start = block.address > address ? block.address : address;
+			uint32_t	stop = blockEnd < end ? blockEnd : end;
+			if (start < stop)
+			{
+				memcpy(&block.data[start - block.address],
+					&((const uint8_t*)inBuffer)[start - address], stop - start);
+			}
+		}
+	}
+#endif
 	mCurrent+=bytesWritten;
 	return(bytesWritten);
 }
-
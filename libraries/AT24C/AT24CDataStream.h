@@ -24,8 +24,28 @@
 #define AT24CDataStream_h
 
 #include "DataStream.h"
+#include <stdint.h>
 class AT24C;
 
+/*
+*	Reads are served from a small LRU block cache.  Blocks are aligned to
+*	absolute EEPROM addresses.  On a miss the whole block is read in one
+*	addressed transaction.  When reads are sequential and the read position
+*	passes the middle of a block, the next block is read ahead.  Reads of at
+*	least a block bypass the cache.
+*
+*	Writes update any cached copy of the data (write through), so the cache
+*	never has to be invalidated.
+*
+*	Define AT24C_CACHE_BLOCKS as 0 to remove the cache.
+*/
+#ifndef AT24C_CACHE_BLOCKS
+#define AT24C_CACHE_BLOCKS		2
+#endif
+#ifndef AT24C_CACHE_BLOCK_SIZE
+#define AT24C_CACHE_BLOCK_SIZE	64	// Power of 2
+#endif
+
 class AT24CDataStream : public DataStreamImpl
 {
 public:
@@ -39,8 +59,45 @@ public:
 	virtual uint32_t		Write(
 								uint32_t				inLength,
 								const void*				inBuffer);
+#if AT24C_CACHE_BLOCKS
+	uint32_t				Hits(void) const
+								{return(mHits);}
+	uint32_t				Misses(void) const
+								{return(mMisses);}
+	uint32_t				ReadAheads(void) const
+								{return(mReadAheads);}
+	void					ResetCounters(void)
+								{mHits = mMisses = mReadAheads = 0;}
+#endif
 protected:
 	AT24C*		mAT24C;
+#if AT24C_CACHE_BLOCKS
+	enum
+	{
+		eNumBlocks	= AT24C_CACHE_BLOCKS,
+		eBlockSize	= AT24C_CACHE_BLOCK_SIZE,
+		eNoBlock	= 0xFFFF
+	};
+	struct SBlock
+	{
+		uint16_t	address;	// eNoBlock when empty
+		uint8_t		lastUsed;	// For LRU, compared against mUseCounter
+		uint8_t		data[eBlockSize];
+	};
+	SBlock		mBlock[eNumBlocks];
+	uint8_t		mUseCounter;
+	uint16_t	mNextSequential;	// Address following the last read
+	uint32_t	mHits;
+	uint32_t	mMisses;
+	uint32_t	mReadAheads;
+
+	SBlock*					FindBlock(
+								uint16_t				inBlockAddress);
+	SBlock*					LoadBlock(
+								uint16_t				inBlockAddress);
+#endif
+	inline uint16_t			EEPROMAddress(void) const
+								{return((uint16_t)(uintptr_t)mCurrent);}
 };
 
 #endif // AT24CDataStream_h
\ No newline at end of file
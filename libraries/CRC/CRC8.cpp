@@ -0,0 +1,42 @@
+/*
+*	CRC8.cpp, Copyright Jonathan Mackey 2026
+*	CRC-8 (poly 0x07, init 0x00)
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "CRC8.h"
+
+/************************************ Calc ************************************/
+uint8_t CRC8::Calc(
+	const void*	inBuffer,
+	uint32_t	inLength,
+	uint8_t		inCRC)
+{
+	const uint8_t*	buffer = (const uint8_t*)inBuffer;
+	uint8_t	crc = inCRC;
+	for (; inLength; inLength--)
+	{
+		crc ^= *(buffer++);
+		for (uint8_t bit = 8; bit; bit--)
+		{
+			crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1);
+		}
+	}
+	return(crc);
+}
@@ -0,0 +1,42 @@
+/*
+*	CRC8.h, Copyright Jonathan Mackey 2026
+*	CRC-8 (poly 0x07, init 0x00)
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef CRC8_h
+#define CRC8_h
+
+#include <inttypes.h>
+
+class CRC8
+{
+public:
+	static const uint8_t	kInitialValue = 0;
+							/*
+							*	Pass the returned value back in as inCRC to
+							*	continue the CRC over multiple buffers.
+							*/
+	static uint8_t			Calc(
+								const void*				inBuffer,
+								uint32_t				inLength,
+								uint8_t					inCRC = kInitialValue);
+};
+
+#endif // CRC8_h
@@ -0,0 +1,137 @@
+/*
+*	FileDataStream.cpp, Copyright Jonathan Mackey 2026
+*	Host only (__MACH__) data stream backed by a file.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "FileDataStream.h"
+#ifdef __MACH__
+
+/******************************* FileDataStream *******************************/
+FileDataStream::FileDataStream(
+	const char*	inPath,
+	uint32_t	inLength)
+	: mFile(nullptr), mPos(0), mLength(inLength)
+{
+	mFile = fopen(inPath, "r+b");
+	if (!mFile)
+	{
+		mFile = fopen(inPath, "w+b");
+	}
+	if (mFile)
+	{
+		fseek(mFile, 0, SEEK_END);
+		long	fileLength = ftell(mFile);
+		for (; fileLength < (long)inLength; fileLength++)
+		{
+			fputc(0xFF, mFile);
+		}
+		fflush(mFile);
+	}
+}
+
+/****************************** ~FileDataStream ******************************/
+FileDataStream::~FileDataStream(void)
+{
+	if (mFile)
+	{
+		fclose(mFile);
+	}
+}
+
+/************************************ Read ************************************/
+uint32_t FileDataStream::Read(
+	uint32_t	inLength,
+	void*		outBuffer)
+{
+	uint32_t	bytesRead = 0;
+	if (mFile)
+	{
+		fseek(mFile, mPos, SEEK_SET);
+		bytesRead = (uint32_t)fread(outBuffer, 1, Clip(inLength), mFile);
+		mPos += bytesRead;
+	}
+	return(bytesRead);
+}
+
+/*********************************** Write ************************************/
+/*
+*	Each write is flushed so that a process killed mid sequence leaves the
+*	file in the same state the EEPROM would be in after a power failure.
+*/
+uint32_t FileDataStream::Write(
+	uint32_t	inLength,
+	const void*	inBuffer)
+{
+	uint32_t	bytesWritten = 0;
+	if (mFile)
+	{
+		fseek(mFile, mPos, SEEK_SET);
+		bytesWritten = (uint32_t)fwrite(inBuffer, 1, Clip(inLength), mFile);
+		fflush(mFile);
+		mPos += bytesWritten;
+	}
+	return(bytesWritten);
+}
+
+/************************************ Seek ************************************/
+bool FileDataStream::Seek(
+	int32_t		inOffset,
+	EOrigin		inOrigin)
+{
+	int64_t	newPos;
+	switch (inOrigin)
+	{
+		case eSeekSet:
+			newPos = inOffset;
+			break;
+		case eSeekCur:
+			newPos = (int64_t)mPos + inOffset;
+			break;
+		default:
+			newPos = (int64_t)mLength + inOffset;
+			break;
+	}
+	bool success = newPos >= 0 && newPos <= mLength;
+	if (success)
+	{
+		mPos = (uint32_t)newPos;
+	}
+	return(success);
+}
+
+/*********************************** GetPos ***********************************/
+uint32_t FileDataStream::GetPos(void) const
+{
+	return(mPos);
+}
+
+/*********************************** AtEOF ************************************/
+bool FileDataStream::AtEOF(void) const
+{
+	return(mPos >= mLength);
+}
+
+/************************************ Clip ************************************/
+uint32_t FileDataStream::Clip(
+	uint32_t	inLength) const
+{
+	return((mPos + inLength) <= mLength ? inLength : mLength - mPos);
+}
+#endif // __MACH__
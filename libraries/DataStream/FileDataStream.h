@@ -0,0 +1,64 @@
+/*
+*	FileDataStream.h, Copyright Jonathan Mackey 2026
+*	Host only (__MACH__) data stream backed by a file.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef FileDataStream_h
+#define FileDataStream_h
+
+#ifdef __MACH__
+#include "DataStream.h"
+#include <stdio.h>
+
+/*
+*	Stands in for an EEPROM backed stream (e.g. AT24CDataStream) on the host.
+*	Like AT24CDataStream the length is fixed by the constructor.  If the file
+*	is shorter than inLength it's extended with 0xFF, the value of erased
+*	EEPROM.
+*/
+class FileDataStream : public DataStream
+{
+public:
+							FileDataStream(
+								const char*				inPath,
+								uint32_t				inLength);
+	virtual					~FileDataStream(void);
+	bool					IsOpen(void) const
+								{return(mFile != nullptr);}
+	virtual uint32_t		Read(
+								uint32_t				inLength,
+								void*					outBuffer);
+	virtual uint32_t		Write(
+								uint32_t				inLength,
+								const void*				inBuffer);
+	virtual bool			Seek(
+								int32_t					inOffset,
+								EOrigin					inOrigin);
+	virtual uint32_t		GetPos(void) const;
+	virtual bool			AtEOF(void) const;
+	virtual uint32_t		Clip(
+								uint32_t				inLength) const;
+protected:
+	FILE*		mFile;
+	uint32_t	mPos;
+	uint32_t	mLength;
+};
+#endif // __MACH__
+#endif // FileDataStream_h
@@ -21,6 +21,7 @@
 *
 */
 #include "DisplayController.h"
+#include "DisplayT.h"
 #include "DataStream.h"
 #ifndef __MACH__
 #include <Arduino.h>
@@ -28,6 +29,12 @@
 #include <iostream>
 #endif
 
+alignas(4) static uint8_t	sScratchBuffer[DISPLAY_SCRATCH_SIZE];
+ScratchArena	DisplayController::sScratch(sScratchBuffer, sizeof(sScratchBuffer));
+#ifdef DISPLAY_STATIC_DRIVER
+DisplayController*	DisplayController::sStaticDisplay;
+#endif
+
 
 /***************************** DisplayController ******************************/
 DisplayController::DisplayController(
@@ -177,23 +184,14 @@ void DisplayController::FillBlock(
 	uint16_t	inColumns,
 	uint16_t	inFillColor)
 {
-	if ((inColumns+mColumn) >= mColumns)
-	{
-		inColumns = mColumns - mColumn;
-	}
-	if ((inRows+mRow) >= mRows)
+#ifdef DISPLAY_STATIC_DRIVER
+	if (StaticDisplay::Is(this))
 	{
-		inRows = mRows - mRow;
-	}
-	if (inColumns && inRows)
+		StaticDisplay(this).FillBlock(inRows, inColumns, inFillColor);
+	} else
+#endif
 	{
-		SetColumnRange(inColumns);
-		// The column index will wrap back to the starting point.
-		// The page won't so it needs to be reset.
-		FillPixels((uint32_t)inRows * inColumns, inFillColor);
-		//SetColumnRange(0, mColumns-1);	// Remove the column range clipping
-		//MoveToRow(mRow);	// Leave the page unchanged
-		MoveColumnBy(inColumns); // Advance by inColumns (or wrap to zero if at or past end)
+		DisplayT<DisplayController>(this).FillBlock(inRows, inColumns, inFillColor);
 	}
 }
 
@@ -205,8 +203,15 @@ void DisplayController::FillRect(
 	uint16_t	inHeight,
 	uint16_t	inFillColor)
 {
-	MoveTo(inY, inX);
-	FillBlock(inHeight, inWidth, inFillColor);
+#ifdef DISPLAY_STATIC_DRIVER
+	if (StaticDisplay::Is(this))
+	{
+		StaticDisplay(this).FillRect(inX, inY, inWidth, inHeight, inFillColor);
+	} else
+#endif
+	{
+		DisplayT<DisplayController>(this).FillRect(inX, inY, inWidth, inHeight, inFillColor);
+	}
 }
 
 /******************************* FillTintedRect *******************************/
@@ -217,8 +222,7 @@ void DisplayController::FillTintedRect(
 	uint16_t	inHeight,
 	uint8_t		inTint)
 {
-	MoveTo(inY, inX);
-	FillBlock(inHeight, inWidth, Calc565Color(inTint));
+	FillRect(inX, inY, inWidth, inHeight, Calc565Color(inTint));
 }
 
 /********************************* FillRect8 **********************************/
@@ -272,18 +276,15 @@ void DisplayController::DrawFrame(
 	uint16_t	inColor,
 	uint8_t		inThickness)
 {
-	MoveTo(inY, inX);
-	SetColumnRange(inWidth);
-	FillPixels(inWidth * inThickness, inColor);
-	MoveToRow(inY+inHeight-inThickness);
-	SetColumnRange(inWidth);
-	FillPixels(inWidth * inThickness, inColor);
-	MoveToRow(inY+inThickness);
-	SetColumnRange(inThickness);
-	FillPixels((inHeight-(inThickness*2)) * inThickness, inColor);
-	MoveToColumn(inX + inWidth - inThickness);
-	SetColumnRange(inThickness);
-	FillPixels((inHeight-(inThickness*2)) * inThickness, inColor);
+#ifdef DISPLAY_STATIC_DRIVER
+	if (StaticDisplay::Is(this))
+	{
+		StaticDisplay(this).DrawFrame(inX, inY, inWidth, inHeight, inColor, inThickness);
+	} else
+#endif
+	{
+		DisplayT<DisplayController>(this).DrawFrame(inX, inY, inWidth, inHeight, inColor, inThickness);
+	}
 }
 
 /****************************** DrawTintedFrame *******************************/
@@ -1265,34 +1266,16 @@ bool DisplayController::StreamCopyBlock(
 	uint16_t		inRows,
 	uint16_t		inColumns)
 {
-	bool	success = WillFit(inRows, inColumns);
-	if (success)
+	bool	success;
+#ifdef DISPLAY_STATIC_DRIVER
+	if (StaticDisplay::Is(this))
 	{
-		uint16_t	pixelsToCopy = inRows * inColumns;
-		if (pixelsToCopy)
-		{
-			if (mAddressingMode == eHorizontal)
-			{
-				SetColumnRange(inColumns);
-				// The column index will wrap back to the starting point.
-				// The page won't so it needs to be reset.
-				StreamCopy(inDataStream, pixelsToCopy);
-				SetColumnRange(0, mColumns-1);	// Remove the column range clipping
-				MoveToRow(mRow);	// Leave the page unchanged
-				MoveColumnBy(inColumns); // Advance by inColumns (or wrap to zero if at or past end)
-			} else
-			{
-				MoveToRow(mRow);	// Leave the page unchanged
-				SetRowRange(inRows);
-				// The row index will wrap back to the starting point.
-				// The column won't so it needs to be reset.
-				StreamCopy(inDataStream, pixelsToCopy);
-				MoveToRow(mRow);	// Leave the page unchanged
-				MoveColumnBy(inColumns); // Advance by inColumns (or wrap to zero if at or past end)
-			}
-		}
+		success = StaticDisplay(this).CopyStreamBlock(inDataStream, inRows, inColumns);
+	} else
+#endif
+	{
+		success = DisplayT<DisplayController>(this).CopyStreamBlock(inDataStream, inRows, inColumns);
 	}
-	
 	return(success);
 }
 
@@ -24,6 +24,23 @@
 #define DisplayController_h
 
 #include "PlatformDefs.h"
+#include "ScratchArena.h"
+
+/*
+*	The size of the scratch arena shared by the display controllers.  The
+*	largest user is FilterStatusGauge::DrawGauge, 1810 bytes for a 320 pixel
+*	radius, plus 288 bytes for the TFT_ILI9488 conversion buffer it draws
+*	through.  The measured peak (the memory shell command) is 2098.  A
+*	larger gauge needs a larger arena, it isn't drawn if the arena is too
+*	small (counted as a failure.)  The AVR displays don't use it.
+*/
+#ifndef DISPLAY_SCRATCH_SIZE
+#ifdef __AVR__
+#define DISPLAY_SCRATCH_SIZE	4
+#else
+#define DISPLAY_SCRATCH_SIZE	2100
+#endif
+#endif
 
 class DataStream;
 
@@ -322,6 +339,12 @@ public:
 								int32_t&				ioA,
 								int32_t&				ioB)
 							{int32_t	tmp = ioA; ioA = ioB; ioB = tmp;}
+							/*
+							*	Temporaries used while drawing, in place of
+							*	stack arrays.  See ScratchArena.
+							*/
+	static inline ScratchArena&	Scratch(void)
+								{return(sScratch);}
 #ifdef __MACH__
 	static int32_t			map(
 								int32_t 				x,
@@ -338,6 +361,12 @@ protected:
 	EAddressingMode	mAddressingMode;
 	uint16_t	mFGColor;
 	uint16_t	mBGColor;
+	static ScratchArena	sScratch;
+#ifdef DISPLAY_STATIC_DRIVER
+	static DisplayController*	sStaticDisplay;	// See DisplayT.h
+	friend class StaticDisplay;
+#endif
+	template <class Driver> friend class DisplayT;
 };
 
 #endif // DisplayController_h
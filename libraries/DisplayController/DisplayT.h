@@ -0,0 +1,287 @@
+/*
+*	DisplayT.h, Copyright Jonathan Mackey 2026
+*	Statically dispatched facade of a display controller.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef DisplayT_h
+#define DisplayT_h
+
+#include "DisplayController.h"
+
+/*
+*	DisplayT<Driver> draws to a display through a Driver*.  When Driver is a
+*	display controller class declared final (TFT_ILI9488) the compiler calls
+*	its MoveTo, SetColumnRange, FillPixels, StreamCopy... directly rather
+*	than through the vtable.  DisplayT<DisplayController> is the virtual path,
+*	used for any display.
+*
+*	The primitives built on those calls (FillBlock, FillRect, DrawFrame,
+*	StreamCopyBlock...) are defined here once, for both paths.  The
+*	DisplayController versions are DisplayT<DisplayController>, or
+*	DisplayT<DISPLAY_STATIC_DRIVER> when drawing to the static display.
+*
+*	A DisplayT is a pointer, pass it by value.
+*/
+template <class Driver>
+class DisplayT
+{
+public:
+	explicit				DisplayT(
+								Driver*					inDriver)
+								: mDriver(inDriver){}
+	inline Driver*			GetDriver(void) const
+								{return(mDriver);}
+	inline uint8_t			BitsPerPixel(void) const
+								{return(mDriver->BitsPerPixel());}
+	inline uint16_t			GetRow(void) const
+								{return(mDriver->mRow);}
+	inline uint16_t			GetColumn(void) const
+								{return(mDriver->mColumn);}
+	inline uint16_t			GetRows(void) const
+								{return(mDriver->mRows);}
+	inline uint16_t			GetColumns(void) const
+								{return(mDriver->mColumns);}
+	inline bool				CanMoveTo(
+								uint16_t				inRow,
+								uint16_t				inColumn) const
+								{return(mDriver->CanMoveTo(inRow, inColumn));}
+	inline bool				WillFit(
+								uint16_t				inRows,
+								uint16_t				inColumns) const
+								{return(mDriver->WillFit(inRows, inColumns));}
+	inline int32_t			ClipX(
+								int32_t&				ioXCoord,
+								int32_t&				ioWidth) const
+								{return(mDriver->ClipX(ioXCoord, ioWidth));}
+	inline void				MoveTo(
+								uint16_t				inRow,
+								uint16_t				inColumn) const
+								{mDriver->MoveTo(inRow, inColumn);}
+	inline void				MoveToRow(
+								uint16_t				inRow) const
+								{mDriver->MoveToRow(inRow);}
+	inline void				MoveToColumn(
+								uint16_t				inColumn) const
+								{mDriver->MoveToColumn(inColumn);}
+	inline void				FillPixels(
+								uint32_t				inPixelsToFill,
+								uint16_t				inFillColor) const
+								{mDriver->FillPixels(inPixelsToFill, inFillColor);}
+	inline void				SetColumnRange(
+								uint16_t				inStartColumn,
+								uint16_t				inEndColumn) const
+								{mDriver->SetColumnRange(inStartColumn, inEndColumn);}
+	inline void				SetRowRange(
+								uint16_t				inStartRow,
+								uint16_t				inEndRow) const
+								{mDriver->SetRowRange(inStartRow, inEndRow);}
+	inline void				StreamCopy(
+								DataStream*				inDataStream,
+								uint16_t				inPixelsToCopy) const
+								{mDriver->StreamCopy(inDataStream, inPixelsToCopy);}
+	inline void				CopyPixels(
+								const void*				inPixels,
+								uint16_t				inPixelsToCopy) const
+								{mDriver->CopyPixels(inPixels, inPixelsToCopy);}
+	inline void				SetAddressingMode(
+								DisplayController::EAddressingMode	inAddressingMode) const
+								{mDriver->SetAddressingMode(inAddressingMode);}
+	/*
+	*	The primitives, see DisplayController.h
+	*/
+	inline void				SetColumnRange(
+								uint16_t				inRelativeWidth) const
+								{SetColumnRange(mDriver->mColumn, mDriver->mColumn + inRelativeWidth-1);}
+	inline void				SetRowRange(
+								uint16_t				inRelativeHeight) const
+								{SetRowRange(mDriver->mRow, mDriver->mRow + inRelativeHeight-1);}
+	void					MoveColumnBy(
+								uint16_t				inMoveBy) const;
+	void					FillBlock(
+								uint16_t				inRows,
+								uint16_t				inColumns,
+								uint16_t				inFillColor) const;
+	inline void				FillRect(
+								uint16_t				inX,
+								uint16_t				inY,
+								uint16_t				inWidth,
+								uint16_t				inHeight,
+								uint16_t				inFillColor) const
+								{MoveTo(inY, inX);
+								 FillBlock(inHeight, inWidth, inFillColor);}
+	inline void				FillTillEndColumn(
+								uint16_t				inRows,
+								uint16_t				inFillColor) const
+								{FillBlock(inRows, mDriver->mColumns, inFillColor);}
+	void					DrawFrame(
+								uint16_t				inX,
+								uint16_t				inY,
+								uint16_t				inWidth,
+								uint16_t				inHeight,
+								uint16_t				inColor,
+								uint8_t					inThickness) const;
+							// Virtual, a driver may override it
+	inline bool				StreamCopyBlock(
+								DataStream*				inDataStream,
+								uint16_t				inRows,
+								uint16_t				inColumns) const
+								{return(mDriver->StreamCopyBlock(inDataStream, inRows, inColumns));}
+							// DisplayController::StreamCopyBlock
+	bool					CopyStreamBlock(
+								DataStream*				inDataStream,
+								uint16_t				inRows,
+								uint16_t				inColumns) const;
+protected:
+	Driver*	mDriver;
+};
+
+/******************************** MoveColumnBy ********************************/
+// Resets to zero on wrap.  Does not affect the row (page)
+template <class Driver>
+void DisplayT<Driver>::MoveColumnBy(
+	uint16_t	inMoveBy) const
+{
+	uint16_t	newColumn = mDriver->mColumn + inMoveBy;
+	if (newColumn >= mDriver->mColumns)
+	{
+		newColumn = 0;
+	}
+	MoveToColumn(newColumn);
+}
+
+/********************************* FillBlock **********************************/
+template <class Driver>
+void DisplayT<Driver>::FillBlock(
+	uint16_t	inRows,
+	uint16_t	inColumns,
+	uint16_t	inFillColor) const
+{
+	if ((inColumns+mDriver->mColumn) >= mDriver->mColumns)
+	{
+		inColumns = mDriver->mColumns - mDriver->mColumn;
+	}
+	if ((inRows+mDriver->mRow) >= mDriver->mRows)
+	{
+		inRows = mDriver->mRows - mDriver->mRow;
+	}
+	if (inColumns && inRows)
+	{
+		SetColumnRange(inColumns);
+		// The column index will wrap back to the starting point.
+		// The page won't so it needs to be reset.
+		FillPixels((uint32_t)inRows * inColumns, inFillColor);
+		MoveColumnBy(inColumns); // Advance by inColumns (or wrap to zero if at or past end)
+	}
+}
+
+/********************************* DrawFrame **********************************/
+template <class Driver>
+void DisplayT<Driver>::DrawFrame(
+	uint16_t	inX,
+	uint16_t	inY,
+	uint16_t	inWidth,
+	uint16_t	inHeight,
+	uint16_t	inColor,
+	uint8_t		inThickness) const
+{
+	MoveTo(inY, inX);
+	SetColumnRange(inWidth);
+	FillPixels(inWidth * inThickness, inColor);
+	MoveToRow(inY+inHeight-inThickness);
+	SetColumnRange(inWidth);
+	FillPixels(inWidth * inThickness, inColor);
+	MoveToRow(inY+inThickness);
+	SetColumnRange(inThickness);
+	FillPixels((inHeight-(inThickness*2)) * inThickness, inColor);
+	MoveToColumn(inX + inWidth - inThickness);
+	SetColumnRange(inThickness);
+	FillPixels((inHeight-(inThickness*2)) * inThickness, inColor);
+}
+
+/****************************** CopyStreamBlock *******************************/
+template <class Driver>
+bool DisplayT<Driver>::CopyStreamBlock(
+	DataStream*	inDataStream,
+	uint16_t	inRows,
+	uint16_t	inColumns) const
+{
+	bool	success = WillFit(inRows, inColumns);
+	if (success)
+	{
+		uint16_t	pixelsToCopy = inRows * inColumns;
+		if (pixelsToCopy)
+		{
+			if (mDriver->mAddressingMode == DisplayController::eHorizontal)
+			{
+				SetColumnRange(inColumns);
+				// The column index will wrap back to the starting point.
+				// The page won't so it needs to be reset.
+				StreamCopy(inDataStream, pixelsToCopy);
+				SetColumnRange(0, mDriver->mColumns-1);	// Remove the column range clipping
+				MoveToRow(mDriver->mRow);	// Leave the page unchanged
+				MoveColumnBy(inColumns); // Advance by inColumns (or wrap to zero if at or past end)
+			} else
+			{
+				MoveToRow(mDriver->mRow);	// Leave the page unchanged
+				SetRowRange(inRows);
+				// The row index will wrap back to the starting point.
+				// The column won't so it needs to be reset.
+				StreamCopy(inDataStream, pixelsToCopy);
+				MoveToRow(mDriver->mRow);	// Leave the page unchanged
+				MoveColumnBy(inColumns); // Advance by inColumns (or wrap to zero if at or past end)
+			}
+		}
+	}
+	return(success);
+}
+
+/*
+*	When DISPLAY_STATIC_DRIVER names the display controller class the
+*	application draws to (e.g. -DDISPLAY_STATIC_DRIVER=TFT_ILI9488) the
+*	display passed to StaticDisplay::Select is drawn to through StaticDisplay
+*	by the DisplayController primitives and XFont.  The class must be final
+*	and declared in a header of the same name.  Other displays of the same
+*	build (ScreenCapture) are still drawn to through the vtable.
+*	Undefined, every display is drawn to through the vtable.
+*/
+#ifdef DISPLAY_STATIC_DRIVER
+#define DISPLAY_STATIC_STR(inName)		#inName
+#define DISPLAY_STATIC_HEADER(inName)	DISPLAY_STATIC_STR(inName.h)
+#include DISPLAY_STATIC_HEADER(DISPLAY_STATIC_DRIVER)
+
+class StaticDisplay : public DisplayT<DISPLAY_STATIC_DRIVER>
+{
+public:
+							// inDisplay must be the selected display, see Is()
+	explicit				StaticDisplay(
+								DisplayController*		inDisplay)
+								: DisplayT<DISPLAY_STATIC_DRIVER>(
+									static_cast<DISPLAY_STATIC_DRIVER*>(inDisplay)){}
+							// True if inDisplay is the selected display
+	static inline bool		Is(
+								const DisplayController*	inDisplay)
+								{return(inDisplay == DisplayController::sStaticDisplay);}
+	static inline void		Select(
+								DISPLAY_STATIC_DRIVER*	inDisplay)
+								{DisplayController::sStaticDisplay = inDisplay;}
+};
+#endif
+
+#endif // DisplayT_h
@@ -40,6 +40,7 @@
 		typedef int8_t pin_t;
 	#endif
 #else
+typedef int32_t pin_t;
 #ifndef memcpy_P
 	#define memcpy_P memcpy
 #endif
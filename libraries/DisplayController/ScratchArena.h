@@ -0,0 +1,148 @@
+/*
+*	ScratchArena.h, Copyright Jonathan Mackey 2026
+*	Bump allocator for drawing temporaries.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef ScratchArena_h
+#define ScratchArena_h
+
+#include <inttypes.h>
+#include <stddef.h>
+
+/*
+*	A typed view of memory allocated from a ScratchArena.  An empty span (the
+*	allocation failed) is false.
+*/
+template <class T>
+class Span
+{
+public:
+							Span(void)
+								: mData(nullptr), mSize(0){}
+							Span(
+								T*						inData,
+								uint32_t				inSize)
+								: mData(inData), mSize(inSize){}
+	inline T*				Data(void) const
+								{return(mData);}
+	inline uint32_t			Size(void) const
+								{return(mSize);}
+	inline T&				operator[](
+								uint32_t				inIndex) const
+								{return(mData[inIndex]);}
+	inline T*				begin(void) const
+								{return(mData);}
+	inline T*				end(void) const
+								{return(mData + mSize);}
+	explicit inline			operator bool(void) const
+								{return(mData != nullptr);}
+protected:
+	T*			mData;
+	uint32_t	mSize;
+};
+
+/*
+*	Allocations are taken from the top of a fixed buffer and released in
+*	reverse order by Frame, a scope that restores the top when it exits.
+*	A drawing routine opens a Frame before allocating, so everything it and
+*	the routines it calls allocated is released when it returns.  Nothing is
+*	allocated between top level draws.
+*
+*	An allocation that doesn't fit returns an empty span and is counted by
+*	Failures().  Peak() is the most ever allocated at once, used to size the
+*	buffer (DISPLAY_SCRATCH_SIZE.)
+*/
+class ScratchArena
+{
+public:
+							// constexpr so it's initialized before any constructor runs
+	constexpr				ScratchArena(
+								uint8_t*				inBuffer,
+								uint32_t				inCapacity)
+								: mBuffer(inBuffer), mCapacity(inCapacity),
+								  mUsed(0), mPeak(0), mFailures(0){}
+							// inCount Ts or an empty span.
+	template <class T>
+	Span<T>					Allocate(
+								uint32_t				inCount)
+							{
+								return(AllocateUpTo<T>(inCount, inCount));
+							}
+							/*
+							*	As many Ts as are available up to inMaxCount,
+							*	or an empty span if that's less than inMinCount.
+							*	For buffers that work in chunks of any size.
+							*/
+	template <class T>
+	Span<T>					AllocateUpTo(
+								uint32_t				inMaxCount,
+								uint32_t				inMinCount = 1)
+							{
+								Span<T>		span;
+								uint32_t	start = (mUsed + alignof(T) - 1) & ~(uint32_t)(alignof(T) - 1);
+								uint32_t	available = start < mCapacity ?
+												(mCapacity - start) / sizeof(T) : 0;
+								uint32_t	count = inMaxCount < available ? inMaxCount : available;
+								if (count && count >= inMinCount)
+								{
+									span = Span<T>((T*)&mBuffer[start], count);
+									mUsed = start + count * sizeof(T);
+									if (mUsed > mPeak)
+									{
+										mPeak = mUsed;
+									}
+								} else if (inMaxCount)
+								{
+									mFailures++;
+								}
+								return(span);
+							}
+	inline uint32_t			Used(void) const
+								{return(mUsed);}
+	inline uint32_t			Capacity(void) const
+								{return(mCapacity);}
+	inline uint32_t			Peak(void) const
+								{return(mPeak);}
+	inline uint32_t			Failures(void) const
+								{return(mFailures);}
+	void					ResetStats(void)
+								{mPeak = mUsed; mFailures = 0;}
+
+	class Frame
+	{
+	public:
+							Frame(
+								ScratchArena&			inArena)
+								: mArena(inArena), mMark(inArena.mUsed){}
+							~Frame(void)
+								{mArena.mUsed = mMark;}
+	protected:
+		ScratchArena&	mArena;
+		uint32_t		mMark;
+	};
+protected:
+	uint8_t*	mBuffer;
+	uint32_t	mCapacity;
+	uint32_t	mUsed;
+	uint32_t	mPeak;
+	uint32_t	mFailures;
+};
+
+#endif // ScratchArena_h
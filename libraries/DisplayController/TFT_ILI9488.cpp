@@ -23,6 +23,7 @@
 #include <SPI.h>
 #include "TFT_ILI9488.h"
 #include <DataStream.h>
+#include <MemoryStats.h>
 #include "Arduino.h"
 
 // 1 of 32 mapped to 1 of 64.
@@ -168,8 +169,11 @@ void TFT_ILI9488::FillPixels(
 			use3Bit = false;
 			// Note: I tried quadrupling the buffer size from 288 to 1152.
 			//		 The time savings was negligable.
-			uint8_t	buffer[288];	// 96 18-bit pixels (96 = 480/5)
-			const uint32_t	kMaxPixels = sizeof(buffer)/3;
+			ScratchArena::Frame	scratchFrame(Scratch());
+			uint8_t	minBuffer[eMinConversionBuffer];
+			Span<uint8_t>	buffer = ConversionBuffer(minBuffer);
+			const uint32_t	kMaxPixels = buffer.Size()/3;
+			STACK_PROBE(ILI9488FillPixels);
 			uint8_t b = k5To6Bit[(inFillColor >> 11)];
 			uint8_t g = (inFillColor >> 3) & 0xFC;
 			uint8_t r = k5To6Bit[inFillColor & 0x1F];
@@ -183,7 +187,7 @@ void TFT_ILI9488::FillPixels(
 			while (inPixelsToFill)
 			{
 				uint32_t	bufferLen = inPixelsToFill > kMaxPixels ? kMaxPixels : inPixelsToFill;
-				uint8_t*	bufferPtr = buffer;
+				uint8_t*	bufferPtr = buffer.Data();
 				for (uint32_t i = 0; i < bufferLen; i++)
 				{
 					*(bufferPtr++) = b;
@@ -191,7 +195,7 @@ void TFT_ILI9488::FillPixels(
 					*(bufferPtr++) = r;
 				}
 				inPixelsToFill -= bufferLen;
-				SPI.transfer(buffer, bufferLen*3);
+				SPI.transfer(buffer.Data(), bufferLen*3);
 			}
 			EndTransaction();
 			break;
@@ -202,7 +206,14 @@ void TFT_ILI9488::FillPixels(
 		/*
 		*	Optimization for 3-bit pixels.
 		*/
-		uint8_t	buffer[240];	// 480 3-bit pixels
+		ScratchArena::Frame	scratchFrame(Scratch());
+		uint8_t	minBuffer[eMinConversionBuffer];
+		// 240 = 480 3-bit pixels
+		Span<uint8_t>	buffer = Scratch().AllocateUpTo<uint8_t>(240, 3);
+		if (!buffer)
+		{
+			buffer = Span<uint8_t>(minBuffer, sizeof(minBuffer));
+		}
 		bool	oddPixel = (inPixelsToFill & 1) != 0;
 		uint32_t	pixelPairs = inPixelsToFill/2;
 	
@@ -223,7 +234,7 @@ void TFT_ILI9488::FillPixels(
 			buffer[0]=fillColor & 4 ? 0xFC : 0;
 			buffer[1]=fillColor & 2 ? 0xFC : 0;
 			buffer[2]=fillColor & 1 ? 0xFC : 0;
-			SPI.transfer(buffer, 3);
+			SPI.transfer(buffer.Data(), 3);
 		}
 		if (pixelPairs)
 		{
@@ -238,13 +249,13 @@ void TFT_ILI9488::FillPixels(
 			*/
 			while (pixelPairs)
 			{
-				uint32_t	bufferLen = pixelPairs > sizeof(buffer) ? sizeof(buffer) : pixelPairs;
+				uint32_t	bufferLen = pixelPairs > buffer.Size() ? buffer.Size() : pixelPairs;
 				for (uint32_t i = 0; i < bufferLen; i++)
 				{
 					buffer[i] = fillColor;	// Lower 6 bits used (2 pixels)
 				}
 				pixelPairs -= bufferLen;
-				SPI.transfer(buffer, bufferLen);
+				SPI.transfer(buffer.Data(), bufferLen);
 			}
 			WriteCmd(eCOLMODCmd);	// Set Interface Pixel Format
 			SPI.transfer(0x66);		// back to 18-bit
@@ -268,19 +279,41 @@ void TFT_ILI9488::FillPixels(
 #endif
 }
 
+/****************************** ConversionBuffer ******************************/
+Span<uint8_t> TFT_ILI9488::ConversionBuffer(
+	uint8_t*	inMinBuffer)
+{
+	Span<uint8_t>	buffer = Scratch().AllocateUpTo<uint8_t>(eConversionBuffer, 3);
+	if (buffer)
+	{
+		buffer = Span<uint8_t>(buffer.Data(), buffer.Size() - buffer.Size() % 3);
+	} else
+	{
+		buffer = Span<uint8_t>(inMinBuffer, eMinConversionBuffer);
+	}
+	return(buffer);
+}
+
 /******************************** StreamCopy **********************************/
 void TFT_ILI9488::StreamCopy(
 	DataStream* inDataStream,	// A 16 bit data stream
 	uint16_t	inPixelsToCopy)
 {
 	BeginTransaction();
-	uint16_t	buffer[96];	// WritePixelData's buffer holds 96 pixels.
+	ScratchArena::Frame	scratchFrame(Scratch());
+	uint16_t	minBuffer[eMinConversionBuffer/3];
+	// WritePixelData's buffer holds 96 pixels.
+	Span<uint16_t>	buffer = Scratch().AllocateUpTo<uint16_t>(eConversionBuffer/3);
+	if (!buffer)
+	{
+		buffer = Span<uint16_t>(minBuffer, eMinConversionBuffer/3);
+	}
 	while (inPixelsToCopy)
 	{
-		uint16_t pixelsToWrite = inPixelsToCopy > 96 ? 96 : inPixelsToCopy;
+		uint16_t pixelsToWrite = inPixelsToCopy > buffer.Size() ? buffer.Size() : inPixelsToCopy;
 		inPixelsToCopy -= pixelsToWrite;
-		inDataStream->Read(pixelsToWrite, buffer);
-		WritePixelData(buffer, pixelsToWrite);
+		inDataStream->Read(pixelsToWrite, buffer.Data());
+		WritePixelData(buffer.Data(), pixelsToWrite);
 	}
 	EndTransaction();
 }
@@ -316,13 +349,16 @@ void TFT_ILI9488::WritePixelData(
 	if (inDataLen)
 	{
 #if 1
-		uint8_t	buffer[288];	// 96 18-bit pixels (96 = 480/5)
-		const uint32_t	kMaxPixels = sizeof(buffer)/3;
+		ScratchArena::Frame	scratchFrame(Scratch());
+		uint8_t	minBuffer[eMinConversionBuffer];
+		Span<uint8_t>	buffer = ConversionBuffer(minBuffer);
+		const uint32_t	kMaxPixels = buffer.Size()/3;
+		STACK_PROBE(ILI9488WritePixelData);
 
 		while (inDataLen)
 		{
 			uint32_t	bufferLen = inDataLen > kMaxPixels ? kMaxPixels : inDataLen;
-			uint8_t*	bufferPtr = buffer;
+			uint8_t*	bufferPtr = buffer.Data();
 			for (uint32_t i = 0; i < bufferLen; i++)
 			{
 				uint16_t	rbg565Color = *(inPixelData++);
@@ -331,7 +367,7 @@ void TFT_ILI9488::WritePixelData(
 				*(bufferPtr++) = k5To6Bit[rbg565Color & 0x1F];
 			}
 			inDataLen -= bufferLen;
-			SPI.transfer(buffer, bufferLen*3);
+			SPI.transfer(buffer.Data(), bufferLen*3);
 		}
 #else
 	// Least efficient
@@ -25,7 +25,7 @@
 
 #include "TFT_ST77XX.h"
 
-class TFT_ILI9488 : public TFT_ST77XX
+class TFT_ILI9488 final : public TFT_ST77XX
 {
 public:
 							TFT_ILI9488(
@@ -61,6 +61,11 @@ protected:
 		eSETIMGFUNCCmd		= 0xE9,	// Set Image Function
 		eADJCTR3Cmd			= 0xF7	// Adjust Control 3 
 	};
+	enum
+	{
+		eConversionBuffer		= 288,	// 96 18-bit pixels (96 = 480/5)
+		eMinConversionBuffer	= 12	// 4 pixels, used when the arena is full
+	};
 
 	virtual void			Init(void);
 	virtual uint16_t		VerticalRes(void) const
@@ -70,6 +75,13 @@ protected:
 	void					WritePixelData(
 								const uint16_t*			inData,
 								uint16_t				inDataLen) const;
+							/*
+							*	An 18-bit pixel buffer from the scratch arena,
+							*	or inMinBuffer (eMinConversionBuffer bytes) if
+							*	the arena is full.  The size is a multiple of 3.
+							*/
+	static Span<uint8_t>	ConversionBuffer(
+								uint8_t*				inMinBuffer);
 };
 
 #endif // TFT_ILI9488_h
@@ -23,6 +23,7 @@
 #include <SPI.h>
 #include "TFT_ST77XX.h"
 #include <DataStream.h>
+#include <MemoryStats.h>
 #include "Arduino.h"
 
 
@@ -516,51 +517,56 @@ void TFT_ST77XX::CopyTintedPattern(
 	bool			inVertical,
 	bool			inReverseOrder)
 {	
-	uint16_t	colorPattern[inPatternLen];
+	ScratchArena::Frame	scratchFrame(Scratch());
+	Span<uint16_t>	colorPattern = Scratch().Allocate<uint16_t>(inPatternLen);
 	uint8_t		thisTint;
 	uint8_t		lastTint;
 	uint16_t	color = 0;
-	if (inReverseOrder)
+	STACK_PROBE(CopyTintedPattern);
+	if (colorPattern)
 	{
-		const uint8_t*	patternPtr = &inTintPattern[inPatternLen-1];
-		lastTint = *patternPtr + 1;
-		for (uint16_t i = 0; i < inPatternLen; i++)
+		if (inReverseOrder)
 		{
-			thisTint = *(patternPtr--);
-			if (lastTint != thisTint)
+			const uint8_t*	patternPtr = &inTintPattern[inPatternLen-1];
+			lastTint = *patternPtr + 1;
+			for (uint16_t i = 0; i < inPatternLen; i++)
 			{
-				lastTint = thisTint;
-				color = Calc565Color(mFGColor, mBGColor, thisTint);
+				thisTint = *(patternPtr--);
+				if (lastTint != thisTint)
+				{
+					lastTint = thisTint;
+					color = Calc565Color(mFGColor, mBGColor, thisTint);
+				}
+				colorPattern[i] = color;
 			}
-			colorPattern[i] = color;
-		}
-	} else
-	{
-		lastTint = inTintPattern[0] + 1;
-		for (uint16_t i = 0; i < inPatternLen; i++)
+		} else
 		{
-			thisTint = inTintPattern[i];
-			if (lastTint != thisTint)
+			lastTint = inTintPattern[0] + 1;
+			for (uint16_t i = 0; i < inPatternLen; i++)
 			{
-				lastTint = thisTint;
-				color = Calc565Color(mFGColor, mBGColor, thisTint);
+				thisTint = inTintPattern[i];
+				if (lastTint != thisTint)
+				{
+					lastTint = thisTint;
+					color = Calc565Color(mFGColor, mBGColor, thisTint);
+				}
+				colorPattern[i] = color;
 			}
-			colorPattern[i] = color;
 		}
-	}
-	uint16_t	relativeWidth = inVertical ? 1 : inPatternLen;
-	for (uint16_t i = inReps; i; i--)
-	{
-		MoveTo(inY, inX);
-		DisplayController::SetColumnRange(relativeWidth);
-		if (inVertical)
-		{
-			inX++;
-		} else
+		uint16_t	relativeWidth = inVertical ? 1 : inPatternLen;
+		for (uint16_t i = inReps; i; i--)
 		{
-			inY++;
+			MoveTo(inY, inX);
+			DisplayController::SetColumnRange(relativeWidth);
+			if (inVertical)
+			{
+				inX++;
+			} else
+			{
+				inY++;
+			}
+			CopyPixels(colorPattern.Data(), inPatternLen);
 		}
-		CopyPixels(colorPattern, inPatternLen);
 	}
 }
 
@@ -0,0 +1,46 @@
+/*
+*	BinThreshold.h, Copyright Jonathan Mackey 2026
+*	The dust bin motor sense trigger threshold limits.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef BinThreshold_h
+#define BinThreshold_h
+
+#include "PlatformDefs.h"
+
+/*
+*	Used by DustCollectorBase and by the DCSettings schema.  DCSettings is
+*	also built on the host (tools) without the sensor libraries.  The host
+*	uses the STM32 values because the host tools work with the STM32
+*	controller's settings files and traces.
+*/
+namespace BinThreshold
+{
+	const uint8_t	kLowerLimit	= 5;
+#if defined(_STM32_DEF_) || defined(__MACH__)
+	const uint8_t	kDefault	= 100;
+	const uint8_t	kUpperLimit	= 120;
+#else
+	const uint8_t	kDefault	= 15;
+	const uint8_t	kUpperLimit	= 50;
+#endif
+}
+
+#endif // BinThreshold_h
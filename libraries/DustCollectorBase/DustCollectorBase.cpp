@@ -19,23 +19,25 @@
 *	notices in any redistribution of this code.
 *
 */
+#ifndef __MACH__
 #include <Arduino.h>
-#include "DustCollectorBase.h"
 #include "BMP280SPI.h"
+#else
+#include <stdlib.h>
+#include <string.h>
+#endif
+#include "DustCollectorBase.h"
+#include "Profiler.h"
 
 // Dust filter
 const uint32_t	DustCollectorBase::kPressureUpdatePeriod = 1500;	// in milliseconds
+const int32_t	DustCollectorBase::kRunningThreshold = 25;	// in Pa, 100 = 1hPa
 
 // Dust bin motor
 const uint32_t	DustCollectorBase::kMotorSensePeriod = 500;	// in milliseconds
-const uint8_t	DustCollectorBase::kThresholdLowerLimit = 5;
-#ifdef _STM32_DEF_
-const uint8_t	DustCollectorBase::kDefaultTriggerThreshold = 100;
-const uint8_t	DustCollectorBase::kThresholdUpperLimit = 120;
-#else
-const uint8_t	DustCollectorBase::kDefaultTriggerThreshold = 15;
-const uint8_t	DustCollectorBase::kThresholdUpperLimit = 50;
-#endif
+const uint8_t	DustCollectorBase::kThresholdLowerLimit = BinThreshold::kLowerLimit;
+const uint8_t	DustCollectorBase::kDefaultTriggerThreshold = BinThreshold::kDefault;
+const uint8_t	DustCollectorBase::kThresholdUpperLimit = BinThreshold::kUpperLimit;
 
 /******************************* DustCollectorBase ********************************/
 DustCollectorBase::DustCollectorBase(
@@ -44,18 +46,54 @@ DustCollectorBase::DustCollectorBase(
 	pin_t	inFlasherControlPin,
 	pin_t	inMotorControlPin,
 	pin_t	inMotorSensePin)
-  : mBMP280Ambient(inBMP280AmbientPin), mBMP280Duct(inBMP280DuctPin),
+  : mStatus(eNotRunning),
  	mFlasherControlPin(inFlasherControlPin), mMotorControlPin(inMotorControlPin),
  	mMotorSensePin(inMotorSensePin),
 	mPressureUpdatePeriod(DustCollectorBase::kPressureUpdatePeriod),
+	mPressureUpdatePeriodMS(DustCollectorBase::kPressureUpdatePeriod),
+	mRunningThreshold(DustCollectorBase::kRunningThreshold), mDeltaSum(0),
+	mNumDeltas(eNumDeltas), mNumDeltaAvgs(eNumDeltaAvgs), mDeltaIndex(0),
+	mDeltaAverageIndex(0), mDeltaSumLoaded(false), mDeltaAveragesLoaded(false),
+	mDCIsRunning(false), mFaultAcknowledged(true),
+#ifndef __MACH__
+	mBMP280Ambient(inBMP280AmbientPin), mBMP280Duct(inBMP280DuctPin),
+#endif
+	mAmbientTemperature(0), mDuctPressure(0), mAmbientPressure(0),
 	mMotorSensePeriod(DustCollectorBase::kMotorSensePeriod),
-	 mDeltaAveragesLoaded(false), mDeltaAverageIndex(0), mMotorEnabled(true),
-	 mDeltaIndex(0), mDeltaSumLoaded(false), mDeltaSum(0)
+	mSampleCount(0), mRingBufIndex(0), mSampleAccumulator(0),
+	mMotorEnabled(true), mMotorRunning(false),
+	mTriggerThreshold(DustCollectorBase::kDefaultTriggerThreshold),
+	mBinMotorAverage(0)
 {
+	/*
+	*	The replay tools construct collectors on the stack, zero the sample
+	*	buffers so a replay doesn't depend on what was there before.
+	*/
+	memset(mDelta, 0, sizeof(mDelta));
+	memset(mDeltaAverage, 0, sizeof(mDeltaAverage));
+	memset(mRingBuf, 0, sizeof(mRingBuf));
 	StopFlasher();
 	StopDustBinMotor();	// Stop before setting pinMode
+#ifndef __MACH__
 	pinMode(mFlasherControlPin, OUTPUT);
 	pinMode(mMotorControlPin, OUTPUT);
+#endif
+}
+
+/******************************** SetNumDeltas ********************************/
+void DustCollectorBase::SetNumDeltas(
+	uint8_t	inNumDeltas)
+{
+	mNumDeltas = inNumDeltas == 0 ? 1 :
+					(inNumDeltas > eMaxNumDeltas ? (uint8_t)eMaxNumDeltas : inNumDeltas);
+}
+
+/****************************** SetNumDeltaAvgs *******************************/
+void DustCollectorBase::SetNumDeltaAvgs(
+	uint8_t	inNumDeltaAvgs)
+{
+	mNumDeltaAvgs = inNumDeltaAvgs == 0 ? 1 :
+					(inNumDeltaAvgs > eMaxNumDeltaAvgs ? (uint8_t)eMaxNumDeltaAvgs : inNumDeltaAvgs);
 }
 
 /*********************************** begin ************************************/
@@ -65,6 +103,7 @@ void DustCollectorBase::begin(void)
 	*	BMP280 pressure sensor setup
 	*/
 	{
+	#ifndef __MACH__
 		/*
 		*	Even though it's not used, turning the temperature oversampling off
 		*	causes a larger delta between the pressure readings.  I don't know why.
@@ -90,6 +129,8 @@ void DustCollectorBase::begin(void)
 		Serial.print(F("BMP280Duct status = "));
 		Serial.println(status);
 	#endif
+	#endif // __MACH__
+		mPressureUpdatePeriod.Set(mPressureUpdatePeriodMS);
 		mPressureUpdatePeriod.Start();	
 	}
 	
@@ -109,13 +150,17 @@ void DustCollectorBase::CancelFault(void)
 /******************************** StartFlasher ********************************/
 void DustCollectorBase::StartFlasher(void)
 {
+#ifndef __MACH__
 	digitalWrite(mFlasherControlPin, HIGH);
+#endif
 }
 
 /******************************** StopFlasher *********************************/
 void DustCollectorBase::StopFlasher(void)
 {
+#ifndef __MACH__
 	digitalWrite(mFlasherControlPin, LOW);
+#endif
 }
 
 /************************** DustCollectorJustStarted **************************/
@@ -136,7 +181,10 @@ void DustCollectorBase::StartDustBinMotor(void)
 {
 	if (mMotorEnabled)
 	{
+	#ifndef __MACH__
 		digitalWrite(mMotorControlPin, HIGH);
+	#endif
+		mMotorRunning = true;
 		// Give the motor 2 seconds to start before taking any readings.
 		mMotorSensePeriod.Set(2000);
 		mMotorSensePeriod.Start();
@@ -154,7 +202,10 @@ void DustCollectorBase::StopDustBinMotor(void)
 	// This will stop sensing the motor.
 	mMotorSensePeriod.Set(0);
 	mBinMotorAverage = 0;
+	mMotorRunning = false;
+#ifndef __MACH__
 	digitalWrite(mMotorControlPin, LOW);
+#endif
 }
 
 /******************************* ToggleBinMotor *******************************/
@@ -200,30 +251,56 @@ bool DustCollectorBase::Update(void)
 /********************************** Baseline **********************************/
 int32_t DustCollectorBase::Baseline(void) const
 {
-	return(mDeltaAverage[mDeltaAverageIndex % eNumDeltaAvgs]);
+	return(mDeltaAverage[mDeltaAverageIndex % mNumDeltaAvgs]);
+}
+
+/**************************** ReadPressureSensors *****************************/
+void DustCollectorBase::ReadPressureSensors(void)
+{
+#ifndef __MACH__
+	mBMP280Ambient.DoForcedRead(mAmbientTemperature, mAmbientPressure);
+	{
+		int32_t	temp;
+		mBMP280Duct.DoForcedRead(temp, mDuctPressure);
+	}
+#endif
+}
+
+/***************************** ReadBinMotorSensor *****************************/
+uint16_t DustCollectorBase::ReadBinMotorSensor(void)
+{
+#ifndef __MACH__
+//#ifdef _STM32_DEF_
+#if 0
+	return(adc_read_value(analogInputToPinName(mMotorSensePin), 10));
+#else
+	return(analogRead(mMotorSensePin));
+#endif
+#else
+	return(0);
+#endif
 }
 
 /******************************** CheckFilter *********************************/
 void DustCollectorBase::CheckFilter(void)
 {
+	PROFILE_SCOPE(CheckFilter);
 	if (mPressureUpdatePeriod.Passed())
 	{
-		mBMP280Ambient.DoForcedRead(mAmbientTemperature, mAmbientPressure);
-		{
-			int32_t	temp;
-			mBMP280Duct.DoForcedRead(temp, mDuctPressure);
-		}
+		ReadPressureSensors();
 		/*
 		*	Calling Set on a MSPeriod isn't generally needed, but because the
 		*	mPressureUpdatePeriod is set to a 30 second delay when the collector
 		*	stops, it's easier to always reset it to the kPressureUpdatePeriod
 		*	on each pass.
 		*/
-		mPressureUpdatePeriod.Set(kPressureUpdatePeriod);
+		mPressureUpdatePeriod.Set(mPressureUpdatePeriodMS);
 		mPressureUpdatePeriod.Start();
 	
 		/*
-		*	The mDeltaSum is the sum of the last eNumDeltas deltas.
+		*	The mDeltaSum is the sum of the last mNumDeltas deltas.
+		*	(The defaults, eNumDeltas, eNumDeltaAvgs, kPressureUpdatePeriod and
+		*	kRunningThreshold, are the values used in the comments below.)
 		*
 		*	The delta average is updated every 1.5 seconds.  This is the average
 		*	delta between the ambient and duct pressure readings when the dust
@@ -271,7 +348,7 @@ void DustCollectorBase::CheckFilter(void)
 			*	till this is true.
 			*/
 			{
-				uint8_t	oldestDeltaIndex = mDeltaIndex % eNumDeltas;
+				uint8_t	oldestDeltaIndex = mDeltaIndex % mNumDeltas;
 				mDeltaSum = mDeltaSum - mDelta[oldestDeltaIndex] + thisDelta;
 				mDelta[oldestDeltaIndex] = thisDelta;
 		/*	Serial.print("DA = ");
@@ -282,9 +359,19 @@ void DustCollectorBase::CheckFilter(void)
 			Serial.println(mDeltaSum);
 		*/
 			}
+			/*
+			*	Once past the first mNumDeltas values, mDeltaIndex is kept in
+			*	the range [mNumDeltas, mNumDeltas*2) so that it never wraps.
+			*	(a uint8_t wrap would break the modulo for counts that aren't
+			*	a power of 2.)
+			*/
 			mDeltaIndex++;
-			// deltaAverage is the average of the eNumDeltas values in mDelta.
-			// This is calculated as mDeltaSum/eNumDeltas
+			if (mDeltaIndex >= (mNumDeltas*2))
+			{
+				mDeltaIndex -= mNumDeltas;
+			}
+			// deltaAverage is the average of the mNumDeltas values in mDelta.
+			// This is calculated as mDeltaSum/mNumDeltas
 			int32_t	deltaAverage = DeltaAverage();
 	
 		#ifdef DEBUG_DELTAS
@@ -301,11 +388,11 @@ void DustCollectorBase::CheckFilter(void)
 				/*
 				*	Calculate the adjusted average delta using the oldest delta
 				*	average.
-				*	(mDeltaAverageIndex % eNumDeltaAvgs) = oldest average
+				*	(mDeltaAverageIndex % mNumDeltaAvgs) = oldest average
 				*/
 				int32_t	adjustedDeltaAverage = deltaAverage  -
-							mDeltaAverage[mDeltaAverageIndex % eNumDeltaAvgs]; //AdjustedDeltaAverage();
-				bool isRunning = adjustedDeltaAverage > 25;	// 100 = 1hPa
+							mDeltaAverage[mDeltaAverageIndex % mNumDeltaAvgs]; //AdjustedDeltaAverage();
+				bool isRunning = adjustedDeltaAverage > mRunningThreshold;
 				if (isRunning != mDCIsRunning)
 				{
 					mDCIsRunning = isRunning;
@@ -340,7 +427,7 @@ void DustCollectorBase::CheckFilter(void)
 						DustCollectorJustStopped();
 					}
 				}
-			} else if (mDeltaAverageIndex >= eNumDeltaAvgs)
+			} else if (mDeltaAverageIndex >= mNumDeltaAvgs)
 			{
 				mDeltaAveragesLoaded = true;
 			/*
@@ -352,7 +439,7 @@ void DustCollectorBase::CheckFilter(void)
 				LoadingDeltas();
 			}
 			/*
-			*	If mDeltaSum contains eNumDeltas...
+			*	If mDeltaSum contains mNumDeltas...
 			*/ 
 			if (mDeltaSumLoaded)
 			{
@@ -373,14 +460,20 @@ void DustCollectorBase::CheckFilter(void)
 				} else if (!mDCIsRunning)
 				{
 					// Set the oldest average to the newest.
-					mDeltaAverage[mDeltaAverageIndex % eNumDeltaAvgs] = (int16_t)deltaAverage;
+					mDeltaAverage[mDeltaAverageIndex % mNumDeltaAvgs] = (int16_t)deltaAverage;
 					mDeltaAverageIndex++;	// The next average is now the oldest
+					// Same as mDeltaIndex, keep it from wrapping.
+					if (mDeltaAverageIndex >= (mNumDeltaAvgs*2))
+					{
+						mDeltaAverageIndex -= mNumDeltaAvgs;
+					}
 				}
-			} else if (mDeltaIndex >= eNumDeltas)
+			} else if (mDeltaIndex >= mNumDeltas)
 			{
 				mDeltaSumLoaded = true;
 			}
 		}
+		PressuresUpdated();
 	}
 }
 
@@ -395,19 +488,15 @@ void DustCollectorBase::FilterFull(void)
 /***************************** CheckDustBinMotor ******************************/
 void DustCollectorBase::CheckDustBinMotor(void)
 {
+	PROFILE_SCOPE(CheckDustBinMotor);
 	/*
 	*	If the motor is running AND
 	*	its value needs to be read...
 	*/
-	if (digitalRead(mMotorControlPin) &&
+	if (mMotorRunning &&
 		mMotorSensePeriod.Passed())
 	{
-	//#ifdef _STM32_DEF_
-	#if 0
-		uint16_t	reading = adc_read_value(analogInputToPinName(mMotorSensePin), 10);
-	#else
-		uint16_t	reading = analogRead(mMotorSensePin);
-	#endif
+		uint16_t	reading = ReadBinMotorSensor();
 		mSampleAccumulator += reading;				// Add the newest reading
 		uint16_t	oldestReading = mRingBuf[mRingBufIndex];
 		mRingBuf[mRingBufIndex] = reading;			// Save the newest reading
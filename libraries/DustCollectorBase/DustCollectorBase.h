@@ -26,8 +26,18 @@
 
 #include <inttypes.h>
 #include "MSPeriod.h"
+#ifndef __MACH__
 #include "BMP280SPI.h"
+#endif
 #include "PlatformDefs.h"
+#include "BinThreshold.h"
+
+/*
+*	On the host (__MACH__) the sensors and pins don't exist.  A host subclass
+*	supplies the sensor values by overriding ReadPressureSensors() and
+*	ReadBinMotorSensor().  This is how recorded traces are replayed, see
+*	tools/DCTraceSweep.
+*/
 
 class DustCollectorBase
 {
@@ -51,9 +61,21 @@ public:
 
 	enum EConfig
 	{
-		eNumDeltas = 4,		// Number of deltas contained in mDeltaSum.
-		eNumDeltaAvgs = 8,	// Number of Delta Averages representing
+		eNumDeltas = 4,		// Default number of deltas contained in mDeltaSum.
+		eNumDeltaAvgs = 8,	// Default number of Delta Averages representing
 							// averages over the period eNumDeltaAvgs*kPressureUpdatePeriod
+		/*
+		*	mDelta and mDeltaAverage are sized by the upper limits.  Only
+		*	the host tools (DCTraceSweep) change the counts, so the firmware
+		*	doesn't spend RAM on larger arrays.
+		*/
+#ifdef __MACH__
+		eMaxNumDeltas = 16,		// Upper limit for SetNumDeltas()
+		eMaxNumDeltaAvgs = 32,	// Upper limit for SetNumDeltaAvgs()
+#else
+		eMaxNumDeltas = eNumDeltas,
+		eMaxNumDeltaAvgs = eNumDeltaAvgs,
+#endif
 		eBinMotorSampleSize = 8
 	};
 	
@@ -67,7 +89,7 @@ public:
 	uint32_t				DuctPressure(void) const
 								{return(mDuctPressure);}
 	inline int32_t			DeltaAverage(void) const
-								{return(mDeltaSum/eNumDeltas);}
+								{return(mDeltaSum/mNumDeltas);}
 	bool					DeltaAveragesLoaded(void) const
 								{return(mDeltaAveragesLoaded);}
 	bool					DCIsRunning(void) const
@@ -90,9 +112,33 @@ public:
 	virtual void			SaveTriggerThreshold(void) = 0;
 	virtual void			StartFlasher(void);
 	virtual void			StopFlasher(void);
+							/*
+							*	Detection parameters.  These default to the
+							*	constants below and should only be changed
+							*	prior to calling begin().
+							*/
+	void					SetRunningThreshold(
+								int32_t					inRunningThreshold)
+								{mRunningThreshold = inRunningThreshold;}
+	int32_t					RunningThreshold(void) const
+								{return(mRunningThreshold);}
+	void					SetNumDeltas(
+								uint8_t					inNumDeltas);
+	uint8_t					NumDeltas(void) const
+								{return(mNumDeltas);}
+	void					SetNumDeltaAvgs(
+								uint8_t					inNumDeltaAvgs);
+	uint8_t					NumDeltaAvgs(void) const
+								{return(mNumDeltaAvgs);}
+	void					SetPressureUpdatePeriod(
+								uint32_t				inPeriod)
+								{mPressureUpdatePeriodMS = inPeriod;}
+	uint32_t				PressureUpdatePeriod(void) const
+								{return(mPressureUpdatePeriodMS);}
 								
 	// Dust filter
 	static const uint32_t	kPressureUpdatePeriod;	// in milliseconds
+	static const int32_t	kRunningThreshold;		// in Pa
 	
 	// Dust bin motor
 	static const uint32_t	kMotorSensePeriod;	// in milliseconds
@@ -106,17 +152,23 @@ protected:
 	pin_t		mMotorControlPin;
 	pin_t		mMotorSensePin;
 	MSPeriod	mPressureUpdatePeriod;
+	uint32_t	mPressureUpdatePeriodMS;
+	int32_t		mRunningThreshold;
 	int32_t		mDeltaSum;
-	int32_t		mDelta[eNumDeltas];
-	int16_t		mDeltaAverage[eNumDeltaAvgs];
+	int32_t		mDelta[eMaxNumDeltas];
+	int16_t		mDeltaAverage[eMaxNumDeltaAvgs];
+	uint8_t		mNumDeltas;
+	uint8_t		mNumDeltaAvgs;
 	uint8_t		mDeltaIndex;
 	uint8_t		mDeltaAverageIndex;
 	bool		mDeltaSumLoaded;
 	bool		mDeltaAveragesLoaded;
 	bool		mDCIsRunning;
 	bool		mFaultAcknowledged;
+#ifndef __MACH__
 	BMP280SPI	mBMP280Ambient;
 	BMP280SPI	mBMP280Duct;
+#endif
 	int32_t		mAmbientTemperature;
 	uint32_t	mDuctPressure;
 	uint32_t	mAmbientPressure;
@@ -129,6 +181,7 @@ protected:
 	uint16_t	mSampleAccumulator;
 
 	bool		mMotorEnabled;
+	bool		mMotorRunning;
 	uint8_t		mTriggerThreshold;
 	uint8_t		mBinMotorAverage;
 	
@@ -141,6 +194,17 @@ protected:
 	virtual void			InitializeMotorThresholdVars(void) = 0;
 	virtual int32_t			CurrentDirtyPressure(void) = 0;
 	virtual void			LoadingDeltas(void){}
+							/*
+							*	Called after every pressure update (every
+							*	mPressureUpdatePeriodMS while sampling.)
+							*/
+	virtual void			PressuresUpdated(void){}
+							/*
+							*	Loads mAmbientTemperature, mAmbientPressure and
+							*	mDuctPressure.
+							*/
+	virtual void			ReadPressureSensors(void);
+	virtual uint16_t		ReadBinMotorSensor(void);
 };
 
 #endif // DustCollectorBase_h
@@ -0,0 +1,91 @@
+/*
+*	ISREvents.cpp, Copyright Jonathan Mackey 2026
+*	Lock-free queue of timestamped events from interrupt handlers.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "ISREvents.h"
+#include "ClockSource.h"
+
+#if (ISR_EVENTS_SIZE & (ISR_EVENTS_SIZE - 1)) || ISR_EVENTS_SIZE > 128
+#error "ISR_EVENTS_SIZE must be a power of 2, 128 or less"
+#endif
+
+SISREvent			ISREvents::sEvents[eSize];
+uint8_t				ISREvents::sHead;
+uint8_t				ISREvents::sTail;
+uint8_t				ISREvents::sHighWater;
+volatile uint32_t	ISREvents::sOverflows[eNumTypes];
+
+/*
+*	The indexes are free running, head - tail is the number queued.  The
+*	acquire/release builtins compile to plain loads and stores (plus a DMB on
+*	the mcu), on the host they also order the two threads of a stress test.
+*/
+
+/************************************ Push ************************************/
+bool ISREvents::Push(
+	uint8_t		inType,
+	uint16_t	inData)
+{
+	uint8_t	head = sHead;
+	uint8_t	queued = head - __atomic_load_n(&sTail, __ATOMIC_ACQUIRE);
+	bool	success = queued < eSize;
+	if (success)
+	{
+		SISREvent&	event = sEvents[head & eMask];
+		event.time = ClockSource::Micros();
+		event.data = inData;
+		event.type = inType;
+		__atomic_store_n(&sHead, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+		if (queued >= sHighWater)
+		{
+			sHighWater = queued + 1;
+		}
+	} else if (inType < eNumTypes)
+	{
+		sOverflows[inType]++;
+	}
+	return(success);
+}
+
+/************************************ Pop *************************************/
+bool ISREvents::Pop(
+	SISREvent&	outEvent)
+{
+	uint8_t	tail = sTail;
+	bool	success = tail != __atomic_load_n(&sHead, __ATOMIC_ACQUIRE);
+	if (success)
+	{
+		outEvent = sEvents[tail & eMask];
+		__atomic_store_n(&sTail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);
+	}
+	return(success);
+}
+
+/********************************* Overflows **********************************/
+uint32_t ISREvents::Overflows(void)
+{
+	uint32_t	overflows = 0;
+	for (uint8_t type = 0; type < eNumTypes; type++)
+	{
+		overflows += sOverflows[type];
+	}
+	return(overflows);
+}
@@ -0,0 +1,94 @@
+/*
+*	ISREvents.h, Copyright Jonathan Mackey 2026
+*	Lock-free queue of timestamped events from interrupt handlers.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef ISREvents_h
+#define ISREvents_h
+
+#include <inttypes.h>
+
+/*
+*	The number of queued events, a power of 2 no larger than 128.
+*/
+#ifndef ISR_EVENTS_SIZE
+#define ISR_EVENTS_SIZE	32
+#endif
+
+struct SISREvent
+{
+	uint32_t	time;	// ClockSource::Micros() when queued
+	uint16_t	data;	// e.g. the button pin state
+	uint8_t		type;	// ISREvents::EType
+};
+
+/*
+*	A single producer, single consumer ring.  Interrupt handlers Push(), the
+*	main loop Pop()s.  Neither side ever waits or masks interrupts: each index
+*	is written by one side only, and the producer publishes an event by
+*	storing its head index with release ordering after the event is written.
+*
+*	Single producer means the handlers that push can't preempt each other.
+*	On the mcu they must run at the same NVIC priority (the pin interrupts
+*	share EXTI_IRQ_PRIO, STM32UnixRTC moves the RTC seconds interrupt to it.)
+*
+*	A full queue drops the new event and counts it in Overflows(type), so
+*	that events are never merged silently.  HighWater() is the most events
+*	that were queued at once.
+*/
+class ISREvents
+{
+public:
+	enum EType
+	{
+		eNoEvent,
+		ePenDown,		// XPT2046 pen IRQ edges
+		ePenUp,
+		eButtonEdge,	// data is the button pins, set = pressed
+		eSecondTick,	// RTC seconds
+		eNumTypes
+	};
+							// Producer.  Returns false if the queue is full.
+	static bool				Push(
+								uint8_t					inType,
+								uint16_t				inData = 0);
+							// Consumer.  Returns false if the queue is empty.
+	static bool				Pop(
+								SISREvent&				outEvent);
+	static uint32_t			Overflows(
+								uint8_t					inType)
+								{return(sOverflows[inType]);}
+	static uint32_t			Overflows(void);	// All types
+	static uint8_t			HighWater(void)
+								{return(sHighWater);}
+	enum
+	{
+		eSize	= ISR_EVENTS_SIZE,
+		eMask	= eSize - 1
+	};
+protected:
+	static SISREvent			sEvents[eSize];
+	static uint8_t				sHead;		// Next to push, producer only
+	static uint8_t				sTail;		// Next to pop, consumer only
+	static uint8_t				sHighWater;	// Producer only
+	static volatile uint32_t	sOverflows[eNumTypes];	// Producer only
+};
+
+#endif // ISREvents_h
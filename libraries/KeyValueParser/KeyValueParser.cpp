@@ -0,0 +1,215 @@
+/*
+*	KeyValueParser.cpp, Copyright Jonathan Mackey 2026
+*	Streaming parser for key=value files.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "KeyValueParser.h"
+#include "DataStream.h"
+#include <string.h>
+
+/******************************* KeyValueParser *******************************/
+KeyValueParser::KeyValueParser(
+	DataStream*	inStream)
+	: mStream(inStream), mPos(mBuffer), mEnd(mBuffer), mKeyHash(0),
+	  mLine(0), mNextLine(1)
+{
+	mKey[0] = 0;
+	mValue[0] = 0;
+}
+
+/*********************************** Refill ***********************************/
+int16_t KeyValueParser::Refill(void)
+{
+	uint32_t	bytesRead = mStream ? mStream->Read(eBufferSize, mBuffer) : 0;
+	mPos = mBuffer;
+	mEnd = &mBuffer[bytesRead];
+	return(bytesRead ? (uint8_t)*(mPos++) : -1);
+}
+
+/******************************* SkipToNextLine *******************************/
+/*
+*	Returns the character following the newline, or -1.
+*/
+int16_t KeyValueParser::SkipToNextLine(
+	int16_t	inCurrChar)
+{
+	int16_t	thisChar = inCurrChar;
+	while (thisChar >= 0 && thisChar != '\n')
+	{
+		thisChar = NextChar();
+	}
+	if (thisChar == '\n')
+	{
+		mNextLine++;
+		thisChar = NextChar();
+	}
+	return(thisChar);
+}
+
+/************************************ Next ************************************/
+uint8_t KeyValueParser::Next(void)
+{
+	int16_t	thisChar = NextChar();
+	/*
+	*	Skip blank and comment lines.
+	*/
+	while (true)
+	{
+		while (IsSpace(thisChar))
+		{
+			thisChar = NextChar();
+		}
+		if (thisChar == '\n' || thisChar == '#')
+		{
+			thisChar = SkipToNextLine(thisChar);
+			continue;
+		}
+		break;
+	}
+	mLine = mNextLine;
+	if (thisChar < 0)
+	{
+		return(eEnd);
+	}
+	/*
+	*	Key
+	*/
+	uint8_t		result = eKeyValue;
+	uint8_t		keyLen = 0;
+	uint8_t		trimmedLen = 0;	// Excludes trailing whitespace
+	uint32_t	hash = 2166136261U;
+	uint32_t	trimmedHash = hash;
+	for (; thisChar >= 0 && thisChar != '=' && thisChar != '\n'; thisChar = NextChar())
+	{
+		if (keyLen < eMaxKeyLen)
+		{
+			mKey[keyLen++] = (char)thisChar;
+			hash = (hash ^ (uint8_t)thisChar) * 16777619U;
+			if (!IsSpace(thisChar))
+			{
+				trimmedLen = keyLen;
+				trimmedHash = hash;
+			}
+		} else
+		{
+			result = eSyntaxError;
+		}
+	}
+	mKey[trimmedLen] = 0;
+	mKeyHash = trimmedHash;
+	if (thisChar != '=')
+	{
+		result = eSyntaxError;
+	} else
+	{
+		/*
+		*	Value
+		*/
+		thisChar = NextChar();
+		while (IsSpace(thisChar))
+		{
+			thisChar = NextChar();
+		}
+		uint8_t	valueLen = 0;
+		trimmedLen = 0;
+		for (; thisChar >= 0 && thisChar != '\n'; thisChar = NextChar())
+		{
+			if (valueLen < eMaxValueLen)
+			{
+				mValue[valueLen++] = (char)thisChar;
+				if (!IsSpace(thisChar))
+				{
+					trimmedLen = valueLen;
+				}
+			} else
+			{
+				result = eSyntaxError;
+			}
+		}
+		mValue[trimmedLen] = 0;
+	}
+	if (result != eKeyValue)
+	{
+		mValue[0] = 0;
+	}
+	// thisChar is the newline or the end, the next line is left unread.
+	if (thisChar == '\n')
+	{
+		mNextLine++;
+	}
+	return(result);
+}
+
+/******************************** ParseUInt32 *********************************/
+bool KeyValueParser::ParseUInt32(
+	const char*	inString,
+	uint32_t&	outValue)
+{
+	bool		bitwiseNot = *inString == '~';
+	uint32_t	value = 0;
+	if (bitwiseNot)
+	{
+		inString++;
+	}
+	bool	success = *inString != 0;
+	if (inString[0] == '0' && (inString[1] == 'x' || inString[1] == 'X'))
+	{
+		inString += 2;
+		success = *inString != 0;
+		for (; *inString && success; inString++)
+		{
+			char	thisChar = *inString;
+			uint8_t	digit;
+			if (thisChar >= '0' && thisChar <= '9')
+			{
+				digit = thisChar - '0';
+			} else if ((thisChar | 0x20) >= 'a' && (thisChar | 0x20) <= 'f')
+			{
+				digit = (thisChar | 0x20) - 'a' + 10;
+			} else
+			{
+				success = false;
+				break;
+			}
+			success = value <= 0x0FFFFFFF;
+			value = (value << 4) + digit;
+		}
+	} else
+	{
+		for (; *inString && success; inString++)
+		{
+			char	thisChar = *inString;
+			success = thisChar >= '0' && thisChar <= '9' &&
+				value <= (0xFFFFFFFF - (thisChar - '0')) / 10;
+			value = (value * 10) + (thisChar - '0');
+		}
+	}
+	outValue = bitwiseNot ? ~value : value;
+	return(success);
+}
+
+/********************************* ParseBool **********************************/
+bool KeyValueParser::ParseBool(
+	const char*	inString,
+	bool&		outValue)
+{
+	outValue = strcmp(inString, "true") == 0;
+	return(outValue || strcmp(inString, "false") == 0);
+}
@@ -0,0 +1,116 @@
+/*
+*	KeyValueParser.h, Copyright Jonathan Mackey 2026
+*	Streaming parser for key=value files.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef KeyValueParser_h
+#define KeyValueParser_h
+
+#include <inttypes.h>
+
+class DataStream;
+
+/*
+*	Parses files of the same form as boards.txt and platform.txt, one
+*	key=value per line:
+*	- whitespace around the key and value is ignored.
+*	- lines starting with # are comments, blank lines are skipped.
+*	- LF and CRLF line endings are accepted.
+*	The stream is read in blocks of eBufferSize bytes, so the per character
+*	cost is a pointer compare rather than a virtual Read call.
+*
+*	The parser doesn't know the keys.  Each key is returned along with its
+*	FNV-1a hash, computed as the key is read.  Hash() is constexpr so the
+*	caller can switch on the hashes of its keys.  Case labels must be unique
+*	so the compiler rejects a colliding key set (a perfect hash by
+*	construction.)  The key still needs to be compared to the matching key
+*	string since an unknown key can have the same hash.
+*/
+class KeyValueParser
+{
+public:
+							KeyValueParser(
+								DataStream*				inStream);
+	enum EResult
+	{
+		eEnd,
+		eKeyValue,
+		eSyntaxError	// No '=', or the key or value is too long
+	};
+	enum
+	{
+		eBufferSize		= 64,
+		eMaxKeyLen		= 31,
+		eMaxValueLen	= 31
+	};
+							/*
+							*	Parses the next key=value line.  After a
+							*	syntax error the rest of the line is skipped
+							*	and parsing can continue.
+							*/
+	uint8_t					Next(void);
+	const char*				Key(void) const
+								{return(mKey);}
+	uint32_t				KeyHash(void) const
+								{return(mKeyHash);}
+	const char*				Value(void) const
+								{return(mValue);}
+	uint16_t				Line(void) const	// Of the last Next()
+								{return(mLine);}
+	static constexpr uint32_t	Hash(
+								const char*				inKey,
+								uint32_t				inHash = 2166136261U)
+								{return(*inKey ? Hash(&inKey[1],
+									(inHash ^ (uint8_t)*inKey) * 16777619U) : inHash);}
+							/*
+							*	Numbers are decimal or hex (0x prefix) with
+							*	an optional leading ~ (bitwise not.)  Returns
+							*	false if inString isn't entirely a number or
+							*	overflows.
+							*/
+	static bool				ParseUInt32(
+								const char*				inString,
+								uint32_t&				outValue);
+							// true/false
+	static bool				ParseBool(
+								const char*				inString,
+								bool&					outValue);
+protected:
+	DataStream*	mStream;
+	const char*	mPos;
+	const char*	mEnd;
+	uint32_t	mKeyHash;
+	uint16_t	mLine;
+	uint16_t	mNextLine;
+	char		mKey[eMaxKeyLen+1];
+	char		mValue[eMaxValueLen+1];
+	char		mBuffer[eBufferSize];
+
+	int16_t					Refill(void);
+	inline int16_t			NextChar(void)	// -1 at end of stream
+								{return(mPos < mEnd ? (uint8_t)*(mPos++) : Refill());}
+	int16_t					SkipToNextLine(
+								int16_t					inCurrChar);
+	static inline bool		IsSpace(
+								int16_t					inChar)
+								{return(inChar == ' ' || inChar == '\t' || inChar == '\r');}
+};
+
+#endif // KeyValueParser_h
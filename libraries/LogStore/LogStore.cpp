@@ -0,0 +1,195 @@
+/*
+*	LogStore.cpp, Copyright Jonathan Mackey 2026
+*	Wear leveled, log structured record store for EEPROM.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "LogStore.h"
+#include "DataStream.h"
+#include "CRC16.h"
+#include <stddef.h>
+#include <string.h>
+
+/********************************** LogStore **********************************/
+LogStore::LogStore(
+	DataStream*	inStream,
+	uint16_t	inSlotSize)
+	: mStream(inStream), mOldestSequence(0), mNextSequence(0), mNumSlots(0),
+	  mSlotSize(inSlotSize > eMaxSlotSize ? (uint16_t)eMaxSlotSize : inSlotSize)
+{
+}
+
+/********************************* RecordCRC **********************************/
+uint16_t LogStore::RecordCRC(
+	const SHeader&	inHeader,
+	const void*		inPayload)
+{
+	uint16_t	crc = CRC16::Calc(&inHeader, offsetof(SHeader, crc));
+	return(CRC16::Calc(inPayload, inHeader.length, crc));
+}
+
+/******************************* ReadSlotHeader *******************************/
+/*
+*	Only reads the header, the CRC isn't checked.
+*/
+bool LogStore::ReadSlotHeader(
+	uint16_t	inSlot,
+	SHeader&	outHeader)
+{
+	return(mStream->Seek((int32_t)inSlot * mSlotSize, DataStream::eSeekSet) &&
+		mStream->Read(sizeof(SHeader), &outHeader) == sizeof(SHeader) &&
+		outHeader.sequence != 0xFFFFFFFF &&
+		(outHeader.sequence % mNumSlots) == inSlot &&
+		outHeader.length <= MaxPayload());
+}
+
+/********************************** ReadSlot **********************************/
+bool LogStore::ReadSlot(
+	uint16_t	inSlot,
+	SHeader&	outHeader,
+	void*		ioBuffer)
+{
+	return(ReadSlotHeader(inSlot, outHeader) &&
+		mStream->Read(outHeader.length, ioBuffer) == outHeader.length &&
+		RecordCRC(outHeader, ioBuffer) == outHeader.crc);
+}
+
+/*********************************** Mount ************************************/
+uint16_t LogStore::Mount(void)
+{
+	mStream->Seek(0, DataStream::eSeekEnd);
+	mNumSlots = mStream->GetPos() / mSlotSize;
+	mOldestSequence = mNextSequence = 0;
+	if (mNumSlots > 1)
+	{
+		uint8_t		payload[eMaxSlotSize];
+		SHeader		header;
+		uint32_t	headSequence;
+		uint16_t	headSlot;
+		if (ReadSlot(0, header, payload))
+		{
+			/*
+			*	Binary search for the last slot holding the lap that starts
+			*	at slot 0.  lo is always such a slot, hi never is.
+			*/
+			uint32_t	firstSequence = header.sequence;
+			uint16_t	lo = 0;
+			uint16_t	hi = mNumSlots;
+			while (hi - lo > 1)
+			{
+				uint16_t	mid = (lo + hi) / 2;
+				if (ReadSlot(mid, header, payload) &&
+					header.sequence == firstSequence + mid)
+				{
+					lo = mid;
+				} else
+				{
+					hi = mid;
+				}
+			}
+			headSlot = lo;
+			headSequence = firstSequence + lo;
+		/*
+		*	Else if slot 0 is invalid then either the store is empty or the
+		*	write that wrapped to slot 0 was torn, in which case the last slot
+		*	is the head.
+		*/
+		} else if (ReadSlot(mNumSlots-1, header, payload))
+		{
+			headSlot = mNumSlots-1;
+			headSequence = header.sequence;
+		} else
+		{
+			return(mNumSlots);	// Empty
+		}
+		mNextSequence = headSequence + 1;
+		/*
+		*	Unless this is the first lap, the oldest record is the one that
+		*	will be overwritten by the next append.
+		*/
+		mOldestSequence = headSequence >= mNumSlots ?
+							mNextSequence - mNumSlots : headSequence - headSlot;
+	} else
+	{
+		mNumSlots = 0;
+	}
+	return(mNumSlots);
+}
+
+/*********************************** Erase ************************************/
+void LogStore::Erase(void)
+{
+	uint8_t	erased[eMaxSlotSize];
+	memset(erased, 0xFF, mSlotSize);
+	for (uint16_t slot = 0; slot < mNumSlots; slot++)
+	{
+		mStream->Seek((int32_t)slot * mSlotSize, DataStream::eSeekSet);
+		mStream->Write(mSlotSize, erased);
+	}
+	mOldestSequence = mNextSequence = 0;
+}
+
+/*********************************** Append ***********************************/
+/*
+*	The header and payload are written to a single page, in one write cycle
+*	when the record is 30 bytes or less, otherwise two.  If power fails
+*	during the write the slot's CRC won't match and Mount will treat the
+*	previous record as the head.
+*/
+bool LogStore::Append(
+	uint8_t		inType,
+	const void*	inPayload,
+	uint8_t		inLength)
+{
+	bool	success = mNumSlots && inLength <= MaxPayload();
+	if (success)
+	{
+		uint8_t		record[eMaxSlotSize];
+		SHeader*	header = (SHeader*)record;
+		header->sequence = mNextSequence;
+		header->type = inType;
+		header->length = inLength;
+		memcpy(&record[eHeaderSize], inPayload, inLength);
+		header->crc = RecordCRC(*header, &record[eHeaderSize]);
+		uint16_t	recordSize = eHeaderSize + inLength;
+		success = mStream->Seek((int32_t)(mNextSequence % mNumSlots) * mSlotSize, DataStream::eSeekSet) &&
+			mStream->Write(recordSize, record) == recordSize;
+		if (success)
+		{
+			mNextSequence++;
+			if (mNextSequence - mOldestSequence > mNumSlots)
+			{
+				mOldestSequence++;
+			}
+		}
+	}
+	return(success);
+}
+
+/************************************ Read ************************************/
+bool LogStore::Read(
+	uint32_t	inSequence,
+	SHeader&	outHeader,
+	void*		ioBuffer)
+{
+	return(mNumSlots &&
+		inSequence - mOldestSequence < mNextSequence - mOldestSequence &&
+		ReadSlot(inSequence % mNumSlots, outHeader, ioBuffer) &&
+		outHeader.sequence == inSequence);
+}
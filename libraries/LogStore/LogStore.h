@@ -0,0 +1,128 @@
+/*
+*	LogStore.h, Copyright Jonathan Mackey 2026
+*	Wear leveled, log structured record store for EEPROM.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef LogStore_h
+#define LogStore_h
+
+#include <inttypes.h>
+class DataStream;
+
+/*
+*	The store is a circular log of fixed size slots, one EEPROM page per slot.
+*	Each record is written to a single page.  A record of 30 bytes or less
+*	(AT24C::WriteChunk's limit) costs one AT24C write cycle, a longer one
+*	two.  Every slot is written once per lap of the log, which levels the
+*	wear across the whole region.
+*
+*	Record (one slot):
+*		uint32_t	sequence;	// Increases by one per record
+*		uint8_t		type;		// Application defined
+*		uint8_t		length;		// Of the payload
+*		uint16_t	crc;		// CRC16 of the above and the payload
+*		uint8_t		payload[length];
+*
+*	A record with sequence S is always in slot S % NumSlots().  A slot is
+*	valid when its CRC matches and its sequence maps to the slot.  Erased
+*	EEPROM (all 0xFF) and torn writes from a power failure are invalid.
+*
+*	Mount finds the head (newest record) with a binary search: starting from
+*	slot 0, slots hold consecutive sequences up to the head, after which the
+*	slots either hold the previous lap or are invalid.  That's O(log N) slot
+*	reads rather than reading every slot.
+*
+*	Once the log has wrapped, an append writes over the oldest record, so an
+*	append interrupted by a power failure loses the oldest record as well.
+*
+*	The stream is typically an AT24CDataStream.  On the host a FileDataStream
+*	can be used for power failure testing.
+*/
+class LogStore
+{
+public:
+							LogStore(
+								DataStream*				inStream,
+								uint16_t				inSlotSize = 32);	// EEPROM page size
+	enum
+	{
+		eHeaderSize		= 8,
+		eMaxSlotSize	= 64
+	};
+	struct SHeader
+	{
+		uint32_t	sequence;
+		uint8_t		type;
+		uint8_t		length;
+		uint16_t	crc;
+	};
+							/*
+							*	Must be called before any other routine.
+							*	Returns the number of slots, 0 for an unusable
+							*	stream.
+							*/
+	uint16_t				Mount(void);
+							// Invalidates every slot.
+	void					Erase(void);
+	bool					Append(
+								uint8_t					inType,
+								const void*				inPayload,
+								uint8_t					inLength);
+							/*
+							*	To iterate from oldest to newest:
+							*	for (seq = OldestSequence();
+							*		seq != NextSequence(); seq++)
+							*	Read returns false for a record that has been
+							*	overwritten or is invalid, which can happen for
+							*	a slot damaged by a power failure.
+							*	ioBuffer needs to be MaxPayload() bytes.
+							*/
+	bool					Read(
+								uint32_t				inSequence,
+								SHeader&				outHeader,
+								void*					ioBuffer);
+	uint32_t				OldestSequence(void) const
+								{return(mOldestSequence);}
+	uint32_t				NextSequence(void) const
+								{return(mNextSequence);}
+	uint16_t				NumSlots(void) const
+								{return(mNumSlots);}
+	uint8_t					MaxPayload(void) const
+								{return(mSlotSize - eHeaderSize);}
+protected:
+	DataStream*	mStream;
+	uint32_t	mOldestSequence;
+	uint32_t	mNextSequence;
+	uint16_t	mNumSlots;
+	uint16_t	mSlotSize;
+
+	bool					ReadSlot(
+								uint16_t				inSlot,
+								SHeader&				outHeader,
+								void*					ioBuffer);
+	bool					ReadSlotHeader(
+								uint16_t				inSlot,
+								SHeader&				outHeader);
+	static uint16_t			RecordCRC(
+								const SHeader&			inHeader,
+								const void*				inPayload);
+};
+
+#endif // LogStore_h
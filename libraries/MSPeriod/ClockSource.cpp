@@ -0,0 +1,161 @@
+/*
+*	ClockSource.cpp, Copyright Jonathan Mackey 2026
+*	The millisecond/microsecond time base used by MSPeriod, USPeriod and
+*	anything else that needs to measure time.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "ClockSource.h"
+
+/*
+*	On the mcu everything is inlined in ClockSource.h
+*/
+#ifdef __MACH__
+#include <sys/time.h>
+#include <unistd.h>
+
+thread_local ClockSource::EMode	ClockSource::sMode = ClockSource::eHostWallClock;
+thread_local uint32_t			ClockSource::sTimeScale = 1;
+thread_local uint64_t			ClockSource::sWallClockStart;
+thread_local uint64_t			ClockSource::sBase;
+thread_local uint64_t			ClockSource::sNow;
+thread_local uint64_t			ClockSource::sNextSecond = 1000000;
+thread_local void				(*ClockSource::sSecondsCallback)(void);
+
+/********************************* WallClock **********************************/
+uint64_t ClockSource::WallClock(void)
+{
+	timeval	timeVal;
+	gettimeofday(&timeVal, nullptr);
+	return(((uint64_t)timeVal.tv_sec * 1000000) + timeVal.tv_usec);
+}
+
+/************************************ Now *************************************/
+uint64_t ClockSource::Now(void)
+{
+	if (sMode != eSimulated)
+	{
+		/*
+		*	The first call establishes the wall clock start.  Before
+		*	ClockSource, the host millis() was the raw gettimeofday ms, so
+		*	the base starts at the wall clock rather than zero.
+		*/
+		if (sWallClockStart == 0)
+		{
+			sWallClockStart = WallClock();
+			sBase = sWallClockStart;
+			sNextSecond = sBase - (sBase % 1000000) + 1000000;
+		}
+		sNow = sBase + ((WallClock() - sWallClockStart) * sTimeScale);
+		CheckSeconds();
+	}
+	return(sNow);
+}
+
+/********************************** SetMode ***********************************/
+void ClockSource::SetMode(
+	EMode	inMode)
+{
+	if (inMode != sMode)
+	{
+		uint64_t	now = Now();
+		sMode = inMode == eHardware ? eHostWallClock : inMode;
+		/*
+		*	Time continues from where the previous mode left off.
+		*/
+		if (sMode == eHostWallClock)
+		{
+			sWallClockStart = WallClock();
+			sBase = now;
+		}
+	}
+}
+
+/******************************** SetTimeScale ********************************/
+void ClockSource::SetTimeScale(
+	uint32_t	inTimeScale)
+{
+	uint64_t	now = Now();
+	sTimeScale = inTimeScale ? inTimeScale : 1;
+	sWallClockStart = WallClock();
+	sBase = now;
+}
+
+/********************************** Advance ***********************************/
+void ClockSource::Advance(
+	uint32_t	inMicroseconds)
+{
+	if (sMode == eSimulated)
+	{
+		sNow += inMicroseconds;
+		CheckSeconds();
+	}
+}
+
+/********************************** SetTime ***********************************/
+void ClockSource::SetTime(
+	uint64_t	inMicroseconds)
+{
+	if (sMode == eSimulated)
+	{
+		sNow = inMicroseconds;
+		sNextSecond = sNow - (sNow % 1000000) + 1000000;
+	}
+}
+
+/***************************** SetSecondsCallback *****************************/
+void ClockSource::SetSecondsCallback(
+	void	(*inSecondsCallback)(void))
+{
+	sSecondsCallback = inSecondsCallback;
+}
+
+/******************************** CheckSeconds ********************************/
+/*
+*	Calls the seconds callback once for each second boundary crossed since the
+*	last call, the same as the RTC would have done.
+*/
+void ClockSource::CheckSeconds(void)
+{
+	while (sNow >= sNextSecond)
+	{
+		sNextSecond += 1000000;
+		if (sSecondsCallback)
+		{
+			sSecondsCallback();
+		}
+	}
+}
+
+/***************************** DelayMicroseconds ******************************/
+/*
+*	In simulated mode a delay simply advances the clock.
+*/
+void ClockSource::DelayMicroseconds(
+	uint32_t	inMicroseconds)
+{
+	if (sMode == eSimulated)
+	{
+		Advance(inMicroseconds);
+	} else
+	{
+		usleep(inMicroseconds/sTimeScale);
+	}
+}
+#endif // __MACH__
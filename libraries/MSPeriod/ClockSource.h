@@ -0,0 +1,126 @@
+/*
+*	ClockSource.h, Copyright Jonathan Mackey 2026
+*	The millisecond/microsecond time base used by MSPeriod, USPeriod and
+*	anything else that needs to measure time.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef ClockSource_h
+#define ClockSource_h
+
+/*
+*	There are three backends:
+*	- eHardware: millis()/micros() of the Arduino core.  This is the only
+*	backend available on the mcu and every call is inlined to the core
+*	function, so there is no added overhead.
+*	- eHostWallClock: (host builds only) gettimeofday, optionally sped up by
+*	SetTimeScale().  A scale of 1000 runs a simulation at 1000x real time.
+*	- eSimulated: (host builds only) time only moves when Advance() is called.
+*	This makes anything driven by MSPeriod/USPeriod deterministic.
+*
+*	Host builds are any build where __MACH__ is defined (the same define used
+*	by the display tester.)  The host backend state is thread local so that
+*	independent simulations can run on separate threads.
+*
+*	Returned values are 32 bit and wrap exactly like millis()/micros(), so the
+*	elapsed time subtraction used by MSPeriod and USPeriod remains wrap safe.
+*/
+#ifndef __MACH__
+#include <Arduino.h>
+
+class ClockSource
+{
+public:
+	enum EMode
+	{
+		eHardware
+	};
+	static inline EMode		Mode(void)
+								{return(eHardware);}
+	static inline uint32_t	Millis(void)
+								{return(millis());}
+	static inline uint32_t	Micros(void)
+								{return(micros());}
+	static inline void		DelayMicroseconds(
+								uint32_t				inMicroseconds)
+								{delayMicroseconds(inMicroseconds);}
+};
+#else
+#include <inttypes.h>
+
+class ClockSource
+{
+public:
+	enum EMode
+	{
+		eHardware,		// Not available on the host, treated as eHostWallClock
+		eHostWallClock,
+		eSimulated
+	};
+	static void				SetMode(
+								EMode					inMode);
+	static inline EMode		Mode(void)
+								{return(sMode);}
+	static inline uint32_t	Millis(void)
+								{return((uint32_t)(Now()/1000));}
+	static inline uint32_t	Micros(void)
+								{return((uint32_t)Now());}
+	static void				DelayMicroseconds(
+								uint32_t				inMicroseconds);
+							/*
+							*	Wall clock speed multiplier (default 1)
+							*/
+	static void				SetTimeScale(
+								uint32_t				inTimeScale);
+							/*
+							*	Simulated clock.  Advance moves time forward,
+							*	SetTime jumps to an absolute time.  Setting the
+							*	time just before 0xFFFFFFFF is an easy way to
+							*	exercise the millis/micros wrap.
+							*/
+	static void				Advance(
+								uint32_t				inMicroseconds);
+	static void				AdvanceMillis(
+								uint32_t				inMilliseconds)
+								{Advance(inMilliseconds*1000);}
+	static void				SetTime(
+								uint64_t				inMicroseconds);
+							/*
+							*	Called once for every second that passes.  This
+							*	takes the place of the RTC seconds interrupt,
+							*	see UnixTime::AttachToClockSource().
+							*/
+	static void				SetSecondsCallback(
+								void					(*inSecondsCallback)(void));
+	static uint64_t			Now(void);	// Microseconds
+protected:
+	static thread_local EMode		sMode;
+	static thread_local uint32_t	sTimeScale;
+	static thread_local uint64_t	sWallClockStart;
+	static thread_local uint64_t	sBase;	// Now() when sWallClockStart was set
+	static thread_local uint64_t	sNow;	// Last Now(), the current time when simulated
+	static thread_local uint64_t	sNextSecond;
+	static thread_local void		(*sSecondsCallback)(void);
+
+	static uint64_t			WallClock(void);
+	static void				CheckSeconds(void);
+};
+#endif
+
+#endif // ClockSource_h
@@ -22,12 +22,8 @@
 #ifndef MSPeriod_h
 #define MSPeriod_h
 
-#ifndef __MACH__
-#include <Arduino.h>
-#else
-#include <sys/time.h>
-#include <inttypes.h>
-#endif
+#include "ClockSource.h"
+
 class MSPeriod
 {
 public:
@@ -43,20 +39,20 @@ public:
 	inline void				SetElapsed(void)
 								{mPeriod = ElapsedTime();}
 #ifdef __MACH__
-	static uint32_t			millis(void)
-							{
-								timeval	timeVal;
-								gettimeofday(&timeVal, nullptr);
-								return((uint32_t)((timeVal.tv_sec * 1000) + (timeVal.tv_usec/1000)));
-							}
+	static inline uint32_t	millis(void)
+								{return(ClockSource::Millis());}
 #endif
 	inline uint32_t			ElapsedTime(void) const
-								{return(millis() - mStart);}
+								{return(ClockSource::Millis() - mStart);}
 	inline bool				Passed(void) const
 								{return(mPeriod && ElapsedTime() >= mPeriod);}
+							// ms until Passed(), 0 if it has or is disabled.
+	inline uint32_t			Remaining(void) const
+								{uint32_t elapsed = ElapsedTime();
+								 return(elapsed < mPeriod ? (mPeriod - elapsed) : 0);}
 	inline void				Start(
 								uint32_t				inDelta = 0)
-								{mStart = millis() + inDelta;}
+								{mStart = ClockSource::Millis() + inDelta;}
 protected:
 	uint32_t	mStart;
 	uint32_t	mPeriod;
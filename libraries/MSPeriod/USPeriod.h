@@ -22,7 +22,7 @@
 #ifndef USPeriod_h
 #define USPeriod_h
 
-#include <Arduino.h>
+#include "ClockSource.h"
 
 class USPeriod
 {
@@ -39,12 +39,12 @@ public:
 	inline void				SetElapsed(void)
 								{mPeriod = ElapsedTime();}
 	inline uint32_t			ElapsedTime(void) const
-								{return(micros() - mStart);}
+								{return(ClockSource::Micros() - mStart);}
 	inline bool				Passed(void) const
 								{return(mPeriod && ElapsedTime() >= mPeriod);}
 	inline void				Start(
 								uint32_t				inDelta = 0)
-								{mStart = micros() + inDelta;}
+								{mStart = ClockSource::Micros() + inDelta;}
 	inline void				Delay(void) const
 								{
 									if (mPeriod)
@@ -52,7 +52,7 @@ public:
 										uint32_t elapsed = ElapsedTime();
 										if (elapsed < mPeriod)
 										{
-											delayMicroseconds(mPeriod - elapsed);
+											ClockSource::DelayMicroseconds(mPeriod - elapsed);
 										}
 									}
 								}
@@ -0,0 +1,166 @@
+/*
+*	MemoryStats.cpp, Copyright Jonathan Mackey 2026
+*	Static RAM, heap and stack high-water diagnostics.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "MemoryStats.h"
+#if MEMORY_STATS_ENABLED
+
+#ifndef __MACH__
+/*
+*	Defined by the STM32 core's linker script and syscalls (_sbrk returns
+*	the current end of the heap when passed 0.)
+*/
+extern "C"
+{
+extern uint8_t	_sdata;
+extern uint8_t	_edata;
+extern uint8_t	_sbss;
+extern uint8_t	_ebss;
+extern uint8_t	_end;
+void*	_sbrk(int incr);
+}
+#else
+uintptr_t	MemoryStats::sStackTop;
+#endif
+uint32_t*	MemoryStats::sPaintBottom;
+StackProbe*	StackProbe::sFirst;
+
+/********************************** HeapEnd ***********************************/
+/*
+*	The first word above the heap.
+*/
+uint32_t* MemoryStats::HeapEnd(void)
+{
+#ifndef __MACH__
+	uintptr_t	heapEnd = (uintptr_t)_sbrk(0);
+	return((uint32_t*)((heapEnd + 3) & ~(uintptr_t)3));
+#else
+	return(nullptr);
+#endif
+}
+
+/********************************* PaintStack *********************************/
+void MemoryStats::PaintStack(void)
+{
+#ifndef __MACH__
+	uint32_t*	word = HeapEnd();
+	uint32_t*	end = (uint32_t*)((StackPointer() - eGuard) & ~(uintptr_t)3);
+	sPaintBottom = word;
+	while (word < end)
+	{
+		*(word++) = ePaint;
+	}
+#else
+	sStackTop = (uintptr_t)__builtin_frame_address(0);
+#endif
+	StackProbe::ResetAll();
+}
+
+/******************************* FirstUnpainted *******************************/
+/*
+*	The heap may have grown into the painted area since it was painted, so
+*	the search starts at the current end of the heap.
+*/
+uint32_t* MemoryStats::FirstUnpainted(void)
+{
+	uint32_t*	word = HeapEnd();
+#ifndef __MACH__
+	uint32_t*	top = (uint32_t*)StackTop();
+	if (word < sPaintBottom)
+	{
+		word = sPaintBottom;
+	}
+	for (; word < top && *word == ePaint; word++){}
+#endif
+	return(word);
+}
+
+/********************************* StackUsed **********************************/
+uint32_t MemoryStats::StackUsed(void)
+{
+	return(sPaintBottom ? StackTop() - (uintptr_t)FirstUnpainted() : 0);
+}
+
+/********************************* StackFree **********************************/
+uint32_t MemoryStats::StackFree(void)
+{
+	return(sPaintBottom ? (uintptr_t)FirstUnpainted() - (uintptr_t)HeapEnd() : 0);
+}
+
+/********************************** DataSize **********************************/
+uint32_t MemoryStats::DataSize(void)
+{
+#ifndef __MACH__
+	return(&_edata - &_sdata);
+#else
+	return(0);
+#endif
+}
+
+/********************************** BssSize ***********************************/
+uint32_t MemoryStats::BssSize(void)
+{
+#ifndef __MACH__
+	return(&_ebss - &_sbss);
+#else
+	return(0);
+#endif
+}
+
+/********************************** HeapSize **********************************/
+uint32_t MemoryStats::HeapSize(void)
+{
+#ifndef __MACH__
+	return((uint8_t*)_sbrk(0) - &_end);
+#else
+	return(0);
+#endif
+}
+
+/********************************** RAMSize ***********************************/
+uint32_t MemoryStats::RAMSize(void)
+{
+#ifndef __MACH__
+	return(StackTop() - (uintptr_t)&_sdata);
+#else
+	return(0);
+#endif
+}
+
+/********************************* StackProbe *********************************/
+StackProbe::StackProbe(
+	const char*	inName)
+	: mName(inName), mNext(nullptr), mMaxDepth(0)
+{
+	StackProbe**	link = &sFirst;
+	for (; *link; link = &(*link)->mNext){}
+	*link = this;
+}
+
+/********************************** ResetAll **********************************/
+void StackProbe::ResetAll(void)
+{
+	for (StackProbe* probe = sFirst; probe; probe = probe->mNext)
+	{
+		probe->mMaxDepth = 0;
+	}
+}
+#endif // MEMORY_STATS_ENABLED
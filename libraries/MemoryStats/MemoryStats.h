@@ -0,0 +1,145 @@
+/*
+*	MemoryStats.h, Copyright Jonathan Mackey 2026
+*	Static RAM, heap and stack high-water diagnostics.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef MemoryStats_h
+#define MemoryStats_h
+
+/*
+*	Define MEMORY_STATS_ENABLED as 0 to remove the diagnostics.  STACK_PROBE
+*	then expands to nothing and the classes aren't declared.
+*/
+#ifndef MEMORY_STATS_ENABLED
+#define MEMORY_STATS_ENABLED	1
+#endif
+
+#if MEMORY_STATS_ENABLED
+#include <inttypes.h>
+#include <stddef.h>
+#ifndef __MACH__
+#include <Arduino.h>
+extern "C" uint8_t	_estack;	// From the linker script, the top of RAM
+#endif
+
+/*
+*	STACK_PROBE(Name) records the deepest the stack has been at this point.
+*	Place it after any variable length arrays in the function so that they
+*	are included.  Name is an identifier, it's also the name reported.
+*/
+#define STACK_PROBE(name)	static StackProbe sStackProbe##name(#name); \
+								sStackProbe##name.Note()
+
+/*
+*	RAM from low to high addresses: .data, .bss, the heap (growing up) and
+*	the stack (growing down from _estack.)  PaintStack fills the gap between
+*	the heap and the stack with a pattern, StackUsed finds the lowest word
+*	no longer holding the pattern.  Call PaintStack first thing in setup().
+*
+*	On the host (__MACH__) there are no linker symbols, the sizes are 0 and
+*	the stack top is the frame that called PaintStack.
+*/
+class MemoryStats
+{
+public:
+							/*
+							*	Fills the free RAM below the current stack
+							*	pointer.  Calling it again restarts the
+							*	high-water mark.
+							*/
+	static void				PaintStack(void);
+							/*
+							*	Bytes used below the stack top, high-water.
+							*	0 until PaintStack is called.
+							*/
+	static uint32_t			StackUsed(void);
+							// Bytes never used between the heap and stack
+	static uint32_t			StackFree(void);
+	static uint32_t			DataSize(void);
+	static uint32_t			BssSize(void);
+	static uint32_t			HeapSize(void);
+							// .data through the stack top
+	static uint32_t			RAMSize(void);
+#ifndef __MACH__
+	static inline uintptr_t	StackTop(void)
+								{return((uintptr_t)&_estack);}
+	static inline uintptr_t	StackPointer(void)
+								{return(__get_MSP());}
+#else
+	static inline uintptr_t	StackTop(void)
+								{return(sStackTop);}
+	static inline uintptr_t	StackPointer(void)
+								{return((uintptr_t)__builtin_frame_address(0));}
+#endif
+protected:
+#ifdef __MACH__
+	static uintptr_t		sStackTop;
+#endif
+	static uint32_t*		sPaintBottom;
+
+	static uint32_t*		HeapEnd(void);
+	static uint32_t*		FirstUnpainted(void);
+	enum
+	{
+		ePaint	= 0xC5C5C5C5,
+		eGuard	= 64	// Bytes left unpainted below the stack pointer
+	};
+};
+
+/*
+*	The deepest stack seen at a STACK_PROBE.  The probes are linked in the
+*	order first reached.
+*/
+class StackProbe
+{
+public:
+							StackProbe(
+								const char*				inName);
+	inline void				Note(void)
+							{
+								uintptr_t	top = MemoryStats::StackTop();
+								uintptr_t	sp = MemoryStats::StackPointer();
+								uint32_t	depth = top > sp ? top - sp : 0;
+								if (depth > mMaxDepth)
+								{
+									mMaxDepth = depth;
+								}
+							}
+	const char*				Name(void) const
+								{return(mName);}
+							// Bytes below the stack top
+	uint32_t				MaxDepth(void) const
+								{return(mMaxDepth);}
+	StackProbe*				Next(void) const
+								{return(mNext);}
+	static StackProbe*		First(void)
+								{return(sFirst);}
+	static void				ResetAll(void);
+protected:
+	const char*			mName;
+	StackProbe*			mNext;
+	uint32_t			mMaxDepth;
+	static StackProbe*	sFirst;
+};
+#else
+#define STACK_PROBE(name)
+#endif // MEMORY_STATS_ENABLED
+
+#endif // MemoryStats_h
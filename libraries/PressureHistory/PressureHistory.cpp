@@ -0,0 +1,285 @@
+/*
+*	PressureHistory.cpp, Copyright Jonathan Mackey 2026
+*	Fixed memory, multi-resolution history of the static pressure, ambient
+*	pressure and temperature.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "PressureHistory.h"
+#include "AT24C.h"
+#include <string.h>
+
+/*
+*	The spread scales (min and max distance from the mean) get coarser as the
+*	resolution decreases.  At 4 hours the ambient pressure spread can be 1020
+*	Pa and the temperature spread 25.5°C before saturating.
+*/
+const PressureHistory::STierDesc PressureHistory::kTierDesc[] =
+{
+	{0,		eRawEntries,		1, 1, 1},	// eRawTier (spreads not used)
+	{60,	eMinuteEntries,		1, 1, 1},	// eMinuteTier
+	{600,	eTenMinuteEntries,	2, 2, 5},	// eTenMinuteTier
+	{14400,	eFourHourEntries,	4, 4, 10}	// eFourHourTier
+};
+const uint32_t PressureHistory::kAmbientBase = 50000;	// Pa
+
+/****************************** PressureHistory *******************************/
+PressureHistory::PressureHistory(
+	AT24C*		inEEPROM,
+	uint16_t	inEEPROMAddress)
+	: mEEPROM(inEEPROM), mEEPROMAddress(inEEPROMAddress), mLastTime(0),
+	  mRawHead(0), mRawCount(0)
+{
+	// 0xFF is the same as erased EEPROM, so the minute tier starts out invalid
+	// the same as the EEPROM tiers of a new board.
+	memset(mMinute, 0xFF, sizeof(mMinute));
+	memset(mAccumulator, 0, sizeof(mAccumulator));
+}
+
+/********************************* NumEntries *********************************/
+uint16_t PressureHistory::NumEntries(
+	ETier	inTier)
+{
+	return(kTierDesc[inTier].numEntries);
+}
+
+/********************************* Resolution *********************************/
+uint32_t PressureHistory::Resolution(
+	ETier	inTier)
+{
+	return(kTierDesc[inTier].resolution);
+}
+
+/********************************* AddSample **********************************/
+void PressureHistory::AddSample(
+	time32_t	inTime,
+	int32_t		inStaticPressure,
+	uint32_t	inAmbientPressure,
+	int32_t		inTemperature)
+{
+	mLastTime = inTime;
+	SRawSample&	raw = mRaw[mRawHead];
+	raw.staticPressure = (int16_t)inStaticPressure;
+	raw.ambientPressure = (uint16_t)(inAmbientPressure - kAmbientBase);
+	raw.temperature = (int16_t)inTemperature;
+	raw.time = (uint16_t)inTime;
+	mRawHead++;
+	if (mRawHead >= eRawEntries)
+	{
+		mRawHead = 0;
+	}
+	if (mRawCount < eRawEntries)
+	{
+		mRawCount++;
+	}
+
+	SAccumulator	sample;
+	sample.bucket = inTime / kTierDesc[eMinuteTier].resolution;
+	sample.count = 1;
+	sample.staticCount = inStaticPressure != eNoStaticPressure;
+	sample.staticMin = sample.staticMax = inStaticPressure;
+	sample.staticSum = sample.staticCount ? inStaticPressure : 0;
+	sample.ambientMin = sample.ambientMax = inAmbientPressure;
+	sample.ambientSum = inAmbientPressure;
+	sample.tempMin = sample.tempMax = inTemperature;
+	sample.tempSum = inTemperature;
+	Accumulate(eMinuteTier, sample);
+}
+
+/********************************* Accumulate *********************************/
+/*
+*	Adds inValues to the tier's accumulator.  If inValues belongs to a
+*	different bucket then the current bucket is complete and is rolled up
+*	first.
+*/
+void PressureHistory::Accumulate(
+	uint8_t				inTier,
+	const SAccumulator&	inValues)
+{
+	SAccumulator&	acc = mAccumulator[inTier];
+	if (acc.count &&
+		acc.bucket != inValues.bucket)
+	{
+		EmitRollup(inTier);
+		acc.count = 0;
+	}
+	if (acc.count == 0)
+	{
+		acc = inValues;
+	} else
+	{
+		acc.count += inValues.count;
+		if (inValues.staticCount)
+		{
+			if (acc.staticCount == 0 || inValues.staticMin < acc.staticMin) acc.staticMin = inValues.staticMin;
+			if (acc.staticCount == 0 || inValues.staticMax > acc.staticMax) acc.staticMax = inValues.staticMax;
+			acc.staticCount += inValues.staticCount;
+			acc.staticSum += inValues.staticSum;
+		}
+		if (inValues.ambientMin < acc.ambientMin) acc.ambientMin = inValues.ambientMin;
+		if (inValues.ambientMax > acc.ambientMax) acc.ambientMax = inValues.ambientMax;
+		acc.ambientSum += inValues.ambientSum;
+		if (inValues.tempMin < acc.tempMin) acc.tempMin = inValues.tempMin;
+		if (inValues.tempMax > acc.tempMax) acc.tempMax = inValues.tempMax;
+		acc.tempSum += inValues.tempSum;
+	}
+}
+
+/*********************************** Spread ***********************************/
+uint8_t PressureHistory::Spread(
+	int32_t	inDistance,
+	uint8_t	inScale)
+{
+	// Rounded up so the decoded min/max always encloses the actual min/max.
+	int32_t	spread = (inDistance + inScale - 1) / inScale;
+	return(spread > 255 ? 255 : (uint8_t)spread);
+}
+
+/********************************* EmitRollup *********************************/
+/*
+*	Stores the completed bucket of inTier and passes it on to the next tier.
+*	The sums carry on to the next tier rather than the means so that the next
+*	tier's mean is correctly weighted by the number of samples.
+*/
+void PressureHistory::EmitRollup(
+	uint8_t	inTier)
+{
+	const SAccumulator&	acc = mAccumulator[inTier];
+	const STierDesc&	desc = kTierDesc[inTier];
+	SRollup		rollup;
+	uint32_t	ambientMean = (uint32_t)(acc.ambientSum / (int32_t)acc.count);
+	int32_t		tempMean = (int32_t)(acc.tempSum / (int32_t)acc.count);
+	if (acc.staticCount)
+	{
+		int32_t	staticMean = (int32_t)(acc.staticSum / (int32_t)acc.staticCount);
+		rollup.staticMean = (int16_t)staticMean;
+		rollup.staticBelow = Spread(staticMean - acc.staticMin, desc.staticScale);
+		rollup.staticAbove = Spread(acc.staticMax - staticMean, desc.staticScale);
+	} else
+	{
+		rollup.staticMean = eNoStaticPressure;
+		rollup.staticBelow = rollup.staticAbove = 0;
+	}
+	rollup.ambientMean = (uint16_t)(ambientMean - kAmbientBase);
+	rollup.ambientBelow = Spread(ambientMean - acc.ambientMin, desc.ambientScale);
+	rollup.ambientAbove = Spread(acc.ambientMax - ambientMean, desc.ambientScale);
+	rollup.tempMean = (int16_t)tempMean;
+	rollup.tempBelow = Spread(tempMean - acc.tempMin, desc.tempScale);
+	rollup.tempAbove = Spread(acc.tempMax - tempMean, desc.tempScale);
+	rollup.bucket = (uint16_t)acc.bucket;
+	WriteRollup(inTier, rollup);
+
+	if (inTier + 1 < eNumTiers)
+	{
+		SAccumulator	values = acc;
+		values.bucket = (acc.bucket * desc.resolution) / kTierDesc[inTier+1].resolution;
+		Accumulate(inTier + 1, values);
+	}
+}
+
+/******************************** WriteRollup *********************************/
+void PressureHistory::WriteRollup(
+	uint8_t			inTier,
+	const SRollup&	inRollup)
+{
+	uint16_t	slot = (uint16_t)(mAccumulator[inTier].bucket % kTierDesc[inTier].numEntries);
+	if (inTier == eMinuteTier)
+	{
+		mMinute[slot] = inRollup;
+	} else if (mEEPROM)
+	{
+		uint16_t	address = mEEPROMAddress + (slot * sizeof(SRollup));
+		if (inTier == eFourHourTier)
+		{
+			address += eTenMinuteEntries * sizeof(SRollup);
+		}
+		// Queued so that sampling isn't stalled by the EEPROM write cycle.
+		mEEPROM->QueueWrite(address, sizeof(SRollup), (const uint8_t*)&inRollup);
+	}
+}
+
+/********************************* ReadRollup *********************************/
+bool PressureHistory::ReadRollup(
+	uint8_t		inTier,
+	uint16_t	inSlot,
+	SRollup&	outRollup)
+{
+	bool	success = true;
+	if (inTier == eMinuteTier)
+	{
+		outRollup = mMinute[inSlot];
+	} else if (mEEPROM)
+	{
+		uint16_t	address = mEEPROMAddress + (inSlot * sizeof(SRollup));
+		if (inTier == eFourHourTier)
+		{
+			address += eTenMinuteEntries * sizeof(SRollup);
+		}
+		success = mEEPROM->Read(address, sizeof(SRollup), (uint8_t*)&outRollup) == sizeof(SRollup);
+	} else
+	{
+		success = false;
+	}
+	return(success);
+}
+
+/********************************** GetEntry **********************************/
+bool PressureHistory::GetEntry(
+	ETier		inTier,
+	uint16_t	inAge,
+	SValues&	outValues)
+{
+	bool	success = false;
+	if (inTier == eRawTier)
+	{
+		if (inAge < mRawCount)
+		{
+			const SRawSample&	raw = mRaw[(mRawHead + eRawEntries - 1 - inAge) % eRawEntries];
+			// Only the low 16 bits of the time are stored.  The difference
+			// from the newest sample is wrap safe (the raw tier spans minutes.)
+			outValues.time = mLastTime - (uint16_t)((uint16_t)mLastTime - raw.time);
+			outValues.staticMin = outValues.staticMean = outValues.staticMax = raw.staticPressure;
+			outValues.ambientMin = outValues.ambientMean = outValues.ambientMax =
+				raw.ambientPressure + kAmbientBase;
+			outValues.tempMin = outValues.tempMean = outValues.tempMax = raw.temperature;
+			success = true;
+		}
+	} else if (inAge < kTierDesc[inTier].numEntries && mLastTime)
+	{
+		const STierDesc&	desc = kTierDesc[inTier];
+		uint32_t	bucket = (mLastTime / desc.resolution) - 1 - inAge;
+		SRollup		rollup;
+		if (ReadRollup(inTier, (uint16_t)(bucket % desc.numEntries), rollup) &&
+			rollup.bucket == (uint16_t)bucket)
+		{
+			outValues.time = bucket * desc.resolution;
+			outValues.staticMean = rollup.staticMean;
+			outValues.staticMin = rollup.staticMean - (rollup.staticBelow * desc.staticScale);
+			outValues.staticMax = rollup.staticMean + (rollup.staticAbove * desc.staticScale);
+			outValues.ambientMean = rollup.ambientMean + kAmbientBase;
+			outValues.ambientMin = outValues.ambientMean - (rollup.ambientBelow * desc.ambientScale);
+			outValues.ambientMax = outValues.ambientMean + (rollup.ambientAbove * desc.ambientScale);
+			outValues.tempMean = rollup.tempMean;
+			outValues.tempMin = rollup.tempMean - (rollup.tempBelow * desc.tempScale);
+			outValues.tempMax = rollup.tempMean + (rollup.tempAbove * desc.tempScale);
+			success = true;
+		}
+	}
+	return(success);
+}
@@ -0,0 +1,215 @@
+/*
+*	PressureHistory.h, Copyright Jonathan Mackey 2026
+*	Fixed memory, multi-resolution history of the static pressure, ambient
+*	pressure and temperature.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef PressureHistory_h
+#define PressureHistory_h
+
+#include <inttypes.h>
+#include "UnixTime.h"
+
+class AT24C;
+
+/*
+*	The number of entries in each tier.  A raw entry takes 8 bytes and a
+*	minute entry 14 bytes of RAM (about 2.4KB with the defaults.)  The EEPROM
+*	tiers take 14 bytes per entry of EEPROM, see EEPROMSize().
+*/
+#ifndef PRESSURE_HISTORY_RAW_ENTRIES
+#define PRESSURE_HISTORY_RAW_ENTRIES		200
+#endif
+#ifndef PRESSURE_HISTORY_MINUTE_ENTRIES
+#define PRESSURE_HISTORY_MINUTE_ENTRIES		60
+#endif
+#ifndef PRESSURE_HISTORY_TEN_MINUTE_ENTRIES
+#define PRESSURE_HISTORY_TEN_MINUTE_ENTRIES	144
+#endif
+#ifndef PRESSURE_HISTORY_FOUR_HOUR_ENTRIES
+#define PRESSURE_HISTORY_FOUR_HOUR_ENTRIES	180
+#endif
+
+/*
+*	The history is kept in tiers, similar to an RRD database:
+*
+*	Tier			Resolution		Entries		Span		Stored in
+*	eRawTier		each sample		200			~5 min		RAM
+*	eMinuteTier		1 minute		60			1 hour		RAM
+*	eTenMinuteTier	10 minutes		144			24 hours	EEPROM
+*	eFourHourTier	4 hours			180			30 days		EEPROM
+*
+*	The entries shown are the defaults.
+*
+*	Each sample is added to the raw tier and to the accumulator of the minute
+*	tier.  When a minute ends the minute's rollup (min/mean/max) is stored and
+*	added to the ten minute accumulator, and so on.  This is O(1) per sample.
+*
+*	Rollup entries are stored in the slot (bucket % entries) where bucket is
+*	the time divided by the tier resolution.  Each entry also stores the low
+*	16 bits of its bucket so a stale or erased slot is easily recognized.
+*	There is no head pointer to maintain, so nothing needs to be recovered
+*	at startup and an EEPROM tier costs one entry write per bucket.
+*
+*	The partially accumulated bucket of each tier is lost on reset.
+*
+*	A sample without a static pressure (eNoStaticPressure, e.g. while the
+*	delta averages are loading) still adds its ambient pressure and
+*	temperature.  A rollup's static values only cover the samples that have
+*	one.  If none do, they're eNoStaticPressure.
+*/
+class PressureHistory
+{
+public:
+							PressureHistory(
+								AT24C*					inEEPROM,
+								uint16_t				inEEPROMAddress);
+	enum ETier
+	{
+		eRawTier,
+		eMinuteTier,
+		eTenMinuteTier,
+		eFourHourTier,
+		eNumTiers
+	};
+	enum EConfig
+	{
+		eRawEntries			= PRESSURE_HISTORY_RAW_ENTRIES,
+		eMinuteEntries		= PRESSURE_HISTORY_MINUTE_ENTRIES,
+		eTenMinuteEntries	= PRESSURE_HISTORY_TEN_MINUTE_ENTRIES,
+		eFourHourEntries	= PRESSURE_HISTORY_FOUR_HOUR_ENTRIES
+	};
+	enum
+	{
+		eNoStaticPressure	= -32768	// For inStaticPressure and SValues
+	};
+	struct SValues
+	{
+		time32_t	time;		// Start of the bucket, or time of the raw sample.
+		int32_t		staticMin;	// Pa, or eNoStaticPressure
+		int32_t		staticMean;
+		int32_t		staticMax;
+		uint32_t	ambientMin;	// Pa
+		uint32_t	ambientMean;
+		uint32_t	ambientMax;
+		int32_t		tempMin;	// 0.01°C
+		int32_t		tempMean;
+		int32_t		tempMax;
+	};
+	void					AddSample(
+								time32_t				inTime,
+								int32_t					inStaticPressure,
+								uint32_t				inAmbientPressure,
+								int32_t					inTemperature);
+							/*
+							*	Returns the entry inAge buckets (or samples
+							*	for eRawTier) before the newest.  For rollup
+							*	tiers the newest is the last completed bucket.
+							*	False is returned if there is no entry, such as
+							*	when the unit was off for the bucket.
+							*/
+	bool					GetEntry(
+								ETier					inTier,
+								uint16_t				inAge,
+								SValues&				outValues);
+	static uint16_t			NumEntries(
+								ETier					inTier);
+	static uint32_t			Resolution(	// In seconds, 0 for eRawTier
+								ETier					inTier);
+	static constexpr uint16_t	EEPROMSize(void)	// Bytes used in EEPROM
+								{return((eTenMinuteEntries + eFourHourEntries) * sizeof(SRollup));}
+protected:
+	/*
+	*	Min and max are stored as unsigned distances from the mean (delta
+	*	encoded) in units of the tier's spread scale.  These saturate at 255.
+	*	The ambient pressure is stored as an offset from kAmbientBase.
+	*/
+	struct SRawSample
+	{
+		int16_t		staticPressure;
+		uint16_t	ambientPressure;	// - kAmbientBase
+		int16_t		temperature;
+		uint16_t	time;				// Low 16 bits of the time
+	};
+	struct SRollup
+	{
+		int16_t		staticMean;
+		uint8_t		staticBelow;
+		uint8_t		staticAbove;
+		uint16_t	ambientMean;		// - kAmbientBase
+		uint8_t		ambientBelow;
+		uint8_t		ambientAbove;
+		int16_t		tempMean;
+		uint8_t		tempBelow;
+		uint8_t		tempAbove;
+		uint16_t	bucket;				// Low 16 bits of the bucket
+	};
+	struct SAccumulator
+	{
+		uint32_t	bucket;
+		uint32_t	count;
+		uint32_t	staticCount;	// Samples with a static pressure
+		int32_t		staticMin;
+		int32_t		staticMax;
+		int64_t		staticSum;
+		uint32_t	ambientMin;
+		uint32_t	ambientMax;
+		int64_t		ambientSum;
+		int32_t		tempMin;
+		int32_t		tempMax;
+		int64_t		tempSum;
+	};
+	struct STierDesc
+	{
+		uint32_t	resolution;		// seconds
+		uint16_t	numEntries;
+		uint8_t		staticScale;	// Pa per spread unit
+		uint8_t		ambientScale;	// Pa per spread unit
+		uint8_t		tempScale;		// 0.01°C per spread unit
+	};
+	AT24C*			mEEPROM;
+	uint16_t		mEEPROMAddress;
+	time32_t		mLastTime;		// Time of the newest sample
+	uint16_t		mRawHead;		// Index of the next raw sample
+	uint16_t		mRawCount;
+	SRawSample		mRaw[eRawEntries];
+	SRollup			mMinute[eMinuteEntries];
+	SAccumulator	mAccumulator[eNumTiers];	// [eRawTier] unused
+	static const STierDesc	kTierDesc[eNumTiers];
+	static const uint32_t	kAmbientBase;
+
+	void					Accumulate(
+								uint8_t					inTier,
+								const SAccumulator&		inValues);	// inValues.bucket in inTier units
+	void					EmitRollup(
+								uint8_t					inTier);
+	void					WriteRollup(
+								uint8_t					inTier,
+								const SRollup&			inRollup);
+	bool					ReadRollup(
+								uint8_t					inTier,
+								uint16_t				inSlot,
+								SRollup&				outRollup);
+	static uint8_t			Spread(
+								int32_t					inDistance,
+								uint8_t					inScale);
+};
+
+#endif // PressureHistory_h
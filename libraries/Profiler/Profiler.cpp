@@ -0,0 +1,159 @@
+/*
+*	Profiler.cpp, Copyright Jonathan Mackey 2026
+*	Named scope timing with log bucketed histograms.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "Profiler.h"
+#if PROFILER_ENABLED
+#include <string.h>
+
+ProfileHistogram*	Profiler::sFirst;
+ProfileHistogram	Profiler::sLoop("Loop", false);
+uint32_t			Profiler::sLoopStart;
+uint32_t			Profiler::sBudget;
+uint32_t			Profiler::sOverBudget;
+
+/****************************** ProfileHistogram ******************************/
+ProfileHistogram::ProfileHistogram(
+	const char*	inName,
+	bool		inRegister)
+	: mName(inName), mNext(nullptr)
+{
+	Reset();
+	if (inRegister)
+	{
+		ProfileHistogram**	link = &Profiler::sFirst;
+		for (; *link; link = &(*link)->mNext){}
+		*link = this;
+	}
+}
+
+/************************************ Reset ***********************************/
+void ProfileHistogram::Reset(void)
+{
+	mCount = 0;
+	mMax = 0;
+	mLoop = 0;
+	mWorstLoop = 0;
+	memset(mBuckets, 0, sizeof(mBuckets));
+}
+
+/************************************* Add ************************************/
+void ProfileHistogram::Add(
+	uint32_t	inCycles)
+{
+	uint32_t	bucket = 0;
+	if (inCycles >> eMinBits)
+	{
+		// The number of significant bits less eMinBits
+		bucket = 32 - __builtin_clz(inCycles) - eMinBits;
+		if (bucket >= eNumBuckets)
+		{
+			bucket = eNumBuckets - 1;
+		}
+	}
+	mBuckets[bucket]++;
+	mCount++;
+	mLoop += inCycles;
+	if (inCycles > mMax)
+	{
+		mMax = inCycles;
+	}
+}
+
+/********************************* Percentile *********************************/
+uint32_t ProfileHistogram::Percentile(
+	uint8_t	inPercent) const
+{
+	uint32_t	percentile = 0;
+	if (mCount)
+	{
+		// The rank of the percentile, rounded up
+		uint32_t	rank = (uint32_t)(((uint64_t)mCount * inPercent + 99) / 100);
+		uint32_t	count = 0;
+		uint8_t		bucket = 0;
+		for (; bucket < eNumBuckets - 1; bucket++)
+		{
+			count += mBuckets[bucket];
+			if (count >= rank)
+			{
+				break;
+			}
+		}
+		percentile = bucket < eNumBuckets - 1 ?
+			(((uint32_t)1 << (eMinBits + bucket)) - 1) : mMax;
+		if (percentile > mMax)
+		{
+			percentile = mMax;
+		}
+	}
+	return(percentile);
+}
+
+/************************************ begin ***********************************/
+void Profiler::begin(void)
+{
+#ifndef __MACH__
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	Reset();
+}
+
+/******************************** LoopBoundary ********************************/
+void Profiler::LoopBoundary(void)
+{
+	uint32_t	now = Cycles();
+	uint32_t	period = now - sLoopStart;
+	sLoopStart = now;
+	if (sBudget &&
+		period > sBudget)
+	{
+		sOverBudget++;
+	}
+	bool	worst = period > sLoop.mMax;
+	sLoop.Add(period);
+	if (worst)
+	{
+		sLoop.mWorstLoop = period;
+	}
+	for (ProfileHistogram* histogram = sFirst; histogram; histogram = histogram->mNext)
+	{
+		if (worst)
+		{
+			histogram->mWorstLoop = histogram->mLoop;
+		}
+		histogram->mLoop = 0;
+	}
+}
+
+/************************************ Reset ***********************************/
+void Profiler::Reset(void)
+{
+	sLoop.Reset();
+	for (ProfileHistogram* histogram = sFirst; histogram; histogram = histogram->mNext)
+	{
+		histogram->Reset();
+	}
+	sOverBudget = 0;
+	sLoopStart = Cycles();
+}
+#endif // PROFILER_ENABLED
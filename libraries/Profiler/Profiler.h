@@ -0,0 +1,174 @@
+/*
+*	Profiler.h, Copyright Jonathan Mackey 2026
+*	Named scope timing with log bucketed histograms.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef Profiler_h
+#define Profiler_h
+
+/*
+*	The profiler is off by default, its histograms use about 1.2KB of RAM.
+*	Define PROFILER_ENABLED as 1 (-DPROFILER_ENABLED=1) to add it for a
+*	profiling build.  When off, PROFILE_SCOPE and PROFILE_LOOP expand to
+*	nothing, so there's no code, RAM or time cost, and the Profiler classes
+*	aren't declared.
+*/
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED	0
+#endif
+
+#if PROFILER_ENABLED
+#include <inttypes.h>
+#ifndef __MACH__
+#include <Arduino.h>
+#else
+#include "ClockSource.h"
+#endif
+
+/*
+*	PROFILE_SCOPE(Name) times the rest of the enclosing block.  Name is an
+*	identifier, it's also the name reported.  The histogram is a function
+*	static, registered the first time the scope is entered.
+*
+*	PROFILE_LOOP() marks the start of each main loop pass (see Profiler.)
+*/
+#define PROFILE_SCOPE(name)	static ProfileHistogram sProfile##name(#name); \
+								ProfileTimer	profileTimer##name(sProfile##name)
+#define PROFILE_LOOP()		Profiler::LoopBoundary()
+
+/*
+*	Bucket 0 counts durations under 2^eMinBits cycles, bucket n durations
+*	from 2^(eMinBits+n-1) to 2^(eMinBits+n)-1, and the last bucket
+*	everything longer.  Percentiles are reported as the upper bound of the
+*	bucket they fall in, so they're within a factor of 2.  The maximum is
+*	exact.
+*/
+class ProfileHistogram
+{
+public:
+							/*
+							*	A histogram is added to the Profiler's list
+							*	unless inRegister is false.
+							*/
+							ProfileHistogram(
+								const char*				inName,
+								bool					inRegister = true);
+	void					Add(
+								uint32_t				inCycles);
+	void					Reset(void);
+	const char*				Name(void) const
+								{return(mName);}
+	uint32_t				Count(void) const
+								{return(mCount);}
+	uint32_t				Max(void) const
+								{return(mMax);}
+							// inPercent 1 to 100
+	uint32_t				Percentile(
+								uint8_t					inPercent) const;
+							// Cycles in the worst loop so far
+	uint32_t				WorstLoop(void) const
+								{return(mWorstLoop);}
+	ProfileHistogram*		Next(void) const
+								{return(mNext);}
+	enum
+	{
+		eMinBits	= 7,
+		eNumBuckets	= 24
+	};
+protected:
+	friend class Profiler;
+	const char*			mName;
+	ProfileHistogram*	mNext;
+	uint32_t			mCount;
+	uint32_t			mMax;
+	uint32_t			mLoop;		// Cycles in the current loop pass
+	uint32_t			mWorstLoop;
+	uint32_t			mBuckets[eNumBuckets];
+};
+
+/*
+*	Times all of the scopes in a main loop pass.  The loop period is also a
+*	histogram, "Loop".  A pass longer than the budget is counted as over
+*	budget.  When a pass is the longest so far, each scope's total for that
+*	pass is kept (ProfileHistogram::WorstLoop), so the worst loop can be
+*	broken down afterwards.
+*
+*	The mcu counts core clock cycles with the DWT cycle counter.  Host
+*	builds count ClockSource microseconds, so a "cycle" is 1us there.
+*/
+class Profiler
+{
+public:
+							// Starts the cycle counter.
+	static void				begin(void);
+#ifndef __MACH__
+	static inline uint32_t	Cycles(void)
+								{return(DWT->CYCCNT);}
+	static inline uint32_t	CyclesPerUS(void)
+								{return(SystemCoreClock/1000000);}
+#else
+	static inline uint32_t	Cycles(void)
+								{return(ClockSource::Micros());}
+	static inline uint32_t	CyclesPerUS(void)
+								{return(1);}
+#endif
+	static void				LoopBoundary(void);
+	static void				SetBudget(
+								uint32_t				inMicroseconds)
+								{sBudget = inMicroseconds * CyclesPerUS();}
+	static uint32_t			Budget(void)	// us
+								{return(sBudget/CyclesPerUS());}
+	static uint32_t			OverBudget(void)
+								{return(sOverBudget);}
+	static const ProfileHistogram&	Loop(void)
+								{return(sLoop);}
+							// The scopes, in the order first entered.
+	static ProfileHistogram*	First(void)
+								{return(sFirst);}
+							// Clears all histograms and counters.
+	static void				Reset(void);
+protected:
+	friend class ProfileHistogram;
+	static ProfileHistogram*	sFirst;
+	static ProfileHistogram		sLoop;
+	static uint32_t				sLoopStart;
+	static uint32_t				sBudget;	// cycles
+	static uint32_t				sOverBudget;
+};
+
+class ProfileTimer
+{
+public:
+							ProfileTimer(
+								ProfileHistogram&		inHistogram)
+								: mHistogram(inHistogram),
+								  mStart(Profiler::Cycles()){}
+							~ProfileTimer(void)
+								{mHistogram.Add(Profiler::Cycles() - mStart);}
+protected:
+	ProfileHistogram&	mHistogram;
+	uint32_t			mStart;
+};
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_LOOP()
+#endif // PROFILER_ENABLED
+
+#endif // Profiler_h
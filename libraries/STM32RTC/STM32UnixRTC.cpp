@@ -27,6 +27,7 @@
 #ifndef __MACH__
 #include "Arduino.h"
 #include "MSPeriod.h"
+#include "ISREvents.h"
 #if defined(STM32_CORE_VERSION) && (STM32_CORE_VERSION  > 0x01090000)
 	#include "rtc.h"
 #endif
@@ -58,6 +59,11 @@ void STM32UnixRTC::RTCInit(void)
 
 	sTime = ReadRTCCount();
 	attachSecondsIrqCallback(SecondsCB);
+	/*
+	*	The seconds interrupt and the pin interrupts both push ISREvents.
+	*	The queue has a single producer, so they must not preempt each other.
+	*/
+	HAL_NVIC_SetPriority(RTC_IRQn, EXTI_IRQ_PRIO, EXTI_IRQ_SUBPRIO);
 	ResetSleepTime();
 #if 0
 	Serial.print("CNTH = 0x");
@@ -97,6 +103,7 @@ void STM32UnixRTC::SecondsCB(
 	void*	inUserData)
 {
 	UnixTime::Tick();
+	ISREvents::Push(ISREvents::eSecondTick);
 }
 
 /******************************** ReadRTCCount ********************************/
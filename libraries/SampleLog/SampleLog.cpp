@@ -0,0 +1,437 @@
+/*
+*	SampleLog.cpp, Copyright Jonathan Mackey 2026
+*	Compact, block based binary format for logged samples.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "SampleLog.h"
+#include <string.h>
+
+namespace SampleLog
+{
+const uint16_t	kMagic = 0x4C44;	// "DL"
+const uint8_t	kVersion = 2;		// 1 was the fixed size SDLogger sample
+
+/*
+*	The header is serialized byte by byte so the layout doesn't depend on the
+*	compiler's struct packing or the host's byte order.
+*/
+/************************************ Put16 ***********************************/
+static inline uint8_t* Put16(
+	uint16_t	inValue,
+	uint8_t*	inBuffer)
+{
+	inBuffer[0] = (uint8_t)inValue;
+	inBuffer[1] = (uint8_t)(inValue >> 8);
+	return(&inBuffer[2]);
+}
+
+/************************************ Put32 ***********************************/
+static inline uint8_t* Put32(
+	uint32_t	inValue,
+	uint8_t*	inBuffer)
+{
+	return(Put16((uint16_t)(inValue >> 16), Put16((uint16_t)inValue, inBuffer)));
+}
+
+/************************************ Get16 ***********************************/
+static inline uint16_t Get16(
+	const uint8_t*	inBuffer)
+{
+	return(inBuffer[0] | ((uint16_t)inBuffer[1] << 8));
+}
+
+/************************************ Get32 ***********************************/
+static inline uint32_t Get32(
+	const uint8_t*	inBuffer)
+{
+	return(Get16(inBuffer) | ((uint32_t)Get16(&inBuffer[2]) << 16));
+}
+
+/********************************** PutVarint *********************************/
+/*
+*	Zigzag (so small negative deltas are small) followed by LEB128, 7 bits
+*	per byte, least significant first.
+*/
+static inline uint8_t* PutVarint(
+	int32_t		inValue,
+	uint8_t*	inBuffer)
+{
+	uint32_t	value = ((uint32_t)inValue << 1) ^ (uint32_t)(inValue >> 31);
+	while (value >= 0x80)
+	{
+		*(inBuffer++) = (uint8_t)value | 0x80;
+		value >>= 7;
+	}
+	*(inBuffer++) = (uint8_t)value;
+	return(inBuffer);
+}
+
+/********************************** GetVarint *********************************/
+/*
+*	Returns nullptr if the varint runs past inEnd or is longer than 5 bytes.
+*/
+static inline const uint8_t* GetVarint(
+	const uint8_t*	inBuffer,
+	const uint8_t*	inEnd,
+	int32_t&		outValue)
+{
+	uint32_t	value = 0;
+	for (uint8_t shift = 0; shift < 35; shift += 7)
+	{
+		if (inBuffer >= inEnd)
+		{
+			break;
+		}
+		uint8_t	thisByte = *(inBuffer++);
+		value |= (uint32_t)(thisByte & 0x7F) << shift;
+		if ((thisByte & 0x80) == 0)
+		{
+			outValue = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+			return(inBuffer);
+		}
+	}
+	return(nullptr);
+}
+
+/********************************* ReadHeader *********************************/
+bool ReadHeader(
+	const uint8_t*	inBlock,
+	uint16_t		inBlockSize,
+	SBlockHeader&	outHeader)
+{
+	bool	success = inBlockSize >= eHeaderSize &&
+		Get16(inBlock) == kMagic &&
+		inBlock[2] == kVersion;
+	if (success)
+	{
+		outHeader.fileID = Get16(&inBlock[4]);
+		outHeader.index = Get16(&inBlock[6]);
+		outHeader.count = Get16(&inBlock[8]);
+		outHeader.length = Get16(&inBlock[10]);
+		outHeader.keyframe.time = Get32(&inBlock[12]);
+		outHeader.keyframe.millis = Get32(&inBlock[16]);
+		outHeader.keyframe.staticPressure = (int16_t)Get16(&inBlock[20]);
+		outHeader.keyframe.ambientPressure = Get32(&inBlock[22]);
+		outHeader.keyframe.temperature = (int16_t)Get16(&inBlock[26]);
+		outHeader.keyframe.binMotor = inBlock[28];
+		outHeader.keyframe.status = inBlock[29];
+		success = outHeader.count != 0 &&
+			outHeader.length <= (inBlockSize - eHeaderSize);
+	}
+	return(success);
+}
+
+/*********************************** IsSmall **********************************/
+static inline bool IsSmall(
+	int32_t	inDelta)
+{
+	return(inDelta >= eSmallMin && inDelta <= eSmallMax);
+}
+
+/******************************** BlockEncoder ********************************/
+BlockEncoder::BlockEncoder(void)
+	: mBlock(nullptr), mBlockSize(0), mFileID(0), mIndex(0), mCount(0),
+	  mPos(0), mRun(0), mMillisDelta(0)
+{
+}
+
+/*********************************** Begin ************************************/
+void BlockEncoder::Begin(
+	uint8_t*		inBlock,
+	uint16_t		inBlockSize,
+	uint16_t		inFileID,
+	uint16_t		inIndex,
+	const SSample&	inKeyframe)
+{
+	mBlock = inBlock;
+	mBlockSize = inBlockSize;
+	mFileID = inFileID;
+	mIndex = inIndex;
+	mCount = 1;
+	mPos = eHeaderSize;
+	mRun = 0;
+	mMillisDelta = 0;
+	mKeyframe = inKeyframe;
+	mPrev = inKeyframe;
+}
+
+/************************************ IsFull **********************************/
+bool BlockEncoder::IsFull(void) const
+{
+	// Room for the largest record plus the tag of a pending run.
+	return(mPos + eMaxRecordSize + 1 > mBlockSize || mCount == 0xFFFF);
+}
+
+/************************************* Add ************************************/
+bool BlockEncoder::Add(
+	const SSample&	inSample)
+{
+	bool	added = mBlock && !IsFull();
+	if (added)
+	{
+		int32_t	millisDelta = (int32_t)(inSample.millis - mPrev.millis);
+		uint8_t	record[eMaxRecordSize];
+		uint8_t*	recordPtr = &record[1];
+		uint8_t	tag = 0;
+		if (millisDelta != mMillisDelta)
+		{
+			tag |= eMillisField;
+			recordPtr = PutVarint(millisDelta - mMillisDelta, recordPtr);
+		}
+		if (inSample.staticPressure != mPrev.staticPressure)
+		{
+			tag |= eStaticField;
+			recordPtr = PutVarint((int32_t)inSample.staticPressure - mPrev.staticPressure, recordPtr);
+		}
+		if (inSample.ambientPressure != mPrev.ambientPressure)
+		{
+			tag |= eAmbientField;
+			recordPtr = PutVarint((int32_t)(inSample.ambientPressure - mPrev.ambientPressure), recordPtr);
+		}
+		if (inSample.temperature != mPrev.temperature)
+		{
+			tag |= eTempField;
+			recordPtr = PutVarint((int32_t)inSample.temperature - mPrev.temperature, recordPtr);
+		}
+		if (inSample.binMotor != mPrev.binMotor)
+		{
+			tag |= eBinMotorField;
+			*(recordPtr++) = inSample.binMotor;
+		}
+		if (inSample.status != mPrev.status)
+		{
+			tag |= eStatusField;
+			*(recordPtr++) = inSample.status;
+		}
+		int32_t	ambientDelta = (int32_t)(inSample.ambientPressure - mPrev.ambientPressure);
+		int32_t	tempDelta = (int32_t)inSample.temperature - mPrev.temperature;
+		int32_t	millisDoD = millisDelta - mMillisDelta;
+		if ((tag & ~(eMillisField | eAmbientField | eTempField)) == 0 && tag &&
+			IsSmall(millisDoD) && IsSmall(ambientDelta) && IsSmall(tempDelta))
+		{
+			tag = eSmallTag | ((millisDoD - eSmallMin) << 4) |
+				((ambientDelta - eSmallMin) << 2) | (tempDelta - eSmallMin);
+			recordPtr = &record[1];
+		}
+		if (tag == 0)
+		{
+			mRun++;
+			if (mRun == eMaxRun)
+			{
+				mBlock[mPos++] = eRunTag | mRun;
+				mRun = 0;
+			}
+		} else
+		{
+			if (mRun)
+			{
+				mBlock[mPos++] = eRunTag | mRun;
+				mRun = 0;
+			}
+			record[0] = tag;
+			uint8_t	length = (uint8_t)(recordPtr - record);
+			memcpy(&mBlock[mPos], record, length);
+			mPos += length;
+		}
+		mMillisDelta = millisDelta;
+		mPrev = inSample;
+		mCount++;
+	}
+	return(added);
+}
+
+/*********************************** Finish ***********************************/
+uint16_t BlockEncoder::Finish(void)
+{
+	uint16_t	used = 0;
+	if (mBlock)
+	{
+		if (mRun)
+		{
+			mBlock[mPos++] = eRunTag | mRun;
+			mRun = 0;
+		}
+		uint8_t*	header = mBlock;
+		header = Put16(kMagic, header);
+		*(header++) = kVersion;
+		*(header++) = 0;
+		header = Put16(mFileID, header);
+		header = Put16(mIndex, header);
+		header = Put16(mCount, header);
+		header = Put16(mPos - eHeaderSize, header);
+		header = Put32(mKeyframe.time, header);
+		header = Put32(mKeyframe.millis, header);
+		header = Put16((uint16_t)mKeyframe.staticPressure, header);
+		header = Put32(mKeyframe.ambientPressure, header);
+		header = Put16((uint16_t)mKeyframe.temperature, header);
+		*(header++) = mKeyframe.binMotor;
+		*(header++) = mKeyframe.status;
+		*(header++) = 0;
+		*header = 0;
+		// The unused tail is cleared so a block's content is repeatable.
+		memset(&mBlock[mPos], 0, mBlockSize - mPos);
+		used = mPos;
+		mBlock = nullptr;
+	}
+	return(used);
+}
+
+/******************************** BlockDecoder ********************************/
+BlockDecoder::BlockDecoder(void)
+	: mPos(nullptr), mEnd(nullptr), mRemaining(0), mRun(0),
+	  mKeyframePending(false), mMillisDelta(0)
+{
+}
+
+/*********************************** Begin ************************************/
+bool BlockDecoder::Begin(
+	const uint8_t*	inBlock,
+	uint16_t		inBlockSize)
+{
+	bool	success = ReadHeader(inBlock, inBlockSize, mHeader);
+	if (success)
+	{
+		mPos = &inBlock[eHeaderSize];
+		mEnd = &mPos[mHeader.length];
+		mRemaining = mHeader.count;
+		mRun = 0;
+		mKeyframePending = true;
+		mMillisDelta = 0;
+		mPrev = mHeader.keyframe;
+	} else
+	{
+		mRemaining = 0;
+	}
+	return(success);
+}
+
+/********************************** Predict ***********************************/
+void BlockDecoder::Predict(void)
+{
+	mPrev.millis += mMillisDelta;
+	mPrev.time = mHeader.keyframe.time +
+		(mPrev.millis - mHeader.keyframe.millis) / 1000;
+}
+
+/************************************ Next ************************************/
+/*
+*	A corrupt record (unknown tag bit, or a varint running past the end of
+*	the encoded data) ends the block early.
+*/
+bool BlockDecoder::Next(
+	SSample&	outSample)
+{
+	if (mRemaining == 0)
+	{
+		return(false);
+	}
+	if (mKeyframePending)
+	{
+		mKeyframePending = false;
+	} else if (mRun)
+	{
+		mRun--;
+		Predict();
+	} else
+	{
+		if (mPos >= mEnd)
+		{
+			mRemaining = 0;
+			return(false);
+		}
+		uint8_t	tag = *(mPos++);
+		if (tag & eRunTag)
+		{
+			mRun = (tag & eMaxRun) - 1;
+			Predict();
+		} else if (tag & eSmallTag)
+		{
+			mMillisDelta += ((tag >> 4) & 3) + eSmallMin;
+			Predict();
+			mPrev.ambientPressure += ((tag >> 2) & 3) + eSmallMin;
+			mPrev.temperature += (tag & 3) + eSmallMin;
+		} else if (tag & ~(eMillisField | eStaticField | eAmbientField |
+							eTempField | eBinMotorField | eStatusField))
+		{
+			mRemaining = 0;
+			return(false);
+		} else
+		{
+			int32_t	delta;
+			if (tag & eMillisField)
+			{
+				if ((mPos = GetVarint(mPos, mEnd, delta)) == nullptr)
+				{
+					mRemaining = 0;
+					return(false);
+				}
+				mMillisDelta += delta;
+			}
+			Predict();
+			if (tag & eStaticField)
+			{
+				if ((mPos = GetVarint(mPos, mEnd, delta)) == nullptr)
+				{
+					mRemaining = 0;
+					return(false);
+				}
+				mPrev.staticPressure += delta;
+			}
+			if (tag & eAmbientField)
+			{
+				if ((mPos = GetVarint(mPos, mEnd, delta)) == nullptr)
+				{
+					mRemaining = 0;
+					return(false);
+				}
+				mPrev.ambientPressure += delta;
+			}
+			if (tag & eTempField)
+			{
+				if ((mPos = GetVarint(mPos, mEnd, delta)) == nullptr)
+				{
+					mRemaining = 0;
+					return(false);
+				}
+				mPrev.temperature += delta;
+			}
+			if (tag & (eBinMotorField | eStatusField))
+			{
+				if (mPos + (((tag & eBinMotorField) != 0) + ((tag & eStatusField) != 0)) > mEnd)
+				{
+					mRemaining = 0;
+					return(false);
+				}
+				if (tag & eBinMotorField)
+				{
+					mPrev.binMotor = *(mPos++);
+				}
+				if (tag & eStatusField)
+				{
+					mPrev.status = *(mPos++);
+				}
+			}
+		}
+	}
+	mRemaining--;
+	outSample = mPrev;
+	return(true);
+}
+}
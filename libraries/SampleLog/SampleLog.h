@@ -0,0 +1,207 @@
+/*
+*	SampleLog.h, Copyright Jonathan Mackey 2026
+*	Compact, block based binary format for logged samples.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef SampleLog_h
+#define SampleLog_h
+
+#include <inttypes.h>
+
+/*
+*	A log is a sequence of fixed size blocks (512 bytes on the SD card.)
+*	Every block starts with a header containing a keyframe, the first sample
+*	of the block stored as absolute values, so any block can be decoded on
+*	its own.  The keyframe times make the blocks a time index: a reader can
+*	binary search the blocks of a file by time without decoding any samples.
+*
+*	Block header (little endian, eHeaderSize bytes):
+*		uint16_t	magic;		// kMagic
+*		uint8_t		version;	// kVersion
+*		uint8_t		reserved;
+*		uint16_t	fileID;		// Identifies blocks belonging to the file
+*		uint16_t	index;		// Of the block within the file (wraps)
+*		uint16_t	count;		// Samples in the block, including the keyframe
+*		uint16_t	length;		// Bytes of encoded samples following the header
+*		keyframe:
+*		uint32_t	time;		// UnixTime
+*		uint32_t	millis;
+*		int16_t		staticPressure;
+*		uint32_t	ambientPressure;
+*		int16_t		temperature;
+*		uint8_t		binMotor;
+*		uint8_t		status;
+*
+*	Each following sample is predicted from the previous one: the same
+*	millis delta as the previous sample and no change in any value.  Only
+*	what differs from the prediction is stored.
+*
+*	Record tag byte:
+*		1nnnnnnn	n (1-127) samples that exactly match the prediction (RLE)
+*		01mmaatt	a single byte sample: millis delta of delta, ambient
+*					and temperature deltas each in -2..1, stored + 2.
+*					The other values are unchanged.  This is the common
+*					case when the collector isn't running (sensor noise.)
+*		00sbtapm	fields that follow, in this order:
+*			m	(0x01) zigzag varint millis delta of delta
+*			p	(0x02) zigzag varint static pressure delta
+*			a	(0x04) zigzag varint ambient pressure delta
+*			t	(0x08) zigzag varint temperature delta
+*			b	(0x10) bin motor, raw byte
+*			s	(0x20) status, raw byte
+*	A tag of 0 is never written, such a sample is part of a run.
+*
+*	Only millis is stored per sample.  The time of a sample is decoded as
+*	keyframe.time + (millis - keyframe.millis)/1000, which can be a second
+*	off from the RTC time logged because the RTC's sub-second phase isn't
+*	known.  millis is exact.
+*/
+namespace SampleLog
+{
+	struct SSample
+	{
+		uint32_t	time;			// UnixTime
+		uint32_t	millis;
+		int16_t		staticPressure;	// Pa
+		uint32_t	ambientPressure;// Pa
+		int16_t		temperature;	// 0.01°C
+		uint8_t		binMotor;		// Bin motor sense average
+		uint8_t		status;			// EStatusBits
+	};
+	enum EStatusBits
+	{
+		eStatusMask			= 3,	// DustCollectorBase::EStatus
+		eMotorRunningBit	= 4,	// Dust bin motor
+		eDCRunningBit		= 8,
+		eDeltasLoadedBit	= 0x10
+	};
+	struct SBlockHeader
+	{
+		uint16_t	fileID;
+		uint16_t	index;
+		uint16_t	count;
+		uint16_t	length;
+		SSample		keyframe;
+	};
+	enum
+	{
+		eHeaderSize		= 32,
+		eMaxRecordSize	= 19,	// 1 + 5 + 3 + 5 + 3 + 1 + 1
+		eRunTag			= 0x80,
+		eMaxRun			= 127,
+		eSmallTag		= 0x40,
+		eSmallMin		= -2,
+		eSmallMax		= 1,
+		eMillisField	= 0x01,
+		eStaticField	= 0x02,
+		eAmbientField	= 0x04,
+		eTempField		= 0x08,
+		eBinMotorField	= 0x10,
+		eStatusField	= 0x20
+	};
+	extern const uint16_t	kMagic;
+	extern const uint8_t	kVersion;
+
+	/*
+	*	Returns true if inBlock has a valid header (magic, version and a
+	*	length that fits.)  The caller checks fileID and index.
+	*/
+	bool					ReadHeader(
+								const uint8_t*			inBlock,
+								uint16_t				inBlockSize,
+								SBlockHeader&			outHeader);
+
+	class BlockEncoder
+	{
+	public:
+								BlockEncoder(void);
+								/*
+								*	inKeyframe becomes the first sample of
+								*	the block.
+								*/
+		void					Begin(
+									uint8_t*				inBlock,
+									uint16_t				inBlockSize,
+									uint16_t				inFileID,
+									uint16_t				inIndex,
+									const SSample&			inKeyframe);
+								/*
+								*	Returns false if the block is full, in
+								*	which case the sample wasn't added.
+								*/
+		bool					Add(
+									const SSample&			inSample);
+								/*
+								*	Writes any pending run and the header.
+								*	The block can't be added to after this.
+								*	Returns the number of bytes used.
+								*/
+		uint16_t				Finish(void);
+								/*
+								*	True when there may not be room for
+								*	another sample.  The block should be
+								*	finished and written.
+								*/
+		bool					IsFull(void) const;
+		bool					IsOpen(void) const
+									{return(mBlock != nullptr);}
+		uint16_t				Count(void) const
+									{return(mCount);}
+	protected:
+		uint8_t*	mBlock;
+		uint16_t	mBlockSize;
+		uint16_t	mFileID;
+		uint16_t	mIndex;
+		uint16_t	mCount;
+		uint16_t	mPos;
+		uint8_t		mRun;		// Pending predicted samples
+		int32_t		mMillisDelta;
+		SSample		mKeyframe;
+		SSample		mPrev;
+	};
+
+	class BlockDecoder
+	{
+	public:
+								BlockDecoder(void);
+								// inBlock must remain valid while decoding.
+		bool					Begin(
+									const uint8_t*			inBlock,
+									uint16_t				inBlockSize);
+		const SBlockHeader&		Header(void) const
+									{return(mHeader);}
+								// Returns false when there are no more samples.
+		bool					Next(
+									SSample&				outSample);
+	protected:
+		const uint8_t*	mPos;
+		const uint8_t*	mEnd;
+		SBlockHeader	mHeader;
+		uint16_t		mRemaining;	// Samples left to return
+		uint8_t			mRun;
+		bool			mKeyframePending;
+		int32_t			mMillisDelta;
+		SSample			mPrev;
+
+		void					Predict(void);
+	};
+}
+
+#endif // SampleLog_h
@@ -0,0 +1,306 @@
+/*
+*	Scheduler.cpp, Copyright Jonathan Mackey 2026
+*	Cooperative task scheduler with a hierarchical timer wheel.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "Scheduler.h"
+#include <string.h>
+
+/********************************* Scheduler **********************************/
+Scheduler::Scheduler(
+	const STask*		inTasks,
+	uint8_t				inNumTasks,
+	SchedulerDelegate*	inDelegate)
+	: mTasks(inTasks), mNumTasks(inNumTasks <= eMaxTasks ? inNumTasks : (uint8_t)eMaxTasks),
+	  mDelegate(inDelegate), mRunning(eNone), mTick(0), mReady(0), mIdleCount(0)
+{
+	memset(mSlot, eNotQueued, sizeof(mSlot));
+	memset(mWheel, eNone, sizeof(mWheel));
+	ResetStats();
+}
+
+/************************************ begin ***********************************/
+void Scheduler::begin(void)
+{
+	mTick = ClockSource::Millis();
+	for (uint8_t task = 0; task < mNumTasks; task++)
+	{
+		Dequeue(task);
+		mDue[task] = mTick;
+		Queue(task);
+	}
+}
+
+/*********************************** Update ***********************************/
+bool Scheduler::Update(void)
+{
+	uint32_t	now = ClockSource::Millis();
+	Advance(now);
+	uint8_t	task = HighestReady();
+	bool	run = task != eNone && !Deferred(task, now);
+	if (run)
+	{
+		mReady &= ~((uint32_t)1 << task);
+		mSlot[task] = eNotQueued;
+		SStats&	stats = mStats[task];
+		uint32_t	late = now - mDue[task];
+		if (late > mTasks[task].latency)
+		{
+			stats.misses++;
+		}
+		if (late > stats.maxLate)
+		{
+			stats.maxLate = late < 0xFFFF ? late : 0xFFFF;
+		}
+		uint32_t	start = ClockSource::Micros();
+		mRunning = task;
+		uint32_t	delay = mDelegate->RunTask(task);
+		mRunning = eNone;
+		uint32_t	time = ClockSource::Micros() - start;
+		stats.slices++;
+		if (time > mTasks[task].budget)
+		{
+			stats.overruns++;
+		}
+		if (time > stats.maxTime)
+		{
+			stats.maxTime = time;
+		}
+		/*
+		*	The task may have been woken by another task it called.  Its
+		*	return value takes precedence.
+		*/
+		Dequeue(task);
+		if (delay != eSuspend)
+		{
+			mDue[task] = now + delay;
+			Queue(task);
+		}
+	} else
+	{
+		Idle(now);
+	}
+	return(run);
+}
+
+/************************************ Wake ************************************/
+void Scheduler::Wake(
+	uint8_t		inTask,
+	uint32_t	inDelay)
+{
+	if (inTask < mNumTasks &&
+		inTask != mRunning)
+	{
+		Dequeue(inTask);
+		mDue[inTask] = ClockSource::Millis() + inDelay;
+		Queue(inTask);
+	}
+}
+
+/********************************** Suspend ***********************************/
+void Scheduler::Suspend(
+	uint8_t	inTask)
+{
+	if (inTask < mNumTasks &&
+		inTask != mRunning)
+	{
+		Dequeue(inTask);
+	}
+}
+
+/********************************* ResetStats *********************************/
+void Scheduler::ResetStats(void)
+{
+	memset(mStats, 0, sizeof(mStats));
+	mIdleCount = 0;
+}
+
+/*********************************** Advance **********************************/
+/*
+*	Processes the ticks up to and including inNow.  When level 0 wraps, the
+*	level 1 slot for the next 32 ticks is cascaded into level 0, and when
+*	level 1 wraps, the level 2 slot for the next 1024 ticks is cascaded into
+*	level 1 (before level 1 is cascaded.)
+*/
+void Scheduler::Advance(
+	uint32_t	inNow)
+{
+	while ((int32_t)(inNow - mTick) > 0)
+	{
+		mTick++;
+		uint8_t	slot = mTick & eSlotMask;
+		if (slot == 0)
+		{
+			uint8_t	slot1 = (mTick >> eLevelBits) & eSlotMask;
+			if (slot1 == 0)
+			{
+				Cascade(2, (mTick >> (eLevelBits*2)) & eSlotMask);
+			}
+			Cascade(1, slot1);
+		}
+		Cascade(0, slot);
+	}
+}
+
+/*********************************** Cascade **********************************/
+/*
+*	Requeues the tasks in a slot relative to mTick.  For level 0 the tasks
+*	are due, so they become ready.
+*/
+void Scheduler::Cascade(
+	uint8_t	inLevel,
+	uint8_t	inSlot)
+{
+	uint8_t	task = mWheel[inLevel][inSlot];
+	mWheel[inLevel][inSlot] = eNone;
+	while (task != eNone)
+	{
+		uint8_t	next = mNext[task];
+		mSlot[task] = eNotQueued;
+		Queue(task);
+		task = next;
+	}
+}
+
+/************************************ Queue ***********************************/
+void Scheduler::Queue(
+	uint8_t	inTask)
+{
+	uint32_t	due = mDue[inTask];
+	int32_t		delta = (int32_t)(due - mTick);
+	if (delta <= 0)
+	{
+		mReady |= ((uint32_t)1 << inTask);
+		mSlot[inTask] = eReady;
+	} else
+	{
+		uint8_t	level = 2;
+		if (delta < eSlots)
+		{
+			level = 0;
+		} else if (delta < (eSlots << eLevelBits))
+		{
+			level = 1;
+		} else if (delta > eMaxDelay)
+		{
+			// Requeued when this slot is cascaded.
+			due = mTick + eMaxDelay;
+		}
+		uint8_t	slot = (due >> (eLevelBits * level)) & eSlotMask;
+		mNext[inTask] = mWheel[level][slot];
+		mWheel[level][slot] = inTask;
+		mSlot[inTask] = level * eSlots + slot;
+	}
+}
+
+/*********************************** Dequeue **********************************/
+void Scheduler::Dequeue(
+	uint8_t	inTask)
+{
+	uint8_t	slot = mSlot[inTask];
+	if (slot == eReady)
+	{
+		mReady &= ~((uint32_t)1 << inTask);
+	} else if (slot != eNotQueued)
+	{
+		uint8_t*	link = &mWheel[slot / eSlots][slot % eSlots];
+		for (; *link != inTask; link = &mNext[*link]){}
+		*link = mNext[inTask];
+	}
+	mSlot[inTask] = eNotQueued;
+}
+
+/******************************** HighestReady ********************************/
+uint8_t Scheduler::HighestReady(void) const
+{
+	uint8_t	highest = eNone;
+	for (uint8_t task = 0; task < mNumTasks; task++)
+	{
+		if ((mReady & ((uint32_t)1 << task)) &&
+			(highest == eNone ||
+				mTasks[task].priority < mTasks[highest].priority))
+		{
+			highest = task;
+		}
+	}
+	return(highest);
+}
+
+/********************************** Deferred **********************************/
+/*
+*	Returns true if running a slice of inTask, taking its whole budget, would
+*	make a queued priority 0 task miss.  A task that's already late isn't
+*	deferred.
+*/
+bool Scheduler::Deferred(
+	uint8_t		inTask,
+	uint32_t	inNow) const
+{
+	const STask&	task = mTasks[inTask];
+	bool	deferred = false;
+	if (task.priority &&
+		task.budget &&
+		(inNow - mDue[inTask]) < task.latency)
+	{
+		uint32_t	end = inNow + (task.budget + 999)/1000;
+		for (uint8_t critical = 0; critical < mNumTasks && !deferred; critical++)
+		{
+			deferred = mSlot[critical] < eReady &&
+				mTasks[critical].priority == 0 &&
+				(int32_t)(mDue[critical] + mTasks[critical].latency - end) < 0;
+		}
+	}
+	return(deferred);
+}
+
+/************************************ Idle ************************************/
+void Scheduler::Idle(
+	uint32_t	inNow)
+{
+	mIdleCount++;
+#ifndef __MACH__
+	/*
+	*	An interrupt between the ready check and the WFI (a button press)
+	*	isn't acted on until the next interrupt, the 1ms SysTick at the
+	*	latest.
+	*/
+	__WFI();
+#else
+	uint32_t	delay = 1;
+	if (ClockSource::Mode() == ClockSource::eSimulated)
+	{
+		uint32_t	next = eSuspend;
+		for (uint8_t task = 0; task < mNumTasks; task++)
+		{
+			if (mSlot[task] < eReady &&
+				(mDue[task] - inNow) < next)
+			{
+				next = mDue[task] - inNow;
+			}
+		}
+		if (next != eSuspend)
+		{
+			delay = next;
+		}
+	}
+	// To the start of the ms the next task is due.
+	ClockSource::DelayMicroseconds(delay*1000 - (uint32_t)(ClockSource::Now() % 1000));
+#endif
+}
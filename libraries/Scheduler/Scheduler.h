@@ -0,0 +1,191 @@
+/*
+*	Scheduler.h, Copyright Jonathan Mackey 2026
+*	Cooperative task scheduler with a hierarchical timer wheel.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef Scheduler_h
+#define Scheduler_h
+
+#include <inttypes.h>
+#include "ClockSource.h"
+
+/*
+*	A task table entry.  The table is static (in flash), a task is identified
+*	by its index in the table.
+*/
+struct STask
+{
+	const char*	name;
+	uint8_t		priority;	// 0 is the highest
+	uint16_t	latency;	// ms a task can start after it's due without
+							// it being counted as a miss
+	uint32_t	budget;		// us, the longest a slice is expected to take
+};
+
+class SchedulerDelegate
+{
+public:
+							/*
+							*	Runs one slice of task inTask.  Returns the ms
+							*	from the start of the slice until the task is
+							*	due again, 0 to continue as soon as higher
+							*	priority tasks allow, or Scheduler::eSuspend to
+							*	wait for Scheduler::Wake().
+							*/
+	virtual uint32_t		RunTask(
+								uint8_t					inTask) = 0;
+};
+
+/*
+*	Tasks are cooperative: each call to RunTask does a bounded amount of work
+*	(a slice) and returns.  Update() runs at most one slice, the highest
+*	priority task that's due, so a higher priority task never waits for more
+*	than one slice of a lower priority task.
+*
+*	Priority 0 tasks are time critical (sensing.)  A slice of any other task
+*	isn't started if, given its budget, it would make a queued priority 0
+*	task start later than that task's latency allows.  The slice waits for a
+*	gap instead, but only until it's late itself, so a long slice (a full
+*	screen redraw) can't be starved.  Other tasks only get priority order,
+*	they can still be held up by a long slice that's already started.
+*
+*	Due times are kept in a three level timer wheel of 1ms ticks.  Level 0
+*	has a slot per tick for the next 32ms, level 1 a slot per 32ms for the
+*	next 1024ms, and level 2 a slot per 1024ms for the next 32.768s.  A slot
+*	is cascaded down a level when the level below wraps, so advancing a tick
+*	only touches one slot (plus a cascade every 32 ticks) no matter how many
+*	tasks are queued.  Longer delays are requeued when their level 2 slot
+*	comes around.
+*
+*	When nothing is due Update() idles.  The mcu executes WFI, waking on the
+*	next interrupt (the 1ms SysTick at the latest.)  On the host, when the
+*	ClockSource is simulated, idling advances the clock to the next due time
+*	so that a simulation runs as fast as the tasks allow.
+*
+*	Deadline statistics are kept per task: slices run, misses (started more
+*	than latency ms after being due), the worst lateness, overruns (slices
+*	longer than the budget) and the longest slice.
+*/
+class Scheduler
+{
+public:
+							Scheduler(
+								const STask*			inTasks,
+								uint8_t					inNumTasks,
+								SchedulerDelegate*		inDelegate);
+							// Queues every task to run now.
+	void					begin(void);
+							/*
+							*	Call from loop().  Returns true if a slice was
+							*	run, false if it idled.
+							*/
+	bool					Update(void);
+							/*
+							*	Makes inTask due in inDelay ms, replacing when
+							*	it was due.  Waking the task that's running has
+							*	no effect, its return value decides.
+							*/
+	void					Wake(
+								uint8_t					inTask,
+								uint32_t				inDelay = 0);
+	void					Suspend(
+								uint8_t					inTask);
+	bool					IsSuspended(
+								uint8_t					inTask) const
+								{return(mSlot[inTask] == eNotQueued);}
+	uint8_t					NumTasks(void) const
+								{return(mNumTasks);}
+	const STask&			Task(
+								uint8_t					inTask) const
+								{return(mTasks[inTask]);}
+	uint32_t				Slices(
+								uint8_t					inTask) const
+								{return(mStats[inTask].slices);}
+	uint16_t				Misses(
+								uint8_t					inTask) const
+								{return(mStats[inTask].misses);}
+	uint16_t				MaxLate(	// ms
+								uint8_t					inTask) const
+								{return(mStats[inTask].maxLate);}
+	uint16_t				Overruns(
+								uint8_t					inTask) const
+								{return(mStats[inTask].overruns);}
+	uint32_t				MaxTime(	// us
+								uint8_t					inTask) const
+								{return(mStats[inTask].maxTime);}
+	uint32_t				IdleCount(void) const
+								{return(mIdleCount);}
+	void					ResetStats(void);
+	enum
+	{
+		eMaxTasks	= 16,
+		eSuspend	= 0xFFFFFFFF
+	};
+protected:
+	enum
+	{
+		eLevelBits	= 5,
+		eSlots		= 1 << eLevelBits,
+		eSlotMask	= eSlots - 1,
+		eLevels		= 3,
+		eMaxDelay	= (1 << (eLevelBits * eLevels)) - 1,
+		eNone		= 0xFF,		// End of a slot's task chain
+		eNotQueued	= 0xFF,		// mSlot values
+		eReady		= 0xFE
+	};
+	struct SStats
+	{
+		uint32_t	slices;
+		uint32_t	maxTime;
+		uint16_t	misses;
+		uint16_t	maxLate;
+		uint16_t	overruns;
+	};
+	const STask*		mTasks;
+	uint8_t				mNumTasks;
+	SchedulerDelegate*	mDelegate;
+	uint8_t				mRunning;		// Task being run, or eNone
+	uint32_t			mTick;			// Last tick processed (ms)
+	uint32_t			mReady;			// Bit per task that's due
+	uint32_t			mIdleCount;
+	uint32_t			mDue[eMaxTasks];
+	uint8_t				mSlot[eMaxTasks];	// Wheel slot, eReady or eNotQueued
+	uint8_t				mNext[eMaxTasks];	// Next task in the same slot
+	uint8_t				mWheel[eLevels][eSlots];	// First task in each slot
+	SStats				mStats[eMaxTasks];
+
+	void					Advance(
+								uint32_t				inNow);
+	void					Cascade(
+								uint8_t					inLevel,
+								uint8_t					inSlot);
+	void					Queue(
+								uint8_t					inTask);
+	void					Dequeue(
+								uint8_t					inTask);
+	uint8_t					HighestReady(void) const;
+	bool					Deferred(
+								uint8_t					inTask,
+								uint32_t				inNow) const;
+	void					Idle(
+								uint32_t				inNow);
+};
+
+#endif // Scheduler_h
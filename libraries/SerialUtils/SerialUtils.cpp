@@ -24,6 +24,7 @@
 #ifndef __MACH__
 #include <Arduino.h>
 #endif
+#include "MSPeriod.h"
 
 /**************************** GetUInt32FromSerial *****************************/
 uint32_t SerialUtils::GetUInt32FromSerial(void)
@@ -40,13 +41,43 @@ uint32_t SerialUtils::GetUInt32FromSerial(void)
 	return(retVal);
 }
 
+/******************************* HexStrToUInt32 *******************************/
+bool SerialUtils::HexStrToUInt32(
+	const char*	inStr,
+	uint32_t&	outValue)
+{
+	uint32_t	value = 0;
+	uint8_t		digits = 0;
+	for (; inStr[digits] && digits <= 8; digits++)
+	{
+		uint8_t	thisChar = inStr[digits];
+		if (thisChar >= 'a')
+		{
+			thisChar -= 'a' - 'A';
+		}
+		if (!((thisChar >= '0' && thisChar <= '9') ||
+			(thisChar >= 'A' && thisChar <= 'F')))
+		{
+			break;
+		}
+		value = (value*16) + HexAsciiToBin(thisChar);
+	}
+	bool	success = digits && digits <= 8 && inStr[digits] == 0;
+	if (success)
+	{
+		outValue = value;
+	}
+	return(success);
+}
+
 /********************************* GetChar ************************************/
 uint8_t SerialUtils::GetChar(void)
 {
-	uint32_t	timeout = millis() + 1000;
+	MSPeriod	timeout(1000);
+	timeout.Start();
 	while (!Serial.available())
 	{
-		if (millis() < timeout)continue;
+		if (!timeout.Passed())continue;
 		return('T');
 	}
 	return(Serial.read());
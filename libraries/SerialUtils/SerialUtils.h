@@ -32,6 +32,13 @@ class SerialUtils
 {
 public:
 	static uint32_t			GetUInt32FromSerial(void);
+							/*
+							*	Up to 8 hex digits, either case.  Returns false
+							*	if inStr is empty or has any other character.
+							*/
+	static bool				HexStrToUInt32(
+								const char*				inStr,
+								uint32_t&				outValue);
 	static uint8_t			GetChar(void);
 	static bool				LoadLine(
 								uint8_t					inMaxLen,
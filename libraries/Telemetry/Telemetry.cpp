@@ -0,0 +1,288 @@
+/*
+*	Telemetry.cpp, Copyright Jonathan Mackey 2026
+*	COBS framed, CRC protected binary telemetry packets.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "Telemetry.h"
+#include "CRC16.h"
+#include <string.h>
+
+namespace Telemetry
+{
+const uint8_t	kVersion = 1;
+
+/************************************ Put16 ***********************************/
+static inline uint8_t* Put16(
+	uint16_t	inValue,
+	uint8_t*	inBuffer)
+{
+	inBuffer[0] = (uint8_t)inValue;
+	inBuffer[1] = (uint8_t)(inValue >> 8);
+	return(&inBuffer[2]);
+}
+
+/************************************ Put32 ***********************************/
+static inline uint8_t* Put32(
+	uint32_t	inValue,
+	uint8_t*	inBuffer)
+{
+	return(Put16((uint16_t)(inValue >> 16), Put16((uint16_t)inValue, inBuffer)));
+}
+
+/************************************ Get16 ***********************************/
+static inline uint16_t Get16(
+	const uint8_t*	inBuffer)
+{
+	return(inBuffer[0] | ((uint16_t)inBuffer[1] << 8));
+}
+
+/************************************ Get32 ***********************************/
+static inline uint32_t Get32(
+	const uint8_t*	inBuffer)
+{
+	return(Get16(inBuffer) | ((uint32_t)Get16(&inBuffer[2]) << 16));
+}
+
+/********************************** PackInfo **********************************/
+uint8_t PackInfo(
+	const SInfo&	inInfo,
+	uint8_t*		outPayload)
+{
+	outPayload[0] = inInfo.version;
+	outPayload[1] = inInfo.divisor;
+	Put16(inInfo.updatePeriod, &outPayload[2]);
+	return(eInfoSize);
+}
+
+/********************************* PackSample *********************************/
+uint8_t PackSample(
+	const SSample&	inSample,
+	uint8_t*		outPayload)
+{
+	uint8_t*	payload = Put32(inSample.time, outPayload);
+	payload = Put32(inSample.millis, payload);
+	payload = Put32(inSample.ductPressure, payload);
+	payload = Put32(inSample.ambientPressure, payload);
+	payload = Put32((uint32_t)inSample.temperature, payload);
+	payload = Put32((uint32_t)inSample.deltaAverage, payload);
+	payload = Put32((uint32_t)inSample.baseline, payload);
+	*(payload++) = inSample.binMotor;
+	*(payload++) = inSample.status;
+	payload = Put16(inSample.loopAvg, payload);
+	Put16(inSample.loopMax, payload);
+	return(eSampleSize);
+}
+
+/********************************* PackScreen *********************************/
+uint8_t PackScreen(
+	const SScreen&	inScreen,
+	uint8_t*		outPayload)
+{
+	uint8_t*	payload = Put16(inScreen.column, Put16(inScreen.row, outPayload));
+	for (uint8_t i = 0; i < inScreen.numRuns; i++)
+	{
+		*(payload++) = inScreen.runs[i].count;
+		payload = Put16(inScreen.runs[i].color, payload);
+	}
+	return(4 + inScreen.numRuns * 3);
+}
+
+/********************************* UnpackInfo *********************************/
+bool UnpackInfo(
+	const uint8_t*	inPayload,
+	uint8_t			inLength,
+	SInfo&			outInfo)
+{
+	bool	success = inLength == eInfoSize;
+	if (success)
+	{
+		outInfo.version = inPayload[0];
+		outInfo.divisor = inPayload[1];
+		outInfo.updatePeriod = Get16(&inPayload[2]);
+	}
+	return(success);
+}
+
+/******************************** UnpackSample ********************************/
+bool UnpackSample(
+	const uint8_t*	inPayload,
+	uint8_t			inLength,
+	SSample&		outSample)
+{
+	bool	success = inLength == eSampleSize;
+	if (success)
+	{
+		outSample.time = Get32(inPayload);
+		outSample.millis = Get32(&inPayload[4]);
+		outSample.ductPressure = Get32(&inPayload[8]);
+		outSample.ambientPressure = Get32(&inPayload[12]);
+		outSample.temperature = (int32_t)Get32(&inPayload[16]);
+		outSample.deltaAverage = (int32_t)Get32(&inPayload[20]);
+		outSample.baseline = (int32_t)Get32(&inPayload[24]);
+		outSample.binMotor = inPayload[28];
+		outSample.status = inPayload[29];
+		outSample.loopAvg = Get16(&inPayload[30]);
+		outSample.loopMax = Get16(&inPayload[32]);
+	}
+	return(success);
+}
+
+/******************************** UnpackScreen ********************************/
+bool UnpackScreen(
+	const uint8_t*	inPayload,
+	uint8_t			inLength,
+	SScreen&		outScreen)
+{
+	bool	success = inLength > 4 &&
+		inLength <= 4 + eMaxScreenRuns * 3 &&
+		(inLength - 4) % 3 == 0;
+	if (success)
+	{
+		outScreen.row = Get16(inPayload);
+		outScreen.column = Get16(&inPayload[2]);
+		outScreen.numRuns = (inLength - 4) / 3;
+		const uint8_t*	payload = &inPayload[4];
+		for (uint8_t i = 0; i < outScreen.numRuns; i++, payload += 3)
+		{
+			outScreen.runs[i].count = payload[0];
+			outScreen.runs[i].color = Get16(&payload[1]);
+		}
+	}
+	return(success);
+}
+
+/******************************** EncodeFrame *********************************/
+/*
+*	COBS: each run of non-zero bytes is preceded by a code byte, one more
+*	than the length of the run.  The zero that ends the run is implied.
+*	Packets are shorter than 254 bytes so the 0xFF (no implied zero) code
+*	is never needed.
+*/
+uint8_t EncodeFrame(
+	uint8_t			inType,
+	uint8_t			inSeq,
+	const uint8_t*	inPayload,
+	uint8_t			inLength,
+	uint8_t*		outFrame)
+{
+	uint8_t	packet[eMaxPacket];
+	packet[0] = inType;
+	packet[1] = inSeq;
+	memcpy(&packet[2], inPayload, inLength);
+	uint8_t	packetLength = inLength + 2;
+	Put16(CRC16::Calc(packet, packetLength), &packet[packetLength]);
+	packetLength += 2;
+
+	outFrame[0] = 0;	// Delimiter, ends any text preceding the frame
+	uint8_t	codeIndex = 1;
+	uint8_t	frameLength = 2;
+	for (uint8_t i = 0; i < packetLength; i++)
+	{
+		if (packet[i])
+		{
+			outFrame[frameLength++] = packet[i];
+		} else
+		{
+			outFrame[codeIndex] = frameLength - codeIndex;
+			codeIndex = frameLength++;
+		}
+	}
+	outFrame[codeIndex] = frameLength - codeIndex;
+	outFrame[frameLength++] = 0;	// Delimiter
+	return(frameLength);
+}
+
+/******************************** FrameDecoder ********************************/
+FrameDecoder::FrameDecoder(void)
+	: mFrameLength(0), mPacketLength(0), mOverrun(false), mHaveSeq(false),
+	  mNextSeq(0), mPackets(0), mBadFrames(0), mLostPackets(0)
+{
+}
+
+/************************************ Add *************************************/
+bool FrameDecoder::Add(
+	uint8_t	inByte)
+{
+	bool	packetComplete = false;
+	if (inByte)
+	{
+		if (mFrameLength < sizeof(mFrame))
+		{
+			mFrame[mFrameLength++] = inByte;
+		} else
+		{
+			mOverrun = true;
+		}
+	} else
+	{
+		if (mOverrun)
+		{
+			mBadFrames++;
+		} else if (mFrameLength)
+		{
+			packetComplete = DecodeFrame();
+		}
+		mFrameLength = 0;
+		mOverrun = false;
+	}
+	return(packetComplete);
+}
+
+/******************************** DecodeFrame *********************************/
+bool FrameDecoder::DecodeFrame(void)
+{
+	uint8_t	frameIndex = 0;
+	mPacketLength = 0;
+	while (frameIndex < mFrameLength)
+	{
+		uint8_t	code = mFrame[frameIndex++];
+		if (frameIndex + code - 1 > mFrameLength ||
+			code == 0xFF)
+		{
+			mBadFrames++;
+			return(false);
+		}
+		for (uint8_t i = 1; i < code; i++)
+		{
+			mPacket[mPacketLength++] = mFrame[frameIndex++];
+		}
+		if (frameIndex < mFrameLength)
+		{
+			mPacket[mPacketLength++] = 0;	// Implied zero
+		}
+	}
+	bool	success = mPacketLength >= 4 &&
+		Get16(&mPacket[mPacketLength - 2]) == CRC16::Calc(mPacket, mPacketLength - 2);
+	if (success)
+	{
+		mPackets++;
+		if (mHaveSeq)
+		{
+			mLostPackets += (uint8_t)(Seq() - mNextSeq);
+		}
+		mHaveSeq = true;
+		mNextSeq = Seq() + 1;
+	} else
+	{
+		mBadFrames++;
+	}
+	return(success);
+}
+}
@@ -0,0 +1,199 @@
+/*
+*	Telemetry.h, Copyright Jonathan Mackey 2026
+*	COBS framed, CRC protected binary telemetry packets.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef Telemetry_h
+#define Telemetry_h
+
+#include <inttypes.h>
+
+/*
+*	Shared by the firmware (encoding) and the host tools (decoding.)
+*
+*	Packet (little endian):
+*		uint8_t		type;		// EPacketType
+*		uint8_t		seq;		// Incremented per packet, detects drops
+*		uint8_t		payload[];
+*		uint16_t	crc;		// CRC16 (CCITT) of type, seq and payload
+*
+*	Each packet is COBS (Consistent Overhead Byte Stuffing) encoded so it
+*	contains no zero bytes, and is preceded and followed by a zero byte.  A
+*	receiver resynchronizes at the next zero after any corruption.  Text
+*	written to the same serial port between packets (the serial shell)
+*	becomes a bad frame of its own rather than corrupting a packet.
+*
+*	Info payload (eInfoSize bytes), sent when the rate changes:
+*		uint8_t		version;		// kVersion
+*		uint8_t		divisor;		// Samples per sensor update, 0 = off
+*		uint16_t	updatePeriod;	// Sensor update period, ms
+*
+*	Sample payload (eSampleSize bytes), one per divisor sensor updates:
+*		uint32_t	time;			// UnixTime
+*		uint32_t	millis;
+*		uint32_t	ductPressure;	// Pa, raw
+*		uint32_t	ambientPressure;// Pa, raw
+*		int32_t		temperature;	// 0.01°C
+*		int32_t		deltaAverage;	// Pa
+*		int32_t		baseline;		// Pa
+*		uint8_t		binMotor;		// Bin motor sense average
+*		uint8_t		status;			// SampleLog::EStatusBits
+*		uint16_t	loopAvg;		// loop() period since the last sample, us
+*		uint16_t	loopMax;		// Saturates at 65535
+*
+*	Screen payload (4 + 3 bytes per run), part of one row of a screen
+*	capture (see ScreenCapture.h), run length encoded:
+*		uint16_t	row;
+*		uint16_t	column;			// Of the first run
+*		struct
+*		{
+*			uint8_t		count;		// 1 to 255 pixels
+*			uint16_t	color;		// RGB565
+*		} runs[1 to eMaxScreenRuns];
+*/
+namespace Telemetry
+{
+	enum EPacketType
+	{
+		eInfoPacket		= 1,
+		eSamplePacket	= 2,
+		eScreenPacket	= 3
+	};
+	struct SInfo
+	{
+		uint8_t		version;
+		uint8_t		divisor;
+		uint16_t	updatePeriod;
+	};
+	struct SSample
+	{
+		uint32_t	time;
+		uint32_t	millis;
+		uint32_t	ductPressure;
+		uint32_t	ambientPressure;
+		int32_t		temperature;
+		int32_t		deltaAverage;
+		int32_t		baseline;
+		uint8_t		binMotor;
+		uint8_t		status;
+		uint16_t	loopAvg;
+		uint16_t	loopMax;
+	};
+	enum
+	{
+		eInfoSize		= 4,
+		eSampleSize		= 34,
+		eMaxScreenRuns	= (eSampleSize - 4) / 3,
+		eMaxPayload		= eSampleSize,
+		eMaxPacket		= eMaxPayload + 4,		// type, seq and crc
+		eMaxFrame		= eMaxPacket + 3		// COBS overhead and delimiters
+	};
+	struct SScreenRun
+	{
+		uint8_t		count;
+		uint16_t	color;
+	};
+	struct SScreen
+	{
+		uint16_t	row;
+		uint16_t	column;
+		uint8_t		numRuns;
+		SScreenRun	runs[eMaxScreenRuns];
+	};
+	extern const uint8_t	kVersion;
+
+							// Returns the payload length.
+	uint8_t					PackInfo(
+								const SInfo&			inInfo,
+								uint8_t*				outPayload);
+	uint8_t					PackSample(
+								const SSample&			inSample,
+								uint8_t*				outPayload);
+	uint8_t					PackScreen(
+								const SScreen&			inScreen,
+								uint8_t*				outPayload);
+							// Return false if inLength is wrong.
+	bool					UnpackInfo(
+								const uint8_t*			inPayload,
+								uint8_t					inLength,
+								SInfo&					outInfo);
+	bool					UnpackSample(
+								const uint8_t*			inPayload,
+								uint8_t					inLength,
+								SSample&				outSample);
+	bool					UnpackScreen(
+								const uint8_t*			inPayload,
+								uint8_t					inLength,
+								SScreen&				outScreen);
+							/*
+							*	Builds the packet, COBS encodes it and adds the
+							*	delimiters.  outFrame must hold eMaxFrame
+							*	bytes.  Returns the frame length.
+							*/
+	uint8_t					EncodeFrame(
+								uint8_t					inType,
+								uint8_t					inSeq,
+								const uint8_t*			inPayload,
+								uint8_t					inLength,
+								uint8_t*				outFrame);
+
+	/*
+	*	Receives a byte stream one byte at a time.  Frames that are too long,
+	*	badly stuffed or fail the crc are counted and skipped.
+	*/
+	class FrameDecoder
+	{
+	public:
+								FrameDecoder(void);
+								// Returns true when a valid packet is complete.
+		bool					Add(
+									uint8_t					inByte);
+		uint8_t					Type(void) const
+									{return(mPacket[0]);}
+		uint8_t					Seq(void) const
+									{return(mPacket[1]);}
+		const uint8_t*			Payload(void) const
+									{return(&mPacket[2]);}
+		uint8_t					PayloadLength(void) const
+									{return(mPacketLength - 4);}
+		uint32_t				Packets(void) const
+									{return(mPackets);}
+		uint32_t				BadFrames(void) const
+									{return(mBadFrames);}
+								// Packets missing, from gaps in seq.
+		uint32_t				LostPackets(void) const
+									{return(mLostPackets);}
+	protected:
+		uint8_t		mFrame[eMaxFrame - 2];	// Less the delimiters
+		uint8_t		mPacket[eMaxPacket];
+		uint8_t		mFrameLength;
+		uint8_t		mPacketLength;
+		bool		mOverrun;		// Discarding until the next delimiter
+		bool		mHaveSeq;
+		uint8_t		mNextSeq;
+		uint32_t	mPackets;
+		uint32_t	mBadFrames;
+		uint32_t	mLostPackets;
+
+		bool					DecodeFrame(void);
+	};
+}
+
+#endif // Telemetry_h
@@ -29,6 +29,7 @@
 #else
 #include <iostream>
 #include <CoreFoundation/CFTimeZone.h>
+#include "ClockSource.h"
 #define PROGMEM
 #define pgm_read_word(xx) *(xx)
 #define pgm_read_byte(xx) *(xx)
@@ -144,6 +145,12 @@ void UnixTime::SetTimeFromExternalRTC(void)
 	CFRelease(tz);
 	sTime = localTime;
 }
+
+/**************************** AttachToClockSource *****************************/
+void UnixTime::AttachToClockSource(void)
+{
+	ClockSource::SetSecondsCallback(Tick);
+}
 #else
 /*************************** SetTimeFromExternalRTC ***************************/
 void UnixTime::SetTimeFromExternalRTC(void)
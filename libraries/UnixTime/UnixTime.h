@@ -136,6 +136,14 @@ public:
 								uint16_t*				outDate,
 								uint16_t*				outTime);
 	static void				SetTimeFromExternalRTC(void);
+#ifdef __MACH__
+							/*
+							*	Host builds have no RTC seconds interrupt.
+							*	This makes the ClockSource call Tick() once
+							*	per (possibly simulated) second instead.
+							*/
+	static void				AttachToClockSource(void);
+#endif
 	struct SComponents
 	{
 		uint8_t		second;
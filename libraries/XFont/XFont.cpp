@@ -29,7 +29,7 @@
 #endif
 #include <string.h>
 #include "DataStream.h"
-#include "DisplayController.h"
+#include "DisplayT.h"
 /*
 *	The font header, charcode runs array, and glyph data offsets array are
 *	assumed to be in near PROGMEM.  The Glyph data is accessed via a DataStream.
@@ -220,11 +220,33 @@ bool XFont::DrawCharcode(
 	uint8_t		inFakeMonospaceWidth)
 {
 	bool doContinue = LoadGlyph(inCharcode);
+	if (doContinue)
+	{
+	#ifdef DISPLAY_STATIC_DRIVER
+		if (StaticDisplay::Is(mDisplay))
+		{
+			doContinue = DrawGlyph(StaticDisplay(mDisplay), inFakeMonospaceWidth);
+		} else
+	#endif
+		{
+			doContinue = DrawGlyph(DisplayT<DisplayController>(mDisplay), inFakeMonospaceWidth);
+		}
+	}
+	return(doContinue);
+}
+
+/********************************* DrawGlyph **********************************/
+template <class Display>
+bool XFont::DrawGlyph(
+	Display		inDisplay,
+	uint8_t		inFakeMonospaceWidth)
+{
+	bool doContinue = true;
 	while (doContinue)
 	{
 		bool	rotated = mFontHeader.rotated;
 		bool	vertical = false;
-		uint16_t	startRow = mDisplay->GetRow();
+		uint16_t	startRow = inDisplay.GetRow();
 		uint8_t	rows = mGlyph.rows;
 		uint8_t	columns = mGlyph.columns;
 		if (inFakeMonospaceWidth)
@@ -235,7 +257,7 @@ bool XFont::DrawCharcode(
 		if (mFontHeader.oneBit)
 		{
 			vertical = rotated && !mFontHeader.horizontal;
-			if (mDisplay->BitsPerPixel() == 1)
+			if (inDisplay.BitsPerPixel() == 1)
 			{
 				if (rotated)
 				{
@@ -254,14 +276,14 @@ bool XFont::DrawCharcode(
 		#endif
 			}
 		}
-		uint16_t	startColumn = mDisplay->GetColumn();
+		uint16_t	startColumn = inDisplay.GetColumn();
 		uint16_t	rowsWritten = 0;
 		/*
 		*	Clear the pixels before the glyph...
 		*/
 		if (mGlyph.x)
 		{
-			mDisplay->FillBlock(mFontRows, mGlyph.x, mTextBGColor);
+			inDisplay.FillBlock(mFontRows, mGlyph.x, mTextBGColor);
 		}
 		/*
 		*	One bit rotated will have the y offset shifted into the data
@@ -275,18 +297,18 @@ bool XFont::DrawCharcode(
 			mGlyph.y &&
 			columns)
 		{
-			mDisplay->FillBlock(mGlyph.y, columns, mTextBGColor);
-			mDisplay->MoveTo(startRow + mGlyph.y, startColumn + mGlyph.x);
+			inDisplay.FillBlock(mGlyph.y, columns, mTextBGColor);
+			inDisplay.MoveTo(startRow + mGlyph.y, startColumn + mGlyph.x);
 			rowsWritten = mGlyph.y;
 		}
 		if (vertical)
 		{
-			mDisplay->SetAddressingMode(DisplayController::eVertical);
+			inDisplay.SetAddressingMode(DisplayController::eVertical);
 		}
-		doContinue = mDisplay->StreamCopyBlock(mFont->glyphData, rows, columns);
+		doContinue = inDisplay.StreamCopyBlock(mFont->glyphData, rows, columns);
 		if (vertical)
 		{
-			mDisplay->SetAddressingMode(DisplayController::eHorizontal);
+			inDisplay.SetAddressingMode(DisplayController::eHorizontal);
 		}
 		if (doContinue)
 		{
@@ -297,13 +319,13 @@ bool XFont::DrawCharcode(
 			if (columns &&
 				rowsWritten < mFontRows)
 			{
-				uint16_t	savedColumn = mDisplay->GetColumn();
-				mDisplay->MoveTo(startRow + rowsWritten, startColumn+mGlyph.x);
-				mDisplay->FillBlock(mFontRows-rowsWritten, columns, mTextBGColor);
-				mDisplay->MoveToColumn(savedColumn);
+				uint16_t	savedColumn = inDisplay.GetColumn();
+				inDisplay.MoveTo(startRow + rowsWritten, startColumn+mGlyph.x);
+				inDisplay.FillBlock(mFontRows-rowsWritten, columns, mTextBGColor);
+				inDisplay.MoveToColumn(savedColumn);
 			}
-			mDisplay->MoveToRow(startRow);
-			doContinue = mDisplay->GetColumn() != 0;	// don't wrap
+			inDisplay.MoveToRow(startRow);
+			doContinue = inDisplay.GetColumn() != 0;	// don't wrap
 			/*
 			*	Fill the pixels after the glyph (advance) with the BG color...
 			*/
@@ -311,10 +333,10 @@ bool XFont::DrawCharcode(
 			{
 				if (mGlyph.advanceX > (mGlyph.x + columns))
 				{
-					mDisplay->FillBlock(mFontRows, mGlyph.advanceX - mGlyph.x - columns, mTextBGColor);
-					doContinue = mDisplay->GetColumn() != 0;	// don't wrap
+					inDisplay.FillBlock(mFontRows, mGlyph.advanceX - mGlyph.x - columns, mTextBGColor);
+					doContinue = inDisplay.GetColumn() != 0;	// don't wrap
 				}
-				mDisplay->MoveToColumn(startColumn+mGlyph.advanceX);
+				inDisplay.MoveToColumn(startColumn+mGlyph.advanceX);
 			}
 		}
 		break;
@@ -256,6 +256,15 @@ protected:
 	bool				mHighlightEnabled;
 	uint8_t				mEllipsisWidth;	// 0 if current font has no ellipsis.
 	static const uint16_t	kEllipsisCharcode;
+
+							/*
+							*	Draws the loaded glyph for DrawCharcode.
+							*	Display is a DisplayT, see DisplayT.h
+							*/
+	template <class Display>
+	bool					DrawGlyph(
+								Display					inDisplay,
+								uint8_t					inFakeMonospaceWidth);
 };
 
 #endif // XFont_h
@@ -0,0 +1,216 @@
+/*
+*	TouchCalibration.cpp, Copyright Jonathan Mackey 2026
+*	Affine mapping of raw touch screen values to display coordinates.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "TouchCalibration.h"
+#include <string.h>
+
+/*********************************** Round ************************************/
+static int64_t Round(
+	double	inValue)
+{
+	return(inValue >= 0 ? (int64_t)(inValue + 0.5) : -(int64_t)(0.5 - inValue));
+}
+
+/********************************* DivRound ***********************************/
+static int64_t DivRound(
+	int64_t	inNumerator,
+	int64_t	inDenominator)
+{
+	if (inDenominator < 0)
+	{
+		inNumerator = -inNumerator;
+		inDenominator = -inDenominator;
+	}
+	return((inNumerator >= 0 ? (inNumerator + inDenominator/2) :
+		(inNumerator - inDenominator/2)) / inDenominator);
+}
+
+/*********************************** RawAt ************************************/
+/*
+*	Returns the raw value where an axis' display coordinate is inValue (Q16),
+*	on the raw center line of the other axis.
+*/
+static uint16_t RawAt(
+	int64_t		inValue,
+	int32_t		inScale,
+	int32_t		inSkew,
+	int32_t		inOffset)
+{
+	int64_t	raw = inScale ? DivRound(inValue -
+		(int64_t)inSkew * TouchCalibration::eRawCenter - inOffset, inScale) : 0;
+	return(raw < 0 ? 0 : (raw > 0xFFF ? 0xFFF : (uint16_t)raw));
+}
+
+/********************************* ClampSkew **********************************/
+static int16_t ClampSkew(
+	int32_t	inSkew)
+{
+	return(inSkew < -0x7FFF ? -0x7FFF : (inSkew > 0x7FFF ? 0x7FFF : (int16_t)inSkew));
+}
+
+/****************************** TouchCalibration ******************************/
+TouchCalibration::TouchCalibration(void)
+{
+	memset(mMatrix, 0, sizeof(mMatrix));
+}
+
+/********************************* SetMinMax **********************************/
+/*
+*	x = columns * (rawX - xMin)/(xMax - xMin) + xSkew * (rawY - eRawCenter)
+*	(similarly for y.)  A min equal to its max maps everything to 0, as the
+*	map() based alignment did when not aligned.
+*/
+void TouchCalibration::SetMinMax(
+	const uint16_t	inMinMax[4],
+	int16_t			inXSkew,
+	int16_t			inYSkew,
+	uint16_t		inColumns,
+	uint16_t		inRows)
+{
+	int64_t	matrix[6] = {0};
+	int64_t	xRange = (int64_t)inMinMax[1] - inMinMax[0];
+	int64_t	yRange = (int64_t)inMinMax[3] - inMinMax[2];
+	if (xRange)
+	{
+		matrix[0] = DivRound((int64_t)inColumns << 16, xRange);
+		matrix[1] = inXSkew;
+		matrix[2] = DivRound(-((int64_t)inColumns << 16) * inMinMax[0], xRange) -
+						(int64_t)inXSkew * eRawCenter;
+	}
+	if (yRange)
+	{
+		matrix[3] = inYSkew;
+		matrix[4] = DivRound((int64_t)inRows << 16, yRange);
+		matrix[5] = DivRound(-((int64_t)inRows << 16) * inMinMax[2], yRange) -
+						(int64_t)inYSkew * eRawCenter;
+	}
+	if (!SetMatrix(matrix))
+	{
+		memset(mMatrix, 0, sizeof(mMatrix));
+	}
+}
+
+/********************************* GetMinMax **********************************/
+/*
+*	The inverse of SetMinMax.  The values are rounded to the nearest raw
+*	count, which moves a point by less than a tenth of a pixel.
+*/
+void TouchCalibration::GetMinMax(
+	uint16_t	outMinMax[4],
+	int16_t&	outXSkew,
+	int16_t&	outYSkew,
+	uint16_t	inColumns,
+	uint16_t	inRows) const
+{
+	outMinMax[0] = RawAt(0, mMatrix[0], mMatrix[1], mMatrix[2]);
+	outMinMax[1] = RawAt((int64_t)inColumns << 16, mMatrix[0], mMatrix[1], mMatrix[2]);
+	outMinMax[2] = RawAt(0, mMatrix[4], mMatrix[3], mMatrix[5]);
+	outMinMax[3] = RawAt((int64_t)inRows << 16, mMatrix[4], mMatrix[3], mMatrix[5]);
+	outXSkew = ClampSkew(mMatrix[1]);
+	outYSkew = ClampSkew(mMatrix[3]);
+}
+
+/*********************************** Solve ************************************/
+/*
+*	Least squares fit of x = a*rawX + b*rawY + c (and y the same way.)  The
+*	raw values are taken relative to their mean so that the normal equations
+*	reduce to a 2x2 system per axis:
+*		| Sxx Sxy | |a|   |Sxt|
+*		| Sxy Syy | |b| = |Syt|		c = mean t - a*mean rawX - b*mean rawY
+*	Three points give an exact fit.
+*/
+bool TouchCalibration::Solve(
+	const STouchPoint*	inPoints,
+	uint8_t				inCount)
+{
+	bool	success = inCount >= 3;
+	if (success)
+	{
+		double	meanRawX = 0, meanRawY = 0, meanX = 0, meanY = 0;
+		for (uint8_t i = 0; i < inCount; i++)
+		{
+			meanRawX += inPoints[i].rawX;
+			meanRawY += inPoints[i].rawY;
+			meanX += inPoints[i].x;
+			meanY += inPoints[i].y;
+		}
+		meanRawX /= inCount;
+		meanRawY /= inCount;
+		meanX /= inCount;
+		meanY /= inCount;
+		double	sxx = 0, sxy = 0, syy = 0;
+		double	sxX = 0, syX = 0, sxY = 0, syY = 0;
+		for (uint8_t i = 0; i < inCount; i++)
+		{
+			double	dx = inPoints[i].rawX - meanRawX;
+			double	dy = inPoints[i].rawY - meanRawY;
+			sxx += dx * dx;
+			sxy += dx * dy;
+			syy += dy * dy;
+			sxX += dx * inPoints[i].x;
+			syX += dy * inPoints[i].x;
+			sxY += dx * inPoints[i].y;
+			syY += dy * inPoints[i].y;
+		}
+		double	det = sxx * syy - sxy * sxy;
+		// Collinear (or repeated) points leave the fit undetermined.
+		success = det > 1e-6 * sxx * syy && det > 0;
+		if (success)
+		{
+			double	a = (sxX * syy - syX * sxy) / det;
+			double	b = (syX * sxx - sxX * sxy) / det;
+			double	d = (sxY * syy - syY * sxy) / det;
+			double	e = (syY * sxx - sxY * sxy) / det;
+			int64_t	matrix[6] =
+			{
+				Round(a * 65536),
+				Round(b * 65536),
+				Round((meanX - a * meanRawX - b * meanRawY) * 65536),
+				Round(d * 65536),
+				Round(e * 65536),
+				Round((meanY - d * meanRawX - e * meanRawY) * 65536)
+			};
+			success = SetMatrix(matrix);
+		}
+	}
+	return(success);
+}
+
+/********************************* SetMatrix **********************************/
+bool TouchCalibration::SetMatrix(
+	const int64_t	inMatrix[6])
+{
+	bool	success = true;
+	for (uint8_t i = 0; i < 6 && success; i++)
+	{
+		int64_t	limit = (i == 2 || i == 5) ? eMaxOffset : eMaxScale;
+		success = inMatrix[i] >= -limit && inMatrix[i] <= limit;
+	}
+	if (success)
+	{
+		for (uint8_t i = 0; i < 6; i++)
+		{
+			mMatrix[i] = (int32_t)inMatrix[i];
+		}
+	}
+	return(success);
+}
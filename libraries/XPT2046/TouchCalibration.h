@@ -0,0 +1,111 @@
+/*
+*	TouchCalibration.h, Copyright Jonathan Mackey 2026
+*	Affine mapping of raw touch screen values to display coordinates.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef TouchCalibration_h
+#define TouchCalibration_h
+
+#include <inttypes.h>
+
+struct STouchPoint
+{
+	uint16_t	rawX;	// 12 bit touch screen values
+	uint16_t	rawY;
+	int16_t		x;		// Where on the display
+	int16_t		y;
+};
+
+/*
+*	x = (a*rawX + b*rawY + c) >> 16
+*	y = (d*rawX + e*rawY + f) >> 16
+*	The matrix is Q16, so applying it is four multiplies and two shifts.
+*	Unlike scaling each axis (the min/max mapping) it corrects rotation and
+*	skew between the panel and the display.
+*
+*	Solve() fits the matrix to three or more points by least squares.  It
+*	uses floating point, it's only done when aligning.
+*
+*	The matrix is stored as min/max values plus two skew terms.  The
+*	min/max values are the rawX values at x = 0 and x = columns when rawY is
+*	eRawCenter (similarly for y.)  With no skew these are the same min/max
+*	values the map() based alignment stored, so either form can be read by
+*	either version of the firmware.
+*/
+class TouchCalibration
+{
+public:
+							TouchCalibration(void);
+	enum
+	{
+		eRawCenter	= 2048
+	};
+							/*
+							*	inMinMax is xMin, xMax, yMin, yMax.  The skew
+							*	terms are b and d, Q16 pixels per raw count.
+							*/
+	void					SetMinMax(
+								const uint16_t			inMinMax[4],
+								int16_t					inXSkew,
+								int16_t					inYSkew,
+								uint16_t				inColumns,
+								uint16_t				inRows);
+	void					GetMinMax(
+								uint16_t				outMinMax[4],
+								int16_t&				outXSkew,
+								int16_t&				outYSkew,
+								uint16_t				inColumns,
+								uint16_t				inRows) const;
+							/*
+							*	Returns false if the points are collinear or
+							*	the result is out of range, in which case the
+							*	matrix isn't changed.
+							*/
+	bool					Solve(
+								const STouchPoint*		inPoints,
+								uint8_t					inCount);
+	inline void				Apply(
+								uint16_t				inRawX,
+								uint16_t				inRawY,
+								int16_t&				outX,
+								int16_t&				outY) const
+							{
+								outX = (mMatrix[0]*inRawX + mMatrix[1]*inRawY + mMatrix[2] + 0x8000) >> 16;
+								outY = (mMatrix[3]*inRawX + mMatrix[4]*inRawY + mMatrix[5] + 0x8000) >> 16;
+							}
+	inline const int32_t*	Matrix(void) const
+								{return(mMatrix);}
+protected:
+	int32_t	mMatrix[6];	// a, b, c, d, e, f
+	enum
+	{
+		/*
+		*	Limits that keep Apply within 31 bits for 12 bit raw values.
+		*	The scale is at most 2 pixels per raw count.
+		*/
+		eMaxScale	= 1 << 17,
+		eMaxOffset	= 1 << 29
+	};
+
+	bool					SetMatrix(
+								const int64_t			inMatrix[6]);
+};
+
+#endif // TouchCalibration_h
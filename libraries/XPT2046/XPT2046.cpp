@@ -25,7 +25,32 @@
 #include <SPI.h>
 #include "XPT2046.h"
 
-volatile bool	XPT2046::sPenStateChanged;
+#if !(TOUCH_SAMPLES & 1) || TOUCH_SAMPLES > 15
+#error "TOUCH_SAMPLES must be odd, 15 or less"
+#endif
+
+pin_t	XPT2046::sPenIRQPin;
+
+/*********************************** Median ***********************************/
+/*
+*	Sorts ioValues (insertion sort, inCount is small) and returns the middle.
+*/
+static uint16_t Median(
+	uint16_t*	ioValues,
+	uint8_t		inCount)
+{
+	for (uint8_t i = 1; i < inCount; i++)
+	{
+		uint16_t	value = ioValues[i];
+		uint8_t		j = i;
+		for (; j > 0 && ioValues[j-1] > value; j--)
+		{
+			ioValues[j] = ioValues[j-1];
+		}
+		ioValues[j] = value;
+	}
+	return(ioValues[inCount/2]);
+}
 
 /********************************** XPT2046 ***********************************/
 XPT2046::XPT2046(
@@ -42,9 +67,11 @@ XPT2046::XPT2046(
 	: mCSPin(inCSPin), mPenIRQPin(inPenIRQPin),
 		mRows(inHeight), mColumns(inWidth),
 		mSPISettings(2000000, MSBFIRST, SPI_MODE0),
-		mMinMax{inMinX, inMaxX, inMinY, inMaxY},
-		mInvertX(inInvertX), mInvertY(inInvertY)
+		mMinMax{inMinX, inMaxX, inMinY, inMaxY}, mSkew{0, 0},
+		mInvertX(inInvertX), mInvertY(inInvertY),
+		mAlignCount(0), mAlignNext(0), mAligned(false)
 {
+	UpdateCalibration();
 }
 
 /*********************************** begin ************************************/
@@ -59,10 +86,14 @@ void XPT2046::begin(
 		digitalWrite(mCSPin, HIGH);
 		pinMode(mCSPin, OUTPUT);
 	}
-	sPenStateChanged = false;
+	mPenStateIsDown = false;
+	mEdgePending = false;
+	mTracking = false;
+	mVelocityX = mVelocityY = 0;
 	SetRotation(inRotation);
 	if (mPenIRQPin >= 0)
 	{
+		sPenIRQPin = mPenIRQPin;
 		pinMode(mPenIRQPin, INPUT);
 		attachInterrupt(digitalPinToInterrupt(mPenIRQPin), XPT2046::PenStateChangedISR, CHANGE);
 	}
@@ -80,6 +111,13 @@ void XPT2046::SetRotation(
 		mRows = mColumns;
 		mColumns = temp;
 	}
+	UpdateCalibration();
+}
+
+/***************************** UpdateCalibration ******************************/
+void XPT2046::UpdateCalibration(void)
+{
+	mCalibration.SetMinMax(mMinMax, mSkew[0], mSkew[1], mColumns, mRows);
 }
 
 /******************************** ToggleInvertX *******************************/
@@ -94,29 +132,31 @@ void XPT2046::ToggleInvertY(void)
 	mInvertY = !mInvertY;
 }
 
+/********************************** PenEdge ***********************************/
+void XPT2046::PenEdge(
+	const SISREvent&	inEvent)
+{
+	mEdgePending = true;
+	mEdgeIsDown = inEvent.type == ISREvents::ePenDown;
+	mEdgeTime = inEvent.time;
+}
+
 /****************************** PenStateChanged *******************************/
 bool XPT2046::PenStateChanged(void)
 {
 	bool penStateChanged = false;
 
-	// Ensure that the change lasts more than mDebouncePeriod.
-	if (sPenStateChanged)
+	// Ensure that the change lasts more than eDebounceUS.
+	if (mEdgePending &&
+		(ClockSource::Micros() - mEdgeTime) >= eDebounceUS)
 	{
-		if (!mDebouncePeriod.Get())
-		{
-			/*
-			*	If the debounce period is too long you miss real changes to
-			*	the pen state.  It's still not perfect.  Some of the state
-			*	changes are missed on very light or fast touches.
-			*/
-			mDebouncePeriod.Set(1);	// 1ms
-			mDebouncePeriod.Start();
-			mPenStateIsDown = PenIsDown();
-		} else if (mDebouncePeriod.Passed())
+		mEdgePending = false;
+		penStateChanged = mPenStateIsDown != mEdgeIsDown;
+		mPenStateIsDown = mEdgeIsDown;
+		if (penStateChanged)
 		{
-			mDebouncePeriod.Set(0);
-			penStateChanged = mPenStateIsDown == PenIsDown();
-			sPenStateChanged = false;
+			mTracking = false;
+			mVelocityX = mVelocityY = 0;
 		}
 	}
 	return(penStateChanged);
@@ -136,13 +176,11 @@ bool XPT2046::ReadRaw(
 	*/
 	enum
 	{
-		eZ1,
-		eZ2,
-		eX0,	// Ignored to allow for settling
-		eY0,	// Ignored to allow for settling
-		eX1,
-		eY1,
-		eNumCommands
+		eFirstZ,							// eSamples Z1, Z2 pairs
+		eSettleX = eFirstZ + eSamples*2,	// Ignored to allow for settling
+		eSettleY,							// Ignored to allow for settling
+		eFirstXY,							// eSamples X, Y pairs
+		eNumCommands = eFirstXY + eSamples*2
 	};
 	struct SCmdData
 	{
@@ -159,8 +197,7 @@ bool XPT2046::ReadRaw(
 			data >>= 3;
 		#endif
 		}
-	} __attribute__ ((packed)) cmdData[eNumCommands] =
-			{{0xB1},{0xC1},{0x91},{0xD1},{0x91},{0xD0}};
+	} __attribute__ ((packed)) cmdData[eNumCommands] = {};
 		//	Commands: (Summary as used. There are other options in doc.)
 		//		Bx reads Z1
 		//		Cx reads Z2
@@ -169,12 +206,19 @@ bool XPT2046::ReadRaw(
 		//		A 1 in the low nibble keeps the chip active.
 		//		A 0 in the low nibble puts the chip to sleep.
 
-		// I noticed that some of the XPT2046 classes do averaging. Looking
-		// at the data coming in, I didn't see any value in averaging.	The
-		// data was just as error prone (but not bad.)
-		// It would be easy to add averaging by simply inserting a few more
-		// 0x91 0xD1 commands into the array above, and add corresponding
-		// enum values.	 Then average the returned data.
+		// Looking at the data coming in, a single read is error prone (but
+		// not bad.)  Averaging doesn't help, a bad sample skews the average.
+		// The median of eSamples reads rejects the occasional bad sample.
+	for (uint8_t i = 0; i < eSamples; i++)
+	{
+		cmdData[eFirstZ + i*2].cmd = 0xB1;
+		cmdData[eFirstZ + i*2 + 1].cmd = 0xC1;
+		cmdData[eFirstXY + i*2].cmd = 0x91;
+		cmdData[eFirstXY + i*2 + 1].cmd = 0xD1;
+	}
+	cmdData[eSettleX].cmd = 0x91;
+	cmdData[eSettleY].cmd = 0xD1;
+	cmdData[eNumCommands-1].cmd = 0xD0;	// Sleep after the last
 
 	/*
 	*	Within the SPI.transfer(), the PenIRQPin toggles between
@@ -190,26 +234,41 @@ bool XPT2046::ReadRaw(
 	*	high.
 	*/
 	attachInterrupt(digitalPinToInterrupt(mPenIRQPin), XPT2046::PenStateChangedISR, CHANGE);
-	sPenStateChanged = false;
 
 	for (uint8_t i = 0; i < eNumCommands; i++)
 	{
 		cmdData[i].Adjust();
 	}
+	uint16_t	x[eSamples];
+	uint16_t	y[eSamples];
+	uint16_t	z[eSamples];
+	uint8_t		pressed = 0;
+	for (uint8_t i = 0; i < eSamples; i++)
+	{
+		z[i] = cmdData[eFirstZ + i*2].data + 0xFFF - cmdData[eFirstZ + i*2 + 1].data;
+		if (z[i] >= eMinZ)
+		{
+			pressed++;
+		}
+		x[i] = cmdData[eFirstXY + i*2].data;
+		y[i] = cmdData[eFirstXY + i*2 + 1].data;
+	}
 #if 0
 	// Dump the raw values
-	static char ll[] = "zzxyxyxyxyxyxyxyrrr";
-	// i = 0 dump all, including z and the skipped xy values.
-	// i = 4 dump just the used xy values.
-	for (uint8_t i = 4; i < eNumCommands; i++)
+	for (uint8_t i = 0; i < eSamples; i++)
 	{
-		Serial.print(ll[i]);
-		Serial.print(cmdData[i].data);
+		Serial.print('x');
+		Serial.print(x[i]);
+		Serial.print(" y");
+		Serial.print(y[i]);
+		Serial.print(" z");
+		Serial.print(z[i]);
 		Serial.print(' ');
 	}
 	Serial.println();
 #endif
-	int32_t z = cmdData[eZ1].data + 0xFFF - cmdData[eZ2].data;
+	uint16_t	rawX = Median(x, eSamples);
+	uint16_t	rawY = Median(y, eSamples);
 
 	/*
 	*	The rotation applied below expects a certain orientation.  I decided on
@@ -223,35 +282,39 @@ bool XPT2046::ReadRaw(
 	*/
 	if (mInvertX)
 	{
-		cmdData[eX1].data = 0xFFF - cmdData[eX1].data;
+		rawX = 0xFFF - rawX;
 	}
 	if (mInvertY)
 	{
-		cmdData[eY1].data = 0xFFF - cmdData[eY1].data;
+		rawY = 0xFFF - rawY;
 	}
 
 
 	switch (mRotation)
 	{
 		case 0: // 0
-			outX = cmdData[eY1].data;
-			outY = 0xFFF - cmdData[eX1].data;
+			outX = rawY;
+			outY = 0xFFF - rawX;
 			break;
 		case 1: // 90
-			outX = 0xFFF - cmdData[eX1].data;
-			outY = 0xFFF - cmdData[eY1].data;
+			outX = 0xFFF - rawX;
+			outY = 0xFFF - rawY;
 			break;
 		case 2: // 180
-			outX = 0xFFF - cmdData[eY1].data;
-			outY = cmdData[eX1].data;
+			outX = 0xFFF - rawY;
+			outY = rawX;
 			break;
 		case 3: // 270
-			outX = cmdData[eX1].data;
-			outY = cmdData[eY1].data;
+			outX = rawX;
+			outY = rawY;
 			break;
 	}
-	outZ = z;
-	bool	isValid = z >= 100;
+	outZ = Median(z, eSamples);
+	/*
+	*	The Z gate: most of the samples need to be pressed.  A light or
+	*	lifting touch gives positions that wander.
+	*/
+	bool	isValid = pressed > eSamples/2;
 	return(isValid);
 }
 
@@ -265,16 +328,67 @@ bool XPT2046::Read(
 
 	bool	isValid = ReadRaw(x,y,z);
 	outZ = z;
-	outX = map(x, mMinMax[eXMin], mMinMax[eXMax], 0, mColumns);
-	outY = map(y, mMinMax[eYMin], mMinMax[eYMax], 0, mRows);
+	int16_t	calX, calY;
+	mCalibration.Apply(x, y, calX, calY);
+	// Touches just off the edge of the display are clipped to 0.
+	outX = calX > 0 ? calX : 0;
+	outY = calY > 0 ? calY : 0;
 
 	return(isValid);
 }
 
+/*********************************** Sample ***********************************/
+bool XPT2046::Sample(
+	uint16_t&	outX,
+	uint16_t&	outY)
+{
+	uint16_t	z;
+	bool	isValid = Read(outX, outY, z);
+	if (isValid)
+	{
+		uint32_t	now = ClockSource::Micros();
+		if (mTracking)
+		{
+			uint32_t	elapsed = now - mLastTime;
+			if (elapsed)
+			{
+				mVelocityX = Velocity(mVelocityX, (int32_t)outX - mLastX, elapsed);
+				mVelocityY = Velocity(mVelocityY, (int32_t)outY - mLastY, elapsed);
+			}
+		}
+		mTracking = true;
+		mLastX = outX;
+		mLastY = outY;
+		mLastTime = now;
+	}
+	return(isValid);
+}
+
+/********************************** Velocity **********************************/
+/*
+*	Returns the average of inVelocity and the velocity of the last move, in
+*	pixels per second.
+*/
+int16_t XPT2046::Velocity(
+	int16_t		inVelocity,
+	int32_t		inDelta,
+	uint32_t	inElapsed)	// us
+{
+	int32_t	velocity = (inVelocity + inDelta * 1000000 / (int32_t)inElapsed)/2;
+	if (velocity > 0x7FFF)
+	{
+		velocity = 0x7FFF;
+	} else if (velocity < -0x7FFF)
+	{
+		velocity = -0x7FFF;
+	}
+	return(velocity);
+}
+
 /***************************** PenStateChangedISR *****************************/
 void XPT2046::PenStateChangedISR(void)
 {
-	sPenStateChanged = true;
+	ISREvents::Push(digitalRead(sPenIRQPin) ? ISREvents::ePenUp : ISREvents::ePenDown);
 }
 
 /********************************* DumpMinMax *********************************/
@@ -287,27 +401,31 @@ void XPT2046::DumpMinMax(void) const
 		Serial.print(mMinMax[i]);
 		Serial.println(';');
 	}
+	Serial.print(F("XSkew = "));
+	Serial.print(mSkew[0]);
+	Serial.print(F(";\nYSkew = "));
+	Serial.print(mSkew[1]);
+	Serial.println(';');
 }
 
 /********************************* StartAlign *********************************/
 void XPT2046::StartAlign(void)
 {
-	mAlignXY[0] = mAlignXY[1] = mAlignXY[2] = mAlignXY[3] = 0x7FF;
+	mAlignCount = 0;
+	mAlignNext = 0;
+	mAligned = false;
 }
 
 /******************************* AlignmentReady *******************************/
 /*
-*	Returns true when enough alignment points have been entered to save min&max.
-*	True does NOT mean that the current min & max values are any good.  That can
-*	only be determined by visually checking the points touched align with
-*	the display, generally by drawing the point touched after each press.
+*	Returns true when enough alignment points have been entered to solve the
+*	calibration.  True does NOT mean that the current calibration is any good.
+*	That can only be determined by visually checking the points touched align
+*	with the display, generally by drawing the point touched after each press.
 */
 bool XPT2046::AlignmentReady(void) const
 {
-	return(mAlignXY[eXMin] != 0x7FF &&
-			mAlignXY[eXMax] != 0x7FF &&
-			mAlignXY[eYMin] != 0x7FF &&
-			mAlignXY[eYMax] != 0x7FF);
+	return(mAligned);
 }
 
 /********************************** GetMinMax *********************************/
@@ -317,11 +435,25 @@ void XPT2046::GetMinMax(
 	memcpy(outMinMax, mMinMax, sizeof(mMinMax));
 }
 
+/*********************************** GetSkew **********************************/
+void XPT2046::GetSkew(
+	int16_t&	outXSkew,
+	int16_t&	outYSkew) const
+{
+	outXSkew = mSkew[0];
+	outYSkew = mSkew[1];
+}
+
 /********************************** SetMinMax *********************************/
 void XPT2046::SetMinMax(
-	const uint16_t	inMinMax[4])
+	const uint16_t	inMinMax[4],
+	int16_t			inXSkew,
+	int16_t			inYSkew)
 {
 	memcpy(mMinMax, inMinMax, sizeof(mMinMax));
+	mSkew[0] = inXSkew;
+	mSkew[1] = inYSkew;
+	UpdateCalibration();
 }
 
 /*********************************** Align ************************************/
@@ -329,81 +461,44 @@ void XPT2046::SetMinMax(
 *	This is used to align the touchscreen to the display.
 *
 *	To use:
-*	Write code to display the x and y values returned by Read() to the display
-*	or dump the values to Serial.  You just need something to display the points
-*	as they're touched/read.
-*
-*	Call DisplayController::DrawAlignmentPoints(void) or an equivalent of your
-*	own design, to draw an inset array of 9 points on the display as shown in
-*	the example below.
+*	Draw a target on the display, when it's touched call Align() passing the
+*	target's location.  Repeat for targets spread over the display, generally
+*	near each corner (see ST77XXToXPT2046Alignment.)  Three targets that aren't
+*	on a line are enough to solve the calibration, more targets (or the same
+*	targets again) average out an imprecise touch.  Only the last
+*	eMaxAlignPoints are used so a bad touch eventually drops out.
 *
-*	Example, for rows = 320, columns = 480, and inset 20:
+*	Unlike scaling each axis between its min and max, the solved calibration
+*	also corrects for the touch panel being slightly rotated or skewed
+*	relative to the display.
 *
-*					*	*	*	=	TL	TC	TR	=	20,20	240,20, 460,20
-*					*	*	*	=	CL	CC	CR	=	20,160	240,160 460,160
-*					*	*	*	=	BL	BC	BR	=	20,300	240,300 460,300
-*
-*	Fill the mAlignXY array by precisely touching CL, CR, TC, and BC points
-*	drawn on the display, calling Align() after each touch.	 If you think you
-*	didn't precisely touch any of the points, touch any point again (any order.)
-*	Stop calling Align(), then touch these 4 points again, verifying that the
-*	points returned by Read() are mapped correctly to your display.  If the
-*	alignment is off, repeat the above for whatever axis is off. Once reasonably
-*	accurate, call DumpMinMax() to get the updated values.	Pass these updated
-*	values to the XPT2046 constructor.
+*	Verify the alignment by drawing the point returned by Read() after each
+*	touch.  Once reasonably accurate, call DumpMinMax() to get the updated
+*	values or GetMinMax() and GetSkew() to save them.
 */
 bool XPT2046::Align(
-	uint16_t	inDesiredOffset)
+	int16_t	inTargetX,
+	int16_t	inTargetY)
 {
 	uint16_t	x,y,z;
 	bool isValid = ReadRaw(x,y,z);
 	if (isValid)
 	{
-		bool changeMade = true;
-		switch (map(x, 0, 0xFFF, 0, 3))
-		{
-			case 0:		// Left 3rd of X axis touched
-				mAlignXY[eXMin] = x;
-				break;
-			case 1:		// Center 3rd of X axis touched
-				changeMade = false;
-				break;
-			default:	// Right 3rd of X axis touched
-				mAlignXY[eXMax] = x;
-				break;
-		}
-		if (changeMade &&
-			mAlignXY[eXMin] != 0x7FF &&
-			mAlignXY[eXMax] != 0x7FF)
+		STouchPoint&	point = mAlignPoints[mAlignNext];
+		point.rawX = x;
+		point.rawY = y;
+		point.x = inTargetX;
+		point.y = inTargetY;
+		mAlignNext = (mAlignNext + 1) % eMaxAlignPoints;
+		if (mAlignCount < eMaxAlignPoints)
 		{
-			mMinMax[eXMin] = map(0, inDesiredOffset, mColumns-inDesiredOffset,
-									mAlignXY[eXMin], mAlignXY[eXMax]);
-			mMinMax[eXMax] = map(mColumns, inDesiredOffset, mColumns-inDesiredOffset,
-									mAlignXY[eXMin], mAlignXY[eXMax]);
+			mAlignCount++;
 		}
-		changeMade = true;
-		switch (map(y, 0, 0xFFF, 0, 3))
+		if (mCalibration.Solve(mAlignPoints, mAlignCount))
 		{
-			case 0:		// Top 3rd of Y axis touched
-				mAlignXY[eYMin] = y;
-				break;
-			case 1:		// Center 3rd of Y axis touched
-				changeMade = false;
-				break;
-			default:	// Bottom 3rd of Y axis touched
-				mAlignXY[eYMax] = y;
-				break;
-		}
-		if (changeMade &&
-			mAlignXY[eYMin] != 0x7FF &&
-			mAlignXY[eYMax] != 0x7FF)
-		{
-			mMinMax[eYMin] = map(0, inDesiredOffset, mRows-inDesiredOffset,
-									mAlignXY[eYMin], mAlignXY[eYMax]);
-			mMinMax[eYMax] = map(mRows, inDesiredOffset, mRows-inDesiredOffset,
-									mAlignXY[eYMin], mAlignXY[eYMax]);
+			mAligned = true;
+			mCalibration.GetMinMax(mMinMax, mSkew[0], mSkew[1], mColumns, mRows);
 		}
 	}
 	return(isValid);
 }
-
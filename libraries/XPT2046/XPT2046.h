@@ -24,8 +24,25 @@
 #define XPT2046_h
 #include <SPI.h>
 #include "PlatformDefs.h"
-#include "MSPeriod.h"
+#include "ClockSource.h"
+#include "ISREvents.h"
+#include "TouchCalibration.h"
 
+/*
+*	The number of X, Y and Z samples taken by each read.  The median of each
+*	is used.  Odd, 15 or less.
+*/
+#ifndef TOUCH_SAMPLES
+#define TOUCH_SAMPLES	5
+#endif
+
+/*
+*	The minimum pressure (Z) for a sample to count.  A read is only valid
+*	when most of its Z samples pass.
+*/
+#ifndef TOUCH_MIN_Z
+#define TOUCH_MIN_Z		100
+#endif
 
 class XPT2046
 {
@@ -45,15 +62,51 @@ public:
 	void					begin(
 								uint8_t					inRotation = 0);
 	
+							/*
+							*	The pen IRQ interrupt queues ePenDown/ePenUp
+							*	ISREvents.  Pass them to PenEdge.  The pen state
+							*	changes once there have been no edges for
+							*	eDebounceUS.
+							*/
+	void					PenEdge(
+								const SISREvent&		inEvent);
 	bool					PenStateChanged(void);
+	inline bool				EdgePending(void) const
+								{return(mEdgePending);}
+							// The debounced state
 	inline bool				PenIsDown(void) const
-								{return(!digitalRead(mPenIRQPin));}
+								{return(mPenStateIsDown);}
 	bool					Read(
 								uint16_t&				outX,
 								uint16_t&				outY,
 								uint16_t&				outZ);
+							/*
+							*	Call every eSamplePeriod ms while the pen is
+							*	down.  Returns false if the read is rejected by
+							*	the Z gate.  Otherwise the point is tracked and
+							*	Velocity is updated.  Tracking restarts on each
+							*	pen state change.
+							*/
+	bool					Sample(
+								uint16_t&				outX,
+								uint16_t&				outY);
+	inline bool				IsTracking(void) const
+								{return(mTracking);}
+							// Pixels per second, smoothed over the samples.
+	inline int16_t			VelocityX(void) const
+								{return(mVelocityX);}
+	inline int16_t			VelocityY(void) const
+								{return(mVelocityY);}
+							/*
+							*	Adds the point touched to the alignment points
+							*	as being at inTargetX, inTargetY on the display.
+							*	Once there are 3 or more (not collinear) the
+							*	calibration is solved from the last
+							*	eMaxAlignPoints.
+							*/
 	bool					Align(
-								uint16_t				inDesiredOffset = 20);
+								int16_t					inTargetX,
+								int16_t					inTargetY);
 	void					StartAlign(void);
 	bool					AlignmentReady(void) const;
 	void					DumpMinMax(void) const;
@@ -69,8 +122,23 @@ public:
 	
 	void					GetMinMax(
 								uint16_t				outMinMax[4]) const;
+	void					GetSkew(
+								int16_t&				outXSkew,
+								int16_t&				outYSkew) const;
+							/*
+							*	See TouchCalibration for the meaning of the skew
+							*	terms.  With no skew the mapping is the same as
+							*	scaling each axis between its min and max.
+							*/
 	void					SetMinMax(
-								const uint16_t			inMinMax[4]);
+								const uint16_t			inMinMax[4],
+								int16_t					inXSkew = 0,
+								int16_t					inYSkew = 0);
+	enum
+	{
+		eSamplePeriod	= 10,	// ms
+		eMaxAlignPoints	= 10
+	};
 	
 protected:
 	pin_t		mCSPin;
@@ -79,6 +147,15 @@ protected:
 	uint16_t	mRows;
 	uint16_t	mColumns;
 	bool		mPenStateIsDown;
+	bool		mEdgePending;
+	bool		mEdgeIsDown;
+	uint32_t	mEdgeTime;			// us
+	bool		mTracking;
+	uint16_t	mLastX;				// Last Sample()
+	uint16_t	mLastY;
+	uint32_t	mLastTime;			// us
+	int16_t		mVelocityX;
+	int16_t		mVelocityY;
 	/*
 	*	One of the modules I have has X inverted, opposite of the display.
 	*/
@@ -92,12 +169,27 @@ protected:
 		eYMax
 	};
 	uint16_t	mMinMax[4];
-	uint16_t	mAlignXY[4];	// Used by Align()
-	MSPeriod	mDebouncePeriod;
+	int16_t		mSkew[2];
+	TouchCalibration	mCalibration;
+	STouchPoint	mAlignPoints[eMaxAlignPoints];	// Used by Align()
+	uint8_t		mAlignCount;
+	uint8_t		mAlignNext;
+	bool		mAligned;
 	volatile port_t*	mChipSelPortReg;
 	port_t		mChipSelBitMask;
 	SPISettings	mSPISettings;
-	static volatile bool	sPenStateChanged;
+	static pin_t	sPenIRQPin;
+	enum
+	{
+		/*
+		*	If the debounce period is too long you miss real changes to the
+		*	pen state.  Some of the state changes are missed on very light or
+		*	fast touches.
+		*/
+		eDebounceUS	= 1000,
+		eSamples	= TOUCH_SAMPLES,
+		eMinZ		= TOUCH_MIN_Z
+	};
 
 
 	bool					ReadRaw(
@@ -106,6 +198,7 @@ protected:
 								uint16_t&				outZ);
 	void					SetRotation(
 								uint8_t					inRotation);
+	void					UpdateCalibration(void);
 	inline void				BeginTransaction(void)
 							{
 								SPI.beginTransaction(mSPISettings);
@@ -126,6 +219,10 @@ protected:
 							}
 
 	static void				PenStateChangedISR(void);
+	static int16_t			Velocity(
+								int16_t					inVelocity,
+								int32_t					inDelta,
+								uint32_t				inElapsed);
 
 };
 #endif // XPT2046_h
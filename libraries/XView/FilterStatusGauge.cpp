@@ -21,6 +21,8 @@
 */
 #include "FilterStatusGauge.h"
 #include "DisplayController.h"
+#include "MemoryStats.h"
+#include "Profiler.h"
 #ifdef __MACH__
 	#define map DisplayController::map
 #endif
@@ -100,6 +102,7 @@ void FilterStatusGauge::SetValue(
 /*********************************** Update ***********************************/
 void FilterStatusGauge::Update(void)
 {
+	PROFILE_SCOPE(FilterStatusGauge);
 	/*
 	*	If the indicator needs to move THEN
 	*	redraw the indicator.
@@ -233,109 +236,119 @@ void FilterStatusGauge::DrawGauge(void)
 	*/
 	uint32_t	columnsToSkip = mRadius - transLineLen;
 
-	uint16_t	pixelLine[gaugeWidth+1];
-	uint16_t*	pixellineEnd = &pixelLine[gaugeWidth];
-	
 	/*
-	*	Generate the left and right color gradients
+	*	The pixel line and the left and right color gradients are taken from
+	*	the display's scratch arena rather than the stack.  They're released
+	*	when scratchFrame goes out of scope.
 	*/
-	uint16_t	leftTransLine[transLineLen];
-	uint16_t	rightTransLine[transLineLen];
-	GenerateTransitionLine(eCenterColor, eStartColor, transLineLen, leftTransLine);
-	GenerateTransitionLine(eCenterColor, eEndColor, transLineLen, rightTransLine);
-
-	uint32_t	dispInset = columnsToSkip ? columnsToSkip-1 : 0;
-	uint32_t	row = mRadius;
-	uint32_t	column;
-	uint32_t	padLeft = 0;
-	uint32_t	padRight = 0;
-	uint32_t	firstRadiusSquared = mRadius*mRadius;
-	uint32_t	lastRadiusSquared = mRadius-mGaugeThickness;
-	lastRadiusSquared *= lastRadiusSquared;
-
-	for (uint32_t rowSquared = row*row; rowSquared > 1; row--, rowSquared = row*row)
+	ScratchArena::Frame	scratchFrame(display->Scratch());
+	Span<uint16_t>	pixelLine = display->Scratch().Allocate<uint16_t>(gaugeWidth+1);
+	Span<uint16_t>	leftTransLine = display->Scratch().Allocate<uint16_t>(transLineLen);
+	Span<uint16_t>	rightTransLine = display->Scratch().Allocate<uint16_t>(transLineLen);
+	STACK_PROBE(DrawGauge);
+	if (pixelLine && leftTransLine && rightTransLine)
 	{
-		uint16_t*	leftPixelPtr = pixelLine;
-		uint16_t*	rightPixelPtr = pixellineEnd;
+		uint16_t*	pixellineEnd = &pixelLine[gaugeWidth];
 		
-		for (column = row-columnsToSkip; column; column--)
+		/*
+		*	Generate the left and right color gradients
+		*/
+		GenerateTransitionLine(eCenterColor, eStartColor, transLineLen, leftTransLine.Data());
+		GenerateTransitionLine(eCenterColor, eEndColor, transLineLen, rightTransLine.Data());
+
+		uint32_t	dispInset = columnsToSkip ? columnsToSkip-1 : 0;
+		uint32_t	row = mRadius;
+		uint32_t	column;
+		uint32_t	padLeft = 0;
+		uint32_t	padRight = 0;
+		uint32_t	firstRadiusSquared = mRadius*mRadius;
+		uint32_t	lastRadiusSquared = mRadius-mGaugeThickness;
+		lastRadiusSquared *= lastRadiusSquared;
+
+		for (uint32_t rowSquared = row*row; rowSquared > 1; row--, rowSquared = row*row)
 		{
-			uint32_t	rcSquared = (column*column) + rowSquared;
-			/*
-			*	If this pixel is within the radius + thickness THEN
-			*	load this pixel based on its position within arc.
-			*/
-			if (rcSquared <= firstRadiusSquared &&
-				rcSquared >= lastRadiusSquared)
+			uint16_t*	leftPixelPtr = pixelLine.Data();
+			uint16_t*	rightPixelPtr = pixellineEnd;
+			
+			for (column = row-columnsToSkip; column; column--)
 			{
-				uint32_t colorIndex = map(column, 0, row, 0, transLineLen);
-				*(leftPixelPtr++) = leftTransLine[colorIndex];
-				*(rightPixelPtr--) = rightTransLine[colorIndex];
-			/*
-			*	Else if this pixel is outside of the radius THEN
-			*	account for the empty space (which won't be drawn.)
-			*/
-			} else if (rcSquared > firstRadiusSquared)
-			{
-				padLeft++;
+				uint32_t	rcSquared = (column*column) + rowSquared;
+				/*
+				*	If this pixel is within the radius + thickness THEN
+				*	load this pixel based on its position within arc.
+				*/
+				if (rcSquared <= firstRadiusSquared &&
+					rcSquared >= lastRadiusSquared)
+				{
+					uint32_t colorIndex = map(column, 0, row, 0, transLineLen);
+					*(leftPixelPtr++) = leftTransLine[colorIndex];
+					*(rightPixelPtr--) = rightTransLine[colorIndex];
+				/*
+				*	Else if this pixel is outside of the radius THEN
+				*	account for the empty space (which won't be drawn.)
+				*/
+				} else if (rcSquared > firstRadiusSquared)
+				{
+					padLeft++;
+				/*
+				*	Else if just passed into empty arc interior THEN
+				*	pad till start of other interior side.
+				*/
+				} else if (rcSquared < lastRadiusSquared)
+				{
+					padRight++;
+					if (column != row)
+					{
+						padRight += (column*2);
+					}
+					column++;
+					break;
+				}
+			}
 			/*
-			*	Else if just passed into empty arc interior THEN
-			*	pad till start of other interior side.
+			*	Draw the left half of the arc row...
 			*/
-			} else if (rcSquared < lastRadiusSquared)
 			{
-				padRight++;
-				if (column != row)
+				if (column == 0)
 				{
-					padRight += (column*2);
+					*(leftPixelPtr++) = eCenterColor;
+				}
+				uint16_t	thisLineLen = leftPixelPtr-pixelLine.Data();
+				if (thisLineLen)
+				{
+					if (row + dispInset < mRadius)
+					{
+						padLeft += (mRadius - row - dispInset);
+					}
+					display->MoveTo(/*mTop + */mRadius - row, mLeft + padLeft);
+					display->SetColumnRange(thisLineLen);
+					display->CopyPixels(pixelLine.Data(), thisLineLen);
+					padRight += thisLineLen;
+				} else
+				{
+					break;
 				}
-				column++;
-				break;
-			}
-		}
-		/*
-		*	Draw the left half of the arc row...
-		*/
-		{
-			if (column == 0)
-			{
-				*(leftPixelPtr++) = eCenterColor;
 			}
-			uint16_t	thisLineLen = leftPixelPtr-pixelLine;
-			if (thisLineLen)
+			/*
+			*	Draw the right half of the arc row...
+			*/
 			{
-				if (row + dispInset < mRadius)
+				uint16_t	thisLineLen = pixellineEnd-rightPixelPtr;
+				if (thisLineLen)
 				{
-					padLeft += (mRadius - row - dispInset);
+					display->MoveBy(0, padRight);
+					display->SetColumnRange(thisLineLen);
+					display->CopyPixels(rightPixelPtr+1, thisLineLen);
 				}
-				display->MoveTo(/*mTop + */mRadius - row, mLeft + padLeft);
-				display->SetColumnRange(thisLineLen);
-				display->CopyPixels(pixelLine, thisLineLen);
-				padRight += thisLineLen;
-			} else
-			{
-				break;
 			}
-		}
-		/*
-		*	Draw the right half of the arc row...
-		*/
-		{
-			uint16_t	thisLineLen = pixellineEnd-rightPixelPtr;
-			if (thisLineLen)
+			padLeft = 0;
+			padRight = 0;
+			
+			if (columnsToSkip)
 			{
-				display->MoveBy(0, padRight);
-				display->SetColumnRange(thisLineLen);
-				display->CopyPixels(rightPixelPtr+1, thisLineLen);
+				columnsToSkip--;
 			}
 		}
-		padLeft = 0;
-		padRight = 0;
-		
-		if (columnsToSkip)
-		{
-			columnsToSkip--;
-		}
 	}
 }
 
@@ -47,6 +47,13 @@ public:
 								uint16_t				inGaugeThickness = 35,
 								uint16_t				inInfoFrameRadius = 105);
 	void					Update(void);
+							/*
+							*	ms until Update() can move the indicator again,
+							*	a full animation period if it already can.
+							*/
+	uint32_t				TimeToNextStep(void) const
+								{uint32_t remaining = mAnimationPeriod.Remaining();
+								 return(remaining ? remaining : mAnimationPeriod.Get());}
 	void					SetMinMax(
 								int32_t				inMin,
 								int32_t				inMax);
@@ -48,6 +48,7 @@ void ST77XXToXPT2046Alignment::Start(
 #ifndef __MACH__
 	mTouchScreen = inTouchScreen;
 	mTouchScreen->GetMinMax(mSavedMinMax);
+	mTouchScreen->GetSkew(mSavedXSkew, mSavedYSkew);
 	mTouchScreen->StartAlign();
 #endif
 	mStep = eStart;
@@ -65,6 +66,7 @@ void ST77XXToXPT2046Alignment::Start(
 		DisplayController*	display = xFont->GetDisplay();
 		mWidth = display->GetColumns();
 		mHeight = display->GetRows();
+		LayoutChanged();
 	}
 	Show();
 	mDebouncePeriod.Start();
@@ -79,7 +81,7 @@ void ST77XXToXPT2046Alignment::Stop(
 #ifndef __MACH__
 	if (inRestoreMinMax)
 	{
-		mTouchScreen->SetMinMax(mSavedMinMax);
+		mTouchScreen->SetMinMax(mSavedMinMax, mSavedXSkew, mSavedYSkew);
 	}
 #endif
 	Hide();
@@ -172,6 +174,10 @@ void ST77XXToXPT2046Alignment::DrawSelf(void)
 					newY = rows-kInset;
 					newX = kInset;
 					break;
+				case eStepMid:
+					newY = rows*3/4;
+					newX = columns/2;
+					break;
 			}
 			// Erase the location where the new circle and white dot will be drawn
 			display->FillRect(newX-10, newY-10, kInset, kInset, XFont::eBlack);
@@ -225,7 +231,7 @@ void ST77XXToXPT2046Alignment::MouseDown(
 		uint16_t	x,y,z;
 #ifndef __MACH__
 		// Update the alignment by adding the current point touched.
-		mTouchScreen->Align(kInset);
+		mTouchScreen->Align(mCurrentX, mCurrentY);
 		// Read the touch again to display the updated alignment...
 		mTouchScreen->Read(x, y, z);
 #else
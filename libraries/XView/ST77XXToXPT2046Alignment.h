@@ -47,6 +47,8 @@ public:
 								int16_t					inLocalX,
 								int16_t					inLocalY)
 								{return(mVisible);}
+	virtual bool			HitsOutsideBounds(void) const
+								{return(true);}
 	virtual void			MouseDown(
 								int16_t					inGlobalX,
 								int16_t					inGlobalY);
@@ -69,6 +71,8 @@ protected:
 	XView*				mSavedModalView;
 	MSPeriod			mDebouncePeriod;
 	uint16_t			mSavedMinMax[4];
+	int16_t				mSavedXSkew;
+	int16_t				mSavedYSkew;
 	const char*			mInstructions;
 	uint16_t			mStep;
 	uint16_t			mCurrentX;
@@ -87,6 +91,7 @@ protected:
 		eStepBR,
 		eStepTR,
 		eStepBL,
+		eStepMid,	// Off center so it isn't on the diagonals
 		eNumSteps
 	};
 };
@@ -48,6 +48,9 @@ public:
 							// Start/Stop.  Stop = 0
 	void					SetAnimationPeriod(
 								uint32_t				inPeriod);
+							// ms until the next frame, 0 if stopped.
+	uint32_t				TimeToNextFrame(void) const
+								{return(mAnimationPeriod.Get() ? mAnimationPeriod.Remaining() : 0);}
 								
 	virtual void			DrawSelf(void);
 	XFont*					MakeFontCurrent(void);
@@ -45,43 +45,34 @@ XColoredView::XColoredView(
 {
 }
 
-/************************************ Draw ************************************/
+/********************************* DrawInArea *********************************/
 /*
-*	inX and inY are local.
+*	The area passed to the subviews isn't made local to this view.
 */
-void XColoredView::Draw(
-	int16_t		inX,
-	int16_t		inY,
-	uint16_t	inWidth,
-	uint16_t	inHeight)
+bool XColoredView::DrawInArea(
+	int16_t&	ioX,
+	int16_t&	ioY,
+	uint16_t&	ioWidth,
+	uint16_t&	ioHeight)
 {
+	bool	drawSubViews = false;
 	/*
 	*	If this view is visible AND
 	*	the area to be drawn intersects this view's bounds...
 	*/
 	if (mVisible &&
-		mX + mWidth > inX &&
-		inX + inWidth > mX &&
-		mY + mHeight > inY &&
-		inY + inHeight > mY)
+		mX + mWidth > ioX &&
+		ioX + ioWidth > mX &&
+		mY + mHeight > ioY &&
+		ioY + ioHeight > mY)
 	{
 		DisplayController*	display = XRootView::GetInstance()->GetDisplay();
 		if (display)
 		{
-			display->FillRect(inX, inY, inWidth, inHeight, mColor);
+			display->FillRect(ioX, ioY, ioWidth, ioHeight, mColor);
 			DrawSelf();
-			if (mSubViews)
-			{
-				mSubViews->Draw(inX, inY, inWidth, inHeight);
-			}
+			drawSubViews = true;
 		}
 	}
-	if (mNextView)
-	{
-		mNextView->Draw(inX, inY, inWidth, inHeight);
-	}
-
-
+	return(drawSubViews);
 }
-
-
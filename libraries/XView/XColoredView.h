@@ -43,11 +43,11 @@ public:
 								bool					inVisible = true,
 								bool					inEnabled = true,
 								uint16_t				inColor =  0);
-	virtual void			Draw(
-								int16_t					inX,
-								int16_t					inY,
-								uint16_t				inWidth,
-								uint16_t				inHeight);
+	virtual bool			DrawInArea(
+								int16_t&				ioX,
+								int16_t&				ioY,
+								uint16_t&				ioWidth,
+								uint16_t&				ioHeight);
 protected:
 	uint16_t	mColor;
 };
@@ -159,6 +159,7 @@ XDateValueField::XDateValueField(
 		}
 		fieldX += spaceWidth; // gap
 		mWidth = fieldX;
+		LayoutChanged();
 	}
 }
 
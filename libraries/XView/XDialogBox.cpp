@@ -181,6 +181,7 @@ void XDialogBox::AutoSize(void)
 			*/
 			mX = (display->GetColumns() - mWidth)/2;
 			mY = (display->GetRows() - mHeight)/4;
+			LayoutChanged();
 		}
 	}
 }
@@ -252,42 +253,43 @@ void XDialogBox::DoCancel(void)
 	}
 }
 
-/************************************ Draw ************************************/
+/********************************* DrawInArea *********************************/
 /*
-*	For a dialog, inX and inY are global because they are placed within the
+*	For a dialog, ioX and ioY are global because they are placed within the
 *	root view.
 */
-void XDialogBox::Draw(
-	int16_t		inX,
-	int16_t		inY,
-	uint16_t	inWidth,
-	uint16_t	inHeight)
+bool XDialogBox::DrawInArea(
+	int16_t&	ioX,
+	int16_t&	ioY,
+	uint16_t&	ioWidth,
+	uint16_t&	ioHeight)
 {
 	/*
 	*	If this view is visible AND
 	*	the area to be drawn intersects this view's bounds...
 	*/
-	if (mVisible &&
-		mX + mWidth > inX &&
-		inX + inWidth > mX &&
-		mY + mHeight > inY &&
-		inY + inHeight > mY)
+	bool	drawSubViews = mVisible &&
+		mX + mWidth > ioX &&
+		ioX + ioWidth > mX &&
+		mY + mHeight > ioY &&
+		ioY + ioHeight > mY;
+	if (drawSubViews)
 	{
 		/*
 		*	If the edge of the dialog is clipped THEN
 		*	draw the entire background.
 		*/
-		if (inX < mX ||
-			inY < mY ||
-			inX+inWidth > mX+mWidth ||
-			inY+inHeight > mY+mHeight)
+		if (ioX < mX ||
+			ioY < mY ||
+			ioX+ioWidth > mX+mWidth ||
+			ioY+ioHeight > mY+mHeight)
 		{
 			DrawSelf();
 			// Because the entire background is being drawn, make sure
 			// all of the sub views are drawn, not just the views in the
 			// original area passed.
-			inX = inY = 0;
-			inWidth = inHeight = 0x7FF;
+			ioX = ioY = 0;
+			ioWidth = ioHeight = 0x7FF;
 		/*
 		*	Else, the area being redrawn doesn't intersect, and is completely
 		*	within the dialog frame.  Just fill the area to be redrawn with
@@ -298,18 +300,13 @@ void XDialogBox::Draw(
 			XFont*	xFont = mTitleLabel.MakeFontCurrent();
 			if (xFont)
 			{
-				xFont->GetDisplay()->FillRect(inX, inY, inWidth, inHeight, mFGColor);
+				xFont->GetDisplay()->FillRect(ioX, ioY, ioWidth, ioHeight, mFGColor);
 			}
 		}
-		if (mSubViews)
-		{
-			mSubViews->Draw(inX-mX, inY-mY, inWidth, inHeight);
-		}
-	}
-	if (mNextView)
-	{
-		mNextView->Draw(inX, inY, inWidth, inHeight);
+		ioX -= mX;
+		ioY -= mY;
 	}
+	return(drawSubViews);
 }
 
 /********************************** DrawSelf **********************************/
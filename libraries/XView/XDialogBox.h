@@ -52,11 +52,11 @@ public:
 								XViewChangedDelegate*	inViewChangedDelegate = nullptr,
 								uint16_t				inFGColor = XFont::eWhite,
 								uint16_t				inBGColor =  XFont::eBlack);
-	virtual void			Draw(
-								int16_t					inX,
-								int16_t					inY,
-								uint16_t				inWidth,
-								uint16_t				inHeight);
+	virtual bool			DrawInArea(
+								int16_t&				ioX,
+								int16_t&				ioY,
+								uint16_t&				ioWidth,
+								uint16_t&				ioHeight);
 	virtual void			DrawSelf(void);
 	virtual void			Show(void);
 	void					DoCancel(void);
@@ -65,6 +65,8 @@ public:
 	virtual bool			HitSelf(
 								int16_t					inLocalX,
 								int16_t					inLocalY);
+	virtual bool			HitsOutsideBounds(void) const
+								{return(true);}
 	void					SetViewChangedDelegate(
 								XViewChangedDelegate*	inViewChangedDelegate)
 								{mViewChangedDelegate = inViewChangedDelegate;}
@@ -62,22 +62,39 @@ void XLabel::DrawSelf(void)
 {
 	if (mString && mFont)
 	{
-		XFont*	xFont = MakeFontCurrent();
-		uint16_t	textColor = mEnabled ? mTextColor :
-						DisplayController::Calc565Color(mTextColor, 0, 184);
-		xFont->SetTextColor(textColor);
-		xFont->SetBGTextColor(mBGColor);
 		int16_t	x = 0;
 		int16_t	y = 0;
 		LocalToGlobal(x, y);
-		if (mTextAlignment != XFont::eAlignLeft ||
-			mEraseUnusedAreaAfterDraw)
-		{
-			xFont->DrawAligned(mString, x, y, mWidth, mTextAlignment, mEraseUnusedAreaAfterDraw);
-		} else
-		{
-			xFont->GetDisplay()->MoveTo(y, x);
-			xFont->DrawStr(mString);
-		}
+		DrawText(x, y, mWidth, mString, mFont, mTextColor, mBGColor,
+			mTextAlignment, mEraseUnusedAreaAfterDraw, mEnabled);
+	}
+}
+
+/********************************** DrawText **********************************/
+void XLabel::DrawText(
+	int16_t					inGlobalX,
+	int16_t					inGlobalY,
+	uint16_t				inWidth,
+	const char*				inString,
+	XFont::Font*			inFont,
+	uint16_t				inTextColor,
+	uint16_t				inBGColor,
+	XFont::ETextAlignment	inTextAlignment,
+	bool					inEraseUnusedArea,
+	bool					inEnabled)
+{
+	XFont*	xFont = inFont->MakeCurrent();
+	uint16_t	textColor = inEnabled ? inTextColor :
+					DisplayController::Calc565Color(inTextColor, 0, 184);
+	xFont->SetTextColor(textColor);
+	xFont->SetBGTextColor(inBGColor);
+	if (inTextAlignment != XFont::eAlignLeft ||
+		inEraseUnusedArea)
+	{
+		xFont->DrawAligned(inString, inGlobalX, inGlobalY, inWidth, inTextAlignment, inEraseUnusedArea);
+	} else
+	{
+		xFont->GetDisplay()->MoveTo(inGlobalY, inGlobalX);
+		xFont->DrawStr(inString);
 	}
 }
@@ -44,6 +44,22 @@ public:
 								XFont::ETextAlignment	inTextAlignment = XFont::eAlignLeft,
 								bool					inEnabled = true);
 	virtual void			DrawSelf(void);
+							/*
+							*	Draws inString at inGlobalX, inGlobalY the way
+							*	a label with these properties is drawn.  Also
+							*	used by XLabelTable.
+							*/
+	static void				DrawText(
+								int16_t					inGlobalX,
+								int16_t					inGlobalY,
+								uint16_t				inWidth,
+								const char*				inString,
+								XFont::Font*			inFont,
+								uint16_t				inTextColor,
+								uint16_t				inBGColor,
+								XFont::ETextAlignment	inTextAlignment,
+								bool					inEraseUnusedArea,
+								bool					inEnabled);
 	XFont*					MakeFontCurrent(void);
 	inline XFont::Font*		GetFont(void)
 								{return(mFont);}
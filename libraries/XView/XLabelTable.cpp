@@ -0,0 +1,198 @@
+/*
+*	XLabelTable.cpp, Copyright Jonathan Mackey 2026
+*	A view that draws a constant table of labels.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "XLabelTable.h"
+
+/******************************** XLabelTable *********************************/
+XLabelTable::XLabelTable(
+	const XLabelSpec*	inSpecs,
+	uint8_t				inCount,
+	XView*				inNextView,
+	uint16_t			inTag)
+	: XView(0, 0, 0, 0, inTag, inNextView),
+	  mSpecs(inSpecs), mHidden(0), mDisabled(0),
+	  mCount(inCount < eMaxLabels ? inCount : (uint8_t)eMaxLabels)
+{
+	for (uint8_t i = 0; i < mCount; i++)
+	{
+		const XLabelSpec&	spec = inSpecs[i];
+		if (spec.x + spec.width > mWidth)
+		{
+			mWidth = spec.x + spec.width;
+		}
+		if (spec.y + spec.height > mHeight)
+		{
+			mHeight = spec.y + spec.height;
+		}
+	}
+}
+
+/********************************* DrawInArea *********************************/
+/*
+*	Only the labels that intersect the area are drawn, as they would be if
+*	they were views.
+*/
+bool XLabelTable::DrawInArea(
+	int16_t&	ioX,
+	int16_t&	ioY,
+	uint16_t&	ioWidth,
+	uint16_t&	ioHeight)
+{
+	if (mVisible &&
+		mX + mWidth > ioX &&
+		ioX + ioWidth > mX &&
+		mY + mHeight > ioY &&
+		ioY + ioHeight > mY)
+	{
+		int16_t	globalX = 0;
+		int16_t	globalY = 0;
+		LocalToGlobal(globalX, globalY);
+		int16_t	x = ioX - mX;
+		int16_t	y = ioY - mY;
+		for (uint8_t i = 0; i < mCount; i++)
+		{
+			const XLabelSpec&	spec = mSpecs[i];
+			if (LabelIsVisible(i) &&
+				spec.x + spec.width > x &&
+				x + ioWidth > spec.x &&
+				spec.y + spec.height > y &&
+				y + ioHeight > spec.y)
+			{
+				DrawLabel(i, globalX, globalY);
+			}
+		}
+	}
+	return(false);
+}
+
+/********************************** DrawSelf **********************************/
+void XLabelTable::DrawSelf(void)
+{
+	if (mVisible)
+	{
+		int16_t	globalX = 0;
+		int16_t	globalY = 0;
+		LocalToGlobal(globalX, globalY);
+		for (uint8_t i = 0; i < mCount; i++)
+		{
+			if (LabelIsVisible(i))
+			{
+				DrawLabel(i, globalX, globalY);
+			}
+		}
+	}
+}
+
+/********************************* DrawLabel **********************************/
+/*
+*	inGlobalX and inGlobalY are the table's origin.
+*/
+void XLabelTable::DrawLabel(
+	uint8_t	inIndex,
+	int16_t	inGlobalX,
+	int16_t	inGlobalY)
+{
+	const XLabelSpec&	spec = mSpecs[inIndex];
+	if (spec.string && spec.font)
+	{
+		XLabel::DrawText(inGlobalX + spec.x, inGlobalY + spec.y, spec.width,
+			spec.string, spec.font, spec.textColor, spec.bgColor,
+			(XFont::ETextAlignment)spec.textAlignment, false,
+			mEnabled && LabelIsEnabled(inIndex));
+	}
+}
+
+/********************************** HitSelf ***********************************/
+/*
+*	Hit if a visible and enabled label is hit, as it would be if it were a
+*	view.
+*/
+bool XLabelTable::HitSelf(
+	int16_t	inLocalX,
+	int16_t	inLocalY)
+{
+	bool	hit = false;
+	for (uint8_t i = 0; i < mCount && !hit; i++)
+	{
+		const XLabelSpec&	spec = mSpecs[i];
+		hit = LabelIsVisible(i) &&
+			LabelIsEnabled(i) &&
+			inLocalX >= spec.x &&
+			inLocalY >= spec.y &&
+			inLocalX < spec.x + spec.width &&
+			inLocalY < spec.y + spec.height;
+	}
+	return(hit);
+}
+
+/********************************* IndexOfTag *********************************/
+int16_t XLabelTable::IndexOfTag(
+	uint16_t	inTag) const
+{
+	int16_t	index = -1;
+	for (uint8_t i = 0; i < mCount && index < 0; i++)
+	{
+		if (mSpecs[i].tag == inTag)
+		{
+			index = i;
+		}
+	}
+	return(index);
+}
+
+/******************************* SetLabelVisible ******************************/
+void XLabelTable::SetLabelVisible(
+	uint8_t	inIndex,
+	bool	inVisible)
+{
+	if (inVisible)
+	{
+		mHidden &= ~(1UL << inIndex);
+	} else
+	{
+		mHidden |= (1UL << inIndex);
+	}
+}
+
+/******************************** EnableLabel *********************************/
+void XLabelTable::EnableLabel(
+	uint8_t	inIndex,
+	bool	inEnabled,
+	bool	inUpdate)
+{
+	if (inEnabled)
+	{
+		mDisabled &= ~(1UL << inIndex);
+	} else
+	{
+		mDisabled |= (1UL << inIndex);
+	}
+	if (inUpdate &&
+		mVisible &&
+		LabelIsVisible(inIndex))
+	{
+		int16_t	globalX = 0;
+		int16_t	globalY = 0;
+		LocalToGlobal(globalX, globalY);
+		DrawLabel(inIndex, globalX, globalY);
+	}
+}
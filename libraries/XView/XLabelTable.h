@@ -0,0 +1,128 @@
+/*
+*	XLabelTable.h, Copyright Jonathan Mackey 2026
+*	A view that draws a constant table of labels.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef XLabelTable_h
+#define XLabelTable_h
+
+#include "XLabel.h"
+
+/*
+*	The properties of a label that never change.  The fields are in the order
+*	of the XLabel constructor parameters.  A table of these declared const
+*	(e.g. static const XLabelSpec kLabels[] = {...}) is initialized at compile
+*	time and placed in flash.
+*/
+struct XLabelSpec
+{
+	int16_t			x;	// Local to the XLabelTable's superview
+	int16_t			y;
+	uint16_t		width;
+	uint16_t		height;
+	uint16_t		tag;
+	const char*		string;
+	XFont::Font*	font;
+	uint16_t		textColor;
+	uint16_t		bgColor;
+	uint8_t			textAlignment;	// XFont::ETextAlignment
+};
+
+/*
+*	XLabelTable replaces a group of labels whose string, font, colors and
+*	position never change (a dialog's field labels.)  Each label costs an
+*	entry in the flash table and two bits of RAM, visible and enabled, rather
+*	than an XLabel object.  The labels are drawn, hit and dimmed exactly as
+*	XLabels with the same properties would be.  Their positions are local to
+*	the table's superview; the table's origin is 0,0 and its size is the
+*	extent of the labels, so XDialogBox::AutoSize sees the same layout.
+*
+*	The labels aren't views, ViewWithTag doesn't find them.  Use IndexOfTag.
+*/
+class XLabelTable : public XView
+{
+public:
+	template <uint8_t N>
+							XLabelTable(
+								const XLabelSpec		(&inSpecs)[N],
+								XView*					inNextView = nullptr,
+								uint16_t				inTag = 0)
+								: XLabelTable(inSpecs, N, inNextView, inTag)
+							{
+								static_assert(N <= eMaxLabels, "Too many labels");
+							}
+							/*
+							*	The hidden and disabled masks hold
+							*	eMaxLabels bits.  Labels past eMaxLabels
+							*	are ignored.
+							*/
+							XLabelTable(
+								const XLabelSpec*		inSpecs,
+								uint8_t					inCount,
+								XView*					inNextView = nullptr,
+								uint16_t				inTag = 0);
+	virtual bool			DrawInArea(
+								int16_t&				ioX,
+								int16_t&				ioY,
+								uint16_t&				ioWidth,
+								uint16_t&				ioHeight);
+	virtual void			DrawSelf(void);
+	virtual bool			HitSelf(
+								int16_t					inLocalX,
+								int16_t					inLocalY);
+	inline uint8_t			Count(void) const
+								{return(mCount);}
+	inline const XLabelSpec& Spec(
+								uint8_t					inIndex) const
+								{return(mSpecs[inIndex]);}
+							// The index of the label with inTag, or -1
+	int16_t					IndexOfTag(
+								uint16_t				inTag) const;
+	bool					LabelIsVisible(
+								uint8_t					inIndex) const
+								{return((mHidden & (1UL << inIndex)) == 0);}
+							// Without redrawing, as XView::SetVisible
+	void					SetLabelVisible(
+								uint8_t					inIndex,
+								bool					inVisible);
+	bool					LabelIsEnabled(
+								uint8_t					inIndex) const
+								{return((mDisabled & (1UL << inIndex)) == 0);}
+	void					EnableLabel(
+								uint8_t					inIndex,
+								bool					inEnabled = true,
+								bool					inUpdate = true);
+	enum
+	{
+		eMaxLabels	= 32
+	};
+protected:
+	const XLabelSpec*	mSpecs;
+	uint32_t			mHidden;	// One bit per label
+	uint32_t			mDisabled;
+	uint8_t				mCount;
+
+	void					DrawLabel(
+								uint8_t					inIndex,
+								int16_t					inGlobalX,
+								int16_t					inGlobalY);
+};
+
+#endif // XLabelTable_h
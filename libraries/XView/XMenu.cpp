@@ -176,6 +176,7 @@ void XMenu::Show(void)
 		mY = globalY;
 		mWidth = viewWidth;
 		mHeight = viewHeight;
+		LayoutChanged();
 	}
 	/*
 	*	Draw the menu
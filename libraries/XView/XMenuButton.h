@@ -54,6 +54,8 @@ public:
 	virtual bool			HitSelf(
 								int16_t					inLocalX,
 								int16_t					inLocalY);
+	virtual bool			HitsOutsideBounds(void) const
+								{return(true);}
 protected:
 	XMenu*		mMenu;
 	XView*		mSavedModalView;
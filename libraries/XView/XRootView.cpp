@@ -64,6 +64,9 @@ XView* XRootView::HitTest(
 	XView* hitView = mModalView;
 	if (hitView == nullptr)
 	{
+	#if XVIEW_HIT_INDEX
+		if (!Index().HitTest(inX, inY, hitView))
+	#endif
 		hitView = XView::HitTest(inX, inY);
 	} else
 	{
@@ -72,4 +75,37 @@ XView* XRootView::HitTest(
 	return(hitView);
 }
 
+#if XVIEW_HIT_INDEX
+/******************************** ViewWithTag *********************************/
+XView* XRootView::ViewWithTag(
+	uint16_t	inTag)
+{
+	XView*	viewWithTag;
+	if (!Index().ViewWithTag(inTag, viewWithTag))
+	{
+		viewWithTag = XView::ViewWithTag(inTag);
+	}
+	return(viewWithTag);
+}
 
+/*********************************** Index ************************************/
+/*
+*	Rebuilds the index when the layout has changed.  An index that doesn't
+*	fit (or no display) isn't valid, the callers then fall back to the
+*	XView traversal.
+*/
+const XViewIndex& XRootView::Index(void)
+{
+	if (!mIndex.IsCurrent())
+	{
+		if (mDisplay)
+		{
+			mIndex.Build(this, mDisplay->GetColumns(), mDisplay->GetRows());
+		} else
+		{
+			mIndex.Invalidate();
+		}
+	}
+	return(mIndex);
+}
+#endif
@@ -26,6 +26,17 @@
 
 #include "XView.h"
 
+/*
+*	When XVIEW_HIT_INDEX is 1 the root view keeps an XViewIndex for HitTest
+*	and ViewWithTag (about 3KB of RAM with the default XViewIndex sizes.)
+*/
+#ifndef XVIEW_HIT_INDEX
+#define XVIEW_HIT_INDEX	0
+#endif
+#if XVIEW_HIT_INDEX
+#include "XViewIndex.h"
+#endif
+
 class DisplayController;
 
 class XRootView : public XView
@@ -41,9 +52,15 @@ public:
 								int16_t					inLocalX,
 								int16_t					inLocalY)
 								{return(true);}
+	virtual bool			HitsOutsideBounds(void) const
+								{return(true);}
 	virtual XView*			HitTest(
 								int16_t					inX,
 								int16_t					inY);
+#if XVIEW_HIT_INDEX
+	virtual XView*			ViewWithTag(
+								uint16_t				inTag);
+#endif
 	void					SetDisplay(
 								DisplayController*		inDisplay)
 								{mDisplay = inDisplay;}
@@ -70,8 +87,15 @@ protected:
 	DisplayController*		mDisplay;
 	XViewChangedDelegate*	mViewChangedDelegate;
 	XView*					mModalView;
+#if XVIEW_HIT_INDEX
+	XViewIndex				mIndex;
+#endif
 	static XRootView*		sInstance;
 
+#if XVIEW_HIT_INDEX
+	const XViewIndex&		Index(void);
+#endif
+
 	virtual	void			HandleChange(
 							XView*						inView,
 							uint16_t					inAction = 0);
@@ -213,6 +213,8 @@ void XStepper::MouseDown(
 		{
 			newState = eOff;
 		}
+		mRepeatPeriod.Set(eRepeatDelay);
+		mRepeatPeriod.Start();
 		if (state != mState)
 		{
 			XControl::SetState(newState, false);
@@ -242,3 +244,26 @@ void XStepper::MouseUp(
 	}
 }
 
+/******************************** MouseDragged ********************************/
+void XStepper::MouseDragged(
+	int16_t	inGlobalX,
+	int16_t	inGlobalY)
+{
+	if (mValueField &&
+		mRepeatPeriod.Passed())
+	{
+		XStepperPart partHit = GetPartHit(inGlobalX, inGlobalY);
+		if (partHit == eUpButtonPart &&
+			mState == eOn)
+		{
+			mValueField->IncrementValue();
+		} else if (partHit == eDownButtonPart &&
+			mState == eDownOn)
+		{
+			mValueField->DecrementValue();
+		}
+		mRepeatPeriod.Set(eRepeatRate);
+		mRepeatPeriod.Start();
+	}
+}
+
@@ -24,6 +24,7 @@
 #define XStepper_h
 
 #include "XControl.h"
+#include "MSPeriod.h"
 class XValueField;
 
 class XStepper : public XControl
@@ -43,9 +44,22 @@ public:
 	virtual void			MouseUp(
 								int16_t					inGlobalX,
 								int16_t					inGlobalY);
+							/*
+							*	Auto-repeats while the pen is held on the part
+							*	pressed.
+							*/
+	virtual void			MouseDragged(
+								int16_t					inGlobalX,
+								int16_t					inGlobalY);
 protected:
 	XValueField*		mValueField;
 	uint16_t			mRadius;
+	MSPeriod			mRepeatPeriod;
+	enum
+	{
+		eRepeatDelay	= 500,	// ms
+		eRepeatRate		= 100
+	};
 	
 	enum XStepperPart
 	{
@@ -76,6 +76,7 @@ XFont* XValueField::SetXStepper(
 		// Note that the width needs to be set before calling SetXStepper().
 		mX = inXStepper->X() - (stepperHeight/5) - mWidth;
 		mY = inXStepper->Y() + (stepperHeight - (int16_t)(xFont->GetFontHeader().ascent))/2;
+		LayoutChanged();
 		UpdateStringForValue();
 	}
 	return(xFont);
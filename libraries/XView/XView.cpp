@@ -27,6 +27,10 @@
 #include <iostream>
 #endif
 
+uint32_t	XView::sLayoutSerial;
+uint8_t		XView::sMaxDrawDepth;
+uint16_t	XView::sDepthOverflows;
+
 /*********************************** XView ************************************/
 XView::XView(
 	int16_t			inX,
@@ -41,7 +45,7 @@ XView::XView(
 	bool			inEnabled)
 	: mX(inX), mY(inY), mTag(inTag),
 	  mWidth(inWidth), mHeight(inHeight),
-	  mNextView(inNextView), mSuperView(inSuperView),
+	  mNextView(inNextView), mSuperView(inSuperView), mSubViews(nullptr),
 	  mVisible(inVisible), mEnabled(inEnabled)
 {
 	SetSubViews(inSubViews);
@@ -50,33 +54,94 @@ XView::XView(
 /************************************ Draw ************************************/
 /*
 *	inX and inY are local.
+*
+*	A depth first walk using an explicit stack of the view to continue with
+*	and its area, one entry per level of nesting.  The recursive version
+*	recursed for each view that followed, so the stack used grew with the
+*	number of views as well as the nesting.
 */
 void XView::Draw(
 	int16_t		inX,
 	int16_t		inY,
 	uint16_t	inWidth,
 	uint16_t	inHeight)
+{
+	struct SFrame
+	{
+		XView*		nextView;
+		int16_t		x;
+		int16_t		y;
+		uint16_t	width;
+		uint16_t	height;
+	} stack[eMaxDepth];
+	uint8_t	depth = 0;
+	XView*	view = this;
+	while (view)
+	{
+		int16_t		x = inX;
+		int16_t		y = inY;
+		uint16_t	width = inWidth;
+		uint16_t	height = inHeight;
+		if (view->DrawInArea(x, y, width, height) &&
+			view->mSubViews)
+		{
+			if (depth < eMaxDepth)
+			{
+				SFrame&	frame = stack[depth++];
+				frame.nextView = view->mNextView;
+				frame.x = inX;
+				frame.y = inY;
+				frame.width = inWidth;
+				frame.height = inHeight;
+				if (depth > sMaxDrawDepth)
+				{
+					sMaxDrawDepth = depth;
+				}
+				inX = x;
+				inY = y;
+				inWidth = width;
+				inHeight = height;
+				view = view->mSubViews;
+				continue;
+			}
+			sDepthOverflows++;
+		}
+		view = view->mNextView;
+		while (!view && depth)
+		{
+			SFrame&	frame = stack[--depth];
+			view = frame.nextView;
+			inX = frame.x;
+			inY = frame.y;
+			inWidth = frame.width;
+			inHeight = frame.height;
+		}
+	}
+}
+
+/********************************* DrawInArea *********************************/
+bool XView::DrawInArea(
+	int16_t&	ioX,
+	int16_t&	ioY,
+	uint16_t&	ioWidth,
+	uint16_t&	ioHeight)
 {
 	/*
 	*	If this view is visible AND
 	*	the area to be drawn intersects this view's bounds...
 	*/
-	if (mVisible &&
-		mX + mWidth > inX &&
-		inX + inWidth > mX &&
-		mY + mHeight > inY &&
-		inY + inHeight > mY)
+	bool	drawSubViews = mVisible &&
+		mX + mWidth > ioX &&
+		ioX + ioWidth > mX &&
+		mY + mHeight > ioY &&
+		ioY + ioHeight > mY;
+	if (drawSubViews)
 	{
 		DrawSelf();
-		if (mSubViews)
-		{
-			mSubViews->Draw(inX-mX, inY-mY, inWidth, inHeight);
-		}
-	}
-	if (mNextView)
-	{
-		mNextView->Draw(inX, inY, inWidth, inHeight);
+		ioX -= mX;
+		ioY -= mY;
 	}
+	return(drawSubViews);
 }
 
 /******************************** SetSubViews *********************************/
@@ -92,6 +157,7 @@ void XView::SetSubViews(
 		mSubViews->SetSuperView();
 	}
 	mSubViews = inSubView;
+	LayoutChanged();
 	/*
 	*	If there are subviews THEN
 	*	attach them to this superview.
@@ -106,10 +172,9 @@ void XView::SetSubViews(
 void XView::SetSuperView(
 	XView*	inSuperView)
 {
-	mSuperView = inSuperView;
-	if (mNextView)
+	for (XView* view = this; view; view = view->mNextView)
 	{
-		mNextView->SetSuperView(inSuperView);
+		view->mSuperView = inSuperView;
 	}
 }
 
@@ -122,6 +187,7 @@ void XView::SetNextView(
 		inNextView->mNextView = mNextView;
 		mNextView = inNextView;
 		inNextView->SetSuperView(mSuperView);
+		LayoutChanged();
 	}
 }
 
@@ -275,29 +341,33 @@ bool XView::HitSelf(
 /********************************** HitTest ***********************************/
 /*
 *	inX and inY are local to the superview.
+*
+*	The first view in the chain hit, then the first of its subviews hit, and
+*	so on.  The deepest view hit is returned.  This is a loop, no stack is
+*	needed because a view that's hit never returns to the views that follow
+*	it.  Only the view HitTest is called on can override HitTest.
 */
 XView* XView::HitTest(
 	int16_t	inX,
 	int16_t	inY)
 {
-	int16_t	localX = inX - mX;
-	int16_t	localY = inY - mY;
-	XView* hitView = nullptr;
-	if (WantsClicks() &&
-		HitSelf(localX, localY))
+	XView*	hitView = nullptr;
+	XView*	view = this;
+	while (view)
 	{
-		hitView = this;
-		if (mSubViews)
+		int16_t	localX = inX - view->mX;
+		int16_t	localY = inY - view->mY;
+		if (view->WantsClicks() &&
+			view->HitSelf(localX, localY))
 		{
-			XView* subHitView = mSubViews->HitTest(localX, localY);
-			if (subHitView)
-			{
-				hitView = subHitView;
-			}
+			hitView = view;
+			inX = localX;
+			inY = localY;
+			view = view->mSubViews;
+		} else
+		{
+			view = view->mNextView;
 		}
-	} else if (mNextView)
-	{
-		hitView = mNextView->HitTest(inX, inY);
 	}
 	return(hitView);
 }
@@ -34,6 +34,15 @@
 
 #include <inttypes.h>
 
+/*
+*	The deepest nesting of subviews that Draw will draw.  Subviews nested
+*	deeper aren't drawn and are counted by DepthOverflows().  Each level
+*	costs 12 bytes of stack within Draw.
+*/
+#ifndef XVIEW_MAX_DEPTH
+#define XVIEW_MAX_DEPTH	8
+#endif
+
 class XView
 {
 public:
@@ -48,11 +57,30 @@ public:
 								XView*					inSuperView = nullptr,
 								bool					inVisible = true,
 								bool					inEnabled = true);
-	virtual void			Draw(
+							/*
+							*	Draws this view, the views that follow it and
+							*	their subviews that intersect the area.  The
+							*	traversal isn't recursive, the stack used
+							*	doesn't depend on the number of views.
+							*	Override DrawInArea, not Draw.
+							*/
+	void					Draw(
 								int16_t					inX,
 								int16_t					inY,
 								uint16_t				inWidth,
 								uint16_t				inHeight);
+							/*
+							*	Called by Draw for each view.  Draws the view if
+							*	it's visible and intersects the area to be drawn
+							*	(local to the superview.)  Returns true if its
+							*	subviews are to be drawn, with the area changed
+							*	to be local to this view.
+							*/
+	virtual bool			DrawInArea(
+								int16_t&				ioX,
+								int16_t&				ioY,
+								uint16_t&				ioWidth,
+								uint16_t&				ioHeight);
 	virtual void			DrawSelf(void){}
 	virtual bool			WantsClicks(void) const
 								{return(mVisible && mEnabled);}
@@ -62,12 +90,27 @@ public:
 	virtual void			MouseUp(
 								int16_t					inGlobalX,
 								int16_t					inGlobalY){}
+							/*
+							*	Called between MouseDown and MouseUp for each
+							*	touch sample, whether or not the pen moved.
+							*/
+	virtual void			MouseDragged(
+								int16_t					inGlobalX,
+								int16_t					inGlobalY){}
 	virtual XView*			HitTest(
 								int16_t					inX,
 								int16_t					inY);
 	virtual bool			HitSelf(
 								int16_t					inLocalX,
 								int16_t					inLocalY);
+							/*
+							*	Return true if HitSelf can return true for a
+							*	point outside of the view's bounds (e.g. a
+							*	modal view that takes all hits.)  Used by
+							*	XViewIndex.
+							*/
+	virtual bool			HitsOutsideBounds(void) const
+								{return(false);}
 	virtual XView*			ViewWithTag(
 								uint16_t				inTag);
 	virtual void			Hide(void);
@@ -105,19 +148,19 @@ public:
 	void					SetOrigin(
 								int16_t					inX,
 								int16_t					inY)
-								{mX = inX; mY = inY;}
+								{mX = inX; mY = inY; LayoutChanged();}
 	void					MoveBy(
 								int16_t					inX,
 								int16_t					inY)
-								{mX += inX; mY += inY;}
+								{mX += inX; mY += inY; LayoutChanged();}
 	virtual void			SetSize(
 								uint16_t				inWidth,
 								uint16_t				inHeight)
-								{mWidth = inWidth; mHeight = inHeight;}
+								{mWidth = inWidth; mHeight = inHeight; LayoutChanged();}
 	virtual void			AdjustSize(
 								int16_t					inWidthAdj,
 								int16_t					inHeightAdj)
-								{mWidth += inWidthAdj; mHeight += inHeightAdj;}
+								{mWidth += inWidthAdj; mHeight += inHeightAdj; LayoutChanged();}
 	inline int16_t			X(void) const
 								{return(mX);}
 	inline int16_t			Y(void) const
@@ -126,12 +169,12 @@ public:
 								{return(mWidth);}
 	virtual void			SetWidth(
 								uint16_t				inWidth)
-								{mWidth = inWidth;}
+								{mWidth = inWidth; LayoutChanged();}
 	inline uint16_t			Height(void) const
 								{return(mHeight);}
 	virtual void			SetHeight(
 								uint16_t				inHeight)
-								{mHeight = inHeight;}
+								{mHeight = inHeight; LayoutChanged();}
 	void					LocalToGlobal(
 								int16_t&				ioX,
 								int16_t&				ioY) const;
@@ -143,6 +186,27 @@ public:
 	virtual void			Enable(
 								bool					inEnabled=true,
 								bool					inUpdate=true);
+							/*
+							*	Any change to the position, size or order of a
+							*	view calls LayoutChanged.  Subclasses that set
+							*	mX, mY, mWidth or mHeight directly need to call
+							*	it too.  Anything derived from the layout (e.g.
+							*	XViewIndex) is rebuilt when LayoutSerial changes.
+							*/
+	static inline void		LayoutChanged(void)
+								{sLayoutSerial++;}
+	static inline uint32_t	LayoutSerial(void)
+								{return(sLayoutSerial);}
+							// The deepest nesting drawn, of XVIEW_MAX_DEPTH
+	static inline uint8_t	MaxDrawDepth(void)
+								{return(sMaxDrawDepth);}
+							// Subviews not drawn because of XVIEW_MAX_DEPTH
+	static inline uint16_t	DepthOverflows(void)
+								{return(sDepthOverflows);}
+	enum
+	{
+		eMaxDepth	= XVIEW_MAX_DEPTH
+	};
 protected:
 	bool			mEnabled;
 	bool			mVisible;
@@ -155,6 +219,9 @@ protected:
 	// mNextView and mSubViews are null terminated chains
 	XView*			mNextView;	// At same level as this view
 	XView*			mSubViews;	// First subview in chain of within this view
+	static uint32_t	sLayoutSerial;
+	static uint8_t	sMaxDrawDepth;
+	static uint16_t	sDepthOverflows;
 	
 	/*
 	*	The change walks up the superview hierarchy until a superview override
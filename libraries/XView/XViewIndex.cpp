@@ -0,0 +1,334 @@
+/*
+*	XViewIndex.cpp, Copyright Jonathan Mackey 2026
+*	Flattened spatial index of a view hierarchy for hit testing.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "XViewIndex.h"
+#include <string.h>
+
+#if XVIEW_INDEX_SIZE >= 0xFFFF || XVIEW_INDEX_POOL >= 0xFFFF
+#error "XVIEW_INDEX_SIZE and XVIEW_INDEX_POOL must be less than 0xFFFF"
+#endif
+// BuildTags uses mPool as its stack.
+static_assert(XVIEW_INDEX_POOL >= XVIEW_INDEX_SIZE, "XVIEW_INDEX_POOL < XVIEW_INDEX_SIZE");
+
+/********************************* XViewIndex *********************************/
+XViewIndex::XViewIndex(void)
+	: mCount(0), mEverywhereCount(0), mPoolUsed(0), mCellWidth(1),
+	  mCellHeight(1), mLayoutSerial(0), mBuilt(false), mValid(false)
+{
+}
+
+/*********************************** Build ************************************/
+/*
+*	Flattens the hierarchy without recursion.  The root's next view (if any)
+*	isn't part of the hierarchy.
+*/
+bool XViewIndex::Build(
+	XView*		inRootView,
+	uint16_t	inColumns,
+	uint16_t	inRows)
+{
+	mBuilt = true;
+	mLayoutSerial = XView::LayoutSerial();
+	mCount = 0;
+	mEverywhereCount = 0;
+	mPoolUsed = 0;
+	mCellWidth = (inColumns + eGridColumns - 1)/eGridColumns;
+	mCellHeight = (inRows + eGridRows - 1)/eGridRows;
+	bool	success = mCellWidth && mCellHeight && Add(inRootView, eNoParent);
+	uint16_t	parent = 0;
+	XView*		view = inRootView->SubViews();
+	while (success &&
+		parent != eNoParent)
+	{
+		if (view)
+		{
+			uint16_t	index = mCount;
+			success = Add(view, parent);
+			if (view->SubViews())
+			{
+				parent = index;
+				view = view->SubViews();
+			} else
+			{
+				mEntries[index].end = mCount;
+				view = view->NextView();
+			}
+		} else
+		{
+			// The last subview of parent has been added.
+			mEntries[parent].end = mCount;
+			view = parent ? mEntries[parent].view->NextView() : nullptr;
+			parent = mEntries[parent].parent;
+		}
+	}
+	if (success)
+	{
+		BuildTags();
+		success = BuildGrid();
+	}
+	mValid = success;
+	return(success);
+}
+
+/************************************ Add *************************************/
+bool XViewIndex::Add(
+	XView*		inView,
+	uint16_t	inParent)
+{
+	bool	success = mCount < eMaxViews;
+	if (success)
+	{
+		SEntry&	entry = mEntries[mCount];
+		entry.view = inView;
+		entry.x = inView->X();
+		entry.y = inView->Y();
+		if (inParent != eNoParent)
+		{
+			entry.x += mEntries[inParent].x;
+			entry.y += mEntries[inParent].y;
+		}
+		entry.parent = inParent;
+		entry.end = mCount + 1;
+		mCount++;
+	}
+	return(success);
+}
+
+/********************************* CellRange **********************************/
+/*
+*	Returns false if the entry's bounds don't overlap the grid.
+*/
+bool XViewIndex::CellRange(
+	const SEntry&	inEntry,
+	uint16_t&		outFirstColumn,
+	uint16_t&		outLastColumn,
+	uint16_t&		outFirstRow,
+	uint16_t&		outLastRow) const
+{
+	int32_t	left = inEntry.x;
+	int32_t	top = inEntry.y;
+	int32_t	right = left + inEntry.view->Width();	// Exclusive
+	int32_t	bottom = top + inEntry.view->Height();
+	int32_t	gridWidth = (int32_t)mCellWidth * eGridColumns;
+	int32_t	gridHeight = (int32_t)mCellHeight * eGridRows;
+	bool	success = left < right && top < bottom &&
+						right > 0 && bottom > 0 &&
+						left < gridWidth && top < gridHeight;
+	if (success)
+	{
+		outFirstColumn = (left > 0 ? left : 0) / mCellWidth;
+		outLastColumn = ((right < gridWidth ? right : gridWidth) - 1) / mCellWidth;
+		outFirstRow = (top > 0 ? top : 0) / mCellHeight;
+		outLastRow = ((bottom < gridHeight ? bottom : gridHeight) - 1) / mCellHeight;
+	}
+	return(success);
+}
+
+/********************************* BuildGrid **********************************/
+/*
+*	A counting sort of the entries into the cells.  The entries are placed
+*	last to first so that each list ends up in drawing order.
+*/
+bool XViewIndex::BuildGrid(void)
+{
+	uint16_t	firstColumn, lastColumn, firstRow, lastRow;
+	uint32_t	total = 0;
+	memset(mCellStart, 0, sizeof(mCellStart));
+	for (uint16_t i = 0; i < mCount; i++)
+	{
+		if (mEntries[i].view->HitsOutsideBounds())
+		{
+			mEverywhereCount++;
+		} else if (CellRange(mEntries[i], firstColumn, lastColumn, firstRow, lastRow))
+		{
+			if (firstColumn == 0 && lastColumn == eGridColumns-1 &&
+				firstRow == 0 && lastRow == eGridRows-1)
+			{
+				mEverywhereCount++;
+			} else
+			{
+				for (uint16_t row = firstRow; row <= lastRow; row++)
+				{
+					for (uint16_t column = firstColumn; column <= lastColumn; column++)
+					{
+						mCellStart[row*eGridColumns + column]++;
+					}
+				}
+			}
+		}
+	}
+	total = mEverywhereCount;
+	for (uint16_t cell = 0; cell < eNumCells; cell++)
+	{
+		total += mCellStart[cell];
+		mCellStart[cell] = total < ePoolSize ? total : ePoolSize;	// End of cell
+	}
+	mCellStart[eNumCells] = mCellStart[eNumCells-1];
+	bool	success = total <= ePoolSize;
+	if (success)
+	{
+		mPoolUsed = total;
+		uint16_t	everywhere = mEverywhereCount;
+		for (uint16_t i = mCount; i-- > 0;)
+		{
+			if (mEntries[i].view->HitsOutsideBounds())
+			{
+				mPool[--everywhere] = i;
+			} else if (CellRange(mEntries[i], firstColumn, lastColumn, firstRow, lastRow))
+			{
+				if (firstColumn == 0 && lastColumn == eGridColumns-1 &&
+					firstRow == 0 && lastRow == eGridRows-1)
+				{
+					mPool[--everywhere] = i;
+				} else
+				{
+					for (uint16_t row = firstRow; row <= lastRow; row++)
+					{
+						for (uint16_t column = firstColumn; column <= lastColumn; column++)
+						{
+							mPool[--mCellStart[row*eGridColumns + column]] = i;
+						}
+					}
+				}
+			}
+		}
+	}
+	return(success);
+}
+
+/********************************* BuildTags **********************************/
+/*
+*	XView::ViewWithTag checks a view, then the views that follow it, then its
+*	subviews.  So the search order of a chain is all of the views in the
+*	chain, then the subviews of the last view in the chain, ..., then the
+*	subviews of the first.  mPool is used as a stack of chains to search.
+*	The tags are then sorted by tag keeping the search order (insertion sort,
+*	this is only done when the layout changes.)
+*/
+void XViewIndex::BuildTags(void)
+{
+	uint16_t*	stack = mPool;
+	uint16_t	stackSize = 0;
+	uint16_t	tagCount = 0;
+	stack[stackSize++] = 0;
+	while (stackSize)
+	{
+		uint16_t	first = stack[--stackSize];
+		uint16_t	parent = mEntries[first].parent;
+		uint16_t	chainEnd = parent == eNoParent ? mCount : mEntries[parent].end;
+		for (uint16_t i = first; i < chainEnd; i = mEntries[i].end)
+		{
+			mTags[tagCount].tag = mEntries[i].view->Tag();
+			mTags[tagCount].index = i;
+			tagCount++;
+		}
+		for (uint16_t i = first; i < chainEnd; i = mEntries[i].end)
+		{
+			if (mEntries[i].end > i + 1)
+			{
+				stack[stackSize++] = i + 1;
+			}
+		}
+	}
+	for (uint16_t i = 1; i < tagCount; i++)
+	{
+		STag		tag = mTags[i];
+		uint16_t	j = i;
+		for (; j > 0 && mTags[j-1].tag > tag.tag; j--)
+		{
+			mTags[j] = mTags[j-1];
+		}
+		mTags[j] = tag;
+	}
+}
+
+/********************************** HitTest ***********************************/
+/*
+*	The lists of the cell touched and of the views in every cell are merged
+*	in drawing order.  As with XView::HitTest, a view is only tested if its
+*	superview was hit, and once a view is hit only its subviews are tested.
+*	A view not listed can't be hit, so skipping it is the same as testing it.
+*/
+bool XViewIndex::HitTest(
+	int16_t		inX,
+	int16_t		inY,
+	XView*&		outHitView) const
+{
+	bool	success = mValid &&
+				inX >= 0 && inX < mCellWidth * eGridColumns &&
+				inY >= 0 && inY < mCellHeight * eGridRows;
+	if (success)
+	{
+		uint16_t	cell = (inY / mCellHeight) * eGridColumns + inX / mCellWidth;
+		const uint16_t*	everywhere = mPool;
+		const uint16_t*	everywhereEnd = &mPool[mEverywhereCount];
+		const uint16_t*	inCell = &mPool[mCellStart[cell]];
+		const uint16_t*	inCellEnd = &mPool[mCellStart[cell+1]];
+		uint16_t	hitIndex = eNoParent;
+		uint16_t	end = mCount;
+		while (everywhere < everywhereEnd || inCell < inCellEnd)
+		{
+			uint16_t	index = (inCell == inCellEnd ||
+							(everywhere < everywhereEnd && *everywhere < *inCell)) ?
+								*(everywhere++) : *(inCell++);
+			if (index >= end)
+			{
+				break;
+			}
+			if (mEntries[index].parent == hitIndex &&
+				Hits(index, inX, inY))
+			{
+				hitIndex = index;
+				end = mEntries[index].end;
+			}
+		}
+		outHitView = hitIndex != eNoParent ? mEntries[hitIndex].view : nullptr;
+	}
+	return(success);
+}
+
+/******************************** ViewWithTag *********************************/
+bool XViewIndex::ViewWithTag(
+	uint16_t	inTag,
+	XView*&		outView) const
+{
+	if (mValid)
+	{
+		// Binary search for the first entry with inTag
+		uint16_t	low = 0;
+		uint16_t	high = mCount;
+		while (low < high)
+		{
+			uint16_t	mid = (low + high)/2;
+			if (mTags[mid].tag < inTag)
+			{
+				low = mid + 1;
+			} else
+			{
+				high = mid;
+			}
+		}
+		outView = low < mCount && mTags[low].tag == inTag ?
+					mEntries[mTags[low].index].view : nullptr;
+	}
+	return(mValid);
+}
@@ -0,0 +1,174 @@
+/*
+*	XViewIndex.h, Copyright Jonathan Mackey 2026
+*	Flattened spatial index of a view hierarchy for hit testing.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef XViewIndex_h
+#define XViewIndex_h
+
+#include "XView.h"
+
+/*
+*	The maximum number of views indexed, including the root view.  When a
+*	hierarchy has more views the index isn't used.
+*/
+#ifndef XVIEW_INDEX_SIZE
+#define XVIEW_INDEX_SIZE	128
+#endif
+
+/*
+*	The total number of view entries in all of the grid cells.  A view is
+*	entered in each cell it overlaps, views that cover every cell are only
+*	entered once.
+*/
+#ifndef XVIEW_INDEX_POOL
+#define XVIEW_INDEX_POOL	512
+#endif
+
+/*
+*	The grid dimensions, in cells.  15 x 10 gives 32 pixel cells on a
+*	480 x 320 display.
+*/
+#ifndef XVIEW_GRID_COLUMNS
+#define XVIEW_GRID_COLUMNS	15
+#endif
+#ifndef XVIEW_GRID_ROWS
+#define XVIEW_GRID_ROWS		10
+#endif
+
+/*
+*	The views are stored in drawing (pre-)order along with their global
+*	origin, the index of their superview, and the index following their last
+*	subview.  A uniform grid over the display lists the views that overlap
+*	each cell.  A hit test only visits the views listed for the cell
+*	touched, in the same order, with the same WantsClicks and HitSelf calls
+*	as XView::HitTest, so the result is the same view.
+*
+*	Visibility and enabled state aren't part of the index, WantsClicks is
+*	called when hit testing, so only layout changes (XView::LayoutChanged)
+*	require the index to be rebuilt.  Views that override HitTest aren't
+*	supported (other than the root view.)
+*
+*	ViewWithTag uses a table of tags sorted in the order that
+*	XView::ViewWithTag searches, so a duplicate tag finds the same view.
+*/
+class XViewIndex
+{
+public:
+							XViewIndex(void);
+							/*
+							*	Returns false if the hierarchy doesn't fit.
+							*	inColumns and inRows are the display size.
+							*/
+	bool					Build(
+								XView*					inRootView,
+								uint16_t				inColumns,
+								uint16_t				inRows);
+							// True if built and there have been no layout changes.
+	inline bool				IsCurrent(void) const
+								{return(mBuilt && mLayoutSerial == XView::LayoutSerial());}
+	inline bool				IsValid(void) const
+								{return(mValid);}
+							/*
+							*	Returns false if the index can't answer, in
+							*	which case use XView::HitTest.  inX and inY
+							*	are global.
+							*/
+	bool					HitTest(
+								int16_t					inX,
+								int16_t					inY,
+								XView*&					outHitView) const;
+							/*
+							*	Returns false if the index can't answer.
+							*	outView is null if no view has inTag.
+							*/
+	bool					ViewWithTag(
+								uint16_t				inTag,
+								XView*&					outView) const;
+	inline uint16_t			Count(void) const
+								{return(mCount);}
+	inline uint16_t			PoolUsed(void) const
+								{return(mPoolUsed);}
+	void					Invalidate(void)
+								{mBuilt = false;}
+	enum
+	{
+		eMaxViews		= XVIEW_INDEX_SIZE,
+		ePoolSize		= XVIEW_INDEX_POOL,
+		eGridColumns	= XVIEW_GRID_COLUMNS,
+		eGridRows		= XVIEW_GRID_ROWS,
+		eNumCells		= eGridColumns * eGridRows,
+		eNoParent		= 0xFFFF
+	};
+protected:
+	struct SEntry
+	{
+		XView*		view;
+		int16_t		x;			// Global origin
+		int16_t		y;
+		uint16_t	parent;		// Index of the superview
+		uint16_t	end;		// Index following the last subview
+	};
+	struct STag
+	{
+		uint16_t	tag;
+		uint16_t	index;
+	};
+	SEntry		mEntries[eMaxViews];
+	STag		mTags[eMaxViews];		// Sorted by tag, then search order
+	/*
+	*	mPool[0 to mEverywhereCount) are the views listed in every cell,
+	*	followed by the cell lists.  Cell c is mPool[mCellStart[c] to
+	*	mCellStart[c+1]).  Each list is in drawing order.
+	*/
+	uint16_t	mPool[ePoolSize];
+	uint16_t	mCellStart[eNumCells + 1];
+	uint16_t	mCount;
+	uint16_t	mEverywhereCount;
+	uint16_t	mPoolUsed;
+	uint16_t	mCellWidth;
+	uint16_t	mCellHeight;
+	uint32_t	mLayoutSerial;
+	bool		mBuilt;		// Build was called for mLayoutSerial
+	bool		mValid;		// and succeeded
+
+	bool					Add(
+								XView*					inView,
+								uint16_t				inParent);
+	bool					CellRange(
+								const SEntry&			inEntry,
+								uint16_t&				outFirstColumn,
+								uint16_t&				outLastColumn,
+								uint16_t&				outFirstRow,
+								uint16_t&				outLastRow) const;
+	bool					BuildGrid(void);
+	void					BuildTags(void);
+	inline bool				Hits(
+								uint16_t				inIndex,
+								int16_t					inX,
+								int16_t					inY) const
+							{
+								const SEntry&	entry = mEntries[inIndex];
+								return(entry.view->WantsClicks() &&
+									entry.view->HitSelf(inX - entry.x, inY - entry.y));
+							}
+};
+
+#endif // XViewIndex_h
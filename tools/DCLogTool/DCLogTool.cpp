@@ -0,0 +1,606 @@
+/*
+*	DCLogTool.cpp, Copyright Jonathan Mackey 2026
+*	Decodes, filters, summarizes and exports SampleLog (.DCL) files.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -I../../libraries/SampleLog DCLogTool.cpp
+*			../../libraries/SampleLog/SampleLog.cpp -o DCLogTool
+*
+*	Usage:
+*		DCLogTool [-f from] [-t to] [-c csvFile] [-r] file...
+*		DCLogTool -g numSamples [-p periodMs] [-s seed] file
+*
+*		-f	skip samples before this time
+*		-t	skip samples after this time
+*			Times are UnixTime seconds or YYYY-MM-DD[THH:MM[:SS]] (UTC.)
+*		-c	export the samples as CSV, "-" for stdout:
+*				time,millis,static,ambient,temperature,binMotor,status
+*		-r	print per-run statistics.  A run is a span of consecutive samples
+*			with the DC running bit set.  Runs continue across files.
+*		-g	write a synthetic log of numSamples samples (default period
+*			1000 ms) starting at the beginning of 2026.  Used to check the
+*			encoded size and decoder speed.
+*	Without -c or -r a summary is printed.
+*
+*	Files are processed in the order given, so pass them in time order (the
+*	YYYYMMDD names sort correctly.)  Each file is read up to the first block
+*	with the wrong magic, fileID or index, the same as SDLogger.  A file
+*	isn't limited to SDLogger's 4096 sectors, the block index is compared
+*	modulo 16 bits.
+*
+*	Each block's keyframe time is its index entry: -f binary searches the
+*	blocks for the last block starting at or before the from time, so
+*	blocks before it aren't decoded.
+*/
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "SampleLog.h"
+
+using namespace SampleLog;
+
+static const uint16_t	kBlockSize = 512;
+
+struct SRun
+{
+	uint32_t	startTime;
+	uint32_t	endTime;
+	uint32_t	samples;
+	uint32_t	staticSamples;	// With eDeltasLoadedBit set
+	int32_t		staticMin;
+	int32_t		staticMax;
+	int64_t		staticSum;
+	int64_t		ambientSum;
+	int64_t		tempSum;
+	uint8_t		binMotorMax;
+	uint8_t		statusMax;		// Worst EStatus seen
+	bool		binMotorRan;
+};
+
+struct SContext
+{
+	uint32_t	from;
+	uint32_t	to;
+	FILE*		csv;
+	bool		runs;
+	uint64_t	samples;		// Within the time range
+	uint64_t	blocks;			// Decoded
+	uint64_t	bytes;			// Of valid blocks
+	uint32_t	firstTime;
+	uint32_t	lastTime;
+	bool		inRun;
+	uint32_t	numRuns;
+	SRun		run;
+	char*		csvBuffer;
+	size_t		csvLength;
+};
+
+static const size_t	kCSVBufferSize = 1 << 20;
+
+/********************************* ParseTime **********************************/
+static bool ParseTime(
+	const char*	inString,
+	uint32_t&	outTime)
+{
+	struct tm	tm;
+	memset(&tm, 0, sizeof(tm));
+	bool	success = true;
+	if (strchr(inString, '-'))
+	{
+		int	fields = sscanf(inString, "%d-%d-%dT%d:%d:%d", &tm.tm_year, &tm.tm_mon,
+						&tm.tm_mday, &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+		success = fields == 3 || fields >= 5;
+		tm.tm_year -= 1900;
+		tm.tm_mon--;
+		outTime = (uint32_t)timegm(&tm);
+	} else
+	{
+		char*	end;
+		outTime = (uint32_t)strtoul(inString, &end, 10);
+		success = *end == 0;
+	}
+	return(success);
+}
+
+/********************************* FormatTime *********************************/
+static const char* FormatTime(
+	uint32_t	inTime,
+	char*		outString)
+{
+	time_t		time = inTime;
+	struct tm	tm;
+	gmtime_r(&time, &tm);
+	strftime(outString, 24, "%Y-%m-%d %H:%M:%S", &tm);
+	return(outString);
+}
+
+/********************************** FlushCSV **********************************/
+static void FlushCSV(
+	SContext&	ioContext)
+{
+	fwrite(ioContext.csvBuffer, 1, ioContext.csvLength, ioContext.csv);
+	ioContext.csvLength = 0;
+}
+
+/********************************* AppendInt **********************************/
+/*
+*	printf is the bottleneck when exporting tens of millions of samples, so
+*	the CSV lines are formatted by hand.
+*/
+static inline char* AppendInt(
+	int64_t	inValue,
+	char*	inBuffer)
+{
+	char	digits[20];
+	char*	digitPtr = digits;
+	uint64_t	value = inValue < 0 ? -(uint64_t)inValue : inValue;
+	if (inValue < 0)
+	{
+		*(inBuffer++) = '-';
+	}
+	do
+	{
+		*(digitPtr++) = '0' + (value % 10);
+		value /= 10;
+	} while (value);
+	while (digitPtr > digits)
+	{
+		*(inBuffer++) = *(--digitPtr);
+	}
+	return(inBuffer);
+}
+
+/********************************* WriteCSV ***********************************/
+static inline void WriteCSV(
+	SContext&		ioContext,
+	const SSample&	inSample)
+{
+	if (ioContext.csvLength > kCSVBufferSize - 128)
+	{
+		FlushCSV(ioContext);
+	}
+	char*	line = &ioContext.csvBuffer[ioContext.csvLength];
+	char*	linePtr = AppendInt(inSample.time, line);
+	*(linePtr++) = ',';
+	linePtr = AppendInt(inSample.millis, linePtr);
+	*(linePtr++) = ',';
+	linePtr = AppendInt(inSample.staticPressure, linePtr);
+	*(linePtr++) = ',';
+	linePtr = AppendInt(inSample.ambientPressure, linePtr);
+	*(linePtr++) = ',';
+	linePtr = AppendInt(inSample.temperature, linePtr);
+	*(linePtr++) = ',';
+	linePtr = AppendInt(inSample.binMotor, linePtr);
+	*(linePtr++) = ',';
+	linePtr = AppendInt(inSample.status, linePtr);
+	*(linePtr++) = '\n';
+	ioContext.csvLength += linePtr - line;
+}
+
+/********************************* PrintRun ***********************************/
+static void PrintRun(
+	SContext&	ioContext)
+{
+	static const char* const	kStatusName[] = {"-", "running", "binFull", "filterFull"};
+	const SRun&	run = ioContext.run;
+	char	timeStr[24];
+	char	binStr[8] = "-";
+	char	staticStr[3][12] = {"-", "-", "-"};
+	if (run.binMotorRan)
+	{
+		snprintf(binStr, sizeof(binStr), "%u", run.binMotorMax);
+	}
+	if (run.staticSamples)
+	{
+		snprintf(staticStr[0], sizeof(staticStr[0]), "%d", run.staticMin);
+		snprintf(staticStr[1], sizeof(staticStr[1]), "%d", (int32_t)(run.staticSum / run.staticSamples));
+		snprintf(staticStr[2], sizeof(staticStr[2]), "%d", run.staticMax);
+	}
+	if (ioContext.numRuns == 0)
+	{
+		printf("%-19s %8s %8s %6s %6s %6s %8s %7s %6s %-10s\n", "start", "seconds",
+			"samples", "stMin", "stMean", "stMax", "ambMean", "tempC", "binMax", "status");
+	}
+	ioContext.numRuns++;
+	printf("%-19s %8u %8u %6s %6s %6s %8d %7.2f %6s %-10s\n",
+		FormatTime(run.startTime, timeStr), run.endTime - run.startTime, run.samples,
+		staticStr[0], staticStr[1], staticStr[2],
+		(int32_t)(run.ambientSum / run.samples),
+		(double)(run.tempSum / run.samples) / 100,
+		binStr,
+		kStatusName[run.statusMax & eStatusMask]);
+}
+
+/********************************* AddToRun ***********************************/
+static inline void AddToRun(
+	SContext&		ioContext,
+	const SSample&	inSample)
+{
+	bool	running = (inSample.status & eDCRunningBit) != 0;
+	SRun&	run = ioContext.run;
+	if (running)
+	{
+		if (!ioContext.inRun)
+		{
+			ioContext.inRun = true;
+			memset(&run, 0, sizeof(SRun));
+			run.startTime = inSample.time;
+		}
+		run.endTime = inSample.time;
+		run.samples++;
+		/*
+		*	The static pressure is only valid once the delta averages have
+		*	loaded (about 15 seconds into a run.)
+		*/
+		if (inSample.status & eDeltasLoadedBit)
+		{
+			if (run.staticSamples == 0 || inSample.staticPressure < run.staticMin) run.staticMin = inSample.staticPressure;
+			if (run.staticSamples == 0 || inSample.staticPressure > run.staticMax) run.staticMax = inSample.staticPressure;
+			run.staticSamples++;
+			run.staticSum += inSample.staticPressure;
+		}
+		run.ambientSum += inSample.ambientPressure;
+		run.tempSum += inSample.temperature;
+		if (inSample.status & eMotorRunningBit)
+		{
+			run.binMotorRan = true;
+			if (inSample.binMotor > run.binMotorMax) run.binMotorMax = inSample.binMotor;
+		}
+		if ((inSample.status & eStatusMask) > (run.statusMax & eStatusMask))
+		{
+			run.statusMax = inSample.status & eStatusMask;
+		}
+	} else if (ioContext.inRun)
+	{
+		ioContext.inRun = false;
+		PrintRun(ioContext);
+	}
+}
+
+/******************************** ProcessFile *********************************/
+static bool ProcessFile(
+	const char*	inPath,
+	SContext&	ioContext)
+{
+	int	fd = open(inPath, O_RDONLY);
+	struct stat	st;
+	if (fd < 0 || fstat(fd, &st) != 0)
+	{
+		fprintf(stderr, "Can't open %s\n", inPath);
+		if (fd >= 0) close(fd);
+		return(false);
+	}
+	size_t	numBlocks = st.st_size / kBlockSize;
+	if (numBlocks == 0)
+	{
+		close(fd);
+		return(true);
+	}
+	const uint8_t*	file = (const uint8_t*)mmap(nullptr, numBlocks * kBlockSize,
+									PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (file == MAP_FAILED)
+	{
+		fprintf(stderr, "Can't map %s\n", inPath);
+		return(false);
+	}
+	madvise((void*)file, numBlocks * kBlockSize, MADV_SEQUENTIAL);
+
+	/*
+	*	Build the block index (keyframe times) and find the end of the log.
+	*/
+	std::vector<uint32_t>	keyTimes;
+	SBlockHeader	header;
+	uint16_t		fileID = 0;
+	for (size_t i = 0; i < numBlocks; i++)
+	{
+		if (!ReadHeader(&file[i * kBlockSize], kBlockSize, header) ||
+			(i && header.fileID != fileID) ||
+			header.index != (uint16_t)i)
+		{
+			break;
+		}
+		fileID = header.fileID;
+		keyTimes.push_back(header.keyframe.time);
+	}
+	ioContext.bytes += keyTimes.size() * kBlockSize;
+
+	/*
+	*	The first block that can contain the from time is the last block
+	*	starting at or before it.
+	*/
+	size_t	block = 0;
+	if (ioContext.from)
+	{
+		size_t	lo = 0;
+		size_t	hi = keyTimes.size();
+		while (lo < hi)
+		{
+			size_t	mid = (lo + hi) / 2;
+			if (keyTimes[mid] <= ioContext.from)
+			{
+				lo = mid + 1;
+			} else
+			{
+				hi = mid;
+			}
+		}
+		block = lo ? lo - 1 : 0;
+	}
+
+	BlockDecoder	decoder;
+	SSample			sample;
+	bool			pastEnd = false;
+	for (; block < keyTimes.size() && !pastEnd; block++)
+	{
+		if (keyTimes[block] > ioContext.to)
+		{
+			break;
+		}
+		decoder.Begin(&file[block * kBlockSize], kBlockSize);
+		ioContext.blocks++;
+		while (decoder.Next(sample))
+		{
+			if (sample.time < ioContext.from)
+			{
+				continue;
+			}
+			if (sample.time > ioContext.to)
+			{
+				pastEnd = true;
+				break;
+			}
+			if (ioContext.samples == 0)
+			{
+				ioContext.firstTime = sample.time;
+			}
+			ioContext.lastTime = sample.time;
+			ioContext.samples++;
+			if (ioContext.csv)
+			{
+				WriteCSV(ioContext, sample);
+			}
+			if (ioContext.runs)
+			{
+				AddToRun(ioContext, sample);
+			}
+		}
+	}
+	munmap((void*)file, numBlocks * kBlockSize);
+	return(true);
+}
+
+/********************************** Generate **********************************/
+/*
+*	A synthetic log: the collector runs for 10 to 60 minutes a few times a
+*	day.  While running the static pressure is noisy and the bin motor runs.
+*	The ambient pressure and temperature drift slowly with sensor noise.
+*/
+static int Generate(
+	const char*	inPath,
+	uint64_t	inNumSamples,
+	uint32_t	inPeriod,
+	unsigned	inSeed)
+{
+	FILE*	file = fopen(inPath, "wb");
+	if (!file)
+	{
+		fprintf(stderr, "Can't create %s\n", inPath);
+		return(1);
+	}
+	srand(inSeed);
+	uint8_t		block[kBlockSize];
+	BlockEncoder	encoder;
+	SSample		sample;
+	memset(&sample, 0, sizeof(sample));
+	sample.time = 1767225600;	// 2026-01-01
+	sample.ambientPressure = 101325;
+	sample.temperature = 2000;
+	uint16_t	fileID = (uint16_t)(sample.time / 86400);
+	uint16_t	index = 0;
+	uint32_t	millis = 0;
+	uint32_t	stateSamples = 0;	// Until the DC starts/stops
+	int32_t		ambient = 101325 * 16;	// 1/16 Pa
+	int32_t		temp = 2000 * 16;		// 1/16 of 0.01°C
+	uint64_t	blocks = 0;
+	for (uint64_t i = 0; i < inNumSamples; i++)
+	{
+		if (stateSamples == 0)
+		{
+			bool	running = (sample.status & eDCRunningBit) == 0;
+			sample.status = running ? (eDCRunningBit | eDeltasLoadedBit | 1) : eDeltasLoadedBit;
+			stateSamples = (uint32_t)((running ? 600 + rand() % 3000 :
+								3600 + rand() % 20000) * 1000 / inPeriod) + 1;
+		}
+		stateSamples--;
+		millis += inPeriod + (rand() % 3) - 1;	// Loop jitter
+		sample.millis = millis;
+		sample.time = 1767225600 + millis / 1000;
+		ambient += (rand() % 5) - 2;
+		temp += (rand() % 5) - 2;
+		// Sensor noise only shows up when it crosses a whole unit.
+		sample.ambientPressure = (ambient + 8) / 16;
+		sample.temperature = (int16_t)((temp + 8) / 16);
+		if (sample.status & eDCRunningBit)
+		{
+			sample.staticPressure = 1200 + (rand() % 7) - 3;
+			bool	motor = (i / 30) % 4 == 0;
+			sample.status = motor ? (sample.status | eMotorRunningBit) :
+									(sample.status & ~eMotorRunningBit);
+			sample.binMotor = motor ? 100 + (rand() % 3) : 0;
+		} else
+		{
+			sample.staticPressure = 0;
+			sample.binMotor = 0;
+		}
+		if (!encoder.IsOpen())
+		{
+			encoder.Begin(block, kBlockSize, fileID, index++, sample);
+		} else
+		{
+			encoder.Add(sample);
+		}
+		if (encoder.IsFull() || i + 1 == inNumSamples)
+		{
+			encoder.Finish();
+			fwrite(block, 1, kBlockSize, file);
+			blocks++;
+		}
+	}
+	fclose(file);
+	fprintf(stderr, "%llu samples, %llu blocks, %llu bytes, %.2f bytes/sample\n",
+		(unsigned long long)inNumSamples, (unsigned long long)blocks,
+		(unsigned long long)(blocks * kBlockSize),
+		inNumSamples ? (double)(blocks * kBlockSize) / inNumSamples : 0.0);
+	return(0);
+}
+
+/*********************************** Usage ************************************/
+static int Usage(void)
+{
+	fprintf(stderr, "Usage: DCLogTool [-f from] [-t to] [-c csvFile] [-r] file...\n"
+		"       DCLogTool -g numSamples [-p periodMs] [-s seed] file\n");
+	return(1);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	SContext	context;
+	memset(&context, 0, sizeof(context));
+	context.to = 0xFFFFFFFF;
+	const char*	csvPath = nullptr;
+	uint64_t	generate = 0;
+	uint32_t	period = 1000;
+	unsigned	seed = 1;
+	std::vector<const char*>	files;
+	for (int i = 1; i < argc; i++)
+	{
+		const char*	arg = argv[i];
+		if (arg[0] == '-' && arg[1] && arg[2] == 0 && strchr("ftcgps", arg[1]))
+		{
+			if (i + 1 >= argc)
+			{
+				return(Usage());
+			}
+			const char*	valueArg = argv[++i];
+			bool	valid = true;
+			switch (arg[1])
+			{
+				case 'f':
+					valid = ParseTime(valueArg, context.from);
+					break;
+				case 't':
+					valid = ParseTime(valueArg, context.to);
+					break;
+				case 'c':
+					csvPath = valueArg;
+					break;
+				case 'g':
+					generate = strtoull(valueArg, nullptr, 10);
+					break;
+				case 'p':
+					period = (uint32_t)strtoul(valueArg, nullptr, 10);
+					valid = period != 0;
+					break;
+				case 's':
+					seed = (unsigned)strtoul(valueArg, nullptr, 10);
+					break;
+			}
+			if (!valid)
+			{
+				fprintf(stderr, "Invalid value for %s: %s\n", arg, valueArg);
+				return(1);
+			}
+		} else if (strcmp(arg, "-r") == 0)
+		{
+			context.runs = true;
+		} else if (arg[0] == '-')
+		{
+			return(Usage());
+		} else
+		{
+			files.push_back(arg);
+		}
+	}
+	if (files.empty())
+	{
+		return(Usage());
+	}
+	if (generate)
+	{
+		return(Generate(files[0], generate, period, seed));
+	}
+	if (csvPath)
+	{
+		context.csv = strcmp(csvPath, "-") == 0 ? stdout : fopen(csvPath, "w");
+		if (!context.csv)
+		{
+			fprintf(stderr, "Can't create %s\n", csvPath);
+			return(1);
+		}
+		context.csvBuffer = (char*)malloc(kCSVBufferSize);
+		fputs("time,millis,static,ambient,temperature,binMotor,status\n", context.csv);
+	}
+	int	failed = 0;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		failed += !ProcessFile(files[i], context);
+	}
+	if (context.csv)
+	{
+		FlushCSV(context);
+		if (context.csv != stdout)
+		{
+			fclose(context.csv);
+		}
+		free(context.csvBuffer);
+	}
+	if (context.runs && context.inRun)
+	{
+		PrintRun(context);	// Still running at the end of the log
+	}
+	if (!context.csv && !context.runs)
+	{
+		char	firstStr[24], lastStr[24];
+		printf("%zu files, %llu bytes logged, %llu blocks decoded, %llu samples\n",
+			files.size(), (unsigned long long)context.bytes,
+			(unsigned long long)context.blocks, (unsigned long long)context.samples);
+		if (context.samples)
+		{
+			printf("%s to %s\n", FormatTime(context.firstTime, firstStr),
+				FormatTime(context.lastTime, lastStr));
+		}
+	} else if (context.runs)
+	{
+		fprintf(stderr, "%u runs\n", context.numRuns);
+	}
+	return(failed);
+}
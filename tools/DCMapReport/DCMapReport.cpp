@@ -0,0 +1,610 @@
+/*
+*	DCMapReport.cpp, Copyright Jonathan Mackey 2026
+*	Attributes static RAM in a linker map to libraries and lists the largest
+*	stack frames.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 DCMapReport.cpp -o DCMapReport
+*
+*	Usage:
+*		DCMapReport [-r ramSize] [-n count] [-v header]... mapFile [suFile...]
+*
+*		-r	the RAM size for the total, default 20480 (BluePill)
+*		-n	the number of symbols and stack frames listed, default 15
+*		-v	a header defining global objects, e.g. DCXViews.h.  Sketch
+*			symbols defined in it are reported as a group named after the
+*			header rather than as "sketch".  The group's constants in flash
+*			(.rodata, e.g. XLabelSpec tables) are listed too, so moving
+*			properties from objects in RAM to constant tables shows as RAM
+*			going down and rodata going up.
+*
+*	The STM32 core writes the map to the build folder as <sketch>.ino.map.
+*	For the stack frames, build with -fstack-usage (e.g. arduino-cli
+*	--build-property compiler.cpp.extra_flags=-fstack-usage) and pass the
+*	.su files from the build folder.  Frames sized at run time (variable
+*	length arrays, alloca) are marked "dynamic", the size is the fixed part.
+*
+*	Input sections are attributed by the path of their object:
+*	.../libraries/<name>/... to <name>, .../sketch/... to "sketch" (or a -v
+*	group), the core archive to "core" and other archives by name.  The
+*	sections are per symbol because the core compiles with -fdata-sections.
+*	The exit status is 1 if the map has no .data or .bss.
+*/
+#include <ctype.h>
+#include <cxxabi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+struct SSymbol
+{
+	std::string	name;
+	std::string	group;
+	std::string	section;	// Output section
+	uint32_t	size;
+};
+
+struct SGroup
+{
+	uint32_t	data;
+	uint32_t	bss;
+	uint32_t	other;		// Other RAM sections
+	uint32_t	rodata;		// Constants in flash, not in the RAM totals
+};
+
+struct SFrame
+{
+	std::string	function;
+	std::string	group;
+	uint32_t	size;
+	bool		dynamic;
+};
+
+/********************************** Trim **************************************/
+static std::string Trim(
+	const std::string&	inString)
+{
+	size_t	start = inString.find_first_not_of(" \t\r\n");
+	size_t	end = inString.find_last_not_of(" \t\r\n");
+	return(start == std::string::npos ? std::string() :
+				inString.substr(start, end - start + 1));
+}
+
+/********************************* Demangle ***********************************/
+static std::string Demangle(
+	const std::string&	inName)
+{
+	std::string	name(inName);
+	int		status;
+	char*	demangled = abi::__cxa_demangle(inName.c_str(), nullptr, nullptr, &status);
+	if (demangled)
+	{
+		name = demangled;
+		free(demangled);
+	}
+	return(name);
+}
+
+/******************************* GroupForPath *********************************/
+static std::string GroupForPath(
+	const std::string&	inPath)
+{
+	std::string	group;
+	std::string	path("/" + inPath);	// To match relative paths
+	size_t	libraries = path.rfind("/libraries/");
+	if (libraries != std::string::npos)
+	{
+		size_t	start = libraries + 11;
+		group = path.substr(start, path.find('/', start) - start);
+	} else if (path.find("/sketch/") != std::string::npos)
+	{
+		group = "sketch";
+	} else if (path.find("core.a") != std::string::npos ||
+		path.find("/core/") != std::string::npos)
+	{
+		group = "core";
+	} else
+	{
+		// An archive, libc_nano.a(lib_a-malloc.o), or an object.
+		size_t	paren = path.find('(');
+		std::string	file(path.substr(0, paren));
+		group = file.substr(file.rfind('/') + 1);
+	}
+	return(group);
+}
+
+/******************************* ReadHeaderNames ******************************/
+/*
+*	The names of the objects defined at file scope in inPath, the first
+*	identifier following a type at the start of a line and followed by
+*	'(', '[', '=' or ';'.  Function declarations match as well, which is
+*	harmless because they aren't in RAM sections.
+*/
+static bool ReadHeaderNames(
+	const char*				inPath,
+	std::set<std::string>&	outNames)
+{
+	FILE*	file = fopen(inPath, "r");
+	if (file)
+	{
+		char	line[512];
+		while (fgets(line, sizeof(line), file))
+		{
+			const char*	ptr = line;
+			if (strncmp(ptr, "static ", 7) == 0)
+			{
+				ptr += 7;
+			}
+			if (strncmp(ptr, "const ", 6) == 0)
+			{
+				ptr += 6;
+			}
+			// The type
+			if (!isalpha((unsigned char)*ptr) && *ptr != '_')
+			{
+				continue;
+			}
+			while (isalnum((unsigned char)*ptr) || *ptr == '_' || *ptr == ':')
+			{
+				ptr++;
+			}
+			if (*ptr != ' ' && *ptr != '\t')
+			{
+				continue;
+			}
+			while (*ptr == ' ' || *ptr == '\t' || *ptr == '*' || *ptr == '&')
+			{
+				ptr++;
+			}
+			const char*	name = ptr;
+			while (isalnum((unsigned char)*ptr) || *ptr == '_')
+			{
+				ptr++;
+			}
+			size_t	length = ptr - name;
+			while (*ptr == ' ' || *ptr == '\t')
+			{
+				ptr++;
+			}
+			if (length &&
+				(*ptr == '(' || *ptr == '[' || *ptr == '=' || *ptr == ';'))
+			{
+				outNames.insert(std::string(name, length));
+			}
+		}
+		fclose(file);
+	}
+	return(file != nullptr);
+}
+
+/********************************* SymbolName *********************************/
+/*
+*	.bss.foo -> foo, .bss._ZL3foo (file static) -> foo, COMMON -> COMMON.
+*/
+static std::string SymbolName(
+	const std::string&	inSection,
+	bool&				outFileStatic)
+{
+	std::string	name(inSection);
+	outFileStatic = false;
+	size_t	dot = name.find('.', 1);
+	if (name[0] == '.' && dot != std::string::npos)
+	{
+		name = name.substr(dot + 1);
+	}
+	if (name.compare(0, 3, "_ZL") == 0)
+	{
+		size_t	start = 3;
+		size_t	length = strtoul(name.c_str() + start, nullptr, 10);
+		for (; start < name.size() && isdigit((unsigned char)name[start]); start++){}
+		if (length &&
+			start + length == name.size())
+		{
+			name = name.substr(start);
+			outFileStatic = true;
+		}
+	}
+	return(name);
+}
+
+/*********************************** IsHex ************************************/
+static bool IsHex(
+	const std::string&	inToken)
+{
+	return(inToken.compare(0, 2, "0x") == 0);
+}
+
+/*********************************** Split ************************************/
+static std::vector<std::string> Split(
+	const std::string&	inLine)
+{
+	std::vector<std::string>	tokens;
+	size_t	pos = 0;
+	while ((pos = inLine.find_first_not_of(" \t\r\n", pos)) != std::string::npos)
+	{
+		size_t	end = inLine.find_first_of(" \t\r\n", pos);
+		tokens.push_back(inLine.substr(pos, end == std::string::npos ? end : end - pos));
+		pos = end;
+	}
+	return(tokens);
+}
+
+/********************************* ReadMap ************************************/
+/*
+*	Only the "Linker script and memory map" part of the map is read, the
+*	discarded input sections before it have the same format.  Input
+*	sections start with a space.  A long section name is on a line of its
+*	own with the address, size and object on the next line (the same for
+*	output sections.)
+*/
+static bool ReadMap(
+	const char*						inPath,
+	const std::set<std::string>&	inRAMSections,
+	std::map<std::string, uint32_t>&	outSectionSizes,
+	std::vector<SSymbol>&			outSymbols)
+{
+	FILE*	file = fopen(inPath, "r");
+	if (file)
+	{
+		char		line[1024];
+		bool		inMemoryMap = false;
+		std::string	outputSection;
+		std::string	pendingName;
+		bool		pendingSize = false;	// Output section name on its own line
+		while (fgets(line, sizeof(line), file))
+		{
+			std::string	text(line);
+			if (!inMemoryMap)
+			{
+				inMemoryMap = Trim(text) == "Linker script and memory map";
+				continue;
+			}
+			std::vector<std::string>	tokens = Split(text);
+			if (tokens.empty())
+			{
+				continue;
+			}
+			if (text[0] == '.')
+			{
+				outputSection = tokens[0];
+				pendingName.clear();
+				pendingSize = tokens.size() == 1;
+				if (inRAMSections.count(outputSection) &&
+					tokens.size() >= 3 && IsHex(tokens[2]))
+				{
+					outSectionSizes[outputSection] += strtoul(tokens[2].c_str(), nullptr, 16);
+				}
+				continue;
+			}
+			if (pendingSize)
+			{
+				pendingSize = false;
+				if (inRAMSections.count(outputSection) &&
+					tokens.size() >= 2 && IsHex(tokens[0]) && IsHex(tokens[1]))
+				{
+					outSectionSizes[outputSection] += strtoul(tokens[1].c_str(), nullptr, 16);
+					continue;
+				}
+			}
+			if (text[0] != ' ' ||
+				!inRAMSections.count(outputSection))
+			{
+				continue;
+			}
+			std::string	name;
+			size_t		next = 1;
+			if (text[1] != ' ')
+			{
+				// " .bss.foo 0x... 0x... object", " COMMON ...", " *fill* ..."
+				name = tokens[0];
+				if (name[0] == '*' && name != "*fill*")
+				{
+					continue;	// Linker script pattern, " *(.data*)"
+				}
+				if (tokens.size() == 1)
+				{
+					pendingName = name;
+					continue;
+				}
+			} else if (!pendingName.empty())
+			{
+				name = pendingName;
+				next = 0;
+			} else
+			{
+				continue;	// A symbol, "0x... name"
+			}
+			pendingName.clear();
+			if (tokens.size() < next + 2 ||
+				!IsHex(tokens[next]) || !IsHex(tokens[next+1]))
+			{
+				continue;
+			}
+			uint32_t	size = strtoul(tokens[next+1].c_str(), nullptr, 16);
+			if (size == 0)
+			{
+				continue;
+			}
+			SSymbol	symbol;
+			symbol.section = outputSection;
+			symbol.size = size;
+			if (name == "*fill*")
+			{
+				symbol.name = "*fill*";
+				symbol.group = "fill";
+			} else
+			{
+				std::string	object;
+				for (size_t i = next + 2; i < tokens.size(); i++)
+				{
+					object += (i > next + 2 ? " " : "") + tokens[i];
+				}
+				symbol.name = name;
+				symbol.group = GroupForPath(object);
+			}
+			outSymbols.push_back(symbol);
+		}
+		fclose(file);
+	}
+	return(file != nullptr);
+}
+
+/******************************** ReadStackUsage ******************************/
+/*
+*	gcc -fstack-usage lines: "path:line:column:function<tab>size<tab>qualifiers"
+*/
+static bool ReadStackUsage(
+	const char*				inPath,
+	std::vector<SFrame>&	outFrames)
+{
+	FILE*	file = fopen(inPath, "r");
+	if (file)
+	{
+		char	line[1024];
+		std::string	group = GroupForPath(inPath);
+		while (fgets(line, sizeof(line), file))
+		{
+			std::string	text(line);
+			size_t	tab1 = text.find('\t');
+			size_t	tab2 = text.find('\t', tab1 + 1);
+			if (tab1 == std::string::npos || tab2 == std::string::npos)
+			{
+				continue;
+			}
+			// Skip path:line:column:
+			size_t	start = 0;
+			for (uint8_t colons = 0; colons < 3 && start < tab1; start++)
+			{
+				if (text[start] == ':')
+				{
+					colons++;
+				}
+			}
+			SFrame	frame;
+			frame.function = text.substr(start, tab1 - start);
+			frame.size = strtoul(text.c_str() + tab1 + 1, nullptr, 10);
+			frame.dynamic = text.find("dynamic", tab2) != std::string::npos;
+			frame.group = group;
+			outFrames.push_back(frame);
+		}
+		fclose(file);
+	}
+	return(file != nullptr);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	ramSize = 20480;
+	uint32_t	count = 15;
+	std::map<std::string, std::set<std::string> >	headerGroups;
+	int	opt;
+	while ((opt = getopt(argc, argv, "r:n:v:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'r':
+				ramSize = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'n':
+				count = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'v':
+			{
+				std::string	group(optarg);
+				size_t	slash = group.rfind('/');
+				if (slash != std::string::npos)
+				{
+					group = group.substr(slash + 1);
+				}
+				group = group.substr(0, group.rfind('.'));
+				if (!ReadHeaderNames(optarg, headerGroups[group]))
+				{
+					fprintf(stderr, "Can't read %s\n", optarg);
+					return(1);
+				}
+				break;
+			}
+			default:
+				fprintf(stderr, "Usage: DCMapReport [-r ramSize] [-n count] "
+					"[-v header]... mapFile [suFile...]\n");
+				return(1);
+		}
+	}
+	if (optind >= argc)
+	{
+		fprintf(stderr, "Usage: DCMapReport [-r ramSize] [-n count] "
+			"[-v header]... mapFile [suFile...]\n");
+		return(1);
+	}
+	/*
+	*	._user_heap_stack is the STM32 core's reservation for the minimum
+	*	heap and stack, it only checks that they fit.
+	*/
+	std::set<std::string>	ramSections = {".data", ".bss", ".noinit", "._user_heap_stack"};
+	std::set<std::string>	sections(ramSections);
+	sections.insert(".rodata");
+	std::map<std::string, uint32_t>	sectionSizes;
+	std::vector<SSymbol>	symbols;
+	if (!ReadMap(argv[optind], sections, sectionSizes, symbols))
+	{
+		fprintf(stderr, "Can't read %s\n", argv[optind]);
+		return(1);
+	}
+	if (!sectionSizes.count(".data") && !sectionSizes.count(".bss"))
+	{
+		fprintf(stderr, "No .data or .bss in %s\n", argv[optind]);
+		return(1);
+	}
+
+	std::map<std::string, SGroup>	groups;
+	for (SSymbol& symbol : symbols)
+	{
+		bool	fileStatic;
+		std::string	name = SymbolName(symbol.name, fileStatic);
+		if (symbol.group == "sketch")
+		{
+			for (auto& headerGroup : headerGroups)
+			{
+				if (headerGroup.second.count(name))
+				{
+					symbol.group = headerGroup.first;
+					break;
+				}
+			}
+		}
+		symbol.name = fileStatic ? name : Demangle(name);
+		SGroup&	group = groups[symbol.group];
+		if (symbol.section == ".data")
+		{
+			group.data += symbol.size;
+		} else if (symbol.section == ".rodata")
+		{
+			group.rodata += symbol.size;
+		} else if (symbol.section == ".bss")
+		{
+			group.bss += symbol.size;
+		} else
+		{
+			group.other += symbol.size;
+		}
+	}
+
+	uint32_t	total = 0;
+	printf("RAM sections\n");
+	for (auto& section : sectionSizes)
+	{
+		if (!ramSections.count(section.first))
+		{
+			continue;
+		}
+		printf("  %-20s %6u\n", section.first.c_str(), section.second);
+		total += section.second;
+	}
+	printf("  %-20s %6u of %u, %u left for the stack and heap beyond the minimum\n",
+		"total", total, ramSize, ramSize > total ? ramSize - total : 0);
+
+	std::vector<std::pair<std::string, SGroup> >	sortedGroups(groups.begin(), groups.end());
+	std::sort(sortedGroups.begin(), sortedGroups.end(),
+		[](const std::pair<std::string, SGroup>& inA, const std::pair<std::string, SGroup>& inB)
+		{
+			return(inA.second.data + inA.second.bss + inA.second.other >
+					inB.second.data + inB.second.bss + inB.second.other);
+		});
+	printf("\n%-20s %6s %6s %6s %6s %7s\n", "group", "data", "bss", "other",
+		"total", "rodata");
+	for (auto& group : sortedGroups)
+	{
+		uint32_t	ram = group.second.data + group.second.bss + group.second.other;
+		/*
+		*	Only the -v groups' rodata is shown.  The other groups are listed
+		*	for their RAM, most of the flash is fonts and code.
+		*/
+		if (headerGroups.count(group.first))
+		{
+			printf("%-20s %6u %6u %6u %6u %7u\n", group.first.c_str(),
+				group.second.data, group.second.bss, group.second.other, ram,
+				group.second.rodata);
+		} else if (ram)
+		{
+			printf("%-20s %6u %6u %6u %6u\n", group.first.c_str(),
+				group.second.data, group.second.bss, group.second.other, ram);
+		}
+	}
+
+	// Only RAM symbols are listed
+	symbols.erase(std::remove_if(symbols.begin(), symbols.end(),
+		[](const SSymbol& inSymbol){return(inSymbol.section == ".rodata");}),
+		symbols.end());
+	std::sort(symbols.begin(), symbols.end(),
+		[](const SSymbol& inA, const SSymbol& inB){return(inA.size > inB.size);});
+	printf("\nLargest symbols\n");
+	for (uint32_t i = 0; i < count && i < symbols.size(); i++)
+	{
+		printf("%6u  %-5s  %-18s %s\n", symbols[i].size, symbols[i].section.c_str() + 1,
+			symbols[i].group.c_str(), symbols[i].name.c_str());
+	}
+
+	if (optind + 1 < argc)
+	{
+		std::vector<SFrame>	frames;
+		for (int i = optind + 1; i < argc; i++)
+		{
+			if (!ReadStackUsage(argv[i], frames))
+			{
+				fprintf(stderr, "Can't read %s\n", argv[i]);
+			}
+		}
+		std::sort(frames.begin(), frames.end(),
+			[](const SFrame& inA, const SFrame& inB){return(inA.size > inB.size);});
+		printf("\nLargest stack frames\n");
+		for (uint32_t i = 0; i < count && i < frames.size(); i++)
+		{
+			printf("%6u%-9s %-18s %s\n", frames[i].size,
+				frames[i].dynamic ? " +dynamic" : "", frames[i].group.c_str(),
+				frames[i].function.c_str());
+		}
+		uint32_t	dynamicFrames = 0;
+		for (SFrame& frame : frames)
+		{
+			dynamicFrames += frame.dynamic;
+		}
+		printf("%zu functions, %u with dynamic frames:\n", frames.size(), dynamicFrames);
+		for (SFrame& frame : frames)
+		{
+			if (frame.dynamic)
+			{
+				printf("%6u +dynamic %-18s %s\n", frame.size, frame.group.c_str(),
+					frame.function.c_str());
+			}
+		}
+	}
+	return(0);
+}
@@ -0,0 +1,361 @@
+/*
+*	DCSchedSim.cpp, Copyright Jonathan Mackey 2026
+*	Runs the controller's task table on a simulated clock and reports the
+*	deadline misses.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -D__MACH__ -I../../libraries/Scheduler
+*			-I../../libraries/MSPeriod DCSchedSim.cpp
+*			../../libraries/Scheduler/Scheduler.cpp
+*			../../libraries/MSPeriod/ClockSource.cpp -o DCSchedSim
+*	(__MACH__ selects the host build of the libraries, the same as the display
+*	tester.  It's predefined on macOS.)
+*
+*	Usage:
+*		DCSchedSim [-t seconds] [-w wake period, s] [-d redraw ms] [-p]
+*
+*	The tasks are those of DustCollectorSTM32 (kTasks, keep in sync.)  Each
+*	slice advances the simulated clock by the slice's modeled cost:
+*		pressure	15ms every 1.5s (two forced BMP280 reads)
+*		motor		0.2ms every 0.5s
+*		touch		a 40ms tap (opens a dialog) every 7s, otherwise a poll
+*		serial		0.3ms every 5ms
+*		storage		3ms SD sector every 1.5s, otherwise 0.2ms
+*		gauge		2ms every 30ms
+*		icon		1.5ms every 750ms
+*		redraw		-d ms (default 220), after a wake every -w s (default 10)
+*	-p runs the same costs as the old superloop instead: every pass polls
+*	every task in table order, whatever it costs.
+*
+*	Results, one line per task: slices run, misses (started more than the
+*	task's latency after it was due), the worst lateness in ms, overruns
+*	(slices longer than the budget) and the longest slice in us.  The exit
+*	status is 1 if a priority 0 (sensing) task missed.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "Scheduler.h"
+#include "ClockSource.h"
+
+enum ETask
+{
+	ePressureTask,
+	eMotorTask,
+	eTouchTask,
+	eButtonsTask,
+	eSerialTask,
+	eStorageTask,
+	eGaugeTask,
+	eIconTask,
+	eRedrawTask,
+	eSleepTask,
+	eNumTasks
+};
+
+static const STask kTasks[] =
+{
+	// name		priority, latency ms, budget us
+	{"pressure",	0, 100, 20000},
+	{"motor",		0, 20, 1000},
+	{"touch",		1, 20, 50000},
+	{"buttons",		1, 20, 50000},
+	{"serial",		2, 20, 5000},
+	{"storage",		3, 50, 10000},
+	{"gauge",		4, 30, 3000},
+	{"icon",		4, 100, 3000},
+	{"redraw",		5, 200, 250000},
+	{"sleep",		5, 1000, 150000}
+};
+
+/*
+*	The cost of a slice in us, and the delay returned.
+*/
+class SimTasks : public SchedulerDelegate
+{
+public:
+							SimTasks(
+								uint32_t				inWakePeriod,	// ms
+								uint32_t				inRedrawCost)	// us
+								: mScheduler(nullptr), mWakePeriod(inWakePeriod),
+								  mRedrawCost(inRedrawCost), mNextTap(7000),
+								  mNextWake(inWakePeriod), mNextSector(1500),
+								  mRedrawPending(false){}
+	void					SetScheduler(
+								Scheduler*				inScheduler)
+								{mScheduler = inScheduler;}
+	virtual uint32_t		RunTask(
+								uint8_t					inTask);
+							// The cost in us, without advancing the clock.
+	uint32_t				Cost(
+								uint8_t					inTask,
+								uint32_t&				outDelay);
+							// True once after a touch woke the display.
+	bool					TakeRedraw(void)
+								{bool pending = mRedrawPending;
+								 mRedrawPending = false; return(pending);}
+protected:
+	Scheduler*	mScheduler;
+	uint32_t	mWakePeriod;	// ms
+	uint32_t	mRedrawCost;	// us
+	uint32_t	mNextTap;		// ms
+	uint32_t	mNextWake;
+	uint32_t	mNextSector;
+	bool		mRedrawPending;
+};
+
+/*********************************** RunTask **********************************/
+uint32_t SimTasks::RunTask(
+	uint8_t	inTask)
+{
+	uint32_t	delay;
+	uint32_t	cost = Cost(inTask, delay);
+	if (TakeRedraw())
+	{
+		mScheduler->Wake(eRedrawTask);
+	}
+	ClockSource::Advance(cost);
+	return(delay);
+}
+
+/************************************ Cost ************************************/
+uint32_t SimTasks::Cost(
+	uint8_t		inTask,
+	uint32_t&	outDelay)
+{
+	uint32_t	now = ClockSource::Millis();
+	uint32_t	cost = 50;
+	outDelay = 10;
+	switch (inTask)
+	{
+		case ePressureTask:
+			cost = 15000;
+			outDelay = 1500;
+			break;
+		case eMotorTask:
+			cost = 200;
+			outDelay = 500;
+			break;
+		case eTouchTask:
+			if ((int32_t)(now - mNextTap) >= 0)
+			{
+				mNextTap += 7000;
+				cost = 40000;
+			}
+			if ((int32_t)(now - mNextWake) >= 0)
+			{
+				mNextWake += mWakePeriod;
+				mRedrawPending = true;
+			}
+			break;
+		case eSerialTask:
+			cost = 300;
+			outDelay = 5;
+			break;
+		case eStorageTask:
+			cost = 200;
+			if ((int32_t)(now - mNextSector) >= 0)
+			{
+				mNextSector += 1500;
+				cost = 3000;
+			}
+			outDelay = 5;
+			break;
+		case eGaugeTask:
+			cost = 2000;
+			outDelay = 30;
+			break;
+		case eIconTask:
+			cost = 1500;
+			outDelay = 750;
+			break;
+		case eRedrawTask:
+			cost = mRedrawCost;
+			outDelay = Scheduler::eSuspend;
+			break;
+		case eSleepTask:
+			outDelay = 1000;
+			break;
+	}
+	return(cost);
+}
+
+/*
+*	The statistics the Scheduler keeps, for the superloop.
+*/
+struct SLoopStats
+{
+	uint32_t	due;
+	uint32_t	slices;
+	uint32_t	misses;
+	uint32_t	maxLate;
+	uint32_t	overruns;
+	uint32_t	maxTime;
+};
+
+/********************************** SuperLoop *********************************/
+/*
+*	Each pass runs every task whose delay has passed, in table order.  A
+*	redraw is due when the touch task asks for one.
+*/
+static bool SuperLoop(
+	SimTasks&	inTasks,
+	uint32_t	inEnd)
+{
+	SLoopStats	stats[eNumTasks] = {};
+	uint32_t	start = ClockSource::Millis();
+	for (uint8_t task = 0; task < eNumTasks; task++)
+	{
+		stats[task].due = task == eRedrawTask ? Scheduler::eSuspend : start;
+	}
+	while ((int32_t)(ClockSource::Millis() - inEnd) < 0)
+	{
+		bool	ran = false;
+		for (uint8_t task = 0; task < eNumTasks; task++)
+		{
+			uint32_t	now = ClockSource::Millis();
+			SLoopStats&	taskStats = stats[task];
+			if (taskStats.due != Scheduler::eSuspend &&
+				(int32_t)(now - taskStats.due) >= 0)
+			{
+				uint32_t	late = now - taskStats.due;
+				if (late > kTasks[task].latency)
+				{
+					taskStats.misses++;
+				}
+				if (late > taskStats.maxLate)
+				{
+					taskStats.maxLate = late;
+				}
+				uint32_t	delay;
+				uint32_t	cost = inTasks.Cost(task, delay);
+				ClockSource::Advance(cost);
+				taskStats.slices++;
+				if (cost > kTasks[task].budget)
+				{
+					taskStats.overruns++;
+				}
+				if (cost > taskStats.maxTime)
+				{
+					taskStats.maxTime = cost;
+				}
+				taskStats.due = delay == Scheduler::eSuspend ? delay : now + delay;
+				ran = true;
+				if (inTasks.TakeRedraw())
+				{
+					stats[eRedrawTask].due = ClockSource::Millis();
+				}
+			}
+		}
+		if (!ran)
+		{
+			ClockSource::Advance(20);	// A pass with nothing to do
+		}
+	}
+	bool	sensingMissed = false;
+	printf("%-10s %8s %6s %6s %6s %8s\n", "task", "n", "miss", "late", "over", "max");
+	for (uint8_t task = 0; task < eNumTasks; task++)
+	{
+		const SLoopStats&	taskStats = stats[task];
+		printf("%-10s %8u %6u %6u %6u %8u\n", kTasks[task].name,
+			taskStats.slices, taskStats.misses, taskStats.maxLate,
+			taskStats.overruns, taskStats.maxTime);
+		if (kTasks[task].priority == 0 &&
+			taskStats.misses)
+		{
+			sensingMissed = true;
+		}
+	}
+	return(sensingMissed);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	seconds = 600;
+	uint32_t	wakePeriod = 10;
+	uint32_t	redrawCost = 220;
+	bool		superLoop = false;
+	int	opt;
+	while ((opt = getopt(argc, argv, "t:w:d:p")) != -1)
+	{
+		switch (opt)
+		{
+			case 't':
+				seconds = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'w':
+				wakePeriod = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'd':
+				redrawCost = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'p':
+				superLoop = true;
+				break;
+			default:
+				fprintf(stderr, "Usage: DCSchedSim [-t seconds] [-w wake period, s] [-d redraw ms] [-p]\n");
+				return(2);
+		}
+	}
+	if (!wakePeriod)
+	{
+		wakePeriod = seconds + 1;
+	}
+	ClockSource::SetMode(ClockSource::eSimulated);
+	ClockSource::SetTime(0);
+	SimTasks	tasks(wakePeriod*1000, redrawCost*1000);
+	uint32_t	end = seconds*1000;
+	bool	sensingMissed;
+	if (superLoop)
+	{
+		sensingMissed = SuperLoop(tasks, end);
+	} else
+	{
+		Scheduler	scheduler(kTasks, eNumTasks, &tasks);
+		tasks.SetScheduler(&scheduler);
+		scheduler.begin();
+		scheduler.Suspend(eRedrawTask);
+		while ((int32_t)(ClockSource::Millis() - end) < 0)
+		{
+			scheduler.Update();
+		}
+		sensingMissed = false;
+		printf("%-10s %8s %6s %6s %6s %8s\n", "task", "n", "miss", "late", "over", "max");
+		for (uint8_t task = 0; task < eNumTasks; task++)
+		{
+			printf("%-10s %8u %6u %6u %6u %8u\n", kTasks[task].name,
+				scheduler.Slices(task), scheduler.Misses(task),
+				scheduler.MaxLate(task), scheduler.Overruns(task),
+				scheduler.MaxTime(task));
+			if (kTasks[task].priority == 0 &&
+				scheduler.Misses(task))
+			{
+				sensingMissed = true;
+			}
+		}
+		printf("idle %u\n", scheduler.IdleCount());
+	}
+	return(sensingMissed ? 1 : 0);
+}
@@ -0,0 +1,646 @@
+/*
+*	DCScreen.cpp, Copyright Jonathan Mackey 2026
+*	Scripted UI testing over the serial shell: touch injection, screen
+*	capture, screenshot comparison and latency.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -I../../libraries/Telemetry -I../../libraries/CRC
+*			DCScreen.cpp ../../libraries/Telemetry/Telemetry.cpp
+*			../../libraries/CRC/CRC16.cpp -o DCScreen
+*
+*	Usage:
+*		DCScreen -d device [-b baud] script
+*		DCScreen -c a.ppm b.ppm [diff.ppm]
+*
+*		-d	serial device, e.g. /dev/ttyUSB0, opened raw at baud (19200)
+*		-c	compare two screenshots, optionally writing a diff image
+*
+*	The script has one command per line, # starts a comment:
+*		tap x y				touch down then up at x y
+*		down x y			touch down
+*		drag x y			move the pen while down
+*		up					touch up
+*		wait ms
+*		send line			any shell command, prints its first response line
+*		capture x y w h file.ppm
+*		expect x y w h ref.ppm [diff.ppm]
+*							capture and compare with ref.ppm, fails if any
+*							pixel differs
+*		mark x y w h		capture a region to watch for latency
+*		latency [ms]		capture the marked region until it differs from
+*							the mark, up to ms (2000) after the last touch
+*
+*	Touch commands print the time the controller took to handle the event.
+*	latency prints the range from the start to the end of the first capture
+*	showing the change, measured from when the last touch was sent.
+*
+*	Screenshots are binary PPM files (P6), RGB565 expanded to 8 bits per
+*	channel.  The diff image shows matching pixels dimmed and differing
+*	pixels in magenta.  The exit status is the number of failed commands.
+*/
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Telemetry.h"
+
+/*
+*	An RGB565 image.
+*/
+struct Image
+{
+	uint16_t				width;
+	uint16_t				height;
+	std::vector<uint16_t>	pixels;
+
+	void					SetSize(
+								uint16_t				inWidth,
+								uint16_t				inHeight)
+								{
+									width = inWidth;
+									height = inHeight;
+									pixels.assign((size_t)inWidth * inHeight, 0);
+								}
+	bool					Read(
+								const char*				inPath);
+	bool					Write(
+								const char*				inPath) const;
+};
+
+static const uint32_t	kTimeout = 3000;	// ms without receiving anything
+static const uint32_t	kMaxWait = 300000;	// ms for a response
+
+/*
+*	Sends shell commands and receives the interleaved text responses and
+*	telemetry packets.
+*/
+class Controller
+{
+public:
+							Controller(void)
+								: mFD(-1), mInFrame(false), mCapture(nullptr),
+								  mCaptured(0){}
+	bool					Open(
+								const char*				inDevice,
+								uint32_t				inBaud);
+	void					Close(void)
+								{if (mFD >= 0) close(mFD);}
+							/*
+							*	Sends inCommand and returns its first response
+							*	line, empty on timeout.
+							*/
+	std::string				Command(
+								const std::string&		inCommand);
+							// Returns false if incomplete.
+	bool					Capture(
+								uint16_t				inX,
+								uint16_t				inY,
+								uint16_t				inWidth,
+								uint16_t				inHeight,
+								Image&					outImage);
+protected:
+	int						mFD;
+	Telemetry::FrameDecoder	mDecoder;
+	bool					mInFrame;		// Between a frame's delimiters
+	std::string				mText;			// Of the current line
+	std::vector<std::string>	mLines;
+	Image*					mCapture;		// Receiving eScreenPackets
+	uint16_t				mCaptureX;
+	uint16_t				mCaptureY;
+	uint32_t				mCaptured;		// Pixels received
+
+	bool					Receive(
+								uint32_t				inTimeout);
+	void					ScreenPacket(void);
+	std::string				NextLine(void);
+};
+
+/*********************************** Millis ***********************************/
+static uint32_t Millis(void)
+{
+	struct timespec	now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return((uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000));
+}
+
+/************************************ Read ************************************/
+bool Image::Read(
+	const char*	inPath)
+{
+	bool	success = false;
+	FILE*	file = fopen(inPath, "rb");
+	if (file)
+	{
+		unsigned	imageWidth, imageHeight, maxValue;
+		if (fscanf(file, "P6 %u %u %u", &imageWidth, &imageHeight, &maxValue) == 3 &&
+			fgetc(file) != EOF &&
+			maxValue == 255 &&
+			imageWidth && imageWidth <= 0xFFFF &&
+			imageHeight && imageHeight <= 0xFFFF)
+		{
+			SetSize(imageWidth, imageHeight);
+			uint8_t	rgb[3];
+			success = true;
+			for (size_t i = 0; i < pixels.size() && success; i++)
+			{
+				success = fread(rgb, 1, 3, file) == 3;
+				pixels[i] = ((rgb[0] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[2] >> 3);
+			}
+		}
+		fclose(file);
+	}
+	return(success);
+}
+
+/*********************************** Write ************************************/
+bool Image::Write(
+	const char*	inPath) const
+{
+	FILE*	file = fopen(inPath, "wb");
+	if (file)
+	{
+		fprintf(file, "P6\n%u %u\n255\n", width, height);
+		for (size_t i = 0; i < pixels.size(); i++)
+		{
+			uint16_t	color = pixels[i];
+			uint8_t		rgb[3];
+			rgb[0] = (color >> 8) & 0xF8;
+			rgb[1] = (color >> 3) & 0xFC;
+			rgb[2] = (color << 3) & 0xF8;
+			// Replicate the high bits so white is 255, not 248
+			rgb[0] |= rgb[0] >> 5;
+			rgb[1] |= rgb[1] >> 6;
+			rgb[2] |= rgb[2] >> 5;
+			fwrite(rgb, 1, 3, file);
+		}
+		return(fclose(file) == 0);
+	}
+	return(false);
+}
+
+/********************************** Compare ***********************************/
+/*
+*	Returns the number of pixels that differ, or -1 if the sizes differ.
+*	If outDiff isn't null it's set to the diff image.
+*/
+static int32_t Compare(
+	const Image&	inA,
+	const Image&	inB,
+	Image*			outDiff)
+{
+	if (inA.width != inB.width ||
+		inA.height != inB.height)
+	{
+		return(-1);
+	}
+	int32_t	differences = 0;
+	if (outDiff)
+	{
+		outDiff->SetSize(inA.width, inA.height);
+	}
+	for (size_t i = 0; i < inA.pixels.size(); i++)
+	{
+		bool	differs = inA.pixels[i] != inB.pixels[i];
+		differences += differs;
+		if (outDiff)
+		{
+			// Dim to a quarter by shifting each channel right 2
+			outDiff->pixels[i] = differs ? 0xF81F : ((inA.pixels[i] >> 2) & 0x39E7);
+		}
+	}
+	return(differences);
+}
+
+/************************************ Open ************************************/
+bool Controller::Open(
+	const char*	inDevice,
+	uint32_t	inBaud)
+{
+	static const struct
+	{
+		uint32_t	baud;
+		speed_t		speed;
+	} kSpeeds[] = {{9600, B9600}, {19200, B19200}, {38400, B38400},
+					{57600, B57600}, {115200, B115200}};
+	for (size_t i = 0; i < sizeof(kSpeeds)/sizeof(kSpeeds[0]); i++)
+	{
+		if (kSpeeds[i].baud == inBaud)
+		{
+			mFD = open(inDevice, O_RDWR | O_NOCTTY);
+			struct termios	tio;
+			if (mFD >= 0 &&
+				tcgetattr(mFD, &tio) == 0)
+			{
+				cfmakeraw(&tio);
+				cfsetispeed(&tio, kSpeeds[i].speed);
+				cfsetospeed(&tio, kSpeeds[i].speed);
+				tio.c_cflag |= CLOCAL | CREAD;
+				tio.c_cc[VMIN] = 0;
+				tio.c_cc[VTIME] = 0;
+				tcsetattr(mFD, TCSANOW, &tio);
+				tcflush(mFD, TCIFLUSH);
+			}
+			break;
+		}
+	}
+	return(mFD >= 0);
+}
+
+/********************************** Receive ***********************************/
+/*
+*	Waits up to inTimeout ms for data and processes what arrives.  Every
+*	frame is preceded and followed by a zero, so the zeros alternate between
+*	starting and ending a frame.  Text lines can only be between the end of
+*	one frame and the start of the next.  A valid packet resynchronizes the
+*	alternation.  Returns false on timeout.
+*/
+bool Controller::Receive(
+	uint32_t	inTimeout)
+{
+	struct pollfd	pfd = {mFD, POLLIN, 0};
+	bool	success = poll(&pfd, 1, (int)inTimeout) > 0;
+	if (success)
+	{
+		uint8_t	buffer[256];
+		ssize_t	length = read(mFD, buffer, sizeof(buffer));
+		for (ssize_t i = 0; i < length; i++)
+		{
+			uint8_t	thisByte = buffer[i];
+			if (mDecoder.Add(thisByte))
+			{
+				mInFrame = false;
+				if (mDecoder.Type() == Telemetry::eScreenPacket)
+				{
+					ScreenPacket();
+				}
+			} else if (thisByte == 0)
+			{
+				mInFrame = !mInFrame;
+			} else if (!mInFrame)
+			{
+				if (thisByte == '\n')
+				{
+					if (!mText.empty() && mText[mText.size()-1] == '\r')
+					{
+						mText.resize(mText.size()-1);
+					}
+					mLines.push_back(mText);
+					mText.clear();
+				} else
+				{
+					mText += (char)thisByte;
+				}
+			}
+			if (thisByte == 0)
+			{
+				mText.clear();
+			}
+		}
+	}
+	return(success);
+}
+
+/******************************** ScreenPacket ********************************/
+void Controller::ScreenPacket(void)
+{
+	Telemetry::SScreen	screen;
+	if (mCapture &&
+		Telemetry::UnpackScreen(mDecoder.Payload(), mDecoder.PayloadLength(), screen))
+	{
+		uint32_t	row = screen.row - mCaptureY;
+		uint32_t	column = screen.column - mCaptureX;
+		for (uint8_t i = 0; i < screen.numRuns; i++)
+		{
+			for (uint8_t j = 0; j < screen.runs[i].count; j++, column++)
+			{
+				if (row < mCapture->height &&
+					column < mCapture->width)
+				{
+					mCapture->pixels[row * mCapture->width + column] = screen.runs[i].color;
+					mCaptured++;
+				}
+			}
+		}
+	}
+}
+
+/********************************** NextLine **********************************/
+std::string Controller::NextLine(void)
+{
+	std::string	line;
+	uint32_t	start = Millis();
+	while (mLines.empty() &&
+		Millis() - start < kMaxWait &&
+		Receive(kTimeout)){}
+	if (!mLines.empty())
+	{
+		line = mLines.front();
+		mLines.erase(mLines.begin());
+	}
+	return(line);
+}
+
+/********************************** Command ***********************************/
+std::string Controller::Command(
+	const std::string&	inCommand)
+{
+	mLines.clear();
+	std::string	command = inCommand + "\r\n";
+	if (write(mFD, command.c_str(), command.size()) != (ssize_t)command.size())
+	{
+		return(std::string());
+	}
+	return(NextLine());
+}
+
+/********************************** Capture ***********************************/
+bool Controller::Capture(
+	uint16_t	inX,
+	uint16_t	inY,
+	uint16_t	inWidth,
+	uint16_t	inHeight,
+	Image&		outImage)
+{
+	outImage.SetSize(inWidth, inHeight);
+	mCapture = &outImage;
+	mCaptureX = inX;
+	mCaptureY = inY;
+	mCaptured = 0;
+	uint32_t	lostPackets = mDecoder.LostPackets();
+	char	command[64];
+	snprintf(command, sizeof(command), "capture %u %u %u %u", inX, inY, inWidth, inHeight);
+	std::string	response = Command(command);
+	mCapture = nullptr;
+	bool	success = response.compare(0, 2, "ok") == 0 &&
+		mCaptured == (uint32_t)inWidth * inHeight &&
+		mDecoder.LostPackets() == lostPackets;
+	if (!success)
+	{
+		fprintf(stderr, "capture failed: \"%s\", %u of %u pixels\n", response.c_str(),
+			mCaptured, (uint32_t)inWidth * inHeight);
+	}
+	return(success);
+}
+
+/*********************************** Usage ************************************/
+static int Usage(void)
+{
+	fprintf(stderr, "Usage: DCScreen -d device [-b baud] script\n"
+		"       DCScreen -c a.ppm b.ppm [diff.ppm]\n");
+	return(1);
+}
+
+/********************************* CompareFiles *******************************/
+static int CompareFiles(
+	int		argc,
+	char*	argv[])
+{
+	Image	a, b, diff;
+	if (argc < 2 || argc > 3)
+	{
+		return(Usage());
+	}
+	if (!a.Read(argv[0]) || !b.Read(argv[1]))
+	{
+		fprintf(stderr, "Can't read %s\n", a.pixels.empty() ? argv[0] : argv[1]);
+		return(1);
+	}
+	int32_t	differences = Compare(a, b, argc == 3 ? &diff : nullptr);
+	if (differences < 0)
+	{
+		printf("sizes differ, %ux%u and %ux%u\n", a.width, a.height, b.width, b.height);
+		return(1);
+	}
+	printf("%d pixels differ\n", differences);
+	if (argc == 3 &&
+		!diff.Write(argv[2]))
+	{
+		fprintf(stderr, "Can't create %s\n", argv[2]);
+	}
+	return(differences != 0);
+}
+
+/********************************* RunScript **********************************/
+static int RunScript(
+	Controller&	inController,
+	FILE*		inScript)
+{
+	int			failures = 0;
+	uint32_t	touchTime = Millis();
+	Image		mark;
+	uint16_t	markRect[4] = {0};
+	char		line[256];
+	for (uint32_t lineNum = 1; fgets(line, sizeof(line), inScript); lineNum++)
+	{
+		char*	comment = strchr(line, '#');
+		if (comment)
+		{
+			*comment = 0;
+		}
+		char	command[16], path[200], diffPath[200];
+		unsigned	x, y, width, height;
+		path[0] = diffPath[0] = 0;
+		int	fields = sscanf(line, "%15s %u %u %u %u %199s %199s", command,
+							&x, &y, &width, &height, path, diffPath);
+		if (fields <= 0)
+		{
+			continue;	// Empty line
+		}
+		bool	success = true;
+		std::string	cmd(command);
+		if ((cmd == "tap" || cmd == "down" || cmd == "drag") && fields == 3)
+		{
+			char	shellCommand[48];
+			if (cmd == "tap")
+			{
+				snprintf(shellCommand, sizeof(shellCommand), "touch %u %u", x, y);
+			} else
+			{
+				snprintf(shellCommand, sizeof(shellCommand), "touch %s %u %u", command, x, y);
+			}
+			touchTime = Millis();
+			std::string	response = inController.Command(shellCommand);
+			printf("%s %u %u: %s\n", command, x, y, response.c_str());
+			success = response.compare(0, 2, "ok") == 0;
+		} else if (cmd == "up" && fields == 1)
+		{
+			touchTime = Millis();
+			std::string	response = inController.Command("touch up");
+			printf("up: %s\n", response.c_str());
+			success = response.compare(0, 2, "ok") == 0;
+		} else if (cmd == "wait" && fields == 2)
+		{
+			usleep(x * 1000);
+		} else if (cmd == "send" && strlen(line) > 5)
+		{
+			std::string	shellCommand(strstr(line, "send") + 5);
+			shellCommand.erase(shellCommand.find_last_not_of(" \t\r\n") + 1);
+			std::string	response = inController.Command(shellCommand);
+			printf("%s: %s\n", shellCommand.c_str(), response.c_str());
+			success = !response.empty() && response[0] != '?';
+		} else if ((cmd == "capture" || cmd == "expect") && fields >= 6)
+		{
+			Image	image;
+			uint32_t	start = Millis();
+			success = inController.Capture(x, y, width, height, image);
+			if (success)
+			{
+				if (cmd == "capture")
+				{
+					success = image.Write(path);
+					printf("capture %u %u %u %u: %s, %u ms\n", x, y, width, height,
+						success ? path : "can't create file", Millis() - start);
+				} else
+				{
+					Image	reference, diff;
+					if (reference.Read(path))
+					{
+						int32_t	differences = Compare(image, reference, &diff);
+						success = differences == 0;
+						if (differences < 0)
+						{
+							printf("expect %s: size differs\n", path);
+						} else
+						{
+							printf("expect %s: %d pixels differ\n", path, differences);
+						}
+						if (!success && diffPath[0])
+						{
+							if (differences >= 0)
+							{
+								diff.Write(diffPath);
+							} else
+							{
+								image.Write(diffPath);
+							}
+						}
+					} else
+					{
+						printf("expect: can't read %s\n", path);
+						success = false;
+					}
+				}
+			}
+		} else if (cmd == "mark" && fields == 5)
+		{
+			markRect[0] = x;
+			markRect[1] = y;
+			markRect[2] = width;
+			markRect[3] = height;
+			success = inController.Capture(x, y, width, height, mark);
+		} else if (cmd == "latency" && fields <= 2 && !mark.pixels.empty())
+		{
+			uint32_t	timeout = fields == 2 ? x : 2000;
+			success = false;
+			while (!success &&
+				Millis() - touchTime < timeout)
+			{
+				Image		image;
+				uint32_t	start = Millis();
+				if (!inController.Capture(markRect[0], markRect[1], markRect[2],
+						markRect[3], image))
+				{
+					break;
+				}
+				if (Compare(image, mark, nullptr) > 0)
+				{
+					printf("latency %u..%u ms\n", start - touchTime, Millis() - touchTime);
+					success = true;
+				}
+			}
+			if (!success)
+			{
+				printf("latency: no change\n");
+			}
+		} else
+		{
+			fprintf(stderr, "line %u: invalid command\n", lineNum);
+			success = false;
+		}
+		if (!success)
+		{
+			printf("line %u: failed\n", lineNum);
+			failures++;
+		}
+	}
+	return(failures);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	const char*	device = nullptr;
+	uint32_t	baud = 19200;
+	bool		compare = false;
+	int			opt;
+	while ((opt = getopt(argc, argv, "d:b:c")) != -1)
+	{
+		switch (opt)
+		{
+			case 'd':
+				device = optarg;
+				break;
+			case 'b':
+				baud = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'c':
+				compare = true;
+				break;
+			default:
+				return(Usage());
+		}
+	}
+	if (compare)
+	{
+		return(CompareFiles(argc - optind, &argv[optind]));
+	}
+	if (device == nullptr ||
+		optind != argc - 1)
+	{
+		return(Usage());
+	}
+	FILE*	script = fopen(argv[optind], "r");
+	if (script == nullptr)
+	{
+		fprintf(stderr, "Can't open %s\n", argv[optind]);
+		return(1);
+	}
+	Controller	controller;
+	if (!controller.Open(device, baud))
+	{
+		fprintf(stderr, "Can't open %s\n", device);
+		return(1);
+	}
+	int	failures = RunScript(controller, script);
+	controller.Close();
+	fclose(script);
+	printf("%d failed\n", failures);
+	return(failures > 125 ? 125 : failures);
+}
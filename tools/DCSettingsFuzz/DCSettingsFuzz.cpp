@@ -0,0 +1,265 @@
+/*
+*	DCSettingsFuzz.cpp, Copyright Jonathan Mackey 2026
+*	Fuzz harness and parse benchmark for DCSettings/KeyValueParser.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build as a libFuzzer target (from this directory):
+*		clang++ -std=c++11 -g -O1 -fsanitize=fuzzer,address -D__MACH__
+*			-I../../DCControllerSTM32 -I../../libraries/KeyValueParser
+*			-I../../libraries/DataStream -I../../libraries/UnixTime
+*			-I../../libraries/DisplayController -I../../libraries/DustCollectorBase
+*			DCSettingsFuzz.cpp ../../DCControllerSTM32/DCSettings.cpp
+*			../../libraries/KeyValueParser/KeyValueParser.cpp -o DCSettingsFuzz
+*	Run: DCSettingsFuzz [corpus directory]
+*
+*	Build standalone, without libFuzzer, by replacing -fsanitize=fuzzer,address
+*	with -DDCSETTINGS_STANDALONE (any compiler):
+*		DCSettingsFuzz -i iterations [-s seed]
+*			Mutates a valid settings file at random (byte flips, inserts,
+*			deletes and line duplication) and runs each through the harness.
+*		DCSettingsFuzz -b megabytes
+*			Parse throughput: parses a buffer of valid settings lines.
+*
+*	The harness checks that any input parses without overrunning anything
+*	(with ASan) and that a successfully read file round trips: Write then
+*	Read gives the same settings.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "DCSettings.h"
+#include "DataStream.h"
+#include "KeyValueParser.h"
+
+/*
+*	Reads from / writes to a memory buffer.
+*/
+class MemoryStream : public DataStream
+{
+public:
+							MemoryStream(
+								const uint8_t*			inData,
+								size_t					inSize)
+								: mData(inData), mSize(inSize), mPos(0){}
+							MemoryStream(void)
+								: mData(nullptr), mSize(0), mPos(0){}
+	virtual uint32_t		Read(
+								uint32_t				inLength,
+								void*					outBuffer)
+							{
+								uint32_t	length = Clip(inLength);
+								memcpy(outBuffer, &mData[mPos], length);
+								mPos += length;
+								return(length);
+							}
+	virtual uint32_t		Write(
+								uint32_t				inLength,
+								const void*				inBuffer)
+							{
+								mOutput.append((const char*)inBuffer, inLength);
+								return(inLength);
+							}
+	virtual bool			Seek(
+								int32_t					/*inOffset*/,
+								EOrigin					/*inOrigin*/)
+								{return(false);}
+	virtual uint32_t		GetPos(void) const
+								{return((uint32_t)mPos);}
+	virtual bool			AtEOF(void) const
+								{return(mPos >= mSize);}
+	virtual uint32_t		Clip(
+								uint32_t				inLength) const
+								{return((uint32_t)(inLength < mSize - mPos ? inLength : mSize - mPos));}
+	const std::string&		Output(void) const
+								{return(mOutput);}
+protected:
+	const uint8_t*	mData;
+	size_t			mSize;
+	size_t			mPos;
+	std::string		mOutput;
+};
+
+/*************************** LLVMFuzzerTestOneInput ***************************/
+extern "C" int LLVMFuzzerTestOneInput(
+	const uint8_t*	inData,
+	size_t			inSize)
+{
+	MemoryStream	input(inData, inSize);
+	DCSettings		settings;
+	if (settings.Read(&input) == DCSettings::eReadOK)
+	{
+		MemoryStream	written;
+		settings.Write(&written, settings.Settings());
+		MemoryStream	reread((const uint8_t*)written.Output().data(), written.Output().size());
+		DCSettings		rereadSettings;
+		if (rereadSettings.Read(&reread) != DCSettings::eReadOK ||
+			memcmp(&settings.Settings(), &rereadSettings.Settings(), sizeof(SDCSettings)) != 0)
+		{
+			fprintf(stderr, "Round trip failed:\n%s", written.Output().c_str());
+			abort();
+		}
+	}
+	return(0);
+}
+
+#ifdef DCSETTINGS_STANDALONE
+#include <chrono>
+
+/******************************* ValidSettings ********************************/
+static std::string ValidSettings(void)
+{
+	SDCSettings	values;
+	DCSettings::SetDefaults(values);
+	values.binThreshold = 110;
+	values.cleanPressure = 150;
+	values.dirtyPressure = 900;
+	values.hourFormat = 24;
+	values.tsXMax = 3900;
+	values.tsXMin = 200;
+	values.tsYMax = 3850;
+	values.tsYMin = 180;
+	values.tsXSkew = -120;
+	values.tsYSkew = 45;
+	MemoryStream	written;
+	DCSettings		settings;
+	settings.Write(&written, values);
+	return(written.Output());
+}
+
+/*********************************** Mutate ***********************************/
+static void Mutate(
+	std::string&	ioInput)
+{
+	static const char	kInteresting[] = "=#\n\r \t~0x-";
+	uint32_t	mutations = 1 + rand() % 4;
+	for (uint32_t i = 0; i < mutations; i++)
+	{
+		size_t	pos = ioInput.empty() ? 0 : rand() % ioInput.size();
+		switch (rand() % 5)
+		{
+			case 0:
+				if (!ioInput.empty()) ioInput[pos] ^= (char)(1 << (rand() % 8));
+				break;
+			case 1:
+				ioInput.insert(pos, 1, kInteresting[rand() % (sizeof(kInteresting) - 1)]);
+				break;
+			case 2:
+				if (!ioInput.empty()) ioInput.erase(pos, 1 + rand() % 8);
+				break;
+			case 3:
+			{
+				// Duplicate the line containing pos
+				size_t	start = ioInput.rfind('\n', pos);
+				start = start == std::string::npos ? 0 : start + 1;
+				size_t	end = ioInput.find('\n', pos);
+				end = end == std::string::npos ? ioInput.size() : end + 1;
+				ioInput.insert(end, ioInput.substr(start, end - start));
+				break;
+			}
+			case 4:
+				ioInput.insert(pos, std::string(1 + rand() % 40, 'a' + rand() % 26));
+				break;
+		}
+	}
+}
+
+/*********************************** Usage ************************************/
+static int Usage(void)
+{
+	fprintf(stderr, "Usage: DCSettingsFuzz -i iterations [-s seed]\n"
+		"       DCSettingsFuzz -b megabytes\n");
+	return(1);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	iterations = 0;
+	uint32_t	megabytes = 0;
+	unsigned	seed = 1;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "-i") == 0)
+		{
+			iterations = (uint32_t)strtoul(argv[i+1], nullptr, 10);
+		} else if (strcmp(argv[i], "-b") == 0)
+		{
+			megabytes = (uint32_t)strtoul(argv[i+1], nullptr, 10);
+		} else if (strcmp(argv[i], "-s") == 0)
+		{
+			seed = (unsigned)strtoul(argv[i+1], nullptr, 10);
+		} else
+		{
+			return(Usage());
+		}
+	}
+	if (!iterations && !megabytes)
+	{
+		return(Usage());
+	}
+	std::string	valid = ValidSettings();
+	if (iterations)
+	{
+		srand(seed);
+		uint32_t	results[DCSettings::eInvalidValue+1] = {0};
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			std::string	input = valid;
+			Mutate(input);
+			LLVMFuzzerTestOneInput((const uint8_t*)input.data(), input.size());
+			MemoryStream	stream((const uint8_t*)input.data(), input.size());
+			DCSettings		settings;
+			results[settings.Read(&stream)]++;
+		}
+		static const char* const	kResultName[] = {"ok", "openFailed", "syntaxError",
+			"unknownKey", "duplicateKey", "invalidValue"};
+		for (uint32_t i = 0; i <= DCSettings::eInvalidValue; i++)
+		{
+			printf("%-13s %u\n", kResultName[i], results[i]);
+		}
+	}
+	if (megabytes)
+	{
+		/*
+		*	The valid file repeated, every key after the first copy is a
+		*	duplicate, so this measures the parser plus the key lookup.
+		*/
+		std::string	input;
+		while (input.size() < (size_t)megabytes << 20)
+		{
+			input += "# comment\n";
+			input += valid;
+		}
+		auto	start = std::chrono::steady_clock::now();
+		MemoryStream	stream((const uint8_t*)input.data(), input.size());
+		DCSettings		settings;
+		settings.Read(&stream);
+		double	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("%zu bytes, %u duplicate keys in %.3f s, %.1f MB/s\n", input.size(),
+			settings.DuplicateKeys(), seconds, input.size() / seconds / (1 << 20));
+	}
+	return(0);
+}
+#endif // DCSETTINGS_STANDALONE
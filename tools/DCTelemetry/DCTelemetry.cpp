@@ -0,0 +1,356 @@
+/*
+*	DCTelemetry.cpp, Copyright Jonathan Mackey 2026
+*	Receives the binary telemetry stream and writes it as a SampleLog file.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -I../../libraries/Telemetry -I../../libraries/CRC
+*			-I../../libraries/SampleLog DCTelemetry.cpp
+*			../../libraries/Telemetry/Telemetry.cpp
+*			../../libraries/CRC/CRC16.cpp
+*			../../libraries/SampleLog/SampleLog.cpp -o DCTelemetry
+*
+*	Usage:
+*		DCTelemetry (-d device [-b baud] [-r divisor] | -i capture)
+*			[-w capture] [-o log.DCL] [-n samples] [-v]
+*
+*		-d	serial device, e.g. /dev/ttyUSB0, opened raw at baud (19200)
+*		-r	telemetry rate sent to the controller (the serial shell command
+*			"telemetry divisor"): 1 = every sensor update, n = every nth,
+*			0 = off
+*		-i	read a raw capture instead of a device (replay)
+*		-w	save the raw bytes received, for replay with -i
+*		-o	write the samples to a SampleLog file (see DCLogTool)
+*		-n	stop after this many samples
+*		-v	print each sample to stdout as CSV:
+*				time,millis,duct,ambient,temperature,deltaAvg,baseline,
+*				binMotor,status,loopAvg,loopMax
+*	Stops at the end of the capture, after -n samples or on Ctrl-C.  The
+*	partially filled log block is written on exit.
+*
+*	The log's static pressure is deltaAvg - baseline once the delta averages
+*	are loaded (0 before), the same value SDLogger logs.
+*/
+#include <fcntl.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Telemetry.h"
+#include "SampleLog.h"
+
+static const uint16_t	kBlockSize = 512;
+static volatile sig_atomic_t	sStop;
+
+/*
+*	Accumulates samples into SampleLog blocks written to a file.
+*/
+class LogWriter
+{
+public:
+							LogWriter(void)
+								: mFile(nullptr), mIndex(0), mFileID(0), mBlocks(0){}
+	bool					Open(
+								const char*				inPath)
+								{
+									mFile = fopen(inPath, "wb");
+									return(mFile != nullptr);
+								}
+	void					Add(
+								const SampleLog::SSample&	inSample);
+	void					Close(void);
+	uint32_t				Blocks(void) const
+								{return(mBlocks);}
+protected:
+	FILE*		mFile;
+	uint16_t	mIndex;
+	uint16_t	mFileID;
+	uint32_t	mBlocks;
+	SampleLog::BlockEncoder	mEncoder;
+	uint8_t		mBlock[kBlockSize];
+
+	void					WriteBlock(void);
+};
+
+/************************************* Add ************************************/
+void LogWriter::Add(
+	const SampleLog::SSample&	inSample)
+{
+	if (mFile)
+	{
+		if (!mEncoder.IsOpen())
+		{
+			if (mIndex == 0)
+			{
+				mFileID = (uint16_t)(inSample.time / 86400);
+			}
+			mEncoder.Begin(mBlock, kBlockSize, mFileID, mIndex++, inSample);
+		} else
+		{
+			mEncoder.Add(inSample);
+		}
+		if (mEncoder.IsFull())
+		{
+			WriteBlock();
+		}
+	}
+}
+
+/********************************* WriteBlock *********************************/
+void LogWriter::WriteBlock(void)
+{
+	mEncoder.Finish();
+	fwrite(mBlock, 1, kBlockSize, mFile);
+	fflush(mFile);	// So the log can be read while receiving
+	mBlocks++;
+}
+
+/************************************ Close ***********************************/
+void LogWriter::Close(void)
+{
+	if (mFile)
+	{
+		if (mEncoder.IsOpen())
+		{
+			WriteBlock();
+		}
+		fclose(mFile);
+		mFile = nullptr;
+	}
+}
+
+/********************************* ToLogSample ********************************/
+static void ToLogSample(
+	const Telemetry::SSample&	inSample,
+	SampleLog::SSample&			outSample)
+{
+	int32_t	staticPressure = (inSample.status & SampleLog::eDeltasLoadedBit) ?
+		inSample.deltaAverage - inSample.baseline : 0;
+	outSample.time = inSample.time;
+	outSample.millis = inSample.millis;
+	outSample.staticPressure = (int16_t)staticPressure;
+	outSample.ambientPressure = inSample.ambientPressure;
+	outSample.temperature = (int16_t)inSample.temperature;
+	outSample.binMotor = inSample.binMotor;
+	outSample.status = inSample.status;
+}
+
+/********************************* OpenSerial *********************************/
+static int OpenSerial(
+	const char*	inDevice,
+	uint32_t	inBaud)
+{
+	static const struct
+	{
+		uint32_t	baud;
+		speed_t		speed;
+	} kSpeeds[] = {{9600, B9600}, {19200, B19200}, {38400, B38400},
+					{57600, B57600}, {115200, B115200}};
+	int	fd = -1;
+	for (size_t i = 0; i < sizeof(kSpeeds)/sizeof(kSpeeds[0]); i++)
+	{
+		if (kSpeeds[i].baud == inBaud)
+		{
+			fd = open(inDevice, O_RDWR | O_NOCTTY);
+			struct termios	tio;
+			if (fd >= 0 &&
+				tcgetattr(fd, &tio) == 0)
+			{
+				cfmakeraw(&tio);
+				cfsetispeed(&tio, kSpeeds[i].speed);
+				cfsetospeed(&tio, kSpeeds[i].speed);
+				tio.c_cflag |= CLOCAL | CREAD;
+				tio.c_cc[VMIN] = 1;
+				tio.c_cc[VTIME] = 0;
+				tcsetattr(fd, TCSANOW, &tio);
+			}
+			break;
+		}
+	}
+	return(fd);
+}
+
+/********************************* StopHandler ********************************/
+static void StopHandler(
+	int	/*inSignal*/)
+{
+	sStop = 1;
+}
+
+/*********************************** Usage ************************************/
+static int Usage(void)
+{
+	fprintf(stderr, "Usage: DCTelemetry (-d device [-b baud] [-r divisor] | -i capture)\n"
+		"           [-w capture] [-o log.DCL] [-n samples] [-v]\n");
+	return(1);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	const char*	device = nullptr;
+	const char*	capturePath = nullptr;
+	const char*	savePath = nullptr;
+	const char*	logPath = nullptr;
+	uint32_t	baud = 19200;
+	int			divisor = -1;
+	uint32_t	maxSamples = 0;
+	bool		verbose = false;
+	int			opt;
+	while ((opt = getopt(argc, argv, "d:b:r:i:w:o:n:v")) != -1)
+	{
+		switch (opt)
+		{
+			case 'd':
+				device = optarg;
+				break;
+			case 'b':
+				baud = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'r':
+				divisor = atoi(optarg);
+				break;
+			case 'i':
+				capturePath = optarg;
+				break;
+			case 'w':
+				savePath = optarg;
+				break;
+			case 'o':
+				logPath = optarg;
+				break;
+			case 'n':
+				maxSamples = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'v':
+				verbose = true;
+				break;
+			default:
+				return(Usage());
+		}
+	}
+	if ((device == nullptr) == (capturePath == nullptr) ||
+		divisor > 255)
+	{
+		return(Usage());
+	}
+	int	fd = device ? OpenSerial(device, baud) : open(capturePath, O_RDONLY);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Can't open %s\n", device ? device : capturePath);
+		return(1);
+	}
+	FILE*	saveFile = nullptr;
+	if (savePath &&
+		(saveFile = fopen(savePath, "wb")) == nullptr)
+	{
+		fprintf(stderr, "Can't create %s\n", savePath);
+		return(1);
+	}
+	LogWriter	log;
+	if (logPath &&
+		!log.Open(logPath))
+	{
+		fprintf(stderr, "Can't create %s\n", logPath);
+		return(1);
+	}
+	if (device && divisor >= 0)
+	{
+		char	command[32];
+		int	length = snprintf(command, sizeof(command), "telemetry %d\r\n", divisor);
+		if (write(fd, command, length) != length)
+		{
+			fprintf(stderr, "Can't write to %s\n", device);
+		}
+	}
+	signal(SIGINT, StopHandler);
+	signal(SIGTERM, StopHandler);
+
+	Telemetry::FrameDecoder	decoder;
+	uint32_t	samples = 0;
+	uint8_t		buffer[256];
+	while (!sStop)
+	{
+		ssize_t	length = read(fd, buffer, sizeof(buffer));
+		if (length <= 0)
+		{
+			break;	// End of the capture, error or interrupted
+		}
+		if (saveFile)
+		{
+			fwrite(buffer, 1, (size_t)length, saveFile);
+		}
+		for (ssize_t i = 0; i < length && !sStop; i++)
+		{
+			if (decoder.Add(buffer[i]))
+			{
+				if (decoder.Type() == Telemetry::eSamplePacket)
+				{
+					Telemetry::SSample	sample;
+					if (Telemetry::UnpackSample(decoder.Payload(),
+							decoder.PayloadLength(), sample))
+					{
+						SampleLog::SSample	logSample;
+						ToLogSample(sample, logSample);
+						log.Add(logSample);
+						if (verbose)
+						{
+							printf("%u,%u,%u,%u,%d,%d,%d,%u,%u,%u,%u\n",
+								sample.time, sample.millis, sample.ductPressure,
+								sample.ambientPressure, sample.temperature,
+								sample.deltaAverage, sample.baseline,
+								sample.binMotor, sample.status,
+								sample.loopAvg, sample.loopMax);
+						}
+						samples++;
+						if (samples == maxSamples)
+						{
+							sStop = 1;
+						}
+					}
+				} else if (decoder.Type() == Telemetry::eInfoPacket)
+				{
+					Telemetry::SInfo	info;
+					if (Telemetry::UnpackInfo(decoder.Payload(),
+							decoder.PayloadLength(), info))
+					{
+						fprintf(stderr, "Telemetry version %u, divisor %u, update period %u ms\n",
+							info.version, info.divisor, info.updatePeriod);
+					}
+				}
+			}
+		}
+	}
+	log.Close();
+	if (saveFile)
+	{
+		fclose(saveFile);
+	}
+	close(fd);
+	fprintf(stderr, "%u samples, %u packets, %u bad frames, %u lost packets, %u log blocks\n",
+		samples, decoder.Packets(), decoder.BadFrames(), decoder.LostPackets(),
+		log.Blocks());
+	return(0);
+}
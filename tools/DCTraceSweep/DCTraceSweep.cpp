@@ -0,0 +1,633 @@
+/*
+*	DCTraceSweep.cpp, Copyright Jonathan Mackey 2026
+*	Replays recorded pressure and bin motor traces through DustCollectorBase
+*	for every combination of a grid of detection parameters.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -D__MACH__ -I../../libraries/DustCollectorBase
+*			-I../../libraries/MSPeriod -I../../libraries/DisplayController
+*			-I../../libraries/Profiler DCTraceSweep.cpp
+*			../../libraries/DustCollectorBase/DustCollectorBase.cpp
+*			../../libraries/MSPeriod/ClockSource.cpp
+*			../../libraries/Profiler/Profiler.cpp -lpthread -o DCTraceSweep
+*	(__MACH__ selects the host build of the libraries, the same as the display
+*	tester.  It's predefined on macOS.)
+*
+*	Usage:
+*		DCTraceSweep [options] <trace directory>
+*
+*	Each option takes a comma separated list of values and/or first:last:step
+*	ranges.  Options not specified use the DustCollectorBase defaults.
+*		-r	running threshold, Pa (kRunningThreshold)
+*		-d	number of deltas (eNumDeltas)
+*		-a	number of delta averages (eNumDeltaAvgs)
+*		-p	pressure update period, ms (kPressureUpdatePeriod)
+*		-f	dirty pressure, Pa
+*		-b	bin motor trigger threshold (mTriggerThreshold)
+*		-j	number of worker threads (default = number of cores)
+*		-s	simulated loop step, ms (default 10)
+*		-w	bin full detection window, s (default 60)
+*	Ex: DCTraceSweep -r 15:40:5 -d 4,6 -a 8,12 -b 90:120:10 traces
+*
+*	Trace files:
+*	Every *.csv file in the directory is a trace.  Each line is one sample:
+*		ms,ambientPa,ductPa,binMotor,dcRunning,binFull
+*	ms is the time of the sample from the start of the recording.  binMotor is
+*	the raw bin motor sense reading (0 when the motor wasn't running.)
+*	dcRunning and binFull (0/1) are the ground truth as logged/annotated at the
+*	time of the recording.  Lines that don't start with a digit are ignored.
+*
+*	During replay the most recent sample at or before the current simulated
+*	time is what the sensors return.
+*
+*	Results:
+*	One line per parameter combination, totaled over all traces:
+*		starts			ground truth collector starts
+*		latAvg/latMax	start detection latency in seconds
+*		missedStarts	starts never detected while the collector was running
+*		falseStarts		detected starts while the collector wasn't running
+*		falseStops		detected stops while the collector was running
+*		binFull			ground truth bin full events
+*		missedBinFull	bin full events not detected within the window
+*		falseBinFull	detected bin full events with no bin full in the window
+*		filterFull		filter full events (no ground truth available)
+*/
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "DustCollectorBase.h"
+#include "ClockSource.h"
+#include "WorkStealingPool.h"
+
+struct STraceSample
+{
+	uint32_t	ms;
+	uint32_t	ambientPressure;
+	uint32_t	ductPressure;
+	uint16_t	binMotor;
+	bool		dcRunning;
+	bool		binFull;
+};
+
+struct STrace
+{
+	std::string					name;
+	std::vector<STraceSample>	samples;
+};
+
+struct SParams
+{
+	int32_t		runningThreshold;
+	uint8_t		numDeltas;
+	uint8_t		numDeltaAvgs;
+	uint32_t	pressureUpdatePeriod;
+	int32_t		dirtyPressure;
+	uint8_t		triggerThreshold;
+};
+
+struct SResults
+{
+	uint32_t	starts;
+	uint32_t	detectedStarts;
+	uint64_t	latencySum;	// ms
+	uint32_t	latencyMax;	// ms
+	uint32_t	missedStarts;
+	uint32_t	falseStarts;
+	uint32_t	falseStops;
+	uint32_t	binFull;
+	uint32_t	missedBinFull;
+	uint32_t	falseBinFull;
+	uint32_t	filterFull;
+
+	void					Add(
+								const SResults&			inResults)
+							{
+								starts += inResults.starts;
+								detectedStarts += inResults.detectedStarts;
+								latencySum += inResults.latencySum;
+								if (inResults.latencyMax > latencyMax)
+								{
+									latencyMax = inResults.latencyMax;
+								}
+								missedStarts += inResults.missedStarts;
+								falseStarts += inResults.falseStarts;
+								falseStops += inResults.falseStops;
+								binFull += inResults.binFull;
+								missedBinFull += inResults.missedBinFull;
+								falseBinFull += inResults.falseBinFull;
+								filterFull += inResults.filterFull;
+							}
+};
+
+/*
+*	The events detected by DustCollectorBase during a replay
+*/
+struct SEvent
+{
+	enum EType
+	{
+		eStart,
+		eStop,
+		eBinFull,
+		eFilterFull
+	};
+	uint32_t	ms;
+	EType		type;
+};
+
+/*
+*	DustCollectorBase subclass with the sensors replaced by the trace.
+*/
+class ReplayCollector : public DustCollectorBase
+{
+public:
+							ReplayCollector(
+								const STrace&			inTrace,
+								const SParams&			inParams)
+								: DustCollectorBase(0, 0, 0, 0, 0),
+								  mTrace(inTrace), mDirtyPressure(inParams.dirtyPressure),
+								  mSampleIndex(0)
+							{
+								SetRunningThreshold(inParams.runningThreshold);
+								SetNumDeltas(inParams.numDeltas);
+								SetNumDeltaAvgs(inParams.numDeltaAvgs);
+								SetPressureUpdatePeriod(inParams.pressureUpdatePeriod);
+								SetTriggerThreshold(inParams.triggerThreshold);
+							}
+	virtual void			SaveTriggerThreshold(void){}
+	virtual void			InitializeMotorThresholdVars(void){}
+	virtual int32_t			CurrentDirtyPressure(void)
+								{return(mDirtyPressure);}
+	void					SetSampleIndex(
+								size_t					inSampleIndex)
+								{mSampleIndex = inSampleIndex;}
+	const std::vector<SEvent>& Events(void) const
+								{return(mEvents);}
+protected:
+	const STrace&		mTrace;
+	int32_t				mDirtyPressure;
+	size_t				mSampleIndex;
+	std::vector<SEvent>	mEvents;
+
+	void					AddEvent(
+								SEvent::EType			inType)
+							{
+								SEvent	event = {ClockSource::Millis(), inType};
+								mEvents.push_back(event);
+							}
+	virtual void			ReadPressureSensors(void)
+							{
+								const STraceSample&	sample = mTrace.samples[mSampleIndex];
+								mAmbientTemperature = 2000;
+								mAmbientPressure = sample.ambientPressure;
+								mDuctPressure = sample.ductPressure;
+							}
+	virtual uint16_t		ReadBinMotorSensor(void)
+								{return(mTrace.samples[mSampleIndex].binMotor);}
+	virtual void			DustCollectorJustStarted(void)
+							{
+								DustCollectorBase::DustCollectorJustStarted();
+								AddEvent(SEvent::eStart);
+							}
+	virtual void			DustCollectorJustStopped(void)
+							{
+								DustCollectorBase::DustCollectorJustStopped();
+								AddEvent(SEvent::eStop);
+							}
+	virtual void			DustBinFull(void)
+							{
+								DustCollectorBase::DustBinFull();
+								AddEvent(SEvent::eBinFull);
+							}
+	virtual void			FilterFull(void)
+							{
+								/*
+								*	CheckFilter calls FilterFull on every
+								*	update past the dirty pressure, only
+								*	count the first one.
+								*/
+								if (mStatus != eFilterFull)
+								{
+									AddEvent(SEvent::eFilterFull);
+								}
+								DustCollectorBase::FilterFull();
+							}
+};
+
+static uint32_t	sStepMS = 10;
+static uint32_t	sBinFullWindowMS = 60000;
+
+/********************************* LoadTrace **********************************/
+static bool LoadTrace(
+	const std::string&	inPath,
+	STrace&				outTrace)
+{
+	FILE*	file = fopen(inPath.c_str(), "r");
+	if (file)
+	{
+		char	line[256];
+		while (fgets(line, sizeof(line), file))
+		{
+			if (line[0] < '0' || line[0] > '9')
+			{
+				continue;
+			}
+			unsigned long	ms, ambient, duct, binMotor;
+			int				dcRunning, binFull;
+			if (sscanf(line, "%lu,%lu,%lu,%lu,%d,%d", &ms, &ambient, &duct,
+					&binMotor, &dcRunning, &binFull) == 6)
+			{
+				STraceSample	sample = {(uint32_t)ms, (uint32_t)ambient,
+								(uint32_t)duct, (uint16_t)binMotor,
+								dcRunning != 0, binFull != 0};
+				outTrace.samples.push_back(sample);
+			}
+		}
+		fclose(file);
+	}
+	return(!outTrace.samples.empty());
+}
+
+/********************************** Replay ************************************/
+/*
+*	Runs a single trace with a single parameter combination.  This is called
+*	from a pool worker.  ClockSource's simulated time is thread local so each
+*	worker has its own clock.
+*/
+static void Replay(
+	const STrace&	inTrace,
+	const SParams&	inParams,
+	SResults&		outResults)
+{
+	memset(&outResults, 0, sizeof(SResults));
+	ClockSource::SetMode(ClockSource::eSimulated);
+	ClockSource::SetTime(0);
+
+	ReplayCollector	collector(inTrace, inParams);
+	collector.begin();
+
+	const std::vector<STraceSample>&	samples = inTrace.samples;
+	uint32_t	endMS = samples.back().ms;
+	size_t		sampleIndex = 0;
+	for (uint32_t now = samples[0].ms; now <= endMS; now += sStepMS)
+	{
+		ClockSource::SetTime((uint64_t)now * 1000);
+		while (sampleIndex + 1 < samples.size() &&
+			samples[sampleIndex + 1].ms <= now)
+		{
+			sampleIndex++;
+		}
+		collector.SetSampleIndex(sampleIndex);
+		collector.Update();
+	}
+
+	/*
+	*	Score the detected events against the ground truth.
+	*/
+	const std::vector<SEvent>&	events = collector.Events();
+	size_t	eventIndex = 0;
+	bool	wasRunning = false;
+	bool	wasBinFull = false;
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		const STraceSample&	sample = samples[i];
+		uint32_t	nextMS = i + 1 < samples.size() ? samples[i+1].ms : endMS + 1;
+		/*
+		*	Ground truth collector start
+		*/
+		if (sample.dcRunning && !wasRunning)
+		{
+			outResults.starts++;
+			/*
+			*	Find the first detected start before the ground truth stop.
+			*/
+			size_t	j = i;
+			while (j < samples.size() && samples[j].dcRunning)j++;
+			uint32_t	stopMS = j < samples.size() ? samples[j].ms : endMS + 1;
+			bool	detected = false;
+			for (size_t e = 0; e < events.size(); e++)
+			{
+				if (events[e].type == SEvent::eStart &&
+					events[e].ms >= sample.ms && events[e].ms < stopMS)
+				{
+					uint32_t	latency = events[e].ms - sample.ms;
+					outResults.detectedStarts++;
+					outResults.latencySum += latency;
+					if (latency > outResults.latencyMax)
+					{
+						outResults.latencyMax = latency;
+					}
+					detected = true;
+					break;
+				}
+			}
+			if (!detected)
+			{
+				outResults.missedStarts++;
+			}
+		}
+		/*
+		*	Ground truth bin full
+		*/
+		if (sample.binFull && !wasBinFull)
+		{
+			outResults.binFull++;
+			bool	detected = false;
+			for (size_t e = 0; e < events.size(); e++)
+			{
+				if (events[e].type == SEvent::eBinFull &&
+					events[e].ms + sBinFullWindowMS >= sample.ms &&
+					events[e].ms <= sample.ms + sBinFullWindowMS)
+				{
+					detected = true;
+					break;
+				}
+			}
+			if (!detected)
+			{
+				outResults.missedBinFull++;
+			}
+		}
+		wasRunning = sample.dcRunning;
+		wasBinFull = sample.binFull;
+		/*
+		*	Detected events within this sample's time span
+		*/
+		for (; eventIndex < events.size() && events[eventIndex].ms < nextMS; eventIndex++)
+		{
+			const SEvent&	event = events[eventIndex];
+			switch (event.type)
+			{
+				case SEvent::eStart:
+					if (!sample.dcRunning)
+					{
+						outResults.falseStarts++;
+					}
+					break;
+				case SEvent::eStop:
+					if (sample.dcRunning)
+					{
+						outResults.falseStops++;
+					}
+					break;
+				case SEvent::eBinFull:
+				{
+					bool	binFullInWindow = false;
+					for (size_t j = 0; j < samples.size() && !binFullInWindow; j++)
+					{
+						binFullInWindow = samples[j].binFull &&
+							samples[j].ms + sBinFullWindowMS >= event.ms &&
+							samples[j].ms <= event.ms + sBinFullWindowMS;
+					}
+					if (!binFullInWindow)
+					{
+						outResults.falseBinFull++;
+					}
+					break;
+				}
+				case SEvent::eFilterFull:
+					outResults.filterFull++;
+					break;
+			}
+		}
+	}
+}
+
+/******************************** ParseValues *********************************/
+/*
+*	Parses a comma separated list of values and/or first:last:step ranges.
+*/
+static bool ParseValues(
+	const char*				inArg,
+	std::vector<int32_t>&	outValues)
+{
+	outValues.clear();
+	const char*	argPtr = inArg;
+	while (*argPtr)
+	{
+		char*	endPtr;
+		long	first = strtol(argPtr, &endPtr, 10);
+		if (endPtr == argPtr)
+		{
+			return(false);
+		}
+		argPtr = endPtr;
+		if (*argPtr == ':')
+		{
+			long	last = strtol(argPtr+1, &endPtr, 10);
+			long	step = 1;
+			argPtr = endPtr;
+			if (*argPtr == ':')
+			{
+				step = strtol(argPtr+1, &endPtr, 10);
+				argPtr = endPtr;
+			}
+			if (step <= 0)
+			{
+				return(false);
+			}
+			for (long value = first; value <= last; value += step)
+			{
+				outValues.push_back((int32_t)value);
+			}
+		} else
+		{
+			outValues.push_back((int32_t)first);
+		}
+		if (*argPtr == ',')
+		{
+			argPtr++;
+		} else if (*argPtr)
+		{
+			return(false);
+		}
+	}
+	return(!outValues.empty());
+}
+
+/*********************************** Usage ************************************/
+static int Usage(void)
+{
+	fprintf(stderr, "Usage: DCTraceSweep [-r thresholds] [-d deltas] [-a deltaAvgs]"
+					" [-p periodMS] [-f dirtyPa] [-b binThresholds] [-j jobs]"
+					" [-s stepMS] [-w windowS] <trace directory>\n");
+	return(1);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	std::vector<int32_t>	runningThresholds(1, DustCollectorBase::kRunningThreshold);
+	std::vector<int32_t>	numDeltas(1, DustCollectorBase::eNumDeltas);
+	std::vector<int32_t>	numDeltaAvgs(1, DustCollectorBase::eNumDeltaAvgs);
+	std::vector<int32_t>	periods(1, DustCollectorBase::kPressureUpdatePeriod);
+	std::vector<int32_t>	dirtyPressures(1, 800);
+	std::vector<int32_t>	triggerThresholds(1, DustCollectorBase::kDefaultTriggerThreshold);
+	unsigned				numWorkers = 0;
+	const char*				traceDir = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char*	arg = argv[i];
+		if (arg[0] == '-' && arg[1] && !arg[2] && i + 1 < argc)
+		{
+			const char*	valueArg = argv[++i];
+			std::vector<int32_t>	values;
+			if (!ParseValues(valueArg, values))
+			{
+				return(Usage());
+			}
+			switch (arg[1])
+			{
+				case 'r': runningThresholds = values; break;
+				case 'd': numDeltas = values; break;
+				case 'a': numDeltaAvgs = values; break;
+				case 'p': periods = values; break;
+				case 'f': dirtyPressures = values; break;
+				case 'b': triggerThresholds = values; break;
+				case 'j': numWorkers = values[0]; break;
+				case 's': sStepMS = values[0] > 0 ? values[0] : 1; break;
+				case 'w': sBinFullWindowMS = values[0] * 1000; break;
+				default:
+					return(Usage());
+			}
+		} else if (!traceDir)
+		{
+			traceDir = arg;
+		} else
+		{
+			return(Usage());
+		}
+	}
+	if (!traceDir)
+	{
+		return(Usage());
+	}
+
+	/*
+	*	Load the traces
+	*/
+	std::vector<STrace>	traces;
+	{
+		DIR*	dir = opendir(traceDir);
+		if (!dir)
+		{
+			fprintf(stderr, "Can't open %s\n", traceDir);
+			return(1);
+		}
+		std::vector<std::string>	names;
+		while (dirent* entry = readdir(dir))
+		{
+			size_t	nameLen = strlen(entry->d_name);
+			if (nameLen > 4 &&
+				strcmp(&entry->d_name[nameLen-4], ".csv") == 0)
+			{
+				names.push_back(entry->d_name);
+			}
+		}
+		closedir(dir);
+		std::sort(names.begin(), names.end());
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			STrace	trace;
+			trace.name = names[i];
+			if (LoadTrace(std::string(traceDir) + "/" + names[i], trace))
+			{
+				traces.push_back(trace);
+			} else
+			{
+				fprintf(stderr, "Skipping %s, no samples\n", names[i].c_str());
+			}
+		}
+	}
+	if (traces.empty())
+	{
+		fprintf(stderr, "No traces found in %s\n", traceDir);
+		return(1);
+	}
+
+	/*
+	*	Build the parameter grid
+	*/
+	std::vector<SParams>	grid;
+	for (size_t r = 0; r < runningThresholds.size(); r++)
+	for (size_t d = 0; d < numDeltas.size(); d++)
+	for (size_t a = 0; a < numDeltaAvgs.size(); a++)
+	for (size_t p = 0; p < periods.size(); p++)
+	for (size_t f = 0; f < dirtyPressures.size(); f++)
+	for (size_t b = 0; b < triggerThresholds.size(); b++)
+	{
+		SParams	params = {runningThresholds[r], (uint8_t)numDeltas[d],
+						(uint8_t)numDeltaAvgs[a], (uint32_t)periods[p],
+						dirtyPressures[f], (uint8_t)triggerThresholds[b]};
+		grid.push_back(params);
+	}
+
+	/*
+	*	Every trace x combination is a job.  Each job writes to its own result
+	*	slot so there's no locking beyond the pool's queues.
+	*/
+	std::vector<SResults>	jobResults(grid.size() * traces.size());
+	WorkStealingPool		pool(numWorkers);
+	for (size_t g = 0; g < grid.size(); g++)
+	{
+		for (size_t t = 0; t < traces.size(); t++)
+		{
+			SResults*		results = &jobResults[(g * traces.size()) + t];
+			const STrace*	trace = &traces[t];
+			const SParams*	params = &grid[g];
+			pool.Add([trace, params, results](){Replay(*trace, *params, *results);});
+		}
+	}
+	fprintf(stderr, "%zu traces x %zu combinations on %u threads\n",
+		traces.size(), grid.size(), pool.NumWorkers());
+	pool.Run();
+
+	printf("threshold,deltas,deltaAvgs,periodMS,dirtyPa,binThreshold,"
+			"starts,latAvgS,latMaxS,missedStarts,falseStarts,falseStops,"
+			"binFull,missedBinFull,falseBinFull,filterFull\n");
+	for (size_t g = 0; g < grid.size(); g++)
+	{
+		SResults	totals;
+		memset(&totals, 0, sizeof(SResults));
+		for (size_t t = 0; t < traces.size(); t++)
+		{
+			totals.Add(jobResults[(g * traces.size()) + t]);
+		}
+		const SParams&	params = grid[g];
+		printf("%d,%u,%u,%u,%d,%u,%u,%.1f,%.1f,%u,%u,%u,%u,%u,%u,%u\n",
+			params.runningThreshold, params.numDeltas, params.numDeltaAvgs,
+			params.pressureUpdatePeriod, params.dirtyPressure,
+			params.triggerThreshold, totals.starts,
+			totals.detectedStarts ? (double)totals.latencySum/(totals.detectedStarts*1000.0) : 0.0,
+			totals.latencyMax/1000.0, totals.missedStarts, totals.falseStarts,
+			totals.falseStops, totals.binFull, totals.missedBinFull,
+			totals.falseBinFull, totals.filterFull);
+	}
+	return(0);
+}
@@ -0,0 +1,123 @@
+/*
+*	WorkStealingPool.h, Copyright Jonathan Mackey 2026
+*	A minimal work stealing thread pool for host tools.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef WorkStealingPool_h
+#define WorkStealingPool_h
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+*	Each worker owns a deque of jobs.  A worker takes jobs from the back of its
+*	own deque and, once empty, steals from the front of the other workers'
+*	deques.  All jobs are queued before Run() is called, so a worker that
+*	finds every deque empty is done.
+*
+*	Replay jobs vary a lot in length (trace length x parameter combination) so
+*	a static split across threads leaves cores idle near the end.
+*/
+class WorkStealingPool
+{
+public:
+	typedef std::function<void(void)>	Job;
+
+							WorkStealingPool(
+								unsigned				inNumWorkers = 0)
+								: mQueues(inNumWorkers ? inNumWorkers :
+									(std::thread::hardware_concurrency() ?
+										std::thread::hardware_concurrency() : 1)),
+								  mNextQueue(0){}
+	unsigned				NumWorkers(void) const
+								{return((unsigned)mQueues.size());}
+							// Jobs are dealt round robin to the workers.
+	void					Add(
+								Job						inJob)
+							{
+								SQueue&	queue = mQueues[mNextQueue];
+								mNextQueue = (mNextQueue + 1) % mQueues.size();
+								std::lock_guard<std::mutex>	lock(queue.mutex);
+								queue.jobs.push_back(inJob);
+							}
+							// Runs all queued jobs, returns when all are done.
+	void					Run(void)
+							{
+								std::vector<std::thread>	threads;
+								for (unsigned i = 0; i < mQueues.size(); i++)
+								{
+									threads.push_back(std::thread(&WorkStealingPool::Worker, this, i));
+								}
+								for (size_t i = 0; i < threads.size(); i++)
+								{
+									threads[i].join();
+								}
+							}
+protected:
+	struct SQueue
+	{
+		std::mutex		mutex;
+		std::deque<Job>	jobs;
+	};
+	std::vector<SQueue>	mQueues;
+	size_t				mNextQueue;
+
+	bool					TakeJob(
+								unsigned				inWorker,
+								Job&					outJob)
+							{
+								{
+									SQueue&	queue = mQueues[inWorker];
+									std::lock_guard<std::mutex>	lock(queue.mutex);
+									if (!queue.jobs.empty())
+									{
+										outJob = queue.jobs.back();
+										queue.jobs.pop_back();
+										return(true);
+									}
+								}
+								for (size_t i = 1; i < mQueues.size(); i++)
+								{
+									SQueue&	victim = mQueues[(inWorker + i) % mQueues.size()];
+									std::lock_guard<std::mutex>	lock(victim.mutex);
+									if (!victim.jobs.empty())
+									{
+										outJob = victim.jobs.front();
+										victim.jobs.pop_front();
+										return(true);
+									}
+								}
+								return(false);
+							}
+	void					Worker(
+								unsigned				inWorker)
+							{
+								Job	job;
+								while (TakeJob(inWorker, job))
+								{
+									job();
+								}
+							}
+};
+
+#endif // WorkStealingPool_h
@@ -0,0 +1,79 @@
+/*
+*	BenchDisplay.h, Copyright Jonathan Mackey 2026
+*	The display DisplayDispatchBench draws to.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef BenchDisplay_h
+#define BenchDisplay_h
+
+#include "DisplayController.h"
+
+/*
+*	Stands in for TFT_ILI9488 as DISPLAY_STATIC_DRIVER.  Rather than sending
+*	commands and pixels it hashes them, so the two paths can be compared.
+*	Its functions are defined in DisplayDispatchBench.cpp, a different
+*	translation unit than XFont.cpp and DisplayController.cpp, as the
+*	driver's are on the target, so the calls to them aren't inlined.
+*/
+class BenchDisplay final : public DisplayController
+{
+public:
+							BenchDisplay(void);
+	virtual void			MoveTo(
+								uint16_t				inRow,
+								uint16_t				inColumn);
+	virtual void			MoveToRow(
+								uint16_t				inRow);
+	virtual void			MoveToColumn(
+								uint16_t				inColumn);
+	virtual void			Sleep(void){}
+	virtual void			WakeUp(void){}
+	virtual void			FillPixels(
+								uint32_t				inPixelsToFill,
+								uint16_t				inFillColor);
+	virtual void			SetColumnRange(
+								uint16_t				inStartColumn,
+								uint16_t				inEndColumn);
+	virtual void			SetRowRange(
+								uint16_t				inStartRow,
+								uint16_t				inEndRow);
+	virtual void			StreamCopy(
+								DataStream*				inDataStream,
+								uint16_t				inPixelsToCopy);
+	virtual void			CopyPixels(
+								const void*				inPixels,
+								uint16_t				inPixelsToCopy);
+	virtual void			SetAddressingMode(
+								EAddressingMode			inAddressingMode);
+	uint32_t				Hash(void) const
+								{return(mHash);}
+	uint32_t				Calls(void) const
+								{return(mCalls);}
+	void					Reset(void)
+								{mHash = 2166136261U; mCalls = 0;}
+protected:
+	uint32_t	mHash;		// FNV-1a of every call and its arguments
+	uint32_t	mCalls;
+
+	void					Add(
+								uint32_t				inValue);
+};
+
+#endif // BenchDisplay_h
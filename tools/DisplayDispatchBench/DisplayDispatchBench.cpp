@@ -0,0 +1,278 @@
+/*
+*	DisplayDispatchBench.cpp, Copyright Jonathan Mackey 2026
+*	Compares drawing through the vtable with drawing through StaticDisplay.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -D__MACH__ -DDISPLAY_STATIC_DRIVER=BenchDisplay
+*			-I. -I.. -I../../libraries/DisplayController
+*			-I../../libraries/XFont -I../../libraries/DataStream
+*			-I../../DCControllerSTM32 DisplayDispatchBench.cpp
+*			../../libraries/DisplayController/DisplayController.cpp
+*			../../libraries/XFont/XFont.cpp
+*			../../libraries/XFont/XFont16BitDataStream.cpp
+*			../../libraries/DataStream/DataStream.cpp -o DisplayDispatchBench
+*
+*	Usage:
+*		DisplayDispatchBench [-n iterations]
+*
+*	BenchDisplay, declared final, is the DISPLAY_STATIC_DRIVER.  Each case
+*	is drawn n (default 20000) times with the display not selected (every
+*	driver call through the vtable, as a build without DISPLAY_STATIC_DRIVER
+*	draws) and then selected (StaticDisplay::Select), best of 5 runs each.
+*	The time per draw, the driver calls per draw and the ratio are printed.
+*	BenchDisplay hashes every call it receives, the hashes of the two paths
+*	must be the same.  The exit status is the number of cases that differ.
+*
+*	BenchDisplay does no pixel work, so the ratio is the most the dispatch
+*	saves.  On the target each call also sends SPI commands.
+*
+*	To compare the flash used, build the objects for the target with and
+*	without -DDISPLAY_STATIC_DRIVER=TFT_ILI9488 and compare the text sizes
+*	of DisplayController.o and XFont.o (arm-none-eabi-size), or the Largest
+*	symbols of DCMapReport for the two maps.  Both paths are in the image
+*	when the flag is defined, the virtual one for ScreenCapture.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include "pgmspace_stub.h"
+#include "BenchDisplay.h"
+#include "DataStream.h"
+#include "DisplayT.h"
+#include "XFont.h"
+XFont	xFont;	// Referenced by the font headers
+#include "MyriadPro-Regular_20.h"
+#include "MyriadPro-Regular_20_1b.h"
+
+static const uint16_t	kColumns = 480;
+static const uint16_t	kRows = 320;
+
+/******************************** BenchDisplay ********************************/
+BenchDisplay::BenchDisplay(void)
+	: DisplayController(kRows, kColumns)
+{
+	Reset();
+}
+
+/************************************ Add *************************************/
+void BenchDisplay::Add(
+	uint32_t	inValue)
+{
+	mHash = (mHash ^ inValue) * 16777619U;
+}
+
+/*********************************** MoveTo ***********************************/
+void BenchDisplay::MoveTo(
+	uint16_t	inRow,
+	uint16_t	inColumn)
+{
+	mRow = inRow;
+	mColumn = inColumn;
+	mCalls++;
+	Add(((uint32_t)inRow << 16) + inColumn);
+}
+
+/********************************* MoveToRow **********************************/
+void BenchDisplay::MoveToRow(
+	uint16_t	inRow)
+{
+	mRow = inRow;
+	mCalls++;
+	Add(0x10000000 + inRow);
+}
+
+/******************************** MoveToColumn ********************************/
+void BenchDisplay::MoveToColumn(
+	uint16_t	inColumn)
+{
+	mColumn = inColumn;
+	mCalls++;
+	Add(0x20000000 + inColumn);
+}
+
+/********************************* FillPixels *********************************/
+void BenchDisplay::FillPixels(
+	uint32_t	inPixelsToFill,
+	uint16_t	inFillColor)
+{
+	mCalls++;
+	Add(inPixelsToFill);
+	Add(inFillColor);
+}
+
+/******************************* SetColumnRange *******************************/
+void BenchDisplay::SetColumnRange(
+	uint16_t	inStartColumn,
+	uint16_t	inEndColumn)
+{
+	mCalls++;
+	Add(((uint32_t)inStartColumn << 16) + inEndColumn + 0x30000000);
+}
+
+/******************************** SetRowRange *********************************/
+void BenchDisplay::SetRowRange(
+	uint16_t	inStartRow,
+	uint16_t	inEndRow)
+{
+	mCalls++;
+	Add(((uint32_t)inStartRow << 16) + inEndRow + 0x40000000);
+}
+
+/********************************* StreamCopy *********************************/
+void BenchDisplay::StreamCopy(
+	DataStream*	inDataStream,
+	uint16_t	inPixelsToCopy)
+{
+	uint16_t	buffer[32];
+	mCalls++;
+	while (inPixelsToCopy)
+	{
+		uint16_t	pixels = inPixelsToCopy > 32 ? 32 : inPixelsToCopy;
+		inDataStream->Read(pixels, buffer);
+		for (uint16_t i = 0; i < pixels; i++)
+		{
+			Add(buffer[i]);
+		}
+		inPixelsToCopy -= pixels;
+	}
+}
+
+/********************************* CopyPixels *********************************/
+void BenchDisplay::CopyPixels(
+	const void*	inPixels,
+	uint16_t	inPixelsToCopy)
+{
+	mCalls++;
+	for (uint16_t i = 0; i < inPixelsToCopy; i++)
+	{
+		Add(((const uint16_t*)inPixels)[i]);
+	}
+}
+
+/***************************** SetAddressingMode ******************************/
+void BenchDisplay::SetAddressingMode(
+	EAddressingMode	inAddressingMode)
+{
+	mAddressingMode = inAddressingMode;
+	mCalls++;
+	Add(0x50000000 + inAddressingMode);
+}
+
+static const char kTextStr[] = "Duct: 4.25 in  Filter 72%";
+
+/************************************ Draw ************************************/
+static void Draw(
+	BenchDisplay&	inDisplay,
+	uint8_t			inCase,
+	uint32_t		inIteration)
+{
+	uint16_t	x = (inIteration * 7) % 400;
+	uint16_t	y = (inIteration * 13) % 280;
+	switch (inCase)
+	{
+		case 0:
+		case 1:
+			inDisplay.MoveTo(y, x % 100);
+			xFont.DrawStr(kTextStr);
+			break;
+		case 2:
+			inDisplay.FillRect(x, y, 8, 8, inIteration);
+			break;
+		case 3:
+			inDisplay.DrawFrame(x, y, 60, 30, inIteration, 2);
+			break;
+		case 4:
+			inDisplay.DrawRoundedRect(x, y, 70, 30, 8);
+			break;
+	}
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	iterations = 20000;
+	int	opt;
+	while ((opt = getopt(argc, argv, "n:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n':
+				iterations = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			default:
+				fprintf(stderr, "Usage: DisplayDispatchBench [-n iterations]\n");
+				return(255);
+		}
+	}
+	static const char* const	kCaseNames[] =
+	{
+		"DrawStr, 8-bit font",
+		"DrawStr, 1-bit font",
+		"FillRect 8 x 8",
+		"DrawFrame",
+		"DrawRoundedRect"
+	};
+	BenchDisplay	display;
+	uint32_t	mismatches = 0;
+	printf("%-20s %10s %10s %7s %8s\n", "", "vtable ns", "static ns", "ratio", "calls");
+	for (uint8_t c = 0; c < 5; c++)
+	{
+		xFont.SetDisplay(&display, c == 1 ? &MyriadPro_Regular_20_1b::font :
+			&MyriadPro_Regular_20::font);
+		xFont.SetTextColor(XFont::eWhite);
+		xFont.SetBGTextColor(XFont::eBlack);
+		double		bestNS[2] = {1e30, 1e30};
+		uint32_t	hash[2];
+		uint32_t	calls = 0;
+		for (uint8_t run = 0; run < 10; run++)
+		{
+			uint8_t	path = run & 1;
+			StaticDisplay::Select(path ? &display : nullptr);
+			display.Reset();
+			auto	start = std::chrono::steady_clock::now();
+			for (uint32_t i = 0; i < iterations; i++)
+			{
+				Draw(display, c, i);
+			}
+			double	ns = std::chrono::duration<double, std::nano>(
+							std::chrono::steady_clock::now() - start).count() / iterations;
+			if (ns < bestNS[path])
+			{
+				bestNS[path] = ns;
+			}
+			hash[path] = display.Hash();
+			calls = display.Calls();
+		}
+		printf("%-20s %10.1f %10.1f %7.2f %8.1f\n", kCaseNames[c],
+			bestNS[0], bestNS[1], bestNS[0]/bestNS[1], (double)calls/iterations);
+		if (hash[0] != hash[1])
+		{
+			printf("  %s drew differently\n", kCaseNames[c]);
+			mismatches++;
+		}
+	}
+	StaticDisplay::Select(nullptr);
+	return(mismatches > 255 ? 255 : mismatches);
+}
@@ -0,0 +1,187 @@
+/*
+*	ISREventsStress.cpp, Copyright Jonathan Mackey 2026
+*	Stress test of the ISREvents queue with a producer thread standing in
+*	for the interrupt handlers.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -D__MACH__ -I../../libraries/ISREvents
+*			-I../../libraries/MSPeriod ISREventsStress.cpp
+*			../../libraries/ISREvents/ISREvents.cpp
+*			../../libraries/MSPeriod/ClockSource.cpp -lpthread -o ISREventsStress
+*
+*	Usage:
+*		ISREventsStress [-n events] [-s seed]
+*
+*	The producer thread pushes n events (default 10,000,000) in random
+*	bursts, some longer than the queue, pausing or yielding between bursts.
+*	Event i has type 1 + i % 4 and data i & 0xFFFF.  The main thread pops
+*	concurrently, also pausing or yielding at random, and checks that:
+*	- the events arrive in order, the data of each is one past the last,
+*	plus the number dropped in between.
+*	- the type of each event matches its data (no torn events.)
+*	- the timestamps don't go backwards.
+*	- the events dropped are the events counted by Overflows(), per type,
+*	and pushed = popped + dropped.
+*	The exit status is the number of failed checks (255 at most.)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include "ISREvents.h"
+
+static std::atomic<bool>	sProducerDone;
+
+/********************************** Producer **********************************/
+static void Producer(
+	uint32_t	inEvents,
+	uint32_t	inSeed,
+	uint32_t*	outDropped)	// Per type
+{
+	srand(inSeed);
+	uint32_t	event = 0;
+	while (event < inEvents)
+	{
+		uint32_t	burst = 1 + rand() % (ISREvents::eSize * 2);
+		for (; burst && event < inEvents; burst--, event++)
+		{
+			uint8_t	type = 1 + event % 4;
+			if (!ISREvents::Push(type, event & 0xFFFF))
+			{
+				outDropped[type]++;
+			}
+		}
+		if (rand() & 1)
+		{
+			std::this_thread::yield();	// Lets a single core pop
+		} else
+		{
+			for (uint32_t spin = rand() % 2000; spin; spin--)
+			{
+				std::atomic_signal_fence(std::memory_order_seq_cst);
+			}
+		}
+	}
+	sProducerDone = true;
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	events = 10000000;
+	uint32_t	seed = 1;
+	int	opt;
+	while ((opt = getopt(argc, argv, "n:s:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n':
+				events = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 's':
+				seed = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			default:
+				fprintf(stderr, "Usage: ISREventsStress [-n events] [-s seed]\n");
+				return(255);
+		}
+	}
+	uint32_t	dropped[ISREvents::eNumTypes] = {};
+	std::thread	producer(Producer, events, seed, dropped);
+	uint32_t	failures = 0;
+	uint32_t	popped = 0;
+	uint32_t	gaps = 0;		// Events dropped, from the data
+	uint32_t	next = 0;		// The event expected next
+	uint32_t	lastTime = 0;
+	bool		first = true;
+	SISREvent	event;
+	srand(seed + 1);
+	for (bool done = false; !done;)
+	{
+		done = sProducerDone;	// Before the last drain
+		while (ISREvents::Pop(event))
+		{
+			uint32_t	skipped = (uint16_t)(event.data - next);
+			uint32_t	received = next + skipped;
+			if (event.type != 1 + received % 4)
+			{
+				if (failures++ < 10)
+				{
+					printf("event %u: type %u, data 0x%04X\n", received, event.type, event.data);
+				}
+			}
+			if (!first &&
+				(int32_t)(event.time - lastTime) < 0)
+			{
+				if (failures++ < 10)
+				{
+					printf("event %u: time %u before %u\n", received, event.time, lastTime);
+				}
+			}
+			lastTime = event.time;
+			first = false;
+			gaps += skipped;
+			next = received + 1;
+			popped++;
+		}
+		if (rand() & 1)
+		{
+			std::this_thread::yield();
+		} else
+		{
+			for (uint32_t spin = rand() % 3000; spin; spin--)
+			{
+				std::atomic_signal_fence(std::memory_order_seq_cst);
+			}
+		}
+	}
+	producer.join();
+	uint32_t	totalDropped = 0;
+	for (uint8_t type = 1; type < ISREvents::eNumTypes; type++)
+	{
+		totalDropped += dropped[type];
+		if (dropped[type] != ISREvents::Overflows(type))
+		{
+			failures++;
+			printf("type %u: dropped %u, overflows %u\n", type, dropped[type], ISREvents::Overflows(type));
+		}
+	}
+	/*
+	*	A gap of 65536 or more isn't seen in the data, it shows up here.
+	*/
+	if (gaps + (events - next) != totalDropped)
+	{
+		failures++;
+		printf("gaps %u + %u missing at the end, dropped %u\n", gaps, events - next, totalDropped);
+	}
+	if (popped + totalDropped != events)
+	{
+		failures++;
+		printf("popped %u + dropped %u != pushed %u\n", popped, totalDropped, events);
+	}
+	printf("pushed %u, popped %u, dropped %u, high water %u of %u, %u failures\n",
+		events, popped, totalDropped, ISREvents::HighWater(), ISREvents::eSize, failures);
+	return(failures < 255 ? failures : 255);
+}
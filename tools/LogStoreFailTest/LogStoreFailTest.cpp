@@ -0,0 +1,235 @@
+/*
+*	LogStoreFailTest.cpp, Copyright Jonathan Mackey 2026
+*	Power failure test of LogStore using a file in place of the EEPROM.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -D__MACH__ -I../../libraries/LogStore
+*			-I../../libraries/DataStream -I../../libraries/CRC
+*			LogStoreFailTest.cpp ../../libraries/LogStore/LogStore.cpp
+*			../../libraries/DataStream/FileDataStream.cpp
+*			../../libraries/CRC/CRC16.cpp -o LogStoreFailTest
+*
+*	Usage:
+*		LogStoreFailTest [-i iterations] [-n slots] [-s seed] [file]
+*	file defaults to LogStoreFailTest.bin.  It is erased at the start.
+*
+*	Each iteration mounts the store, appends a random number of records and
+*	then "loses power" at a random byte of a random append.  Bytes of the
+*	interrupted write after the cut are either left as is or filled with
+*	random values (an EEPROM page write interrupted part way through leaves
+*	the page undefined.)  The store is then remounted and checked:
+*	- the next sequence is one past the last acknowledged append.
+*	- every acknowledged record still within the log reads back intact,
+*	except the oldest.  The interrupted write was to the oldest record's slot
+*	so it's expected to be gone once the log has wrapped.
+*	The exit status is the number of failed iterations.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LogStore.h"
+#include "FileDataStream.h"
+
+/*
+*	A FileDataStream that stops writing after mWriteBudget bytes.
+*/
+class FailingFileDataStream : public FileDataStream
+{
+public:
+							FailingFileDataStream(
+								const char*				inPath,
+								uint32_t				inLength)
+								: FileDataStream(inPath, inLength),
+								  mWriteBudget(0xFFFFFFFF), mGarbage(false){}
+	void					SetWriteBudget(
+								uint32_t				inWriteBudget,
+								bool					inGarbage)
+								{mWriteBudget = inWriteBudget; mGarbage = inGarbage;}
+	bool					PowerFailed(void) const
+								{return(mWriteBudget == 0);}
+	virtual uint32_t		Write(
+								uint32_t				inLength,
+								const void*				inBuffer)
+							{
+								if (inLength <= mWriteBudget)
+								{
+									if (mWriteBudget != 0xFFFFFFFF)
+									{
+										mWriteBudget -= inLength;
+									}
+									return(FileDataStream::Write(inLength, inBuffer));
+								}
+								uint32_t	bytesWritten = FileDataStream::Write(mWriteBudget, inBuffer);
+								if (mGarbage)
+								{
+									uint8_t		garbage[LogStore::eMaxSlotSize];
+									uint32_t	garbageLen = inLength - bytesWritten;
+									for (uint32_t i = 0; i < garbageLen; i++)
+									{
+										garbage[i] = (uint8_t)rand();
+									}
+									FileDataStream::Write(garbageLen, garbage);
+								}
+								mWriteBudget = 0;
+								return(bytesWritten);
+							}
+protected:
+	uint32_t	mWriteBudget;
+	bool		mGarbage;
+};
+
+/******************************* MakePayload **********************************/
+/*
+*	The payload is derived from the sequence so it can be checked after a
+*	remount without keeping a copy.
+*/
+static uint8_t MakePayload(
+	uint32_t	inSequence,
+	uint8_t		inMaxPayload,
+	uint8_t*	outPayload)
+{
+	uint32_t	hash = inSequence * 2654435761U;
+	uint8_t		length = (uint8_t)(hash % (inMaxPayload + 1));
+	for (uint8_t i = 0; i < length; i++)
+	{
+		hash = hash * 1103515245 + 12345;
+		outPayload[i] = (uint8_t)(hash >> 16);
+	}
+	return(length);
+}
+
+/*********************************** Usage ************************************/
+static int Usage(void)
+{
+	fprintf(stderr, "Usage: LogStoreFailTest [-i iterations] [-n slots] [-s seed] [file]\n");
+	return(-1);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	iterations = 1000;
+	uint32_t	numSlots = 113;		// The AT24C64 region in DCControllerSTM32
+	uint32_t	seed = 1;
+	const char*	path = "LogStoreFailTest.bin";
+	for (int i = 1; i < argc; i++)
+	{
+		const char*	arg = argv[i];
+		if (arg[0] == '-' && arg[1] && !arg[2] && i + 1 < argc)
+		{
+			uint32_t	value = (uint32_t)strtoul(argv[++i], nullptr, 10);
+			switch (arg[1])
+			{
+				case 'i': iterations = value; break;
+				case 'n': numSlots = value > 2 ? value : 2; break;
+				case 's': seed = value; break;
+				default:
+					return(Usage());
+			}
+		} else if (arg[0] != '-')
+		{
+			path = arg;
+		} else
+		{
+			return(Usage());
+		}
+	}
+	srand(seed);
+	const uint16_t	kSlotSize = 32;
+	remove(path);
+	uint32_t	failures = 0;
+	uint32_t	acknowledged = 0;	// Next sequence expected after a remount
+	uint32_t	tornWrites = 0;
+	for (uint32_t iteration = 0; iteration < iterations; iteration++)
+	{
+		FailingFileDataStream	stream(path, numSlots * kSlotSize);
+		LogStore	store(&stream, kSlotSize);
+		if (!store.Mount())
+		{
+			fprintf(stderr, "Mount failed\n");
+			return(-1);
+		}
+		/*
+		*	Verify the state left by the previous iteration.
+		*/
+		bool	failed = false;
+		if (store.NextSequence() != acknowledged)
+		{
+			fprintf(stderr, "%u: next sequence %u, expected %u\n", iteration,
+				store.NextSequence(), acknowledged);
+			failed = true;
+		}
+		uint32_t	oldest = acknowledged > numSlots ? acknowledged - numSlots : 0;
+		if (store.OldestSequence() != oldest)
+		{
+			fprintf(stderr, "%u: oldest sequence %u, expected %u\n", iteration,
+				store.OldestSequence(), oldest);
+			failed = true;
+		}
+		uint8_t		payload[LogStore::eMaxSlotSize];
+		uint8_t		expected[LogStore::eMaxSlotSize];
+		for (uint32_t seq = oldest ? oldest + 1 : 0; seq < acknowledged; seq++)
+		{
+			LogStore::SHeader	header;
+			uint8_t	length = MakePayload(seq, store.MaxPayload(), expected);
+			if (!store.Read(seq, header, payload) ||
+				header.type != (uint8_t)seq ||
+				header.length != length ||
+				memcmp(payload, expected, length))
+			{
+				fprintf(stderr, "%u: record %u is missing or damaged\n", iteration, seq);
+				failed = true;
+			}
+		}
+		if (failed)
+		{
+			failures++;
+			/*
+			*	Continue from what the store recovered.
+			*/
+			acknowledged = store.NextSequence();
+		}
+
+		/*
+		*	Append till the power fails.  The cut is somewhere within the
+		*	next few hundred records, which exercises wrapping.
+		*/
+		uint32_t	budget = (uint32_t)rand() % (numSlots * kSlotSize * 3);
+		stream.SetWriteBudget(budget, (rand() & 1) != 0);
+		while (!stream.PowerFailed())
+		{
+			uint8_t	length = MakePayload(store.NextSequence(), store.MaxPayload(), payload);
+			if (store.Append((uint8_t)store.NextSequence(), payload, length))
+			{
+				acknowledged = store.NextSequence();
+			} else
+			{
+				tornWrites++;
+			}
+		}
+	}
+	printf("%u iterations, %u torn writes, %u records, %u failures\n",
+		iterations, tornWrites, acknowledged, failures);
+	return(failures);
+}
@@ -0,0 +1,262 @@
+/*
+*	TouchCalTest.cpp, Copyright Jonathan Mackey 2026
+*	Checks the TouchCalibration fit against synthetic skewed touch panels.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -I../../libraries/XPT2046 TouchCalTest.cpp
+*			../../libraries/XPT2046/TouchCalibration.cpp -o TouchCalTest
+*
+*	Usage:
+*		TouchCalTest [-i iterations] [-s seed] [-n noise]
+*
+*	Each iteration makes a random panel: the raw values are an affine
+*	function of the display position with a scale of 0.7 to 0.95 times
+*	nominal, up to 4 degrees of rotation, up to 3% skew, offsets of up to
+*	200 counts and either axis possibly inverted.  Panels with a display
+*	corner outside the 12 bit raw range are skipped.  The points touched are
+*	the five ST77XXToXPT2046Alignment targets, twice, with the raw values
+*	rounded to whole counts (plus up to +/- noise counts.)  The fit is then
+*	checked over a grid covering the 480 x 320 display:
+*	- the Q16 position before rounding to a pixel is within 0.25 pixels
+*	(1 pixel when noise is added.)
+*	- after storing as min/max + skew and restoring, within 0.5 pixels
+*	(1.25 when noise is added.)
+*	- collinear points are rejected.
+*	The exit status is the number of failed iterations (255 at most.)
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "TouchCalibration.h"
+
+static const uint16_t	kColumns = 480;
+static const uint16_t	kRows = 320;
+static const uint16_t	kInset = 20;
+
+/*
+*	The display to raw mapping of a synthetic panel.
+*/
+struct SPanel
+{
+	double	m[6];	// rawX = m0*x + m1*y + m2, rawY = m3*x + m4*y + m5
+
+	void Raw(
+		double		inX,
+		double		inY,
+		double&		outRawX,
+		double&		outRawY) const
+	{
+		outRawX = m[0]*inX + m[1]*inY + m[2];
+		outRawY = m[3]*inX + m[4]*inY + m[5];
+	}
+};
+
+/*********************************** Random ***********************************/
+static double Random(
+	double	inMin,
+	double	inMax)
+{
+	return(inMin + (inMax - inMin) * rand() / RAND_MAX);
+}
+
+/********************************* MakePanel **********************************/
+/*
+*	Nominally the full 0 to 4095 raw range covers the display.
+*/
+static SPanel MakePanel(void)
+{
+	SPanel	panel;
+	for (bool onPanel = false; !onPanel;)
+	{
+		double	angle = Random(-4, 4) * M_PI / 180;
+		double	skew = Random(-0.03, 0.03);
+		double	scaleX = Random(0.7, 0.95) * 4095 / kColumns * (rand() & 1 ? -1 : 1);
+		double	scaleY = Random(0.7, 0.95) * 4095 / kRows * (rand() & 1 ? -1 : 1);
+		panel.m[0] = scaleX * cos(angle);
+		panel.m[1] = scaleY * (skew - sin(angle));
+		panel.m[3] = scaleX * sin(angle);
+		panel.m[4] = scaleY * cos(angle);
+		// Center the display in the raw range, then offset.
+		double	rawX, rawY;
+		panel.m[2] = panel.m[5] = 0;
+		panel.Raw(kColumns/2.0, kRows/2.0, rawX, rawY);
+		panel.m[2] = 2048 - rawX + Random(-200, 200);
+		panel.m[5] = 2048 - rawY + Random(-200, 200);
+		onPanel = true;
+		for (uint8_t corner = 0; corner < 4 && onPanel; corner++)
+		{
+			panel.Raw((corner & 1) ? kColumns : 0, (corner & 2) ? kRows : 0, rawX, rawY);
+			onPanel = rawX >= 0 && rawX <= 4095 && rawY >= 0 && rawY <= 4095;
+		}
+	}
+	return(panel);
+}
+
+/*********************************** Touch ************************************/
+static STouchPoint Touch(
+	const SPanel&	inPanel,
+	int16_t			inX,
+	int16_t			inY,
+	int				inNoise)
+{
+	double	rawX, rawY;
+	inPanel.Raw(inX, inY, rawX, rawY);
+	STouchPoint	point;
+	int	noiseX = inNoise ? rand() % (inNoise*2 + 1) - inNoise : 0;
+	int	noiseY = inNoise ? rand() % (inNoise*2 + 1) - inNoise : 0;
+	point.rawX = (uint16_t)lround(rawX) + noiseX;
+	point.rawY = (uint16_t)lround(rawY) + noiseY;
+	point.x = inX;
+	point.y = inY;
+	return(point);
+}
+
+/********************************** MaxError **********************************/
+/*
+*	The largest distance between where a touch was and where the calibration
+*	puts it, over a grid of the display.
+*/
+static double MaxError(
+	const SPanel&			inPanel,
+	const TouchCalibration&	inCalibration)
+{
+	const int32_t*	matrix = inCalibration.Matrix();
+	double	maxError = 0;
+	for (double y = 0; y <= kRows; y += kRows/16.0)
+	{
+		for (double x = 0; x <= kColumns; x += kColumns/16.0)
+		{
+			double	rawX, rawY;
+			inPanel.Raw(x, y, rawX, rawY);
+			// The raw values the XPT2046 would return
+			int32_t	rx = lround(rawX);
+			int32_t	ry = lround(rawY);
+			double	calX = (matrix[0]*rx + matrix[1]*ry + matrix[2]) / 65536.0;
+			double	calY = (matrix[3]*rx + matrix[4]*ry + matrix[5]) / 65536.0;
+			double	error = hypot(calX - x, calY - y);
+			if (error > maxError)
+			{
+				maxError = error;
+			}
+		}
+	}
+	return(maxError);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	iterations = 10000;
+	uint32_t	seed = 1;
+	int			noise = 0;
+	int	opt;
+	while ((opt = getopt(argc, argv, "i:s:n:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'i':
+				iterations = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 's':
+				seed = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'n':
+				noise = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "Usage: TouchCalTest [-i iterations] [-s seed] [-n noise]\n");
+				return(255);
+		}
+	}
+	srand(seed);
+	const int16_t	kTargets[][2] =
+	{
+		{kInset, kInset},
+		{kColumns-kInset, kRows-kInset},
+		{kColumns-kInset, kInset},
+		{kInset, kRows-kInset},
+		{kColumns/2, kRows*3/4}
+	};
+	const double	kFitLimit = noise ? 1.0 : 0.25;
+	const double	kStoredLimit = noise ? 1.25 : 0.5;
+	uint32_t	failures = 0;
+	double		worstFit = 0;
+	double		worstStored = 0;
+	for (uint32_t iteration = 0; iteration < iterations; iteration++)
+	{
+		SPanel		panel = MakePanel();
+		STouchPoint	points[10];
+		for (uint8_t i = 0; i < 10; i++)
+		{
+			points[i] = Touch(panel, kTargets[i % 5][0], kTargets[i % 5][1], noise);
+		}
+		TouchCalibration	calibration;
+		bool	solved = calibration.Solve(points, 10);
+		double	fitError = solved ? MaxError(panel, calibration) : 1e9;
+
+		uint16_t	minMax[4];
+		int16_t		xSkew, ySkew;
+		calibration.GetMinMax(minMax, xSkew, ySkew, kColumns, kRows);
+		TouchCalibration	stored;
+		stored.SetMinMax(minMax, xSkew, ySkew, kColumns, kRows);
+		double	storedError = MaxError(panel, stored);
+
+		// Three points along a line (the diagonal) can't be solved.
+		STouchPoint	line[3] =
+		{
+			Touch(panel, kInset, kInset, 0),
+			Touch(panel, kColumns/2, kRows/2, 0),
+			Touch(panel, kColumns-kInset, kRows-kInset, 0)
+		};
+		line[1].x = (line[0].x + line[2].x)/2;
+		line[1].y = (line[0].y + line[2].y)/2;
+		line[1].rawX = (line[0].rawX + line[2].rawX)/2;
+		line[1].rawY = (line[0].rawY + line[2].rawY)/2;
+		TouchCalibration	collinear;
+		bool	rejected = !collinear.Solve(line, 3);
+
+		if (fitError > worstFit)
+		{
+			worstFit = fitError;
+		}
+		if (storedError > worstStored)
+		{
+			worstStored = storedError;
+		}
+		if (fitError > kFitLimit ||
+			storedError > kStoredLimit ||
+			!rejected)
+		{
+			if (failures++ < 10)
+			{
+				printf("iteration %u: fit %.3f, stored %.3f px%s\n", iteration,
+					fitError, storedError, rejected ? "" : ", collinear solved");
+			}
+		}
+	}
+	printf("%u iterations, worst fit %.3f px, worst stored %.3f px, %u failures\n",
+		iterations, worstFit, worstStored, failures);
+	return(failures < 255 ? failures : 255);
+}
@@ -0,0 +1,336 @@
+/*
+*	XLabelTableCheck.cpp, Copyright Jonathan Mackey 2026
+*	Checks that an XLabelTable draws and hits the same as the XLabels it
+*	replaces.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -D__MACH__ -I.. -I../../libraries/XView
+*			-I../../libraries/DisplayController -I../../libraries/XFont
+*			-I../../libraries/DataStream -I../../DCControllerSTM32
+*			XLabelTableCheck.cpp ../../libraries/XView/XView.cpp
+*			../../libraries/XView/XRootView.cpp
+*			../../libraries/XView/XColoredView.cpp
+*			../../libraries/XView/XLabel.cpp
+*			../../libraries/XView/XLabelTable.cpp
+*			../../libraries/XFont/XFont.cpp
+*			../../libraries/XFont/XFont16BitDataStream.cpp
+*			../../libraries/DisplayController/DisplayController.cpp
+*			../../libraries/DataStream/DataStream.cpp -o XLabelTableCheck
+*
+*	Usage:
+*		XLabelTableCheck [-a areas] [-s seed]
+*
+*	The labels of the DCXViews info view and dialogs (all three alignments,
+*	both background colors) are built twice within a panel: as XLabels and
+*	as one XLabelTable.  A display that logs every call it receives, with
+*	the pixel data, records each drawing.
+*
+*	1. a (default 3000) random areas are drawn from the root view, the first
+*	the whole display.  After a third of them some labels are disabled, after
+*	two thirds some are hidden.  The two logs must be the same.
+*	2. Every point of the display is hit tested.  Where an XLabel is hit the
+*	table must be hit, elsewhere the same panel or root view.
+*	3. DrawSelf of the visible labels and of the table must log the same.
+*
+*	Then the RAM each costs on this host is printed.  For the target, compare
+*	DCMapReport -v DCXViews.h before and after.  The exit status is the
+*	number of mismatches (255 at most.)
+*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include "pgmspace_stub.h"
+#include "DisplayController.h"
+#include "DataStream.h"
+#include "XFont.h"
+XFont	xFont;	// Referenced by the font header
+#include "MyriadPro-Regular_20_1b.h"
+#include "XColoredView.h"
+#include "XLabelTable.h"
+#include "XRootView.h"
+
+#define UI20ptFont	MyriadPro_Regular_20_1b::font
+
+static const uint16_t	kColumns = 480;
+static const uint16_t	kRows = 320;
+static const uint16_t	kRowHeight = 36;
+static const uint16_t	kLabelYAdj = 4;
+static const uint16_t	kDialogBGColor = 0xF77D;
+
+static const char kStartsPerHourStr[] = "Starts per hour:";
+static const char kTemperatureStr[] = "Temperature:";
+static const char kDuctPresStr[] = "Duct:";
+static const char kCleanPresStr[] = "\"Clean\" pressure:";
+static const char kDustBinMotorStr[] = "Dust bin motor:";
+static const char kSoftwareNameStr[] = "Dust Collector Monitor";
+static const char kVersionStr[] = "STM32 version 1.0";
+
+static const XLabelSpec	kLabels[] =
+{
+	{0, kRowHeight, 170, 26, 1, kStartsPerHourStr,
+		&UI20ptFont, XFont::eWhite, XFont::eBlack, XFont::eAlignRight},
+	{0, (kRowHeight*2), 170, 26, 2, kTemperatureStr,
+		&UI20ptFont, XFont::eWhite, XFont::eBlack, XFont::eAlignRight},
+	{180, (kRowHeight*2), 100, 26, 3, kDuctPresStr,
+		&UI20ptFont, XFont::eCyan, XFont::eBlack, XFont::eAlignLeft},
+	{0, kLabelYAdj + (kRowHeight*3), 150, 26, 4, kCleanPresStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignRight},
+	{160, kLabelYAdj + (kRowHeight*4), 232, 26, 5, kDustBinMotorStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignRight},
+	{40, (kRowHeight*5), 280, 26, 6, kSoftwareNameStr,
+		&UI20ptFont, XFont::eBlack, kDialogBGColor, XFont::eAlignCenter},
+	{300, (kRowHeight*6), 120, 26, 7, kVersionStr,
+		&UI20ptFont, XFont::eYellow, XFont::eBlack, XFont::eAlignLeft}
+};
+static const uint8_t	kLabelCount = sizeof(kLabels)/sizeof(kLabels[0]);
+
+/*
+*	Logs each call with its arguments and pixels.
+*/
+class LogDisplay : public DisplayController
+{
+public:
+							LogDisplay(void)
+								: DisplayController(kRows, kColumns){}
+	virtual void			MoveTo(
+								uint16_t				inRow,
+								uint16_t				inColumn)
+								{Log("M%u,%u;", inRow, inColumn);
+								 mRow = inRow; mColumn = inColumn;}
+	virtual void			MoveToRow(
+								uint16_t				inRow)
+								{Log("R%u;", inRow); mRow = inRow;}
+	virtual void			MoveToColumn(
+								uint16_t				inColumn)
+								{Log("C%u;", inColumn); mColumn = inColumn;}
+	virtual void			Sleep(void){}
+	virtual void			WakeUp(void){}
+	virtual void			FillPixels(
+								uint32_t				inPixelsToFill,
+								uint16_t				inFillColor)
+								{Log("F%u,%X;", inPixelsToFill, inFillColor);}
+	virtual void			SetColumnRange(
+								uint16_t				inStartColumn,
+								uint16_t				inEndColumn)
+								{Log("CR%u,%u;", inStartColumn, inEndColumn);}
+	virtual void			SetRowRange(
+								uint16_t				inStartRow,
+								uint16_t				inEndRow)
+								{Log("RR%u,%u;", inStartRow, inEndRow);}
+	virtual void			StreamCopy(
+								DataStream*				inDataStream,
+								uint16_t				inPixelsToCopy);
+	virtual void			CopyPixels(
+								const void*				inPixels,
+								uint16_t				inPixelsToCopy);
+	virtual void			SetAddressingMode(
+								EAddressingMode			inAddressingMode)
+								{Log("A%d;", inAddressingMode);}
+	std::string				mLog;
+protected:
+	void					Log(
+								const char*				inFormat,
+								...);
+};
+
+/************************************* Log ************************************/
+void LogDisplay::Log(
+	const char*	inFormat,
+	...)
+{
+	char	buffer[64];
+	va_list	args;
+	va_start(args, inFormat);
+	vsnprintf(buffer, sizeof(buffer), inFormat, args);
+	va_end(args);
+	mLog += buffer;
+}
+
+/********************************* StreamCopy *********************************/
+void LogDisplay::StreamCopy(
+	DataStream*	inDataStream,
+	uint16_t	inPixelsToCopy)
+{
+	Log("S%u:", inPixelsToCopy);
+	for (uint16_t i = 0; i < inPixelsToCopy; i++)
+	{
+		uint16_t	pixel;
+		inDataStream->Read(1, &pixel);
+		Log("%X.", pixel);
+	}
+}
+
+/********************************* CopyPixels *********************************/
+void LogDisplay::CopyPixels(
+	const void*	inPixels,
+	uint16_t	inPixelsToCopy)
+{
+	Log("P%u:", inPixelsToCopy);
+	for (uint16_t i = 0; i < inPixelsToCopy; i++)
+	{
+		Log("%X.", ((const uint16_t*)inPixels)[i]);
+	}
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	areas = 3000;
+	uint32_t	seed = 1;
+	int	opt;
+	while ((opt = getopt(argc, argv, "a:s:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'a':
+				areas = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 's':
+				seed = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			default:
+				fprintf(stderr, "Usage: XLabelTableCheck [-a areas] [-s seed]\n");
+				return(255);
+		}
+	}
+	srand(seed);
+	LogDisplay	display;
+	xFont.SetDisplay(&display, &UI20ptFont);
+
+	XLabel*	labels[kLabelCount];
+	XView*	nextView = nullptr;
+	for (int16_t i = kLabelCount-1; i >= 0; i--)
+	{
+		const XLabelSpec&	spec = kLabels[i];
+		labels[i] = new XLabel(spec.x, spec.y, spec.width, spec.height,
+			spec.tag, nextView, spec.string, spec.font, nullptr,
+			spec.textColor, spec.bgColor,
+			(XFont::ETextAlignment)spec.textAlignment);
+		nextView = labels[i];
+	}
+	XColoredView	labelsPanel(20, 10, 440, 300, 0, nullptr, nextView,
+						nullptr, true, true, 0x1234);
+	XRootView		labelsRoot(&labelsPanel, nullptr, &display);
+	XLabelTable		table(kLabels);
+	XColoredView	tablePanel(20, 10, 440, 300, 0, nullptr, &table,
+						nullptr, true, true, 0x1234);
+	XRootView		tableRoot(&tablePanel, nullptr, &display);
+	labelsRoot.SetSize(kColumns, kRows);
+	tableRoot.SetSize(kColumns, kRows);
+
+	uint32_t	mismatches = 0;
+	uint32_t	labelDraws = 0;
+	for (uint32_t i = 0; i < areas; i++)
+	{
+		int16_t		x = 0;
+		int16_t		y = 0;
+		uint16_t	width = kColumns;
+		uint16_t	height = kRows;
+		if (i)
+		{
+			x = rand() % kColumns - 20;
+			y = rand() % kRows - 20;
+			width = 1 + rand() % 300;
+			height = 1 + rand() % 200;
+		}
+		if (i == areas/3)
+		{
+			for (uint8_t j = 0; j < kLabelCount; j += 2)
+			{
+				labels[j]->Enable(false, false);
+				table.EnableLabel(j, false, false);
+			}
+		} else if (i == (areas*2)/3)
+		{
+			for (uint8_t j = 1; j < kLabelCount; j += 3)
+			{
+				labels[j]->SetVisible(false);
+				table.SetLabelVisible(j, false);
+			}
+		}
+		display.mLog.clear();
+		labelsRoot.Draw(x, y, width, height);
+		std::string	labelsLog(display.mLog);
+		display.mLog.clear();
+		tableRoot.Draw(x, y, width, height);
+		// The panel's fill alone is short
+		labelDraws += labelsLog.size() > 64;
+		if (labelsLog != display.mLog)
+		{
+			if (mismatches < 5)
+			{
+				printf("Draw %d, %d, %u x %u differs\n", x, y, width, height);
+			}
+			mismatches++;
+		}
+	}
+	printf("%u of %u areas drew labels\n", labelDraws, areas);
+
+	uint32_t	labelHits = 0;
+	for (int16_t y = 0; y < kRows; y++)
+	{
+		for (int16_t x = 0; x < kColumns; x++)
+		{
+			XView*	labelsHit = labelsRoot.HitTest(x, y);
+			XView*	tableHit = tableRoot.HitTest(x, y);
+			bool	labelHit = labelsHit != &labelsPanel && labelsHit != &labelsRoot;
+			labelHits += labelHit;
+			if (labelHit ? tableHit != &table :
+				(labelsHit == &labelsPanel) != (tableHit == &tablePanel))
+			{
+				if (mismatches < 5)
+				{
+					printf("HitTest %d, %d differs\n", x, y);
+				}
+				mismatches++;
+			}
+		}
+	}
+	printf("%u points hit labels\n", labelHits);
+
+	display.mLog.clear();
+	for (uint8_t i = 0; i < kLabelCount; i++)
+	{
+		if (labels[i]->IsVisible())
+		{
+			labels[i]->DrawSelf();
+		}
+	}
+	std::string	labelsLog(display.mLog);
+	display.mLog.clear();
+	table.DrawSelf();
+	if (labelsLog != display.mLog)
+	{
+		printf("DrawSelf differs\n");
+		mismatches++;
+	}
+
+	printf("RAM on this host: XLabel %zu bytes each, XLabelTable %zu bytes plus "
+		"%zu bytes of flash per label\n", sizeof(XLabel), sizeof(XLabelTable),
+		sizeof(XLabelSpec));
+	printf("%u mismatches\n", mismatches);
+	return(mismatches > 255 ? 255 : mismatches);
+}
@@ -0,0 +1,382 @@
+/*
+*	XViewDrawDepth.cpp, Copyright Jonathan Mackey 2026
+*	Compares the stack used by the recursive and iterative XView traversals.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -D__MACH__ -I../../libraries/XView
+*			-I../../libraries/DisplayController -I../../libraries/XFont
+*			XViewDrawDepth.cpp ../../libraries/XView/XView.cpp
+*			../../libraries/XView/XRootView.cpp -o XViewDrawDepth
+*
+*	Usage:
+*		XViewDrawDepth [-t trees] [-s seed]
+*
+*	The recursive Draw and HitTest that XView used before are copied here as
+*	RecursiveDraw and RecursiveHitTest.  Each probe view records the lowest
+*	stack address seen when it's drawn or hit tested, so the stack used by
+*	a traversal is the distance from the caller's frame to that address.
+*
+*	1. Chains of 10, 50, 100 and 200 siblings, nested 1, 4 and
+*	XVIEW_MAX_DEPTH deep: the stack used by each traversal (the point hit
+*	tested is the last view.)  Note that with optimization the compiler
+*	turns the recursive call for the next view into a jump, so the
+*	recursive stack only grows with the nesting, which the iterative
+*	traversal bounds.  Build with -O0 to see the stack used without that.
+*	2. t (default 1000) random trees up to XVIEW_MAX_DEPTH deep with hidden
+*	and disabled views: both traversals must draw the same views in the
+*	same order and hit the same view for 100 random points.
+*	3. A chain nested 2 deeper than XVIEW_MAX_DEPTH: the views below
+*	XVIEW_MAX_DEPTH aren't drawn and each is counted by DepthOverflows.
+*	The exit status is the number of mismatches (255 at most.)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+#include "XRootView.h"
+
+static const uint16_t	kColumns = 480;
+static const uint16_t	kRows = 320;
+
+static uintptr_t			sLowest;
+static std::vector<XView*>	sDrawn;
+
+/******************************** NoteStackUse ********************************/
+static void __attribute__((noinline)) NoteStackUse(void)
+{
+	uintptr_t	address = (uintptr_t)__builtin_frame_address(0);
+	if (address < sLowest)
+	{
+		sLowest = address;
+	}
+}
+
+/*
+*	A view that records its stack use and the order it's drawn in.
+*/
+class XProbeView : public XView
+{
+public:
+							XProbeView(
+								int16_t					inX,
+								int16_t					inY,
+								uint16_t				inWidth,
+								uint16_t				inHeight,
+								uint16_t				inTag)
+								: XView(inX, inY, inWidth, inHeight, inTag){}
+	virtual void			DrawSelf(void)
+							{
+								NoteStackUse();
+								sDrawn.push_back(this);
+							}
+	virtual bool			HitSelf(
+								int16_t					inLocalX,
+								int16_t					inLocalY)
+							{
+								NoteStackUse();
+								return(XView::HitSelf(inLocalX, inLocalY));
+							}
+};
+
+/******************************* RecursiveDraw ********************************/
+/*
+*	XView::Draw before it was made iterative.
+*/
+static void RecursiveDraw(
+	XView*		inView,
+	int16_t		inX,
+	int16_t		inY,
+	uint16_t	inWidth,
+	uint16_t	inHeight)
+{
+	if (inView->IsVisible() &&
+		inView->X() + inView->Width() > inX &&
+		inX + inWidth > inView->X() &&
+		inView->Y() + inView->Height() > inY &&
+		inY + inHeight > inView->Y())
+	{
+		inView->DrawSelf();
+		if (inView->SubViews())
+		{
+			RecursiveDraw(inView->SubViews(), inX-inView->X(), inY-inView->Y(),
+				inWidth, inHeight);
+		}
+	}
+	if (inView->NextView())
+	{
+		RecursiveDraw(inView->NextView(), inX, inY, inWidth, inHeight);
+	}
+}
+
+/****************************** RecursiveHitTest ******************************/
+/*
+*	XView::HitTest before it was made iterative.
+*/
+static XView* RecursiveHitTest(
+	XView*	inView,
+	int16_t	inX,
+	int16_t	inY)
+{
+	int16_t	localX = inX - inView->X();
+	int16_t	localY = inY - inView->Y();
+	XView* hitView = nullptr;
+	if (inView->WantsClicks() &&
+		inView->HitSelf(localX, localY))
+	{
+		hitView = inView;
+		if (inView->SubViews())
+		{
+			XView* subHitView = RecursiveHitTest(inView->SubViews(), localX, localY);
+			if (subHitView)
+			{
+				hitView = subHitView;
+			}
+		}
+	} else if (inView->NextView())
+	{
+		hitView = RecursiveHitTest(inView->NextView(), inX, inY);
+	}
+	return(hitView);
+}
+
+/******************************** StackUsed ***********************************/
+/*
+*	Returns the bytes of stack used below this function's frame by either
+*	the recursive (inRecursive) or the XView traversal.  Draws the whole
+*	screen if inHit is false, else hit tests inX, inY.
+*/
+static uint32_t __attribute__((noinline)) StackUsed(
+	XView*	inRoot,
+	bool	inRecursive,
+	bool	inHit,
+	int16_t	inX,
+	int16_t	inY,
+	XView**	outHitView = nullptr)
+{
+	uintptr_t	base = (uintptr_t)__builtin_frame_address(0);
+	XView*		hitView = nullptr;
+	sLowest = base;
+	sDrawn.clear();
+	if (inHit)
+	{
+		hitView = inRecursive ? RecursiveHitTest(inRoot, inX, inY) :
+								inRoot->XView::HitTest(inX, inY);
+	} else if (inRecursive)
+	{
+		RecursiveDraw(inRoot, 0, 0, kColumns, kRows);
+	} else
+	{
+		inRoot->Draw(0, 0, kColumns, kRows);
+	}
+	if (outHitView)
+	{
+		*outHitView = hitView;
+	}
+	return((uint32_t)(base - sLowest));
+}
+
+/*********************************** Random ***********************************/
+static int32_t Random(
+	int32_t	inMin,
+	int32_t	inMax)	// Inclusive
+{
+	return(inMin + rand() % (inMax - inMin + 1));
+}
+
+/********************************* AddSubView *********************************/
+static void AddSubView(
+	XView*	inSuperView,
+	XView*	inView)
+{
+	XView*	last = inSuperView->SubViews();
+	if (last)
+	{
+		for (; last->NextView(); last = last->NextView()){}
+		last->SetNextView(inView);
+	} else
+	{
+		inSuperView->SetSubViews(inView);
+	}
+}
+
+/********************************* MakeChain **********************************/
+/*
+*	inSiblings full screen views nested inDepth deep.  Returns the last
+*	sibling at the deepest level.
+*/
+static XView* MakeChain(
+	XView*		inRoot,
+	uint16_t	inSiblings,
+	uint8_t		inDepth)
+{
+	XView*	superView = inRoot;
+	for (uint8_t depth = 1; depth < inDepth; depth++)
+	{
+		XView*	view = new XProbeView(0, 0, kColumns, kRows, depth);
+		AddSubView(superView, view);
+		superView = view;
+	}
+	XView*	last = nullptr;
+	for (uint16_t i = 0; i < inSiblings; i++)
+	{
+		last = new XProbeView(0, 0, kColumns, kRows, i);
+		AddSubView(superView, last);
+	}
+	return(last);
+}
+
+/********************************** MakeTree **********************************/
+static void MakeTree(
+	XView*		inSuperView,
+	uint8_t		inDepth)
+{
+	uint16_t	siblings = Random(1, 5);
+	for (uint16_t i = 0; i < siblings; i++)
+	{
+		int16_t		width = inSuperView->Width();
+		int16_t		height = inSuperView->Height();
+		int16_t		w = Random(4, width > 8 ? width*3/4 : 4);
+		int16_t		h = Random(4, height > 8 ? height*3/4 : 4);
+		XView*	view = new XProbeView(Random(-4, width - w/2),
+							Random(-4, height - h/2), w, h, rand() % 100);
+		view->SetVisible(rand() % 10 != 0);
+		if (rand() % 10 == 0)
+		{
+			view->Enable(false, false);
+		}
+		AddSubView(inSuperView, view);
+		if (inDepth < XView::eMaxDepth &&
+			rand() % 2)
+		{
+			MakeTree(view, inDepth + 1);
+		}
+	}
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	trees = 1000;
+	uint32_t	seed = 1;
+	int	opt;
+	while ((opt = getopt(argc, argv, "t:s:")) != -1)
+	{
+		switch (opt)
+		{
+			case 't':
+				trees = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 's':
+				seed = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			default:
+				fprintf(stderr, "Usage: XViewDrawDepth [-t trees] [-s seed]\n");
+				return(255);
+		}
+	}
+	srand(seed);
+	uint32_t	mismatches = 0;
+	const uint16_t	kSiblings[] = {10, 50, 100, 200};
+	const uint8_t	kDepths[] = {1, 4, XView::eMaxDepth};
+	printf("XVIEW_MAX_DEPTH %u\n", XView::eMaxDepth);
+	printf("siblings  depth  recursive draw  draw  recursive hit  hit  (bytes of stack)\n");
+	for (uint8_t depth : kDepths)
+	{
+		for (uint16_t siblings : kSiblings)
+		{
+			XRootView	root(nullptr);
+			root.SetSize(kRows, kColumns);
+			XView*	last = MakeChain(&root, siblings, depth);
+			// Only the last sibling takes the hit.
+			for (XView* view = last->SuperView()->SubViews(); view != last;
+				view = view->NextView())
+			{
+				view->Enable(false, false);
+			}
+			XView*	recursiveHit;
+			XView*	hit;
+			uint32_t	recursiveDraw = StackUsed(&root, true, false, 0, 0);
+			size_t		recursiveDrawn = sDrawn.size();
+			uint32_t	draw = StackUsed(&root, false, false, 0, 0);
+			size_t		drawn = sDrawn.size();
+			uint32_t	recursiveHitTest = StackUsed(&root, true, true, 10, 10, &recursiveHit);
+			uint32_t	hitTest = StackUsed(&root, false, true, 10, 10, &hit);
+			if ((drawn != recursiveDrawn || hit != last || recursiveHit != last) &&
+				mismatches++ < 10)
+			{
+				printf("%u siblings %u deep: drawn %zu/%zu, hit %s\n", siblings, depth,
+					drawn, recursiveDrawn, hit == last ? "same" : "different");
+			}
+			printf("%8u  %5u  %14u  %4u  %13u  %3u\n", siblings, depth,
+				recursiveDraw, draw, recursiveHitTest, hitTest);
+		}
+	}
+
+	for (uint32_t tree = 0; tree < trees; tree++)
+	{
+		XRootView	root(nullptr);
+		root.SetSize(kRows, kColumns);
+		MakeTree(&root, 1);
+		StackUsed(&root, true, false, 0, 0);
+		std::vector<XView*>	recursiveDrawn(sDrawn);
+		StackUsed(&root, false, false, 0, 0);
+		if (sDrawn != recursiveDrawn &&
+			mismatches++ < 10)
+		{
+			printf("tree %u: drawn %zu views, recursive %zu\n", tree,
+				sDrawn.size(), recursiveDrawn.size());
+		}
+		for (uint16_t i = 0; i < 100; i++)
+		{
+			int16_t	x = rand() % kColumns;
+			int16_t	y = rand() % kRows;
+			if (RecursiveHitTest(&root, x, y) != root.XView::HitTest(x, y) &&
+				mismatches++ < 10)
+			{
+				printf("tree %u: hit %d,%d found different views\n", tree, x, y);
+			}
+		}
+	}
+
+	{
+		XRootView	root(nullptr);
+		root.SetSize(kRows, kColumns);
+		uint16_t	overflows = XView::DepthOverflows();
+		// The root and eMaxDepth probes fit, the next level overflows.
+		MakeChain(&root, 1, XView::eMaxDepth + 2);
+		StackUsed(&root, false, false, 0, 0);
+		size_t	drawn = sDrawn.size();
+		overflows = XView::DepthOverflows() - overflows;
+		if ((drawn != XView::eMaxDepth || overflows != 1 ||
+			XView::MaxDrawDepth() != XView::eMaxDepth) &&
+			mismatches++ < 10)
+		{
+			printf("overflow: drawn %zu, overflows %u, max depth %u\n", drawn,
+				overflows, XView::MaxDrawDepth());
+		}
+	}
+	printf("%u trees, %u mismatches\n", trees, mismatches);
+	// XView has no virtual destructor, the views are left allocated.
+	return(mismatches < 255 ? mismatches : 255);
+}
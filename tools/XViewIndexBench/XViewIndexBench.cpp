@@ -0,0 +1,303 @@
+/*
+*	XViewIndexBench.cpp, Copyright Jonathan Mackey 2026
+*	Compares XViewIndex hit testing and tag lookup with the XView traversal.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+/*
+*	Build (from this directory):
+*		c++ -std=c++11 -O2 -D__MACH__ -DXVIEW_INDEX_SIZE=512
+*			-DXVIEW_INDEX_POOL=8192 -I../../libraries/XView
+*			-I../../libraries/DisplayController -I../../libraries/XFont
+*			XViewIndexBench.cpp ../../libraries/XView/XView.cpp
+*			../../libraries/XView/XRootView.cpp
+*			../../libraries/XView/XViewIndex.cpp -o XViewIndexBench
+*
+*	Usage:
+*		XViewIndexBench [-h hits] [-s seed]
+*
+*	For hierarchies of 50, 100, 200 and 500 views on a 480 x 320 root, each
+*	built at random: a few full screen views (some hidden) containing
+*	panels, containing controls, up to 4 deep, with 10% hidden and 10%
+*	disabled.  Some views are round (HitSelf overridden), some capture hits
+*	outside their bounds, and tags are duplicated.  Then h (default 200,000)
+*	random points are hit tested and every tag looked up both ways.  The
+*	results must be the same view.  The exit status is the number of
+*	mismatches (255 at most.)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <vector>
+#include "XRootView.h"
+#include "XViewIndex.h"
+
+static const uint16_t	kColumns = 480;
+static const uint16_t	kRows = 320;
+
+/*
+*	A view that's only hit within the circle inscribed in its bounds.
+*/
+class XRoundView : public XView
+{
+public:
+							XRoundView(
+								int16_t					inX,
+								int16_t					inY,
+								uint16_t				inSize,
+								uint16_t				inTag)
+								: XView(inX, inY, inSize, inSize, inTag){}
+	virtual bool			HitSelf(
+								int16_t					inLocalX,
+								int16_t					inLocalY)
+							{
+								int32_t	radius = mWidth/2;
+								int32_t	dx = inLocalX - radius;
+								int32_t	dy = inLocalY - radius;
+								return(dx*dx + dy*dy < radius*radius);
+							}
+};
+
+/*
+*	A view that takes all hits while captured, like an open XMenuButton.
+*/
+class XCaptureView : public XView
+{
+public:
+							XCaptureView(
+								int16_t					inX,
+								int16_t					inY,
+								uint16_t				inWidth,
+								uint16_t				inHeight,
+								uint16_t				inTag,
+								bool					inCaptured)
+								: XView(inX, inY, inWidth, inHeight, inTag),
+								  mCaptured(inCaptured){}
+	virtual bool			HitSelf(
+								int16_t					inLocalX,
+								int16_t					inLocalY)
+								{return(mCaptured || XView::HitSelf(inLocalX, inLocalY));}
+	virtual bool			HitsOutsideBounds(void) const
+								{return(true);}
+protected:
+	bool	mCaptured;
+};
+
+/*********************************** Random ***********************************/
+static int32_t Random(
+	int32_t	inMin,
+	int32_t	inMax)	// Inclusive
+{
+	return(inMin + rand() % (inMax - inMin + 1));
+}
+
+/********************************* AddSubView *********************************/
+static void AddSubView(
+	XView*	inSuperView,
+	XView*	inView)
+{
+	XView*	last = inSuperView->SubViews();
+	if (last)
+	{
+		for (; last->NextView(); last = last->NextView()){}
+		last->SetNextView(inView);
+	} else
+	{
+		inSuperView->SetSubViews(inView);
+	}
+}
+
+/******************************* MakeHierarchy ********************************/
+static void MakeHierarchy(
+	XRootView&				ioRoot,
+	uint16_t				inViews,
+	std::vector<XView*>&	outViews)
+{
+	struct SContainer
+	{
+		XView*		view;
+		uint8_t		depth;
+	};
+	std::vector<SContainer>	containers;
+	uint16_t	screens = 2 + inViews/100;
+	for (uint16_t i = 0; i < screens; i++)
+	{
+		XView*	screen = new XView(0, 0, kColumns, kRows, Random(1, inViews/2),
+								nullptr, nullptr, nullptr, i == 0 || rand() % 3 == 0);
+		AddSubView(&ioRoot, screen);
+		outViews.push_back(screen);
+		containers.push_back({screen, 1});
+	}
+	while (outViews.size() < inViews)
+	{
+		SContainer	parent = containers[rand() % containers.size()];
+		int16_t		width = parent.view->Width();
+		int16_t		height = parent.view->Height();
+		uint16_t	tag = rand() % 8 ? Random(1, inViews/2) : 0;
+		int16_t		w = Random(4, width > 8 ? width/2 : 4);
+		int16_t		h = Random(4, height > 8 ? height/2 : 4);
+		// Mostly within the superview, sometimes overhanging it.
+		int16_t		x = Random(-4, width - w/2);
+		int16_t		y = Random(-4, height - h/2);
+		XView*		view;
+		switch (rand() % 16)
+		{
+			case 0:
+				view = new XRoundView(x, y, w, tag);
+				break;
+			case 1:
+				view = new XCaptureView(x, y, w, h, tag, rand() % 4 == 0);
+				break;
+			default:
+				view = new XView(x, y, w, h, tag);
+				break;
+		}
+		view->SetVisible(rand() % 10 != 0);
+		if (rand() % 10 == 0)
+		{
+			view->Enable(false, false);
+		}
+		AddSubView(parent.view, view);
+		outViews.push_back(view);
+		if (parent.depth < 4 &&
+			w > 24 && h > 24)
+		{
+			containers.push_back({view, (uint8_t)(parent.depth + 1)});
+		}
+	}
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	hits = 200000;
+	uint32_t	seed = 1;
+	int	opt;
+	while ((opt = getopt(argc, argv, "h:s:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'h':
+				hits = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 's':
+				seed = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			default:
+				fprintf(stderr, "Usage: XViewIndexBench [-h hits] [-s seed]\n");
+				return(255);
+		}
+	}
+	srand(seed);
+	const uint16_t	kSizes[] = {50, 100, 200, 500};
+	uint32_t	mismatches = 0;
+	printf("XViewIndex %zu bytes (%u views, %u pool)\n", sizeof(XViewIndex),
+		XViewIndex::eMaxViews, XViewIndex::ePoolSize);
+	printf("views  build us  pool  traverse ns/hit  index ns/hit  traverse ns/tag  index ns/tag\n");
+	for (uint16_t size : kSizes)
+	{
+		XRootView	root(nullptr);
+		std::vector<XView*>	views;
+		MakeHierarchy(root, size, views);
+		XViewIndex*	index = new XViewIndex;
+		auto	start = std::chrono::steady_clock::now();
+		bool	built = index->Build(&root, kColumns, kRows);
+		double	buildUS = std::chrono::duration<double, std::micro>(
+							std::chrono::steady_clock::now() - start).count();
+		if (!built)
+		{
+			printf("%5u  doesn't fit\n", size);
+			mismatches++;
+			continue;
+		}
+		std::vector<int16_t>	points(hits*2);
+		for (uint32_t i = 0; i < hits*2; i += 2)
+		{
+			points[i] = rand() % kColumns;
+			points[i+1] = rand() % kRows;
+		}
+		std::vector<XView*>	traversed(hits);
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < hits; i++)
+		{
+			traversed[i] = root.HitTest(points[i*2], points[i*2+1]);
+		}
+		double	traverseNS = std::chrono::duration<double, std::nano>(
+							std::chrono::steady_clock::now() - start).count() / hits;
+		std::vector<XView*>	indexed(hits);
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < hits; i++)
+		{
+			index->HitTest(points[i*2], points[i*2+1], indexed[i]);
+		}
+		double	indexNS = std::chrono::duration<double, std::nano>(
+							std::chrono::steady_clock::now() - start).count() / hits;
+		for (uint32_t i = 0; i < hits; i++)
+		{
+			if (traversed[i] != indexed[i] &&
+				mismatches++ < 10)
+			{
+				printf("%u views: hit %d,%d traversal tag %u, index tag %u\n", size,
+					points[i*2], points[i*2+1], traversed[i] ? traversed[i]->Tag() : 0xFFFF,
+					indexed[i] ? indexed[i]->Tag() : 0xFFFF);
+			}
+		}
+		uint16_t	tags = size/2 + 2;
+		std::vector<XView*>	tagTraversed(tags);
+		std::vector<XView*>	tagIndexed(tags);
+		uint32_t	tagRepeats = 1 + 100000/tags;
+		start = std::chrono::steady_clock::now();
+		for (uint32_t repeat = 0; repeat < tagRepeats; repeat++)
+		{
+			for (uint16_t tag = 0; tag < tags; tag++)
+			{
+				tagTraversed[tag] = root.ViewWithTag(tag);
+			}
+		}
+		double	tagTraverseNS = std::chrono::duration<double, std::nano>(
+							std::chrono::steady_clock::now() - start).count() / (tagRepeats*tags);
+		start = std::chrono::steady_clock::now();
+		for (uint32_t repeat = 0; repeat < tagRepeats; repeat++)
+		{
+			for (uint16_t tag = 0; tag < tags; tag++)
+			{
+				index->ViewWithTag(tag, tagIndexed[tag]);
+			}
+		}
+		double	tagIndexNS = std::chrono::duration<double, std::nano>(
+							std::chrono::steady_clock::now() - start).count() / (tagRepeats*tags);
+		for (uint16_t tag = 0; tag < tags; tag++)
+		{
+			if (tagTraversed[tag] != tagIndexed[tag] &&
+				mismatches++ < 10)
+			{
+				printf("%u views: tag %u found different views\n", size, tag);
+			}
+		}
+		printf("%5u  %8.1f  %4u  %15.1f  %12.1f  %15.1f  %12.1f\n", size, buildUS,
+			index->PoolUsed(), traverseNS, indexNS, tagTraverseNS, tagIndexNS);
+		delete index;
+		// XView has no virtual destructor, the views are left allocated.
+	}
+	printf("%u mismatches\n", mismatches);
+	return(mismatches < 255 ? mismatches : 255);
+}
@@ -0,0 +1,20 @@
+/*
+*	pgmspace_stub.h
+*	The host build of XFont and DataStream (__MACH__) includes this in place
+*	of avr/pgmspace.h.  Flash is ordinary memory on the host.  Shared by the
+*	tools, built with -I.. from a tool's directory.
+*/
+#ifndef pgmspace_stub_h
+#define pgmspace_stub_h
+
+#include <inttypes.h>
+#include <string.h>
+
+#define PROGMEM
+#define memcpy_P				memcpy
+#define pgm_read_byte(p)		(*(const uint8_t*)(p))
+#define pgm_read_word(p)		(*(const uint16_t*)(p))
+#define pgm_read_byte_near(p)	(*(const uint8_t*)(p))
+#define pgm_read_word_near(p)	(*(const uint16_t*)(p))
+
+#endif // pgmspace_stub_h